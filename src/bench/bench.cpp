@@ -0,0 +1,478 @@
+/**
+ * @file
+ * @brief Driver of graphAnon_bench, which times each hot path of both modes
+ * on synthetic and real-world graphs.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>		/* For std::cout, std::cerr, std::endl */
+#include <fstream>		/* For std::ofstream */
+#include <algorithm>	/* For std::find, std::min, std::shuffle */
+#include <random>		/* For std::mt19937_64 */
+#include <memory>		/* For std::unique_ptr */
+#include <string.h>		/* For strcmp(), strchr() */
+#include <stdlib.h>		/* For strtoull(), atof(), srand(), mkdtemp() */
+#include <stdio.h>		/* For remove() */
+#include <unistd.h>		/* For rmdir() */
+
+/* STL libraries in use */
+#include <vector>
+#include <string>
+#include <functional>
+#include <utility>
+
+#include "omp.h"
+
+#include "benchmark.h"
+#include "../labelled_graph/labelled_graph.h"
+#include "../unlabelled_graph/unlabelled_graph.h"
+#include "../unlabelled_graph/random_graph.h"
+
+namespace
+{
+	/**
+	 * Finds a specified option among the command line arguments.
+	 * @see getCmdOption() in main.cpp
+	 */
+	char* getCmdOption( char **begin, char **end, const std::string &option, bool has_val ) {
+		char **itr = std::find( begin, end, option );
+		if( itr != end ) {
+			if( !has_val ) { return *itr; }
+			else if( ++itr != end ) { return *itr; }
+		}
+		return 0;
+	}
+
+	/**
+	 * Parses a comma-separated list of non-negative integers (e.g., "1,2,4").
+	 */
+	std::vector< uint64_t > parse_list( const char *list ) {
+		std::vector< uint64_t > values;
+		for( const char *c = list; c != NULL && *c != '\0'; ) {
+			char *end;
+			values.push_back( strtoull( c, &end, 10 ) );
+			c = ( *end == ',' ? end + 1 : NULL );
+		}
+		return values;
+	}
+
+	/**
+	 * Splits a comma-separated list of strings.
+	 */
+	std::vector< std::string > split( const char *list ) {
+		std::vector< std::string > items;
+		if( list == NULL ) { return items; }
+		std::string const s( list );
+		for( size_t first = 0; first <= s.size(); ) {
+			size_t last = s.find( ',', first );
+			if( last == std::string::npos ) { last = s.size(); }
+			if( last > first ) { items.push_back( s.substr( first, last - first ) ); }
+			first = last + 1;
+		}
+		return items;
+	}
+
+	/**
+	 * Mutes std::cout for as long as it is in scope, because the graph
+	 * constructors echo the name of every file that they load.
+	 */
+	class MuteStdout {
+	public:
+		MuteStdout() : saved_( std::cout.rdbuf( NULL ) ) {}
+		~MuteStdout() {
+			std::cout.rdbuf( saved_ );
+			std::cout.clear();
+		}
+	private:
+		std::streambuf *saved_; /**< The buffer to restore. */
+	};
+
+	/** Every hot path, in the order in which they run. */
+	const char *const all_cases[] = { "load_edge_list", "load_binary", "reorder", "retrieve_degree_sequence",
+		"anonymize_degree_sequence", "hide_waldo_false", "hide_waldo_true", "is_alpha_proximal",
+		"greedy", "parallel_greedy", "hopeful", "hop_plot", "clustering_coefficient",
+		"subgraph_centrality" };
+
+	/**
+	 * @brief The settings of a benchmark run, from the command line.
+	 */
+	struct BenchOptions {
+		std::vector< std::string > cases; /**< The hot paths to time. */
+		std::vector< uint64_t > threads; /**< The thread counts at which to time them. */
+
+		/** The vertex orders in which to time them, by name. */
+		std::vector< std::pair< std::string, graphAnon::VertexOrder > > orders;
+		uint32_t repetitions; /**< The number of times to time each. */
+		uint32_t k; /**< The privacy threshold of the identity mode. */
+		float alpha; /**< The privacy threshold of the attribute mode. */
+		uint32_t num_labels; /**< The label alphabet size of the attribute mode. */
+		uint64_t seed; /**< Seeds the synthetic graphs and labels. */
+		std::string directory; /**< Where to keep the temporary graph files. */
+	};
+
+	/**
+	 * Writes g in the vertex-labelled adjacency list format, with labels
+	 * spread as evenly as possible over the vertices in a random order.
+	 * @return False if the file could not be written.
+	 */
+	bool write_labelled( UnlabelledGraph const& g, BenchOptions const& options,
+		std::string const& filename ) {
+
+		CsrGraph const& csr = g.csr();
+		std::vector< uint32_t > labels( csr.num_vertices() );
+		for( uint32_t v = 0; v < labels.size(); ++v ) { labels[ v ] = v % options.num_labels; }
+		std::mt19937_64 rng( options.seed );
+		std::shuffle( labels.begin(), labels.end(), rng );
+
+		std::ofstream file( filename );
+		file << csr.num_vertices() << " " << options.num_labels << "\n";
+		for( uint32_t u = 0; u < csr.num_vertices(); ++u ) {
+			file << labels[ u ];
+			for( uint32_t const v : csr.neighbours( u ) ) { file << " " << v; }
+			file << "\n";
+		}
+		return static_cast< bool >( file );
+	}
+
+	/**
+	 * Times every requested hot path on one graph, in every requested
+	 * vertex order and at every requested thread count.
+	 * @param name The name of the workload.
+	 * @param base The graph.
+	 * @param results The results to which to append.
+	 * @return False if the graph could not be staged in the temporary directory.
+	 */
+	bool run_workload( std::string const& name, UnlabelledGraph const& base,
+		BenchOptions const& options, std::vector< BenchmarkResult > *results ) {
+
+		/* Stage the graph in every format that the hot paths load. */
+		std::string const stem = options.directory + "/" + name;
+		std::string const edge_list = stem + ".edgeList", binary = stem + ".bin";
+		std::string const labelled_text = stem + ".adjListVL", labelled = stem + ".labelled.bin";
+		bool staged = base.write( edge_list, graphAnon::FileFormat::edgeList )
+			&& base.write( binary, graphAnon::FileFormat::binary )
+			&& write_labelled( base, options, labelled_text );
+		if( staged ) {
+			MuteStdout mute;
+			LabelledGraph const g( labelled_text, graphAnon::FileFormat::adjacencyListVertexLabelled );
+			staged = g.write( labelled, graphAnon::FileFormat::binary );
+		}
+		remove( labelled_text.c_str() );
+		if( !staged ) {
+			std::cerr << "Could not write the graph files of " << name << " to "
+				<< options.directory << std::endl;
+			return false;
+		}
+
+		const uint32_t n = base.num_vertices();
+		const uint32_t k = std::min( options.k, n );
+		std::unique_ptr< UnlabelledGraph > g;
+		std::unique_ptr< LabelledGraph > lg;
+		DegreeSequence degrees;
+		volatile double sink = 0;
+
+		/* Fresh graphs for the hot paths that modify them, reused otherwise,
+		 * all relabelled (untimed) into the vertex order being measured. */
+		graphAnon::VertexOrder order = graphAnon::VertexOrder::none;
+		auto const load = [ & ]() { g.reset( new UnlabelledGraph( binary, graphAnon::FileFormat::binary ) ); };
+		auto const fresh = [ & ]() {
+			load();
+			g->reorder( order );
+		};
+		auto const frozen = [ & ]() {
+			if( !g ) {
+				fresh();
+				g->freeze();
+			}
+		};
+		auto const fresh_labelled = [ & ]() {
+			lg.reset( new LabelledGraph( labelled, graphAnon::FileFormat::binary ) );
+			lg->reorder( order );
+			srand( static_cast< unsigned >( options.seed ) );
+		};
+
+		typedef std::pair< std::function< void() >, std::function< void() > > HotPath;
+		auto const hot_path = [ & ]( std::string const& path ) -> HotPath {
+			if( path == "load_edge_list" ) {
+				return HotPath( [ & ]() { g.reset(); },
+					[ & ]() { g.reset( new UnlabelledGraph( edge_list, graphAnon::FileFormat::edgeList ) ); } );
+			}
+			if( path == "load_binary" ) { return HotPath( [ & ]() { g.reset(); }, load ); }
+			if( path == "reorder" ) { return HotPath( load, [ & ]() { g->reorder( order ); } ); }
+			if( path == "retrieve_degree_sequence" ) {
+				return HotPath( frozen, [ & ]() { degrees = g->retrieve_degree_sequence(); } );
+			}
+			if( path == "anonymize_degree_sequence" ) {
+				return HotPath( [ & ]() {
+						frozen();
+						degrees = g->retrieve_degree_sequence();
+					},
+					[ & ]() { sink = anonymize_degree_sequence( &degrees, k ); } );
+			}
+			if( path == "hide_waldo_false" ) { return HotPath( fresh, [ & ]() { g->hide_waldo< false >( k ); } ); }
+			if( path == "hide_waldo_true" ) { return HotPath( fresh, [ & ]() { g->hide_waldo< true >( k ); } ); }
+			if( path == "is_alpha_proximal" ) {
+				return HotPath( fresh_labelled, [ & ]() { sink = lg->is_alpha_proximal( options.alpha ); } );
+			}
+			if( path == "greedy" ) { return HotPath( fresh_labelled, [ & ]() { lg->greedy( options.alpha ); } ); }
+			if( path == "parallel_greedy" ) {
+				return HotPath( fresh_labelled, [ & ]() { lg->parallel_greedy( options.alpha ); } );
+			}
+			if( path == "hopeful" ) { return HotPath( fresh_labelled, [ & ]() { lg->hopeful( options.alpha ); } ); }
+			if( path == "hop_plot" ) { return HotPath( frozen, [ & ]() { sink = g->hop_plot().size(); } ); }
+			if( path == "clustering_coefficient" ) {
+				return HotPath( frozen, [ & ]() { sink = g->clustering_coefficient(); } );
+			}
+			return HotPath( frozen, [ & ]() { sink = g->sparse_subgraph_centrality( 1e-3 ); } );
+		};
+
+		auto const time_case = [ & ]( std::string const& workload, std::string const& path,
+			HotPath const& functions ) {
+			for( uint64_t const threads : options.threads ) {
+				omp_set_num_threads( static_cast< int >( threads ) );
+				g.reset();
+				lg.reset();
+
+				BenchmarkResult result;
+				result.workload = workload;
+				result.num_vertices = n;
+				result.num_edges = base.num_edges();
+				result.name = path;
+				result.threads = static_cast< uint32_t >( threads );
+				result.speedup = 0;
+				{
+					MuteStdout mute;
+					graphAnon::time_hot_path( options.repetitions, functions.first, functions.second, &result );
+				}
+				std::cerr << workload << "\t" << path << "\t" << threads << " thread(s)\t"
+					<< graphAnon::percentile( result.seconds, 0.5 ) << " s" << std::endl;
+				results->push_back( result );
+			}
+		};
+
+		for( auto const& named_order : options.orders ) {
+			order = named_order.second;
+			std::string const workload = order == graphAnon::VertexOrder::none
+				? name : name + "+" + named_order.first;
+			for( std::string const& path : options.cases ) {
+
+				/* Loading does not depend on the order, and there is no "none" pass to time. */
+				if( ( path.compare( 0, 5, "load_" ) == 0 && &named_order != &options.orders.front() )
+						|| ( path == "reorder" && order == graphAnon::VertexOrder::none ) ) {
+					continue;
+				}
+				time_case( workload, path, hot_path( path ) );
+			}
+		}
+		g.reset();
+		lg.reset();
+
+		remove( edge_list.c_str() );
+		remove( binary.c_str() );
+		remove( labelled.c_str() );
+		return true;
+	}
+
+	/**
+	 * Prints instructions for how to use graphAnon_bench.
+	 */
+	void print_usage_instructions( const char *bin_path ) {
+		std::cout << std::endl << "\tUsage: " << bin_path << std::endl;
+		std::cout << "\t\t[-sizes [comma-separated vertex counts of the synthetic G(n,m) "
+			<< "graphs (1000,4000 by default; 0 for none)]]" << std::endl;
+		std::cout << "\t\t[-degree [average degree of the synthetic graphs (8 by default)]]" << std::endl;
+		std::cout << "\t\t[-workloads [comma-separated name=path pairs of real-world graphs, "
+			<< "e.g., enron=Email-Enron.edgeList]]" << std::endl;
+		std::cout << "\t\t[-format {adjList, edgeList, binary} [format of the -workloads "
+			<< "files (edgeList by default)]]" << std::endl;
+		std::cout << "\t\t[-cases [comma-separated hot paths to time (all by default)]]" << std::endl;
+		std::cout << "\t\t[-threads [comma-separated thread counts (1 and the powers of two up "
+			<< "to the number of threads available, by default)]]" << std::endl;
+		std::cout << "\t\t[-repetitions [timed runs per hot path (5 by default)]]" << std::endl;
+		std::cout << "\t\t[-k [privacy threshold of the identity mode (5 by default)]]" << std::endl;
+		std::cout << "\t\t[-alpha [privacy threshold of the attribute mode (0.1 by default)]]" << std::endl;
+		std::cout << "\t\t[-l [label set size of the attribute mode (4 by default)]]" << std::endl;
+		std::cout << "\t\t[-seed [seed of the synthetic graphs and labels (1 by default)]]" << std::endl;
+		std::cout << "\t\t[-reorder [comma-separated vertex orders, from none, degree, rcm, and "
+			<< "gorder, in which to time every hot path; workloads are suffixed with \"+order\" "
+			<< "(none by default)]]" << std::endl;
+		std::cout << "\t\t[-tmp [directory for the temporary graph files (/tmp by default)]]" << std::endl;
+		std::cout << "\t\t[-o [path to which to write the results (stdout by default)]]" << std::endl;
+		std::cout << "\t\t[-report-format {json, csv} [format of the results (csv if the -o path "
+			<< "ends in .csv, else json, by default)]]" << std::endl << std::endl;
+		std::cout << "\tThe hot paths are:";
+		for( auto const path : all_cases ) { std::cout << " " << path; }
+		std::cout << std::endl << std::endl;
+	}
+}
+
+/**
+ * Main driver method of graphAnon_bench, which generates or loads each
+ * workload, times the requested hot paths on it, and writes the results.
+ * @returns 0 on success, 1 on invalid input, and 2 if the results or the
+ * temporary graph files could not be written.
+ */
+int main( int argc, char** argv ) {
+	if( getCmdOption( argv, argv + argc, "-h", false ) != NULL
+			|| getCmdOption( argv, argv + argc, "--help", false ) != NULL ) {
+		print_usage_instructions( *argv );
+		return 0;
+	}
+
+	BenchOptions options;
+	char *value = getCmdOption( argv, argv + argc, "-cases", true );
+	options.cases = value ? split( value )
+		: std::vector< std::string >( std::begin( all_cases ), std::end( all_cases ) );
+	for( std::string const& path : options.cases ) {
+		if( std::find_if( std::begin( all_cases ), std::end( all_cases ), [ &path ]( const char *c ) {
+				return path == c; } ) == std::end( all_cases ) ) {
+			std::cerr << std::endl << "\tHot path \"" << path << "\" not supported." << std::endl;
+			return 1;
+		}
+	}
+
+	const uint32_t max_threads = omp_get_max_threads();
+	value = getCmdOption( argv, argv + argc, "-threads", true );
+	if( value ) { options.threads = parse_list( value ); }
+	else {
+		for( uint64_t t = 1; t < max_threads; t *= 2 ) { options.threads.push_back( t ); }
+		options.threads.push_back( max_threads );
+	}
+	value = getCmdOption( argv, argv + argc, "-repetitions", true );
+	options.repetitions = value ? strtoull( value, NULL, 10 ) : 5;
+	value = getCmdOption( argv, argv + argc, "-k", true );
+	options.k = value ? strtoull( value, NULL, 10 ) : 5;
+	value = getCmdOption( argv, argv + argc, "-alpha", true );
+	options.alpha = value ? atof( value ) : 0.1;
+	value = getCmdOption( argv, argv + argc, "-l", true );
+	options.num_labels = value ? strtoull( value, NULL, 10 ) : 4;
+	value = getCmdOption( argv, argv + argc, "-seed", true );
+	options.seed = value ? strtoull( value, NULL, 10 ) : 1;
+	value = getCmdOption( argv, argv + argc, "-reorder", true );
+	for( std::string const& name : split( value ? value : "none" ) ) {
+		graphAnon::VertexOrder order;
+		if( name == "none" ) { order = graphAnon::VertexOrder::none; }
+		else if( name == "degree" ) { order = graphAnon::VertexOrder::degree; }
+		else if( name == "rcm" ) { order = graphAnon::VertexOrder::rcm; }
+		else if( name == "gorder" ) { order = graphAnon::VertexOrder::gorder; }
+		else {
+			std::cerr << std::endl << "\tVertex order \"" << name << "\" not supported." << std::endl;
+			return 1;
+		}
+		options.orders.push_back( std::make_pair( name, order ) );
+	}
+	if( options.repetitions == 0 || options.k == 0 || options.num_labels == 0
+			|| std::find( options.threads.begin(), options.threads.end(), 0 ) != options.threads.end() ) {
+		std::cerr << std::endl << "\t-repetitions, -threads, -k, and -l must be positive." << std::endl;
+		return 1;
+	}
+
+	value = getCmdOption( argv, argv + argc, "-sizes", true );
+	std::vector< uint64_t > const sizes = parse_list( value ? value : "1000,4000" );
+	value = getCmdOption( argv, argv + argc, "-degree", true );
+	const double degree = value ? atof( value ) : 8;
+
+	graphAnon::FileFormat format = graphAnon::FileFormat::edgeList;
+	value = getCmdOption( argv, argv + argc, "-format", true );
+	if( value && strcmp( value, "adjList" ) == 0 ) { format = graphAnon::FileFormat::adjacencyList; }
+	else if( value && strcmp( value, "binary" ) == 0 ) { format = graphAnon::FileFormat::binary; }
+	else if( value && strcmp( value, "edgeList" ) != 0 ) {
+		std::cerr << std::endl << "\tFormat \"" << value << "\" not supported." << std::endl;
+		return 1;
+	}
+	std::vector< std::pair< std::string, std::string > > workloads;
+	for( std::string const& workload : split( getCmdOption( argv, argv + argc, "-workloads", true ) ) ) {
+		const size_t equals = workload.find( '=' );
+		if( equals == std::string::npos || equals == 0 || equals + 1 == workload.size() ) {
+			std::cerr << std::endl << "\tWorkload \"" << workload << "\" is not of the form name=path."
+				<< std::endl;
+			return 1;
+		}
+		workloads.push_back( std::make_pair( workload.substr( 0, equals ), workload.substr( equals + 1 ) ) );
+	}
+
+	char *output = getCmdOption( argv, argv + argc, "-o", true );
+	graphAnon::ReportFormat report_format = graphAnon::ReportFormat::json;
+	value = getCmdOption( argv, argv + argc, "-report-format", true );
+	if( value == NULL ) {
+		const size_t length = output == NULL ? 0 : strlen( output );
+		if( length >= 4 && strcmp( output + length - 4, ".csv" ) == 0 ) {
+			report_format = graphAnon::ReportFormat::csv;
+		}
+	}
+	else if( strcmp( value, "csv" ) == 0 ) { report_format = graphAnon::ReportFormat::csv; }
+	else if( strcmp( value, "json" ) != 0 ) {
+		std::cerr << std::endl << "\tReport format \"" << value << "\" not supported." << std::endl;
+		return 1;
+	}
+
+	value = getCmdOption( argv, argv + argc, "-tmp", true );
+	std::string directory_template = std::string( value ? value : "/tmp" ) + "/graphAnon_bench_XXXXXX";
+	if( mkdtemp( &directory_template[ 0 ] ) == NULL ) {
+		std::cerr << "Could not create a temporary directory like " << directory_template << std::endl;
+		return 2;
+	}
+	options.directory = directory_template;
+
+	/* Time the synthetic graphs, then the real ones. */
+	std::vector< BenchmarkResult > results;
+	bool staged = true;
+	for( uint64_t const n : sizes ) {
+		if( n == 0 ) { continue; }
+		UnlabelledGraph g( static_cast< uint32_t >( n ) );
+		const uint64_t m = std::min< uint64_t >( degree * n / 2, graphAnon::num_vertex_pairs( n ) );
+		g.populate_uniformly( m, options.seed );
+		std::string const name = "gnm-n" + std::to_string( n ) + "-d" + std::to_string( static_cast< uint32_t >( degree ) );
+		staged = staged && run_workload( name, g, options, &results );
+	}
+	for( auto const& workload : workloads ) {
+		std::unique_ptr< UnlabelledGraph > g;
+		{
+			MuteStdout mute;
+			g.reset( new UnlabelledGraph( workload.second, format ) );
+		}
+		if( g->num_vertices() == 0 ) {
+			std::cerr << "Could not load workload " << workload.first << " from " << workload.second
+				<< std::endl;
+			continue;
+		}
+		staged = staged && run_workload( workload.first, *g, options, &results );
+	}
+	rmdir( options.directory.c_str() );
+
+	graphAnon::compute_speedups( &results );
+	if( output == NULL ) {
+		graphAnon::write_benchmark_results( results, max_threads, &std::cout, report_format );
+		return staged ? 0 : 2;
+	}
+	std::ofstream file( output );
+	graphAnon::write_benchmark_results( results, max_threads, &file, report_format );
+	file.close();
+	if( !file ) {
+		std::cerr << "Could not write the results to " << output << std::endl;
+		return 2;
+	}
+	return staged ? 0 : 2;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief Implementation of the benchmark utilities in benchmark.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cstdio>		/* for FILE, fopen, fputs */
+#include <chrono>		/* for std::chrono::steady_clock */
+#include <algorithm>	/* for std::sort, std::min */
+#include <numeric>		/* for std::accumulate */
+#include <limits>		/* for std::numeric_limits */
+
+/* STL stuff in use. */
+#include <vector>
+#include <map>
+#include <string>
+
+#include "benchmark.h" /* implementing these functions. */
+#include "../unlabelled_graph/profile.h"
+#include "../unlabelled_graph/scratch_arena.h"
+
+namespace
+{
+	/**
+	 * Resets the peak resident set size, so that it can be measured per hot
+	 * path rather than per process (Linux only; elsewhere, a no-op).
+	 */
+	void reset_peak_rss() {
+		FILE *clear_refs = fopen( "/proc/self/clear_refs", "w" );
+		if( clear_refs == NULL ) { return; }
+		fputs( "5", clear_refs );
+		fclose( clear_refs );
+	}
+
+	/**
+	 * Appends the quoted, escaped JSON string s to os.
+	 */
+	void write_string( std::ostream *os, std::string const& s ) {
+		*os << '"';
+		for( char const c : s ) {
+			if( c == '"' || c == '\\' ) { *os << '\\'; }
+			*os << c;
+		}
+		*os << '"';
+	}
+}
+
+namespace graphAnon
+{
+	void time_hot_path( const uint32_t repetitions, std::function< void() > const& setup,
+		std::function< void() > const& run, BenchmarkResult *result ) {
+
+		Profile &profile = Profile::global();
+		result->seconds.clear();
+
+		/* Scratch memory that earlier hot paths left in the arenas would
+		 * otherwise count towards this one's peak. */
+#pragma omp parallel
+		{
+			ScratchArena::local().release();
+		}
+		reset_peak_rss();
+		for( uint32_t i = 0; i < repetitions; ++i ) {
+			setup();
+			profile.reset();
+			profile.enable( true );
+			auto const start = std::chrono::steady_clock::now();
+			run();
+			auto const stop = std::chrono::steady_clock::now();
+			profile.enable( false );
+			result->seconds.push_back( std::chrono::duration< double >( stop - start ).count() );
+		}
+		result->peak_rss_kib = Profile::peak_rss_kib();
+		result->counters.clear();
+		for( uint32_t c = 0; c < static_cast< uint32_t >( ProfileCounter::num_counters ); ++c ) {
+			result->counters.push_back( profile.counter( static_cast< ProfileCounter >( c ) ) );
+		}
+		std::sort( result->seconds.begin(), result->seconds.end() );
+	}
+
+	double percentile( std::vector< double > const& seconds, const double fraction ) {
+		if( seconds.empty() ) { return 0; }
+		const size_t rank = static_cast< size_t >( fraction * ( seconds.size() - 1 ) + 0.5 );
+		return seconds[ std::min( rank, seconds.size() - 1 ) ];
+	}
+
+	void compute_speedups( std::vector< BenchmarkResult > *results ) {
+		std::map< std::pair< std::string, std::string >, double > serial;
+		for( auto const& result : *results ) {
+			if( result.threads == 1 ) {
+				serial[ std::make_pair( result.workload, result.name ) ] = percentile( result.seconds, 0.5 );
+			}
+		}
+		for( auto &result : *results ) {
+			auto const it = serial.find( std::make_pair( result.workload, result.name ) );
+			const double median = percentile( result.seconds, 0.5 );
+			result.speedup = ( it == serial.end() || median <= 0 ) ? 0 : it->second / median;
+		}
+	}
+
+	void write_benchmark_results( std::vector< BenchmarkResult > const& results,
+		const uint32_t max_threads, std::ostream *os, const ReportFormat format ) {
+
+		os->precision( 6 );
+		const char *const stats[] = { "min_s", "median_s", "p90_s", "max_s", "mean_s" };
+		const uint32_t num_counters = static_cast< uint32_t >( ProfileCounter::num_counters );
+		if( format == ReportFormat::csv ) {
+			*os << "workload,vertices,edges,case,threads,repetitions";
+			for( auto const stat : stats ) { *os << "," << stat; }
+			*os << ",speedup,peak_rss_kib";
+			for( uint32_t c = 0; c < num_counters; ++c ) {
+				*os << "," << Profile::counter_name( static_cast< ProfileCounter >( c ) );
+			}
+			*os << std::endl;
+		}
+		else {
+			*os << "{" << std::endl << "\t\"schema\": " << GRAPHANON_BENCH_SCHEMA << ","
+				<< std::endl << "\t\"max_threads\": " << max_threads << "," << std::endl
+				<< "\t\"results\": [";
+		}
+
+		for( size_t r = 0; r < results.size(); ++r ) {
+			BenchmarkResult const& result = results[ r ];
+			std::vector< double > const& seconds = result.seconds;
+			const double values[] = { percentile( seconds, 0 ), percentile( seconds, 0.5 ),
+				percentile( seconds, 0.9 ), percentile( seconds, 1 ),
+				seconds.empty() ? 0 : std::accumulate( seconds.begin(), seconds.end(), 0.0 ) / seconds.size() };
+
+			if( format == ReportFormat::csv ) {
+				*os << result.workload << "," << result.num_vertices << "," << result.num_edges
+					<< "," << result.name << "," << result.threads << "," << seconds.size();
+				for( double const value : values ) { *os << "," << value; }
+				*os << "," << result.speedup << "," << result.peak_rss_kib;
+				for( uint32_t c = 0; c < num_counters; ++c ) {
+					*os << "," << ( c < result.counters.size() ? result.counters[ c ] : 0 );
+				}
+				*os << std::endl;
+				continue;
+			}
+
+			*os << ( r == 0 ? "" : "," ) << std::endl << "\t\t{ \"workload\": ";
+			write_string( os, result.workload );
+			*os << ", \"vertices\": " << result.num_vertices << ", \"edges\": " << result.num_edges
+				<< ", \"case\": ";
+			write_string( os, result.name );
+			*os << ", \"threads\": " << result.threads << ", \"repetitions\": " << seconds.size();
+			for( uint32_t i = 0; i < 5; ++i ) { *os << ", \"" << stats[ i ] << "\": " << values[ i ]; }
+			*os << ", \"speedup\": " << result.speedup << ", \"peak_rss_kib\": " << result.peak_rss_kib
+				<< ", \"counters\": {";
+			for( uint32_t c = 0; c < num_counters; ++c ) {
+				*os << ( c == 0 ? " \"" : ", \"" ) << Profile::counter_name( static_cast< ProfileCounter >( c ) )
+					<< "\": " << ( c < result.counters.size() ? result.counters[ c ] : 0 );
+			}
+			*os << " } }";
+		}
+		if( format == ReportFormat::json ) {
+			*os << std::endl << "\t]" << std::endl << "}" << std::endl;
+		}
+	}
+}
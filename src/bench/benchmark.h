@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief Definition of the timing, memory, and reporting utilities of the
+ * graphAnon_bench harness.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <cstdint>		/* For uint32_t, uint64_t */
+#include <string>		/* For std::string */
+#include <ostream>		/* For std::ostream */
+#include <functional>	/* For std::function */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "../unlabelled_graph/report_format.h"
+
+/**
+ * The version of the graphAnon_bench output schema, which changes only when
+ * a field is renamed, removed, or reinterpreted (so that results from two
+ * releases with the same version can be diffed directly).
+ */
+#define GRAPHANON_BENCH_SCHEMA 2
+
+/**
+ * @brief The timings of one hot path on one workload with one thread count.
+ */
+struct BenchmarkResult {
+	std::string workload; /**< The name of the graph (e.g., "gnm-n1000-d8" or "enron"). */
+	uint32_t num_vertices; /**< |V| of the workload. */
+	uint64_t num_edges; /**< |E| of the workload. */
+	std::string name; /**< The name of the hot path (e.g., "hop_plot"). */
+	uint32_t threads; /**< The number of OpenMP threads. */
+	std::vector< double > seconds; /**< The wall-clock time of each repetition, sorted. */
+	uint64_t peak_rss_kib; /**< The peak resident set size during the repetitions. */
+	std::vector< uint64_t > counters; /**< Each Profile counter's value during the last repetition. */
+	double speedup; /**< The median time with one thread over this one, or 0 if unknown. */
+};
+
+namespace graphAnon
+{
+	/**
+	 * Times a hot path.
+	 * @param repetitions The number of times to run it.
+	 * @param setup Prepares a repetition (e.g., reloads a graph that run
+	 * modifies); it is not timed.
+	 * @param run The hot path itself.
+	 * @param result The result whose seconds, peak_rss_kib, and counters to fill in.
+	 * @post result->seconds holds the sorted time of each repetition.
+	 * @note The global Profile records each repetition (but not its setup).
+	 */
+	void time_hot_path( const uint32_t repetitions, std::function< void() > const& setup,
+		std::function< void() > const& run, BenchmarkResult *result );
+
+	/**
+	 * Computes a percentile of sorted timings by nearest rank.
+	 * @param seconds Sorted timings.
+	 * @param fraction The percentile, from 0 (the minimum) to 1 (the maximum).
+	 */
+	double percentile( std::vector< double > const& seconds, const double fraction );
+
+	/**
+	 * Fills in the speedup of every result over the corresponding one-thread result.
+	 */
+	void compute_speedups( std::vector< BenchmarkResult > *results );
+
+	/**
+	 * Writes benchmark results.
+	 * @param results The results, in the order in which they ran.
+	 * @param max_threads The number of threads available.
+	 * @param os The stream to which to write them.
+	 * @param format Either a JSON object with a "results" array or a CSV
+	 * table with one row per result; both hold the minimum, median, 90th
+	 * percentile, maximum, and mean time in seconds, and the Profile counters.
+	 */
+	void write_benchmark_results( std::vector< BenchmarkResult > const& results,
+		const uint32_t max_threads, std::ostream *os, const ReportFormat format );
+}
+
+#endif /* BENCHMARK_H_ */
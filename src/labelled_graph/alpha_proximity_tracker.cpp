@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @brief Implementation of the AlphaProximityTracker class in alpha_proximity_tracker.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t */
+#include <cstddef>		/* for size_t */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "alpha_proximity_tracker.h" /* implementing this class. */
+
+AlphaProximityTracker::AlphaProximityTracker() : active_( false ), alpha_( 0 ),
+	histograms_( NULL ), max_distance_( 0 ), max_valid_( false ) {}
+
+void AlphaProximityTracker::track( LabelHistograms const& histograms, const float alpha ) {
+
+	const uint32_t n = histograms.num_vertices();
+	histograms_ = &histograms;
+	alpha_ = alpha;
+
+	/* Distances and the violating set. */
+	distances_.resize( n );
+	violating_.clear();
+	violating_pos_.assign( n, n );
+	max_distance_ = 0;
+	for( uint32_t v = 0; v < n; ++v ) {
+		distances_[ v ] = histograms.distance( v );
+		if( distances_[ v ] > max_distance_ ) { max_distance_ = distances_[ v ]; }
+		if( distances_[ v ] > alpha_ ) {
+			violating_pos_[ v ] = violating_.size();
+			violating_.push_back( v );
+		}
+	}
+	max_valid_ = true;
+	active_ = true;
+}
+
+void AlphaProximityTracker::stop() { active_ = false; }
+
+bool AlphaProximityTracker::is_tracking( const float alpha ) const {
+	return active_ && alpha == alpha_;
+}
+
+bool AlphaProximityTracker::is_tracking() const { return active_; }
+
+bool AlphaProximityTracker::is_alpha_proximal() const { return violating_.empty(); }
+
+float AlphaProximityTracker::max_distance() const {
+	if( !max_valid_ ) {
+		max_distance_ = 0;
+		for( float const d : distances_ ) {
+			if( d > max_distance_ ) { max_distance_ = d; }
+		}
+		max_valid_ = true;
+	}
+	return max_distance_;
+}
+
+std::vector< uint32_t > const& AlphaProximityTracker::violating_vertices() const {
+	return violating_;
+}
+
+void AlphaProximityTracker::update( const uint32_t v ) {
+	set_distance( v, histograms_->distance( v ) );
+}
+
+void AlphaProximityTracker::update( std::vector< uint32_t > const& vertices ) {
+
+	/* The O( l ) distance computations are independent, so run them first in
+	 * parallel and only then maintain the shared summaries. */
+	std::vector< float > distances( vertices.size() );
+#pragma omp parallel for schedule( static )
+	for( size_t i = 0; i < vertices.size(); ++i ) {
+		distances[ i ] = histograms_->distance( vertices[ i ] );
+	}
+	for( size_t i = 0; i < vertices.size(); ++i ) { set_distance( vertices[ i ], distances[ i ] ); }
+}
+
+void AlphaProximityTracker::set_distance( const uint32_t v, const float distance ) {
+	const uint32_t n = distances_.size();
+	const float old_distance = distances_[ v ];
+	distances_[ v ] = distance;
+
+	/* Maintain the maximum, invalidating it if the maximal vertex improved. */
+	if( max_valid_ ) {
+		if( distance >= max_distance_ ) { max_distance_ = distance; }
+		else if( old_distance == max_distance_ ) { max_valid_ = false; }
+	}
+
+	/* Maintain the violating set with O( 1 ) swap-and-pop removal. */
+	const bool was_violating = violating_pos_[ v ] != n;
+	const bool is_violating = distance > alpha_;
+	if( is_violating && !was_violating ) {
+		violating_pos_[ v ] = violating_.size();
+		violating_.push_back( v );
+	}
+	else if( was_violating && !is_violating ) {
+		const uint32_t pos = violating_pos_[ v ];
+		const uint32_t last = violating_.back();
+		violating_[ pos ] = last;
+		violating_pos_[ last ] = pos;
+		violating_.pop_back();
+		violating_pos_[ v ] = n;
+	}
+}
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Definition of an incrementally maintained summary of which vertices
+ * of a LabelledGraph violate alpha-proximity.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ALPHA_PROXIMITY_TRACKER_H_
+#define ALPHA_PROXIMITY_TRACKER_H_
+
+#include <cstdint>	/* For uint32_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "label_histograms.h"
+
+/**
+ * @brief Maintains, under edge insertions, the distance of every vertex's
+ * neighbourhood LabelDistribution from the global LabelDistribution, and the
+ * set of vertices for which that distance exceeds alpha.
+ *
+ * The tracker reads the neighbourhood label counts from a LabelHistograms
+ * store. Adding an edge (u,v) changes only the histograms of u and v, so each
+ * insertion costs O( l ) for l labels, after which the graph-wide
+ * alpha-proximity check of Definition 2.6 in @cite asonam is O( 1 ).
+ */
+class AlphaProximityTracker {
+public:
+
+	/**
+	 * Constructs a tracker that is not yet tracking any graph.
+	 */
+	AlphaProximityTracker();
+
+	/**
+	 * Starts (or restarts) tracking a vertex-labelled graph at threshold alpha,
+	 * computing every neighbourhood distance from scratch in O( nl ).
+	 * @param histograms The label histograms of the graph. They must outlive
+	 * the tracking, and update() must be called for every vertex whose
+	 * histogram changes while tracking.
+	 * @param alpha The privacy threshold.
+	 */
+	void track( LabelHistograms const& histograms, const float alpha );
+
+	/**
+	 * Stops tracking, so that edge insertions are no longer recorded.
+	 */
+	void stop();
+
+	/**
+	 * Determines whether the tracker is up to date and tracking threshold alpha.
+	 */
+	bool is_tracking( const float alpha ) const;
+
+	/**
+	 * Determines whether the tracker is up to date for some threshold.
+	 */
+	bool is_tracking() const;
+
+	/**
+	 * Refreshes the cached distance and violating-set membership of vertex v
+	 * in O( l ) after its label histogram has changed.
+	 */
+	void update( const uint32_t v );
+
+	/**
+	 * Refreshes every vertex in vertices (which may contain repeats) after
+	 * their label histograms have changed, computing the new distances with
+	 * every OpenMP thread.
+	 */
+	void update( std::vector< uint32_t > const& vertices );
+
+	/**
+	 * Determines in O( 1 ) whether the tracked graph is alpha-proximal at the
+	 * tracked threshold.
+	 */
+	bool is_alpha_proximal() const;
+
+	/**
+	 * Retrieves the largest distance of any neighbourhood LabelDistribution
+	 * from the global LabelDistribution.
+	 * @note Amortised O( 1 ): the maximum is maintained under increases and
+	 * only recomputed (in O( n )) after the maximal vertex's distance falls.
+	 */
+	float max_distance() const;
+
+	/**
+	 * Retrieves the vertices whose neighbourhoods are currently further than
+	 * alpha from the global LabelDistribution, in no particular order.
+	 */
+	std::vector< uint32_t > const& violating_vertices() const;
+
+private:
+
+	/**
+	 * Records that the distance of vertex v is now distance, maintaining the
+	 * maximum and the violating set.
+	 */
+	void set_distance( const uint32_t v, const float distance );
+
+	bool active_; /**< Whether the tracker is up to date with a graph. */
+	float alpha_; /**< The tracked privacy threshold. */
+	LabelHistograms const *histograms_; /**< The tracked label histograms. */
+
+	std::vector< float > distances_; /**< The cached distance of each vertex. */
+	std::vector< uint32_t > violating_; /**< Vertices whose distance exceeds alpha_. */
+	std::vector< uint32_t > violating_pos_; /**< Index of each vertex in violating_, or n. */
+
+	mutable float max_distance_; /**< The largest cached distance, if max_valid_. */
+	mutable bool max_valid_; /**< Whether max_distance_ is up to date. */
+};
+
+#endif /* ALPHA_PROXIMITY_TRACKER_H_ */
@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Implementation of unit tests for the AlphaProximityTracker class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <cstdlib> /* for rand */
+#include <vector>
+
+#include "alpha_proximity_tracker.test.h"
+#include "alpha_proximity_tracker.h"
+#include "label_histograms.h"
+
+namespace
+{
+	/**
+	 * Computes from scratch, one label at a time, the distance of v's closed
+	 * neighbourhood from the global label distribution.
+	 */
+	float brute_force_distance( AdjacencyList const& adjacency_list,
+		std::vector< uint32_t > const& labels, const uint32_t l, const uint32_t v ) {
+
+		std::vector< uint32_t > global_counts( l, 0 ), counts( l, 0 );
+		for( uint32_t const label : labels ) { ++global_counts[ label ]; }
+		++counts[ labels[ v ] ];
+		for( uint32_t const u : adjacency_list[ v ] ) { ++counts[ labels[ u ] ]; }
+
+		float distance = 0;
+		for( uint32_t i = 0; i + 1 < l; ++i ) {
+			const float label_distance = global_counts[ i ] / (float) labels.size()
+				- counts[ i ] / (float) ( adjacency_list[ v ].size() + 1 );
+			distance += label_distance > 0 ? label_distance: -1 * label_distance;
+		}
+		return distance;
+	}
+}
+
+bool test_alpha_proximity_tracker() {
+
+	bool passed = true;
+
+	/**
+	 * @test Random edge insertions
+	 * After every insertion into a random labelled graph, the histogram
+	 * distances, the tracker's violating set and its proximity verdict should
+	 * agree exactly with a full recomputation of every neighbourhood
+	 * distribution (including for alphabets that span several kernel blocks).
+	 */
+	for( uint32_t const l : { 2u, 3u, 7u, 40u } ) {
+		const uint32_t n = 60;
+		const float alpha = 0.25;
+		AdjacencyList adjacency_list( n );
+		std::vector< uint32_t > labels( n );
+		for( uint32_t v = 0; v < n; ++v ) { labels[ v ] = rand() % l; }
+
+		LabelHistograms histograms;
+		histograms.build( adjacency_list, labels, l );
+		AlphaProximityTracker tracker;
+		tracker.track( histograms, alpha );
+
+		for( uint32_t step = 0; step < 600; ++step ) {
+			const uint32_t u = rand() % n, v = rand() % n;
+			if( u != v && adjacency_list[ u ].count( v ) == 0 ) {
+				adjacency_list[ u ].insert( v );
+				adjacency_list[ v ].insert( u );
+				histograms.add_edge( u, labels[ u ], v, labels[ v ] );
+				tracker.update( u );
+				tracker.update( v );
+			}
+
+			float max_distance = 0;
+			uint32_t num_violating = 0;
+			std::vector< bool > violating( n, false );
+			for( uint32_t const w : tracker.violating_vertices() ) { violating[ w ] = true; }
+			for( uint32_t w = 0; w < n; ++w ) {
+				const float distance = brute_force_distance( adjacency_list, labels, l, w );
+				if( histograms.distance( w ) != distance ) { passed = false; }
+				if( distance > max_distance ) { max_distance = distance; }
+				if( distance > alpha ) {
+					++num_violating;
+					if( !violating[ w ] ) { passed = false; }
+				}
+			}
+			if( num_violating != tracker.violating_vertices().size() ) { passed = false; }
+			if( tracker.max_distance() != max_distance ) { passed = false; }
+			if( tracker.is_alpha_proximal() != ( max_distance <= alpha ) ) { passed = false; }
+		}
+	}
+
+	return passed;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Definition of dynamically sized bitsets of deficient labels, for
+ * label alphabets of any size.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DEFICIENCY_SET_H_
+#define DEFICIENCY_SET_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For size_t */
+
+/* STL libraries in use */
+#include <vector>
+
+/**
+ * @brief A non-owning view of a bitset over the label alphabet, in which bit i
+ * is set if the corresponding vertex is deficient in label i.
+ *
+ * The bits are packed into 64-bit words, so counting and iterating the set
+ * bits costs O( l / 64 ) popcount and find-first-set instructions rather
+ * than one test per label.
+ */
+class DeficiencySet {
+public:
+
+	/**
+	 * Constructs a view over num_words words at the address words.
+	 */
+	DeficiencySet( uint64_t *words, const uint32_t num_words )
+		: words_( words ), num_words_( num_words ) {}
+
+	/** Adds label i to the set. */
+	void set( const uint32_t i ) { words_[ i / 64 ] |= 1ull << ( i % 64 ); }
+
+	/** Removes label i from the set. */
+	void reset( const uint32_t i ) { words_[ i / 64 ] &= ~( 1ull << ( i % 64 ) ); }
+
+	/** Determines whether label i is in the set. */
+	bool test( const uint32_t i ) const { return ( words_[ i / 64 ] >> ( i % 64 ) ) & 1; }
+
+	/** Removes every label from the set. */
+	void clear() { for( uint32_t w = 0; w < num_words_; ++w ) { words_[ w ] = 0; } }
+
+	/** Determines whether the set contains no labels. */
+	bool empty() const {
+		uint64_t any = 0;
+		for( uint32_t w = 0; w < num_words_; ++w ) { any |= words_[ w ]; }
+		return any == 0;
+	}
+
+	/** Retrieves the number of labels in the set. */
+	uint32_t count() const {
+		uint32_t count = 0;
+		for( uint32_t w = 0; w < num_words_; ++w ) { count += __builtin_popcountll( words_[ w ] ); }
+		return count;
+	}
+
+	/**
+	 * Retrieves the smallest label in the set that is at least i.
+	 * @return The label, or npos() if there is none.
+	 */
+	uint32_t find_next( const uint32_t i ) const {
+		uint32_t w = i / 64;
+		if( w >= num_words_ ) { return npos(); }
+		uint64_t word = words_[ w ] & ( ~0ull << ( i % 64 ) );
+		while( word == 0 ) {
+			if( ++w == num_words_ ) { return npos(); }
+			word = words_[ w ];
+		}
+		return w * 64 + __builtin_ctzll( word );
+	}
+
+	/**
+	 * Retrieves the smallest label in the set.
+	 * @return The label, or npos() if the set is empty.
+	 */
+	uint32_t find_first() const { return find_next( 0 ); }
+
+	/**
+	 * The sentinel returned by find_first() and find_next() when no label remains.
+	 */
+	static constexpr uint32_t npos() { return ~0u; }
+
+	/**
+	 * The number of 64-bit words needed for a set over num_labels labels.
+	 */
+	static constexpr uint32_t words_for( const uint32_t num_labels ) {
+		return ( num_labels + 63 ) / 64;
+	}
+
+private:
+	uint64_t *words_; /**< The packed bits, 64 labels per word. */
+	uint32_t num_words_; /**< The number of words in the set. */
+};
+
+/**
+ * @brief An owning, contiguous collection of equally sized DeficiencySets,
+ * one per row, so that a pass over many vertices performs one allocation.
+ */
+class DeficiencySets {
+public:
+
+	/**
+	 * Constructs an empty collection of sets over num_labels labels.
+	 */
+	explicit DeficiencySets( const uint32_t num_labels = 0 )
+		: num_words_( DeficiencySet::words_for( num_labels ) ) {}
+
+	/** Retrieves the number of rows in the collection. */
+	size_t size() const { return num_words_ == 0 ? 0 : words_.size() / num_words_; }
+
+	/**
+	 * Resizes the collection to num_rows rows, any new ones of which are empty.
+	 * @warning Invalidates views of existing rows.
+	 */
+	void resize( const size_t num_rows ) { words_.resize( num_rows * num_words_, 0 ); }
+
+	/** Removes every row, retaining the allocated capacity. */
+	void clear() { words_.clear(); }
+
+	/**
+	 * Appends a new, empty row and returns a view of it.
+	 * @warning Invalidates views of earlier rows.
+	 */
+	DeficiencySet push_back() {
+		words_.resize( words_.size() + num_words_, 0 );
+		return row( size() - 1 );
+	}
+
+	/** Removes the last row. */
+	void pop_back() { words_.resize( words_.size() - num_words_ ); }
+
+	/** Retrieves a view of row r. */
+	DeficiencySet row( const size_t r ) {
+		return DeficiencySet( words_.data() + r * num_words_, num_words_ );
+	}
+
+private:
+	uint32_t num_words_; /**< The number of words in each row. */
+	std::vector< uint64_t > words_; /**< All rows, back to back. */
+};
+
+#endif /* DEFICIENCY_SET_H_ */
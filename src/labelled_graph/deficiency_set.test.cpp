@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Implementation of unit tests for the DeficiencySet class and the
+ * label_deficiencies() kernel.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for rand */
+#include <vector>
+
+#include "deficiency_set.test.h"
+#include "deficiency_set.h"
+#include "label_histograms.h"
+
+bool test_deficiency_set() {
+
+	bool passed = true;
+
+	/**
+	 * @test Iteration across word boundaries
+	 * Labels on either side of each 64-bit word boundary should be found in
+	 * ascending order, counted, and removed individually.
+	 */
+	const uint32_t num_labels = 200;
+	std::vector< uint64_t > words( DeficiencySet::words_for( num_labels ), 0 );
+	DeficiencySet set( words.data(), words.size() );
+	std::vector< uint32_t > const expected { 0, 63, 64, 127, 128, 199 };
+	for( uint32_t const i : expected ) { set.set( i ); }
+	std::vector< uint32_t > found;
+	for( uint32_t i = set.find_first(); i != DeficiencySet::npos(); i = set.find_next( i + 1 ) ) {
+		found.push_back( i );
+	}
+	if( found != expected || set.count() != expected.size() ) { passed = false; }
+	set.reset( 64 );
+	if( set.test( 64 ) || !set.test( 63 ) || set.find_next( 64 ) != 127 ) { passed = false; }
+	set.clear();
+	if( !set.empty() || set.find_first() != DeficiencySet::npos() ) { passed = false; }
+
+	/**
+	 * @test Deficiencies beyond 32 labels
+	 * For random histograms over num_labels labels, label_deficiencies()
+	 * should report exactly the labels whose relative frequency falls short of
+	 * the reference, unless the histograms are within alpha of each other.
+	 */
+	for( uint32_t trial = 0; trial < 50; ++trial ) {
+		std::vector< uint32_t > counts( num_labels ), reference( num_labels );
+		uint32_t sum = 0, reference_sum = 0;
+		for( uint32_t i = 0; i < num_labels; ++i ) {
+			counts[ i ] = rand() % 5;
+			reference[ i ] = rand() % 5;
+			sum += counts[ i ];
+			reference_sum += reference[ i ];
+		}
+
+		float difference = 0;
+		std::vector< bool > deficient( num_labels );
+		for( uint32_t i = 0; i < num_labels; ++i ) {
+			const float diff = reference[ i ] / (float) reference_sum - counts[ i ] / (float) sum;
+			deficient[ i ] = diff > 0;
+			difference += diff > 0 ? diff : -1 * diff;
+		}
+		const float alpha = trial % 2 == 0 ? 0.01 : difference + 1;
+
+		set.clear();
+		const bool any = label_deficiencies( counts.data(), sum, reference.data(),
+			reference_sum, num_labels, alpha, &set );
+		if( any != ( difference >= alpha ) ) { passed = false; }
+		for( uint32_t i = 0; i < num_labels; ++i ) {
+			if( set.test( i ) != ( any && deficient[ i ] ) ) { passed = false; }
+		}
+	}
+
+	return passed;
+}
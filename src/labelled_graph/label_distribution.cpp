@@ -32,8 +32,13 @@
 
 #include <cstdint>	/* for uint32_t */
 #include <iostream>	/* for cout, endl */
+#include <algorithm>	/* for std::max */
+
+/* STL stuff in use. */
+#include <vector>
 
 #include "label_distribution.h"
+#include "label_histograms.h"
 
 LabelDistribution::LabelDistribution( const uint32_t n ) {
 	for( uint32_t i = 0; i < n; ++i ) {
@@ -60,46 +65,22 @@ float LabelDistribution::get_frequency( const uint32_t pos ) {
 uint32_t LabelDistribution::get_length( ) { return frequencies_.size(); }
 
 float LabelDistribution::distance( LabelDistribution *another ) {
-	float distance = 0;
 
 	/* Error checking. */
 	const uint32_t my_length = frequencies_.size();
 	if( my_length != another->get_length() ) { return LD_INCOMPARABLE; }
 
-	/* Pairwise comparison of values. */
-	for( uint32_t i = 0; i < my_length - 1; ++i ) {
-		const float label_distance = get_frequency( i ) - another->get_frequency( i );
-		distance += label_distance > 0 ? label_distance: -1 * label_distance; /* take absolute value. */
-	}
-	return distance;
+	return label_distance( frequencies_.data(), sum_,
+		another->frequencies_.data(), another->sum_, my_length );
 }
 
 uint32_t LabelDistribution::get_deficiencies( LabelDistribution *another, const float alpha ) {
-
-	/* cur_bit tracks the current bit of the bitmask (shifting left once
-	 * for each label/iteration. i keeps track of which label is currently
-	 * begin processed, and controls the number of iterations of the loop.
-	 */
-	uint32_t deficiencies = 0;
-	float difference = 0;
-
-	/* Iterate the set of labels, detecting deficiencies and scoring alpha-proximity */
 	const uint32_t num_labels = frequencies_.size();
-	for( uint32_t i = 0, cur_bit = 1; i < num_labels; ++i ) {
-
-		float pairwise_diff = another->get_frequency( i ) - get_frequency( i );
-		if( pairwise_diff > 0 ) {
-			/* the other has more, set bit and add to difference */
-			deficiencies |= cur_bit;
-			difference += pairwise_diff;
-		}
-		else { difference -= pairwise_diff; } /* invert sign for absolute value difference */
-
-		cur_bit *= 2; /* shift current working bit in bitmask */
-	}
-
-	if( difference < alpha ) return 0; /* alpha-proximal */
-	else return deficiencies;
+	std::vector< uint64_t > words( std::max( 1u, DeficiencySet::words_for( num_labels ) ), 0 );
+	DeficiencySet deficiencies( words.data(), words.size() );
+	label_deficiencies( frequencies_.data(), sum_,
+		another->frequencies_.data(), another->sum_, num_labels, alpha, &deficiencies );
+	return static_cast< uint32_t >( words[ 0 ] );
 }
 
 void LabelDistribution::print() {
@@ -108,9 +108,9 @@ public:
 	 * (counting from the rightmost, least significant bit)
 	 * is set in the bitmask, then another has a higher relative frequency
 	 * of the i'th label than does this LabelDistribution.
-	 * @warning Assumes the alphabet size for the set of labels is <= 32,
-	 * because the bitmask returned is a 32-bit unsigned integer. For larger
-	 * alphabets, a new implementation is needed.
+	 * @warning Only reports the first 32 labels, because the bitmask returned
+	 * is a 32-bit unsigned integer. For larger alphabets, use
+	 * label_deficiencies() with a DeficiencySet instead.
 	 * @warning Behaviour is undefined if this LabelDistribution and another
 	 * have different lengths
 	 */
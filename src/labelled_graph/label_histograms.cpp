@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief Implementation of the LabelHistograms class and the histogram
+ * kernels in label_histograms.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t */
+#include <cstddef>		/* for size_t */
+#include <algorithm>	/* for std::min */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "label_histograms.h" /* implementing this class. */
+
+namespace
+{
+	/**
+	 * The number of labels whose relative frequencies are computed together
+	 * (with vector instructions) before being accumulated in order.
+	 */
+	const uint32_t block_size = 16;
+
+	/**
+	 * Writes the relative frequency differences reference - counts for labels
+	 * [ first, first + length ) into diff.
+	 */
+	inline void frequency_differences( uint32_t const *counts, const uint32_t sum,
+		uint32_t const *reference_counts, const uint32_t reference_sum,
+		const uint32_t first, const uint32_t length, float *diff ) {
+
+		/* A histogram with no mass has every relative frequency equal to 0,
+		 * as in LabelDistribution::get_frequency(). */
+		const float fsum = static_cast< float >( sum );
+		const float freference_sum = static_cast< float >( reference_sum );
+		if( sum == 0 && reference_sum == 0 ) {
+			for( uint32_t i = 0; i < length; ++i ) { diff[ i ] = 0; }
+		}
+		else if( sum == 0 ) {
+#pragma omp simd
+			for( uint32_t i = 0; i < length; ++i ) {
+				diff[ i ] = reference_counts[ first + i ] / freference_sum;
+			}
+		}
+		else if( reference_sum == 0 ) {
+#pragma omp simd
+			for( uint32_t i = 0; i < length; ++i ) {
+				diff[ i ] = 0 - counts[ first + i ] / fsum;
+			}
+		}
+		else {
+#pragma omp simd
+			for( uint32_t i = 0; i < length; ++i ) {
+				diff[ i ] = reference_counts[ first + i ] / freference_sum
+					- counts[ first + i ] / fsum;
+			}
+		}
+	}
+}
+
+float label_distance( uint32_t const *counts, const uint32_t sum,
+	uint32_t const *other_counts, const uint32_t other_sum, const uint32_t num_labels ) {
+
+	float distance = 0;
+	float diff[ block_size ];
+
+	/* Only the first num_labels - 1 labels are compared: the last is implied. */
+	const uint32_t length = num_labels > 0 ? num_labels - 1 : 0;
+	for( uint32_t first = 0; first < length; first += block_size ) {
+		const uint32_t block = std::min( block_size, length - first );
+		frequency_differences( other_counts, other_sum, counts, sum, first, block, diff );
+		for( uint32_t i = 0; i < block; ++i ) {
+			distance += diff[ i ] > 0 ? diff[ i ] : -1 * diff[ i ];
+		}
+	}
+	return distance;
+}
+
+bool label_deficiencies( uint32_t const *counts, const uint32_t sum,
+	uint32_t const *reference_counts, const uint32_t reference_sum,
+	const uint32_t num_labels, const float alpha, DeficiencySet *deficiencies ) {
+
+	float difference = 0;
+	float diff[ block_size ];
+
+	for( uint32_t first = 0; first < num_labels; first += block_size ) {
+		const uint32_t block = std::min( block_size, num_labels - first );
+		frequency_differences( counts, sum, reference_counts, reference_sum, first, block, diff );
+		for( uint32_t i = 0; i < block; ++i ) {
+			if( diff[ i ] > 0 ) {
+				/* the reference has more, set bit and add to difference */
+				deficiencies->set( first + i );
+				difference += diff[ i ];
+			}
+			else { difference -= diff[ i ]; }
+		}
+	}
+
+	if( difference < alpha ) { /* alpha-proximal */
+		deficiencies->clear();
+		return false;
+	}
+	return true;
+}
+
+LabelHistograms::LabelHistograms() : l_( 0 ), global_sum_( 0 ) {}
+
+void LabelHistograms::build( AdjacencyList const& adjacency_list,
+	std::vector< uint32_t > const& vertex_labels, const uint32_t num_labels ) {
+
+	const uint32_t n = vertex_labels.size();
+	l_ = num_labels;
+
+	/* Global label counts. */
+	global_counts_.assign( l_, 0 );
+	for( uint32_t const label : vertex_labels ) { ++global_counts_[ label ]; }
+	global_sum_ = n;
+
+	/* Closed-neighbourhood label counts: each vertex counts itself too. */
+	counts_.assign( static_cast< size_t >( n ) * l_, 0 );
+	sums_.resize( n );
+	for( uint32_t v = 0; v < n; ++v ) {
+		uint32_t *counts = counts_.data() + static_cast< size_t >( v ) * l_;
+		++counts[ vertex_labels[ v ] ];
+		for( uint32_t const u : adjacency_list[ v ] ) { ++counts[ vertex_labels[ u ] ]; }
+		sums_[ v ] = adjacency_list[ v ].size() + 1;
+	}
+}
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @brief Definition of a flat store of the neighbourhood label histograms of
+ * every vertex in a LabelledGraph, and of the kernels that compare them.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LABEL_HISTOGRAMS_H_
+#define LABEL_HISTOGRAMS_H_
+
+#include <cstdint>	/* For uint32_t */
+#include <cstddef>	/* For size_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "../unlabelled_graph/unlabelled_graph.h"
+#include "deficiency_set.h"
+
+/**
+ * Calculates the distance between two label histograms (Definition 2.4 in
+ * @cite asonam ), i.e., the sum of the absolute differences in relative
+ * frequency over the first num_labels - 1 labels.
+ * @param counts The label counts of the first histogram.
+ * @param sum The sum of counts.
+ * @param other_counts The label counts of the second histogram.
+ * @param other_sum The sum of other_counts.
+ * @param num_labels The length of both histograms.
+ * @note Produces bit-for-bit the same result as LabelDistribution::distance():
+ * the relative frequencies are computed with vector instructions, but the
+ * absolute differences are accumulated in label order.
+ */
+float label_distance( uint32_t const *counts, const uint32_t sum,
+	uint32_t const *other_counts, const uint32_t other_sum, const uint32_t num_labels );
+
+/**
+ * Determines the labels in which one histogram is deficient relative to a
+ * reference histogram, with the semantics of
+ * LabelDistribution::get_deficiencies() but for any number of labels.
+ * @param counts The label counts of the (typically neighbourhood) histogram.
+ * @param sum The sum of counts.
+ * @param reference_counts The label counts of the reference (typically global)
+ * histogram.
+ * @param reference_sum The sum of reference_counts.
+ * @param num_labels The length of both histograms.
+ * @param alpha The privacy threshold.
+ * @param deficiencies A set over at least num_labels labels, into which label
+ * i is added if the reference has a higher relative frequency of label i.
+ * @return False, with deficiencies left empty, if the histograms are already
+ * within alpha of each other; otherwise true.
+ */
+bool label_deficiencies( uint32_t const *counts, const uint32_t sum,
+	uint32_t const *reference_counts, const uint32_t reference_sum,
+	const uint32_t num_labels, const float alpha, DeficiencySet *deficiencies );
+
+/**
+ * @brief The closed-neighbourhood label histogram of every vertex, stored as
+ * one contiguous n x l count matrix plus a vector of row sums, together with
+ * the global label histogram.
+ *
+ * Row v counts the labels in v's closed neighbourhood (v and its neighbours),
+ * which is the neighbourhood LabelDistribution of Definition 2.5 in
+ * @cite asonam . The store is built once and then updated in O( 1 ) per edge
+ * insertion, so that the attribute disclosure algorithms never allocate a
+ * distribution per vertex.
+ */
+class LabelHistograms {
+public:
+
+	/**
+	 * Constructs an empty store with no vertices.
+	 */
+	LabelHistograms();
+
+	/**
+	 * (Re)builds every histogram from scratch in O( m + nl ).
+	 * @param adjacency_list The adjacency list of the graph.
+	 * @param vertex_labels The label of each vertex, each less than num_labels.
+	 * @param num_labels The size of the label alphabet.
+	 */
+	void build( AdjacencyList const& adjacency_list,
+		std::vector< uint32_t > const& vertex_labels, const uint32_t num_labels );
+
+	/**
+	 * Records the insertion of the new undirected edge (u,v) between vertices
+	 * with labels u_label and v_label.
+	 */
+	void add_edge( const uint32_t u, const uint32_t u_label,
+		const uint32_t v, const uint32_t v_label ) {
+		++counts_[ static_cast< size_t >( u ) * l_ + v_label ];
+		++sums_[ u ];
+		++counts_[ static_cast< size_t >( v ) * l_ + u_label ];
+		++sums_[ v ];
+	}
+
+	/**
+	 * Records that vertex u has a new neighbour with label v_label, which
+	 * is half of the insertion of an edge and only modifies u's histogram.
+	 */
+	void add_neighbour( const uint32_t u, const uint32_t v_label ) {
+		++counts_[ static_cast< size_t >( u ) * l_ + v_label ];
+		++sums_[ u ];
+	}
+
+	/**
+	 * Accessor method to retrieve the number of vertices with histograms.
+	 */
+	uint32_t num_vertices() const { return static_cast< uint32_t >( sums_.size() ); }
+
+	/**
+	 * Accessor method to retrieve the length of each histogram.
+	 */
+	uint32_t num_labels() const { return l_; }
+
+	/**
+	 * Retrieves the l label counts in the closed neighbourhood of vertex v.
+	 */
+	uint32_t const* row( const uint32_t v ) const {
+		return counts_.data() + static_cast< size_t >( v ) * l_;
+	}
+
+	/**
+	 * Retrieves the size of the closed neighbourhood of vertex v.
+	 */
+	uint32_t sum( const uint32_t v ) const { return sums_[ v ]; }
+
+	/**
+	 * Retrieves the l label counts over the whole graph.
+	 */
+	uint32_t const* global_row() const { return global_counts_.data(); }
+
+	/**
+	 * Retrieves the number of labelled vertices in the whole graph.
+	 */
+	uint32_t global_sum() const { return global_sum_; }
+
+	/**
+	 * Calculates the distance of vertex v's neighbourhood histogram from the
+	 * global histogram.
+	 * @see label_distance()
+	 */
+	float distance( const uint32_t v ) const {
+		return label_distance( global_row(), global_sum_, row( v ), sums_[ v ], l_ );
+	}
+
+	/**
+	 * Determines the labels in which vertex v's neighbourhood is deficient
+	 * relative to the global histogram.
+	 * @see label_deficiencies()
+	 */
+	bool deficiencies( const uint32_t v, const float alpha, DeficiencySet *deficiencies ) const {
+		return label_deficiencies( row( v ), sums_[ v ], global_row(), global_sum_,
+			l_, alpha, deficiencies );
+	}
+
+private:
+
+	uint32_t l_; /**< The size of the label alphabet. */
+	std::vector< uint32_t > counts_; /**< Row-major n x l neighbourhood label counts. */
+	std::vector< uint32_t > sums_; /**< The size of each closed neighbourhood. */
+	std::vector< uint32_t > global_counts_; /**< The frequency of each label in the graph. */
+	uint32_t global_sum_; /**< The number of labelled vertices. */
+};
+
+#endif /* LABEL_HISTOGRAMS_H_ */
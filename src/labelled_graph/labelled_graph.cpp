@@ -31,93 +31,112 @@
  */
 
 #include <cstdint>		/* for uint32_t */
-#include <algorithm>	/* for random_shuffle */
-#include <iostream>		/* for cout, endl */
-#include <cstdlib>		/* for srand, rand */
-#include <cstring>		/* for ffs and std::string */
-#include <fstream>		/* for ifstream, infile */
-#include <sstream>		/* for istringstream, getline */
+#include <algorithm>	/* for random_shuffle, sort, unique, lower_bound, min, max */
+#include <functional>	/* for std::greater */
+#include <cassert>
+#include <cstdlib>		/* for rand */
+#include <cstring>		/* for std::string */
+#include <fstream>		/* for ofstream */
 
 /* STL stuff in use. */
 #include <vector>
 #include <unordered_set>
+#include <utility>
 
 #include "labelled_graph.h" /* implementing this class. */
+#include "../unlabelled_graph/graph_loader.h"
+#include "../unlabelled_graph/concurrent_adjacency_builder.h"
+#include "../unlabelled_graph/scratch_arena.h"
 
 void LabelledGraph::init() {
 	/* Initialize adjacency list with n_ empty vectors and every vertex
 	 * to have the same label. */
-	adjacency_list_.reserve( n_ );
-	for( uint32_t i = 0; i < n_ ; ++i ) {
-		adjacency_list_.push_back( std::unordered_set< uint32_t >() );
-		vertex_labels_.push_back ( 0 );
-	}
+	adjacency_list_ = AdjacencyList( n_ );
+	vertex_labels_.assign( n_, 0 );
+	histograms_current_ = false;
+	proximity_.stop();
 
 	/* Originally, there are no edges yet (every vertex is  isolated). */
 	m_ = 0;
-
-	/* initialize random seed for generating random edges later */
-	srand (time(NULL));
+	degree_histogram_.reset( n_ );
 }
 
 LabelledGraph::LabelledGraph( const uint32_t num_vertices, const uint32_t num_labels ) :
-	UnlabelledGraph( num_vertices ), l_ ( num_labels ) { init(); }
-
-LabelledGraph::LabelledGraph( const std::string filename ) {
-	std::string line;
-	std::cout << filename << std::endl;
-	std::ifstream infile( filename );
-
-	/* first parse the graph and label alphabet sizes from
-	 * the first line of the file
-	 */
-	std::getline( infile, line );
-	std::istringstream iss( line );
-	iss >> n_ >> l_;
-
-	/* check whether n_ was at least read correctly -- the only real
-	 * error checking done in this constructor.
-	 */
-	if( n_ <= 0 ) {
-		std::cerr << "Did not parse a positive number of vertices from input file. "
-				<< "Did you format the file correctly and specify the correct path?"
-				<< std::endl;
+	UnlabelledGraph( num_vertices ), l_ ( num_labels ), histograms_current_( false ) { init(); }
+
+LabelledGraph::LabelledGraph( LabelledGraph const& other ) : UnlabelledGraph( other ),
+	vertex_labels_( other.vertex_labels_ ), l_( other.l_ ), histograms_( other.histograms_ ),
+	histograms_current_( other.histograms_current_ ) {}
+
+LabelledGraph::LabelledGraph( const std::string filename, const graphAnon::FileFormat format )
+	: histograms_current_( false ) {
+	GRAPHANON_PROFILE_PHASE( "load" );
+
+	/* Parse the whole file in bulk. The only real error checking done in
+	 * this constructor is whether a positive number of vertices was read,
+	 * which the caller can check with num_vertices(). */
+	GraphLoader loader( filename );
+	bool loaded;
+	{
+		GRAPHANON_PROFILE_PHASE( "parse" );
+		loaded = loader.load( format );
+	}
+	if( !loaded ) {
+		l_ = 0;
+		init();
 		return;
 	}
 
 	/* Init like other constructors now that the data structure sizes
-	 * are known.
-	 */
+	 * are known, and then adopt the parsed labels and edges. */
+	n_ = loader.num_vertices();
+	l_ = loader.num_labels();
 	init();
-
-	/* Iterate exactly enough times to fill the data structures,
-	 * irrespective of the length of the file. Each iteration handles
-	 * one vertex, and the file is assumed to be sorted by increasing vertex
-	 * id, with all vertex ids represented as integers in a contiguous sequence
-	 * starting from 0.
-	 */
-	for( uint32_t u = 0; u < n_; ++u ) {
-
-		/* grab line related to vertex u. */
-		std::getline( infile, line );
-		std::istringstream iss( line );
-
-		/* set label to be first character */
-		iss >> vertex_labels_[ u ];
-
-		/* all other numbers on the adjacency list line
-		 * neighbours of u: add them to u's adjacency list.
-		 * Note: undirected graph, so also reciprocally adds
-		 * (v, u), even if that isn't in the input file
-		 */
-		uint32_t v;
-		while( iss >> v ) { add_edge( u, v ); }
+	if( loader.vertex_labels().size() == n_ ) {
+		vertex_labels_ = std::move( loader.vertex_labels() );
+	}
+	else {
+		/* A binary file written from an UnlabelledGraph: give every vertex label 0. */
+		l_ = std::max( l_, 1u );
 	}
+	assign_csr( std::move( loader.csr() ) );
 }
 
 LabelledGraph::~LabelledGraph() {}
 
+std::vector< uint32_t > const* LabelledGraph::output_labels() const { return &vertex_labels_; }
+
+uint32_t LabelledGraph::output_num_labels() const { return l_; }
+
+bool LabelledGraph::add_edge( const uint32_t u, const uint32_t v ) {
+	if( !UnlabelledGraph::add_edge( u, v ) ) { return false; }
+	if( histograms_current_ ) {
+		histograms_.add_edge( u, vertex_labels_[ u ], v, vertex_labels_[ v ] );
+		if( proximity_.is_tracking() ) {
+			proximity_.update( u );
+			proximity_.update( v );
+		}
+	}
+	return true;
+}
+
+void LabelledGraph::assign_csr( CsrGraph &&g ) {
+	UnlabelledGraph::assign_csr( std::move( g ) );
+	histograms_current_ = false;
+	proximity_.stop();
+}
+
+void LabelledGraph::permute_vertex_data( std::vector< uint32_t > const& new_id ) {
+	std::vector< uint32_t > labels( n_ );
+	for( uint32_t v = 0; v < n_; ++v ) { labels[ new_id[ v ] ] = vertex_labels_[ v ]; }
+	vertex_labels_ = std::move( labels );
+}
+
 void LabelledGraph::evenly_distribute_labels() {
+	/* Relabelling invalidates every label histogram. */
+	histograms_current_ = false;
+	proximity_.stop();
+
 	const uint32_t vertices_per_label = n_ / l_;
 	uint32_t labels_left = n_ - vertices_per_label;
 
@@ -157,75 +176,70 @@ void LabelledGraph::evenly_distribute_labels() {
 }
 
 void LabelledGraph::print( std::ofstream *outstream ) {
-	(*outstream) << n_ << " " << l_ << std::endl;
-	for( uint32_t i = 0; i < n_; ++i ) {
-		(*outstream) << vertex_labels_[ i ] << " ";
-		for( auto it = adjacency_list_[i].begin(); it != adjacency_list_[i].end(); ++it ) {
-			(*outstream) << *it << " ";
-		}
-		(*outstream) << std::endl;
-	}
+	GraphWriter writer( outstream );
+	write_text( &writer, graphAnon::FileFormat::adjacencyListVertexLabelled );
 }
 
-void inline LabelledGraph::get_global_ld( LabelDistribution **ld ) {
-
-	/* Initialize an empty solution. */
-	std::vector< uint32_t > counts;
-	for( uint32_t i = 0; i < l_; ++i ) { counts.push_back( 0 ); }
-
-	/* Iterate vertices, incrementing the relative label frequency
-	 * counts for each one.
-	 */
-	for( auto it = vertex_labels_.begin(); it != vertex_labels_.end(); ++it ) {
-		++counts[ *it ];
+void LabelledGraph::format_header( const graphAnon::FileFormat format, std::string *buffer ) const {
+	if( format != graphAnon::FileFormat::adjacencyListVertexLabelled ) {
+		UnlabelledGraph::format_header( format, buffer );
+		return;
 	}
-
-	/* Create new LabelDistribuion from he counts vector. */
-	*ld = new LabelDistribution( &counts );
+	GraphWriter::append( buffer, n_ );
+	buffer->push_back( ' ' );
+	GraphWriter::append( buffer, l_ );
+	buffer->push_back( '\n' );
 }
 
-void inline LabelledGraph::get_neighbourhood_ld( LabelDistribution **ld, 
-	const uint32_t v ) {
-
-	/* Initialize an empty solution. */
-	std::vector< uint32_t > counts;
-	for( uint32_t i = 0; i < l_; ++i ) { counts.push_back( 0 ); }
-
-	/* Increment count for v's label. */
-	++counts[ vertex_labels_[ v ] ];
+void LabelledGraph::format_vertex( const uint32_t u, const graphAnon::FileFormat format,
+	std::string *buffer ) const {
 
-	/* Iterate neighbours of v, incrementing the relative label frequency
-	 * counts for each one.
-	 */
-	for( auto it = adjacency_list_[ v ].begin(); it != adjacency_list_[ v ].end(); ++it ) {
-		++counts[ vertex_labels_[ *it ] ];
+	if( format != graphAnon::FileFormat::adjacencyListVertexLabelled ) {
+		UnlabelledGraph::format_vertex( u, format, buffer );
+		return;
+	}
+	GraphWriter::append( buffer, vertex_labels_[ u ] );
+	buffer->push_back( ' ' );
+	ScratchArena::Scope scratch;
+	uint32_t const *const neighbours = sorted_neighbours( u );
+	for( size_t i = 0; i < adjacency_list_[ u ].size(); ++i ) {
+		GraphWriter::append( buffer, neighbours[ i ] );
+		buffer->push_back( ' ' );
 	}
+	buffer->push_back( '\n' );
+}
 
-	/* Create new LabelDistribuion from he counts vector. */
-	*ld = new LabelDistribution( &counts );
+void LabelledGraph::refresh_histograms() {
+	if( !histograms_current_ ) {
+		histograms_.build( adjacency_list_, vertex_labels_, l_ );
+		histograms_current_ = true;
+	}
 }
 
 bool LabelledGraph::is_alpha_proximal( const float alpha ) {
-	LabelDistribution *global, *neighbourhood;
-	float max_distance = 0;
 
-	get_global_ld( &global );
+	/* (Re)build the tracker from scratch only when the threshold changes;
+	 * otherwise it is already up to date with every inserted edge. */
+	refresh_histograms();
+	if( !proximity_.is_tracking( alpha ) ) { proximity_.track( histograms_, alpha ); }
+	return proximity_.is_alpha_proximal();
+}
 
-	/* Iterate every vertex, checking its susceptibility to an
-	 * attribute disclosure (NAD) attack
-	 */
+bool LabelledGraph::verify_alpha_proximal( const float alpha ) const {
+	GRAPHANON_PROFILE_PHASE( "verify" );
+	LabelHistograms histograms;
+	histograms.build( adjacency_list_, vertex_labels_, l_ );
+
+	float max_distance = 0;
+#pragma omp parallel for schedule( static ) reduction( max : max_distance )
 	for( uint32_t v = 0; v < n_; ++v ) {
-		get_neighbourhood_ld( &neighbourhood, v );
-		const float distance = global->distance( neighbourhood );
-		if( distance > max_distance ) { max_distance = distance; }
-		delete neighbourhood;
+		max_distance = std::max( max_distance, histograms.distance( v ) );
 	}
-
-	delete global;
 	return max_distance <= alpha;
 }
 
 void LabelledGraph::hopeful( const float alpha ) {
+	GRAPHANON_PROFILE_PHASE( "hopeful" );
 	bool leaks_privacy = !is_alpha_proximal( alpha );
 	while( leaks_privacy && !is_complete() ) {
 		if( is_alpha_proximal( alpha ) ) { leaks_privacy = false; }
@@ -233,79 +247,271 @@ void LabelledGraph::hopeful( const float alpha ) {
 	}
 }
 
-uint32_t LabelledGraph::run_greedy_iteration( const float alpha ) {
+uint64_t LabelledGraph::run_greedy_iteration( const float alpha, const bool parallel ) {
 
-	LabelDistribution *global, *neighbourhood;
-	std::vector< std::pair< uint32_t, uint32_t > > visit_order;
-	uint32_t num_edges_added = 0;
+	refresh_histograms();
 
-	get_global_ld( &global );
+	/* The per-iteration buffers are scratch, reused by every iteration. */
+	ScratchArena::Scope scratch;
 
+	/* First determine which "partition" each vertex belongs to. Every vertex
+	 * gets a row, so that the rows can be filled in parallel. */
+	DeficiencySets deficiencies( l_ );
+	deficiencies.resize( n_ );
+	ScratchVector< uint8_t > is_deficient( n_ );
+#pragma omp parallel for schedule( dynamic, 1024 ) if( parallel )
 	for( uint32_t i = 0; i < n_; ++i ) {
+		DeficiencySet defs = deficiencies.row( i );
+		is_deficient[ i ] = histograms_.deficiencies( i, alpha, &defs );
+	}
 
-		/* First determine which "partition" vertex i belongs to. */
-		get_neighbourhood_ld( &neighbourhood, i );
-		const uint32_t defs = neighbourhood->get_deficiencies( global, alpha );
-
-		/* If vertex i is already alpha-proximal, exclude it
-		 * from further processing. */
-		if( defs > 0 ) {
-			visit_order.push_back ( std::pair< uint32_t, uint32_t > ( i, defs ) );
-		}
-
-		/* clean up from vertex i. */
-		delete neighbourhood;
+	/* If a vertex is already alpha-proximal, exclude it
+	 * from further processing. */
+	ScratchVector< uint32_t > visit_order;
+	for( uint32_t i = 0; i < n_; ++i ) {
+		if( is_deficient[ i ] ) { visit_order.push_back( i ); }
 	}
 
 	/* Randomize the order of the points so that edges are added more
 	 * "evenly." */
 	std::random_shuffle( visit_order.begin(), visit_order.end() );
 
-	/* Process each deficient point v with label l1 by, for each deficient label
-	 * l2, finding a mate u with label l who is deficient in l2 and adding
-	 * edge (u,v) to the graph (if it can be done).
-	 */
-	for( auto it = visit_order.begin(); it != visit_order.end(); ++it ) {
-		/* redeclare for readability the variables related to this iteration. */
-		const uint32_t v = it->first;
-		const uint32_t v_label_bitmask = 1 << vertex_labels_[ v ];
-		uint32_t defs = it->second;
-		const uint32_t num_def_labels = __builtin_popcount( defs );
-
-		/* Iterate deficient labels, trying to correct them. */
-		for( uint32_t i = 0; i < num_def_labels; ++i ) {
-			/* grab next deficient label from bitmask */
-			const uint32_t l = ffs( defs ) - 1;
+	/* Bucket the visit order positions by (label, deficient label). Within a
+	 * bucket, positions are ascending. */
+	const uint64_t l = l_;
+	ScratchVector< std::pair< uint64_t, uint32_t > > candidates;
+	for( uint32_t pos = 0; pos < visit_order.size(); ++pos ) {
+		const uint64_t label = vertex_labels_[ visit_order[ pos ] ];
+		DeficiencySet const defs = deficiencies.row( visit_order[ pos ] );
+		for( uint32_t d = defs.find_first(); d != DeficiencySet::npos(); d = defs.find_next( d + 1 ) ) {
+			candidates.push_back( std::pair< uint64_t, uint32_t >( label * l + d, pos ) );
+		}
+	}
+	std::sort( candidates.begin(), candidates.end() );
+	ScratchVector< uint64_t > bucket_keys;
+	ScratchVector< size_t > bucket_heads;
+	for( size_t i = 0; i < candidates.size(); ++i ) {
+		if( i == 0 || candidates[ i ].first != candidates[ i - 1 ].first ) {
+			bucket_keys.push_back( candidates[ i ].first );
+			bucket_heads.push_back( i );
+		}
+	}
+	bucket_heads.push_back( candidates.size() );
+
+	/* Each deficient point v with label l1 is processed, in visit order, by
+	 * finding for each deficient label l2 the first later mate u with label l2
+	 * who is still deficient in l1, and adding edge (u,v) to the graph (if it
+	 * does not already exist). Edge (u,v) only resolves deficiencies in the
+	 * buckets (l1,l2) and (l2,l1), so each such pair of buckets is processed
+	 * independently: it is a merge of the two buckets in visit order. */
+	std::vector< std::vector< std::pair< uint32_t, uint32_t > > > new_edges( bucket_keys.size() );
+#pragma omp parallel for schedule( dynamic, 1 ) if( parallel )
+	for( size_t b = 0; b < bucket_keys.size(); ++b ) {
+		const uint64_t label = bucket_keys[ b ] / l, deficient_label = bucket_keys[ b ] % l;
+		if( label > deficient_label ) { continue; } /* handled with its partner. */
+
+		/* The bucket of vertices with deficient_label that lack label (if any). */
+		size_t partner = b;
+		if( label != deficient_label ) {
+			const uint64_t key = deficient_label * l + label;
+			auto const it = std::lower_bound( bucket_keys.begin(), bucket_keys.end(), key );
+			if( it == bucket_keys.end() || *it != key ) { continue; } /* no mates for anyone. */
+			partner = it - bucket_keys.begin();
+		}
+
+		/* Whether each entry of the two buckets is still deficient. */
+		const size_t first[ 2 ] = { bucket_heads[ b ], bucket_heads[ partner ] };
+		const size_t size[ 2 ] = { bucket_heads[ b + 1 ] - first[ 0 ], bucket_heads[ partner + 1 ] - first[ 1 ] };
+		ScratchArena::Scope bucket_scratch;
+		ScratchVector< uint8_t > still_deficient[ 2 ];
+		still_deficient[ 0 ].assign( size[ 0 ], 1 );
+		still_deficient[ 1 ].assign( size[ 1 ], 1 );
+		size_t next[ 2 ] = { 0, 0 }, cursor[ 2 ] = { 0, 0 };
+		const uint32_t sides = partner == b ? 1 : 2;
+
+		while( next[ 0 ] < size[ 0 ] || ( sides == 2 && next[ 1 ] < size[ 1 ] ) ) {
+
+			/* The next vertex in visit order, and the side offering its mates. */
+			uint32_t side = 0;
+			if( sides == 2 && ( next[ 0 ] == size[ 0 ] || ( next[ 1 ] < size[ 1 ]
+				&& candidates[ first[ 1 ] + next[ 1 ] ].second < candidates[ first[ 0 ] + next[ 0 ] ].second ) ) ) {
+				side = 1;
+			}
+			const uint32_t mates = sides == 2 ? 1 - side : 0;
+			const size_t me = next[ side ]++;
+			if( !still_deficient[ side ][ me ] ) { continue; }
+			const uint32_t pos = candidates[ first[ side ] + me ].second;
+			const uint32_t v = visit_order[ pos ];
+
+			/* Permanently skip mates that precede v or are no longer deficient. */
+			size_t &c = cursor[ mates ];
+			while( c < size[ mates ] && ( candidates[ first[ mates ] + c ].second <= pos
+				|| !still_deficient[ mates ][ c ] ) ) { ++c; }
 
 			/* find a mate with whom to connect (if there is one) */
-			for( auto it_mate = it + 1; it_mate != visit_order.end(); ++it_mate ) {
-				if( it_mate->second & v_label_bitmask ) { /* mate deficient in my label */
-					if( vertex_labels_[ it_mate->first ] == l ) { /* mate offers my deficiency */
-						if( add_edge( v, it_mate->first ) ) {
-							it_mate->second ^= v_label_bitmask;
-							++num_edges_added;
-							break; /* success! */
-						}
-					}
+			for( size_t i = c; i < size[ mates ]; ++i ) {
+				const uint32_t u = visit_order[ candidates[ first[ mates ] + i ].second ];
+				if( still_deficient[ mates ][ i ] && adjacency_list_[ v ].count( u ) == 0 ) {
+					still_deficient[ mates ][ i ] = 0;
+					new_edges[ b ].push_back( std::pair< uint32_t, uint32_t >( v, u ) );
+					break; /* success! */
 				}
 			}
-
-			/* clear bit as having been resolved */
-			defs ^= 1 << ( l - 1 );
 		}
 	}
 
-	/* clean up and return */
-	delete global;
+	/* Commit the chosen edges. */
+	uint64_t num_edges_added = 0;
+	if( parallel ) {
+		std::vector< std::pair< uint32_t, uint32_t > > edges;
+		for( auto const& bucket_edges : new_edges ) {
+			edges.insert( edges.end(), bucket_edges.begin(), bucket_edges.end() );
+		}
+		num_edges_added = add_edges_in_parallel( edges );
+	}
+	else {
+		for( auto const& bucket_edges : new_edges ) {
+			for( auto const& e : bucket_edges ) {
+				if( add_edge( e.first, e.second ) ) { ++num_edges_added; }
+			}
+		}
+	}
 	return num_edges_added;
 }
 
+uint32_t LabelledGraph::add_targeted_edges( const float alpha, const bool parallel ) {
+
+	if( !proximity_.is_tracking( alpha ) ) { return 0; }
+
+	/* The vertices with each label, from which to draw mates. */
+	std::vector< std::vector< uint32_t > > vertices_with_label( l_ );
+	for( uint32_t u = 0; u < n_; ++u ) { vertices_with_label[ vertex_labels_[ u ] ].push_back( u ); }
+
+	std::vector< uint32_t > violating = proximity_.violating_vertices();
+	std::random_shuffle( violating.begin(), violating.end() );
+
+	/* Connect each violating vertex to its most under-represented label that
+	 * still has a non-neighbour (which any under-represented label does,
+	 * unless v already neighbours every vertex). */
+	uint32_t const *global = histograms_.global_row();
+	const float global_sum = histograms_.global_sum();
+	std::vector< std::pair< float, uint32_t > > shortfalls;
+	std::vector< std::pair< uint32_t, uint32_t > > edges;
+	for( uint32_t const v : violating ) {
+		uint32_t const *counts = histograms_.row( v );
+		const float sum = histograms_.sum( v );
+		shortfalls.clear();
+		for( uint32_t label = 0; label < l_; ++label ) {
+			const float shortfall = global[ label ] / global_sum - counts[ label ] / sum;
+			if( shortfall > 0 ) { shortfalls.push_back( std::make_pair( shortfall, label ) ); }
+		}
+		std::sort( shortfalls.begin(), shortfalls.end(), std::greater< std::pair< float, uint32_t > >() );
+		for( auto const& shortfall : shortfalls ) {
+			std::vector< uint32_t > const& mates = vertices_with_label[ shortfall.second ];
+			const uint32_t num_free = mates.size() - counts[ shortfall.second ];
+			if( num_free == 0 ) { continue; }
+			const uint32_t u = sample_non_neighbour( v, mates, num_free );
+			edges.push_back( std::make_pair( std::min( u, v ), std::max( u, v ) ) );
+			break;
+		}
+	}
+
+	/* Two violating vertices may have chosen each other. */
+	std::sort( edges.begin(), edges.end() );
+	edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+	if( parallel ) { add_edges_in_parallel( edges ); }
+	else {
+		for( auto const& e : edges ) { add_edge( e.first, e.second ); }
+	}
+	GRAPHANON_PROFILE_COUNT( targeted_fallback_edges, edges.size() );
+	return edges.size();
+}
+
+uint32_t LabelledGraph::sample_non_neighbour( const uint32_t v,
+	std::vector< uint32_t > const& candidates, const uint32_t num_free ) const {
+
+	NeighbourList const& neighbours = adjacency_list_[ v ];
+	if( 4 * static_cast< uint64_t >( num_free ) >= candidates.size() ) {
+		while( true ) {
+			const uint32_t u = candidates[ rand() % candidates.size() ];
+			if( u != v && neighbours.count( u ) == 0 ) { return u; }
+			GRAPHANON_PROFILE_COUNT( rejection_retries, 1 );
+		}
+	}
+
+	/* Most candidates are taken: pick the r'th free one directly. */
+	uint32_t r = rand() % num_free;
+	for( uint32_t const u : candidates ) {
+		if( u != v && neighbours.count( u ) == 0 && r-- == 0 ) { return u; }
+	}
+	assert( false );
+	return v;
+}
+
+uint64_t LabelledGraph::add_edges_in_parallel(
+	std::vector< std::pair< uint32_t, uint32_t > > const& edges ) {
+
+	ConcurrentAdjacencyBuilder builder( &adjacency_list_ );
+#pragma omp parallel for schedule( static )
+	for( size_t i = 0; i < edges.size(); ++i ) { builder.add_edge( edges[ i ].first, edges[ i ].second ); }
+	return commit_edges( &builder );
+}
+
+uint64_t LabelledGraph::commit_edges( ConcurrentAdjacencyBuilder *builder ) {
+
+	/* Each thread only updates the histogram rows of the vertices whose
+	 * neighbour lists it is extending. */
+	const bool update_histograms = histograms_current_;
+	std::vector< uint8_t > touched( update_histograms ? n_ : 0, 0 );
+	const uint64_t num_inserted = builder->commit(
+		[ this, update_histograms, &touched ]( const uint32_t u, const uint32_t v ) {
+			if( update_histograms ) {
+				histograms_.add_neighbour( u, vertex_labels_[ v ] );
+				touched[ u ] = 1;
+			}
+		} );
+	m_ += num_inserted;
+	csr_.reset();
+	degree_histogram_.invalidate();
+
+	/* Finally, bring the tracker up to date with both endpoints of every edge. */
+	if( update_histograms && proximity_.is_tracking() ) {
+		std::vector< uint32_t > vertices;
+		for( uint32_t u = 0; u < n_; ++u ) {
+			if( touched[ u ] ) { vertices.push_back( u ); }
+		}
+		proximity_.update( vertices );
+	}
+	return num_inserted;
+}
+
 void LabelledGraph::greedy( const float alpha ) {
+	GRAPHANON_PROFILE_PHASE( "greedy" );
 	bool leaks_privacy = !is_alpha_proximal( alpha );
 	while( leaks_privacy && !is_complete() ) {
-		const uint32_t num_new_edges = run_greedy_iteration( alpha );
+		uint64_t num_new_edges;
+		{
+			GRAPHANON_PROFILE_PHASE( "iteration" );
+			num_new_edges = run_greedy_iteration( alpha, false );
+		}
+		GRAPHANON_PROFILE_COUNT( greedy_iterations, 1 );
+		if( is_alpha_proximal( alpha ) ) { leaks_privacy = false; }
+		else if ( num_new_edges == 0 && add_targeted_edges( alpha, false ) == 0 ) { add_random_edge(); }
+	}
+}
+
+void LabelledGraph::parallel_greedy( const float alpha ) {
+	GRAPHANON_PROFILE_PHASE( "parallel_greedy" );
+	bool leaks_privacy = !is_alpha_proximal( alpha );
+	while( leaks_privacy && !is_complete() ) {
+		uint64_t num_new_edges;
+		{
+			GRAPHANON_PROFILE_PHASE( "iteration" );
+			num_new_edges = run_greedy_iteration( alpha, true );
+		}
+		GRAPHANON_PROFILE_COUNT( greedy_iterations, 1 );
 		if( is_alpha_proximal( alpha ) ) { leaks_privacy = false; }
-		else if ( num_new_edges == 0 ) { add_random_edge(); }
+		else if ( num_new_edges == 0 && add_targeted_edges( alpha, true ) == 0 ) { add_random_edge(); }
 	}
 }
 
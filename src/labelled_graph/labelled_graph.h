@@ -39,9 +39,13 @@
 /* STL libraries in use */
 #include <vector>
 #include <unordered_set>
+#include <utility>
 
 #include "../unlabelled_graph/unlabelled_graph.h"
 #include "label_distribution.h"
+#include "label_histograms.h"
+#include "deficiency_set.h"
+#include "alpha_proximity_tracker.h"
 
 /**
  * @brief A simple, undirected, vertex-labelled graph with no self-loops that is
@@ -56,15 +60,20 @@ public:
 	/**
 	 * Constructs a LabelledGraph object from a file
 	 * @param filename The path to the input file containing the graph
+	 * @param format The format of the input file: either the vertex-labelled
+	 * adjacency list format or the binary format.
 	 * @post Constructs a new LabelledGraph object
 	 * @warning Does minimal error-checking. If the file format is
 	 * invalid or filename is an incorrect path, then the behaviour
 	 * of this constructor is undefined.
+	 * @note Writes nothing to stdout or stderr: if no vertices could be
+	 * parsed (e.g., filename is an incorrect path), the graph is empty.
 	 * @see <a href="../../workloads/paper_example.adjList">An example file</a>
 	 * consisting of the example LabelledGraph from Figure 1 of @cite asonam ,
 	 * represented in the vertex-labelled adjacency list format.
 	 */
-	LabelledGraph( const std::string filename );
+	LabelledGraph( const std::string filename,
+		const graphAnon::FileFormat format = graphAnon::FileFormat::adjacencyListVertexLabelled );
 
 
 	/**
@@ -76,6 +85,16 @@ public:
 	 */
 	LabelledGraph( const uint32_t num_vertices, const uint32_t num_labels );
 
+	/**
+	 * Constructs a copy of a LabelledGraph, including its label histograms,
+	 * e.g., to anonymise a graph while keeping the original.
+	 * @param other The graph to copy.
+	 * @post The copy does not track alpha-proximity until it is next queried.
+	 */
+	LabelledGraph( LabelledGraph const& other );
+
+	LabelledGraph& operator=( LabelledGraph const& ) = delete;
+
 	/**
 	 * Destroys the LabelledGraph.
 	 */
@@ -99,9 +118,24 @@ public:
 	 * @return True if every vertex has a LabelDistribution within a distance
 	 * of alpha of the global LabelDistribution
 	 * @see Definition 2.6 of @cite asonam
+	 * @note The first call for a given alpha costs O( m + nl ) to start the
+	 * AlphaProximityTracker; subsequent calls with the same alpha are O( 1 ),
+	 * because every edge insertion in between updates the tracker.
 	 */
 	bool is_alpha_proximal( const float alpha );
 
+	/**
+	 * Determines whether this graph is alpha-proximal from scratch, by
+	 * rebuilding the neighbourhood label histograms and rescanning every
+	 * vertex, without consulting the incrementally maintained histograms or
+	 * AlphaProximityTracker that drive the anonymisation algorithms.
+	 * @param alpha The privacy threshold
+	 * @return As for is_alpha_proximal().
+	 * @note Costs O( m + nl ) on every call, so it is meant as an independent
+	 * final check of an anonymised graph.
+	 */
+	bool verify_alpha_proximal( const float alpha ) const;
+
 	/**
 	 * Naively transforms the graph into an alpha-proximal graph by alternately
 	 * adding a random edge and then checking if the graph is alpha-proximal. The
@@ -122,6 +156,20 @@ public:
 	 */
 	void greedy( const float alpha );
 
+	/**
+	 * Transforms the graph into an alpha-proximal graph with the same Greedy
+	 * alpha-proximity algorithm as greedy(), but using every OpenMP thread.
+	 * Deficiencies are computed in parallel across vertices and mates are
+	 * chosen in parallel across pairs of labels; the chosen edges are then
+	 * inserted in conflict-free batches (matchings), so that no two threads
+	 * ever modify the neighbourhood of the same vertex at once.
+	 * @param alpha The privacy threshold
+	 * @post Inserts edges into the graph so that the graph is alpha-proximal
+	 * @note Each iteration chooses exactly the same edges as an iteration of
+	 * greedy() given the same random visit order.
+	 */
+	void parallel_greedy( const float alpha );
+
 	/**
 	 * Prints the graph to outstream in vertex-labelled adjacency list format
 	 * (primarily for the purpose of testing).
@@ -132,41 +180,118 @@ public:
 	 */
 	void print( std::ofstream *outstream );
 
-private:
+protected:
+
+	/**
+	 * Inserts the undirected edge (u,v) into the graph if it does not already
+	 * exist and, if it was inserted, updates the alpha-proximity tracker.
+	 * @see UnlabelledGraph::add_edge()
+	 */
+	bool add_edge( const uint32_t u, const uint32_t v ) override;
+
+	/**
+	 * Replaces the edges of the graph in bulk, after which the label
+	 * histograms must be rebuilt.
+	 * @see UnlabelledGraph::assign_csr()
+	 */
+	void assign_csr( CsrGraph &&g ) override;
+
+	/**
+	 * Moves the label of every vertex to its new id.
+	 * @see UnlabelledGraph::permute_vertex_data()
+	 */
+	void permute_vertex_data( std::vector< uint32_t > const& new_id ) override;
+
+	/**
+	 * Inserts the edges queued in builder, updating the label histograms and
+	 * the alpha-proximity tracker with them.
+	 * @see UnlabelledGraph::commit_edges()
+	 */
+	uint64_t commit_edges( ConcurrentAdjacencyBuilder *builder ) override;
 
 	/**
-	 * Obtains and constructs at address ld a LabelDistribution
-	 * corresponding to the global frequencies of all labels for all
-	 * vertices in the graph.
-	 * @param ld The address at which the new LabelDistribution should
-	 * be constructted.
-	 * @post ld contains a new LabelDistribution instance.
+	 * Retrieves the vertex labels, so that binary output files keep them.
+	 * @see UnlabelledGraph::output_labels()
 	 */
-	void inline get_global_ld( LabelDistribution **ld );
+	std::vector< uint32_t > const* output_labels() const override;
 
 	/**
-	 * Obtains and constructs at address ld a LabelDistribution
-	 * corresponding to the frequencies of all labels of vertices
-	 * within the 1-hop neighbourhood of vertex v.
-	 * @param ld The address at which the new LabelDistribution should
-	 * be constructed.
-	 * @param v The vertex id for whom the neighbourhood LabelDistribution
-	 * should be calculated
-	 * @post ld contains a new LabelDistribution instance.
+	 * Retrieves the size of the label alphabet.
+	 * @see UnlabelledGraph::output_num_labels()
 	 */
-	void inline get_neighbourhood_ld( LabelDistribution **ld, const uint32_t v );
+	uint32_t output_num_labels() const override;
 
+	/**
+	 * Formats the header of an ascii file, which for the vertex-labelled
+	 * adjacency list format also gives the label alphabet size.
+	 * @see UnlabelledGraph::format_header()
+	 */
+	void format_header( const graphAnon::FileFormat format, std::string *buffer ) const override;
+
+	/**
+	 * Formats vertex u of an ascii file, which for the vertex-labelled
+	 * adjacency list format is its label followed by all of its neighbours.
+	 * @see UnlabelledGraph::format_vertex()
+	 */
+	void format_vertex( const uint32_t u, const graphAnon::FileFormat format,
+		std::string *buffer ) const override;
+
+private:
+
+	/**
+	 * Rebuilds the neighbourhood label histograms from scratch if any vertex
+	 * has been relabelled since they were last built.
+	 * @post histograms_ is consistent with the current graph and labelling.
+	 */
+	void refresh_histograms();
 
 	/**
 	 * Runs an iteration of the Greedy Alpha-Proximity algorithm (Lines 2--4 in
 	 * Algorithm 1 of @cite asonam ).
 	 * @param alpha The privacy threshold
+	 * @param parallel Whether to use every OpenMP thread
 	 * @return The number of edges that were added to the graph during
 	 * this iteration
 	 * @post The graph contains new edges and has greedily moved closer to being
 	 * alpha-proximal.
 	 */
-	uint32_t run_greedy_iteration( const float alpha );
+	uint64_t run_greedy_iteration( const float alpha, const bool parallel );
+
+	/**
+	 * Adds a batch of edges when a greedy iteration could not: for each
+	 * vertex that is not alpha-proximal, one edge to a random non-neighbour
+	 * with the label that is most under-represented in its neighbourhood.
+	 * Validation of the whole batch is then left to the caller.
+	 * @param alpha The privacy threshold, which the alpha-proximity tracker
+	 * must already be tracking.
+	 * @param parallel Whether to insert the batch with every OpenMP thread
+	 * @return The number of edges that were added to the graph
+	 * @note Never zero unless the graph is alpha-proximal (or complete),
+	 * because a vertex with a deficient label always has a non-neighbour with it.
+	 */
+	uint32_t add_targeted_edges( const float alpha, const bool parallel );
+
+	/**
+	 * Chooses a vertex uniformly at random among candidates that is neither v
+	 * nor a neighbour of v, by rejection sampling while at least a quarter of
+	 * candidates qualify (O( 1 ) expected draws) and otherwise by a scan of
+	 * candidates (whose length is then within a constant factor of v's degree).
+	 * @param v The vertex to which to connect.
+	 * @param candidates The vertices from which to choose.
+	 * @param num_free The number of candidates that qualify, which must be positive.
+	 */
+	uint32_t sample_non_neighbour( const uint32_t v, std::vector< uint32_t > const& candidates,
+		const uint32_t num_free ) const;
+
+	/**
+	 * Inserts a batch of edges with every OpenMP thread, through a
+	 * ConcurrentAdjacencyBuilder.
+	 * @param edges The edges to insert; any that already exist are skipped.
+	 * @return The number of edges that were inserted.
+	 * @post The graph, the label histograms, and the alpha-proximity tracker
+	 * all contain the new edges.
+	 */
+	uint64_t add_edges_in_parallel( std::vector< std::pair< uint32_t, uint32_t > > const& edges );
 
 
 	/* Private member variables. */
@@ -176,7 +301,21 @@ private:
 	 */
 	std::vector< uint32_t > vertex_labels_;
 	uint32_t l_; /**< The size of the label set. */
-	
+
+	/**
+	 * The closed-neighbourhood label histogram of every vertex, shared by
+	 * is_alpha_proximal() and run_greedy_iteration() and reused across
+	 * iterations, so that neither allocates a LabelDistribution per vertex.
+	 */
+	LabelHistograms histograms_;
+	bool histograms_current_; /**< Whether histograms_ reflects the current labels. */
+
+	/**
+	 * Incrementally maintains which vertices are not alpha-proximal, so that
+	 * is_alpha_proximal() need not rescan the graph after every edge insertion.
+	 */
+	AlphaProximityTracker proximity_;
+
 };
 
 
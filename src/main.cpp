@@ -28,15 +28,49 @@
  */
 
 #include <iostream>		/* For std::cout, std::endl */
+#include <fstream>		/* For std::ifstream, std::ofstream */
+#include <sstream>		/* For std::istringstream, std::ostringstream */
 #include <algorithm>	/* For std::find */
-#include <string.h>		/* For strcmp() */
+#include <string.h>		/* For strcmp(), strchr() */
+#include <stdio.h>		/* For sscanf() */
+#include <stdlib.h>		/* For strtoull(), srand() */
+#include <time.h>		/* For time() */
 
 #include "labelled_graph/labelled_graph.h"
 #include "unlabelled_graph/unlabelled_graph.h"
+#include "unlabelled_graph/streaming_identity.h"
+#include "unlabelled_graph/graph_overlay.h"
+#include "unlabelled_graph/utility_report.h"
+#include "unlabelled_graph/hop_plot_estimator.h"
+#include "unlabelled_graph/hop_plot_partition.h"
+#include "unlabelled_graph/random_graph.h"
+#include "unlabelled_graph/profile.h"
+#include "service/graph_service.h"
 #include "labelled_graph/label_distribution.test.h"
+#include "labelled_graph/deficiency_set.test.h"
+#include "labelled_graph/alpha_proximity_tracker.test.h"
+#include "unlabelled_graph/all_pairs_bfs.test.h"
+#include "unlabelled_graph/triangle_count.test.h"
+#include "unlabelled_graph/subgraph_centrality.test.h"
+#include "unlabelled_graph/degree_anonymiser.test.h"
+#include "unlabelled_graph/degree_histogram.test.h"
+#include "unlabelled_graph/neighbour_list.test.h"
+#include "unlabelled_graph/vertex_order.test.h"
+#include "unlabelled_graph/scratch_arena.test.h"
+#include "unlabelled_graph/concurrent_adjacency_builder.test.h"
+#include "unlabelled_graph/random_graph.test.h"
+#include "unlabelled_graph/graph_overlay.test.h"
+#include "unlabelled_graph/hop_plot_estimator.test.h"
+#include "unlabelled_graph/hop_plot_partition.test.h"
+#include "unlabelled_graph/streaming_identity.test.h"
+#include "unlabelled_graph/binary_format.test.h"
+#include "service/graph_service.test.h"
 
 /* STL containers in use */
 #include <map>
+#include <vector>
+#include <string>
+#include <memory>
 
 /**
  * Finds a specified option among the command line arguments
@@ -61,26 +95,636 @@ char* getCmdOption(char **begin, char **end, const std::string &option, bool has
 }
 
 
+/**
+ * Parses the name of a file format, as given to the -format and -oformat options.
+ * @param name The name of the format (e.g., "adjList")
+ * @param format The format that name describes, if it is recognised
+ * @return False if name does not describe a supported format, in which
+ * case an error message is echoed to stderr.
+ */
+bool parse_format( const char *name, graphAnon::FileFormat *format ) {
+	if( strcmp( name, "adjList" ) == 0 ) {
+		*format = graphAnon::FileFormat::adjacencyList;
+	}
+	else if( strcmp( name, "edgeList" ) == 0 ) {
+		*format = graphAnon::FileFormat::edgeList;
+	}
+	else if( strcmp( name, "adjListVL" ) == 0 ) {
+		*format = graphAnon::FileFormat::adjacencyListVertexLabelled;
+	}
+	else if( strcmp( name, "binary" ) == 0 ) {
+		*format = graphAnon::FileFormat::binary;
+	}
+	else {
+		std::cerr << std::endl
+			<< "\tFormat \"" << name << "\" not supported."
+			<< std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -compress option, if any.
+ * @param compression The compression requested (none if there is no -compress option)
+ * @return False if the compression is not recognised or not supported by this
+ * build, in which case an error message is echoed to stderr.
+ */
+bool parse_compression( int argc, char** argv, graphAnon::Compression *compression ) {
+	*compression = graphAnon::Compression::none;
+	char *name = getCmdOption( argv, argv + argc, "-compress", true );
+	if( name == NULL || strcmp( name, "none" ) == 0 ) { return true; }
+	if( strcmp( name, "gzip" ) == 0 ) { *compression = graphAnon::Compression::gzip; }
+	else if( strcmp( name, "zstd" ) == 0 ) { *compression = graphAnon::Compression::zstd; }
+	else {
+		std::cerr << std::endl
+			<< "\tCompression \"" << name << "\" not supported."
+			<< std::endl;
+		return false;
+	}
+	if( !GraphWriter::supported( *compression ) ) {
+		std::cerr << std::endl
+			<< "\tThis build of graphAnon does not support " << name
+			<< " compression." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the options that govern how an output file is written: -oformat
+ * (or default_format if there is none), -varint, and -compress.
+ * @return False if any of them is invalid, in which case an error message is
+ * echoed to stderr.
+ */
+bool parse_output_options( int argc, char** argv, const graphAnon::FileFormat default_format,
+	graphAnon::FileFormat *format, bool *varint, graphAnon::Compression *compression ) {
+
+	*format = default_format;
+	char *output_format = getCmdOption( argv, argv + argc, "-oformat", true );
+	if( output_format != NULL && !parse_format( output_format, format ) ) { return false; }
+
+	if( !parse_compression( argc, argv, compression ) ) { return false; }
+	if( *format == graphAnon::FileFormat::binary && *compression != graphAnon::Compression::none ) {
+		std::cerr << std::endl
+			<< "\t-compress applies only to the ascii formats (use -varint for binary)."
+			<< std::endl;
+		return false;
+	}
+
+	*varint = getCmdOption( argv, argv + argc, "-varint", false ) != NULL;
+	return true;
+}
+
+/**
+ * Writes a graph to the output file named by the -o option, if any, as
+ * specified by the options that parse_output_options() parses.
+ * @return False if an output option is invalid or the file could not be written.
+ */
+bool write_output( UnlabelledGraph const *g, int argc, char** argv,
+	const graphAnon::FileFormat default_format ) {
+
+	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
+	if( output_filename == NULL ) { return true; }
+	GRAPHANON_PROFILE_PHASE( "write" );
+
+	graphAnon::FileFormat format;
+	bool varint;
+	graphAnon::Compression compression;
+	if( !parse_output_options( argc, argv, default_format, &format, &varint, &compression ) ) {
+		return false;
+	}
+	if( !g->write( output_filename, format, varint, compression ) ) {
+		std::cerr << "Could not write output file " << output_filename << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Echoes the path of an input file to stdout and checks that a graph was
+ * read from it.
+ * @param filename The path of the input file.
+ * @param g The graph that was loaded from filename.
+ * @return False if no vertices were read, in which case an error message is
+ * echoed to stderr.
+ */
+bool check_loaded( const char *filename, UnlabelledGraph const& g ) {
+	std::cout << filename << std::endl;
+	if( g.num_vertices() > 0 ) { return true; }
+	std::cerr << "Did not parse a positive number of vertices from input file. "
+			<< "Did you format the file correctly and specify the correct path?"
+			<< std::endl;
+	return false;
+}
+
+/**
+ * Runs the unit tests of the analysis routines behind -stats and -report.
+ * @return False if any test fails, in which case an error message is echoed
+ * to stderr.
+ */
+bool test_analyses() {
+	GRAPHANON_PROFILE_PAUSE(); /* the tests' own graphs would skew the counters */
+	if( !test_all_pairs_bfs() ) {
+		std::cerr << "Failed unit test of AllPairsBfs"
+				<< " histogram function! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_triangle_count() ) {
+		std::cerr << "Failed unit test of TriangleCounter"
+				<< " count functions! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_subgraph_centrality() ) {
+		std::cerr << "Failed unit test of the sparse SubgraphCentrality"
+				<< " estimate! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_hop_plot_estimator() ) {
+		std::cerr << "Failed unit test of the sampled and sketched"
+				<< " hop plots! Aborting." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Runs the unit tests of the identity mode's data structures and algorithms.
+ * @return False if any test fails, in which case an error message is echoed
+ * to stderr.
+ */
+bool test_identity() {
+	GRAPHANON_PROFILE_PAUSE(); /* the tests' own graphs would skew the counters */
+	if( !test_degree_anonymiser() ) {
+		std::cerr << "Failed unit test of DegreeSequenceAnonymiser! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_degree_histogram() ) {
+		std::cerr << "Failed unit test of DegreeHistogram! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_neighbour_list() ) {
+		std::cerr << "Failed unit test of NeighbourList! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_scratch_arena() ) {
+		std::cerr << "Failed unit test of ScratchArena! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_vertex_order() ) {
+		std::cerr << "Failed unit test of the vertex reorderings! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_concurrent_adjacency_builder() ) {
+		std::cerr << "Failed unit test of ConcurrentAdjacencyBuilder! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_random_graph() ) {
+		std::cerr << "Failed unit test of the random graph generators! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_graph_overlay() ) {
+		std::cerr << "Failed unit test of GraphOverlay analyses! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_streaming_identity() ) {
+		std::cerr << "Failed unit test of StreamingIdentityAnonymiser! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_binary_format() ) {
+		std::cerr << "Failed unit test of the binary graph format! Aborting." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Runs the unit tests of the attribute mode's data structures.
+ * @return False if any test fails, in which case an error message is echoed
+ * to stderr.
+ */
+bool test_attribute() {
+	GRAPHANON_PROFILE_PAUSE(); /* the tests' own graphs would skew the counters */
+	if( !test_distance() ) {
+		std::cerr << "Failed unit test of LabelDistribution" <<
+				" distance function! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_deficiency_set() ) {
+		std::cerr << "Failed unit test of DeficiencySet! Aborting." << std::endl;
+		return false;
+	}
+	if( !test_alpha_proximity_tracker() ) {
+		std::cerr << "Failed unit test of AlphaProximityTracker! Aborting." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -reorder option, if any.
+ * @param order The relabelling requested (none if there is no -reorder option)
+ * @return False if the relabelling is not recognised, in which case an error
+ * message is echoed to stderr.
+ */
+bool parse_vertex_order( int argc, char** argv, graphAnon::VertexOrder *order ) {
+	*order = graphAnon::VertexOrder::none;
+	char *name = getCmdOption( argv, argv + argc, "-reorder", true );
+	if( name == NULL || strcmp( name, "none" ) == 0 ) { return true; }
+	if( strcmp( name, "degree" ) == 0 ) { *order = graphAnon::VertexOrder::degree; }
+	else if( strcmp( name, "rcm" ) == 0 ) { *order = graphAnon::VertexOrder::rcm; }
+	else if( strcmp( name, "gorder" ) == 0 ) { *order = graphAnon::VertexOrder::gorder; }
+	else {
+		std::cerr << std::endl
+			<< "\tVertex order \"" << name << "\" not supported."
+			<< std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -seed option, if any.
+ * @return The seed for every random choice: the -seed value, or else the
+ * current time (so that, by default, every run differs).
+ */
+uint64_t parse_seed( int argc, char** argv ) {
+	char *seed = getCmdOption( argv, argv + argc, "-seed", true );
+	return ( seed == NULL ? static_cast< uint64_t >( time( NULL ) ) : strtoull( seed, NULL, 10 ) );
+}
+
+/**
+ * Adds random edges to an edgeless graph, as requested by the -occ,
+ * -random-model, and -seed options: either exactly occ * n * ( n - 1 ) / 2
+ * uniformly chosen edges (gnm, the default) or each edge independently with
+ * probability occ (gnp).
+ * @param g The graph to populate.
+ * @param occ The requested occupancy.
+ * @return False if -random-model is not recognised or the occupancy is
+ * impossible, in which case an error message is echoed to stderr.
+ */
+bool populate_random_graph( UnlabelledGraph *g, int argc, char** argv, const float occ ) {
+	const uint64_t seed = parse_seed( argc, argv );
+	char *model = getCmdOption( argv, argv + argc, "-random-model", true );
+	if( model == NULL || strcmp( model, "gnm" ) == 0 ) {
+		const uint64_t num_edges = occ * graphAnon::num_vertex_pairs( g->num_vertices() );
+		if( g->populate_uniformly( num_edges, seed ) ) { return true; }
+		std::cerr << std::endl << "	-occ must be at most 1." << std::endl;
+		return false;
+	}
+	if( strcmp( model, "gnp" ) == 0 ) {
+		g->populate_binomially( occ, seed );
+		return true;
+	}
+	std::cerr << std::endl
+		<< "	Random graph model \"" << model << "\" not supported." << std::endl;
+	return false;
+}
+
+/**
+ * Parses the -hop-plot, -hop-plot-samples, and -sketch-registers options, if any.
+ * @param options The requested hop plot settings (exact if there is no
+ * -hop-plot option).
+ * @return False if any of them is invalid, in which case an error message is
+ * echoed to stderr.
+ */
+bool parse_hop_plot_options( int argc, char** argv, HopPlotOptions *options ) {
+	*options = HopPlotOptions();
+	char *method = getCmdOption( argv, argv + argc, "-hop-plot", true );
+	if( method == NULL || strcmp( method, "exact" ) == 0 ) {}
+	else if( strcmp( method, "sampled" ) == 0 ) { options->method = graphAnon::HopPlotMethod::sampled; }
+	else if( strcmp( method, "sketch" ) == 0 ) { options->method = graphAnon::HopPlotMethod::sketch; }
+	else {
+		std::cerr << std::endl
+			<< "\tHop plot method \"" << method << "\" not supported." << std::endl;
+		return false;
+	}
+
+	char *samples = getCmdOption( argv, argv + argc, "-hop-plot-samples", true );
+	if( samples != NULL ) { options->num_samples = atoi( samples ); }
+	char *registers = getCmdOption( argv, argv + argc, "-sketch-registers", true );
+	if( registers != NULL ) { options->num_registers = atoi( registers ); }
+	if( getCmdOption( argv, argv + argc, "-seed", true ) != NULL ) {
+		options->seed = parse_seed( argc, argv );
+	}
+	const uint32_t m = options->num_registers;
+	if( options->num_samples == 0 || m < 16 || m > 65536 || ( m & ( m - 1 ) ) != 0 ) {
+		std::cerr << std::endl
+			<< "\t-hop-plot-samples must be positive and -sketch-registers a power"
+			<< " of two from 16 to 65536." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -sc-tol option, if any.
+ * @return The relative standard error of the sparse subgraph centrality
+ * estimate (0.001 if there is no -sc-tol option).
+ */
+double parse_sc_tolerance( int argc, char** argv ) {
+	char *sc_tolerance = getCmdOption( argv, argv + argc, "-sc-tol", true );
+	return ( sc_tolerance == NULL ? 1e-3 : atof( sc_tolerance ) );
+}
+
+/**
+ * Parses the format of a report file. The format is that named by name or,
+ * if there is none, csv for a path that ends in ".csv" and json otherwise.
+ * @param filename The path of the report file, or NULL if there is none.
+ * @param name The value of the format option, or NULL if there is none.
+ * @return False if name is not recognised, in which case an error
+ * message is echoed to stderr.
+ */
+bool parse_report_format( const char *filename, const char *name, graphAnon::ReportFormat *format ) {
+	if( name == NULL ) {
+		const size_t length = filename == NULL ? 0 : strlen( filename );
+		const bool csv = length >= 4 && strcmp( filename + length - 4, ".csv" ) == 0;
+		*format = csv ? graphAnon::ReportFormat::csv : graphAnon::ReportFormat::json;
+	}
+	else if( strcmp( name, "json" ) == 0 ) { *format = graphAnon::ReportFormat::json; }
+	else if( strcmp( name, "csv" ) == 0 ) { *format = graphAnon::ReportFormat::csv; }
+	else {
+		std::cerr << std::endl
+			<< "\tReport format \"" << name << "\" not supported." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -report and -report-format options, if any.
+ * @param filename The path named by -report, or NULL if there is none.
+ * @return False if -report-format is not recognised.
+ * @see parse_report_format()
+ */
+bool parse_report( int argc, char** argv, char **filename, graphAnon::ReportFormat *format ) {
+	*filename = getCmdOption( argv, argv + argc, "-report", true );
+	return parse_report_format( *filename,
+		getCmdOption( argv, argv + argc, "-report-format", true ), format );
+}
+
+/**
+ * Parses the -profile and -profile-format options, if any.
+ * @param filename The path named by -profile ("-" for stderr), or NULL if
+ * there is none.
+ * @return False if -profile-format is not recognised.
+ * @see parse_report_format()
+ */
+bool parse_profile( int argc, char** argv, char **filename, graphAnon::ReportFormat *format ) {
+	*filename = getCmdOption( argv, argv + argc, "-profile", true );
+	return parse_report_format( *filename,
+		getCmdOption( argv, argv + argc, "-profile-format", true ), format );
+}
+
+/**
+ * Writes a utility report to the file named by -report.
+ * @return False if the file could not be written.
+ */
+bool write_report( UtilityReport const& report, const char *filename,
+	const graphAnon::ReportFormat format ) {
+
+	if( !report.write( filename, format ) ) {
+		std::cerr << "Could not write report file " << filename << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parses the -k-sweep option, first:last[:step], into the privacy thresholds
+ * that it spans.
+ * @param sweep The value of the -k-sweep option.
+ * @param n The number of vertices in the graph, which bounds every k.
+ * @param ks The thresholds first, first + step, ..., up to at most last.
+ * @return False if sweep is malformed or out of [ 1, n ], in which case an
+ * error message is echoed to stderr.
+ */
+bool parse_k_sweep( const char *sweep, const uint32_t n, std::vector< uint32_t > *ks ) {
+	unsigned long first = 0, last = 0, step = 1;
+	char trailing;
+	const int fields = sscanf( sweep, "%lu:%lu:%lu%c", &first, &last, &step, &trailing );
+	if( ( fields != 2 && fields != 3 ) || first < 1 || first > last || last > n || step < 1 ) {
+		std::cerr << std::endl
+			<< "\t-k-sweep expects first:last[:step] with 1 <= first <= last <= n"
+			<< " (here, n = " << n << ")" << std::endl;
+		return false;
+	}
+	ks->clear();
+	for( unsigned long k = first; k <= last; k += step ) {
+		ks->push_back( static_cast< uint32_t >( k ) );
+	}
+	return true;
+}
+
+/**
+ * Parses the -hop-plot-part option, i/N, into a share of the BFS sources.
+ * @param option The value of the -hop-plot-part option.
+ * @param part Set to i, which share of the sources to search from.
+ * @param num_parts Set to N, the number of shares.
+ * @return False if option is malformed or i is not in [ 0, N ), in which
+ * case an error message is echoed to stderr.
+ */
+bool parse_hop_plot_part( const char *option, uint32_t *part, uint32_t *num_parts ) {
+	unsigned long i = 0, parts = 0;
+	char trailing;
+	if( sscanf( option, "%lu/%lu%c", &i, &parts, &trailing ) != 2 || i >= parts || parts > UINT32_MAX ) {
+		std::cerr << std::endl
+			<< "	-hop-plot-part expects i/N with 0 <= i < N (or mpi)" << std::endl;
+		return false;
+	}
+	*part = static_cast< uint32_t >( i );
+	*num_parts = static_cast< uint32_t >( parts );
+	return true;
+}
+
+/**
+ * Parses the -alpha-sweep option, a comma-separated list of thresholds.
+ * @param sweep The value of the -alpha-sweep option.
+ * @param alphas The distinct thresholds, each as given and as a number, from
+ * the loosest (largest) to the tightest (smallest).
+ * @return False if sweep is malformed or any threshold is not positive, in
+ * which case an error message is echoed to stderr.
+ */
+bool parse_alpha_sweep( const char *sweep, std::vector< std::pair< std::string, float > > *alphas ) {
+	alphas->clear();
+	for( const char *c = sweep; c != NULL; ) {
+		char *end;
+		const float alpha = strtof( c, &end );
+		if( end == c || !( alpha > 0 ) || ( *end != ',' && *end != '\0' ) ) {
+			std::cerr << std::endl
+				<< "\t-alpha-sweep expects a comma-separated list of positive thresholds"
+				<< " (e.g., 0.2,0.15,0.1)" << std::endl;
+			return false;
+		}
+		alphas->push_back( std::make_pair( std::string( c, end - c ), alpha ) );
+		c = ( *end == ',' ? end + 1 : NULL );
+	}
+	std::stable_sort( alphas->begin(), alphas->end(),
+		[]( std::pair< std::string, float > const& a, std::pair< std::string, float > const& b ) {
+			return a.second > b.second; } );
+	alphas->erase( std::unique( alphas->begin(), alphas->end(),
+		[]( std::pair< std::string, float > const& a, std::pair< std::string, float > const& b ) {
+			return a.second == b.second; } ), alphas->end() );
+	return true;
+}
+
+/**
+ * Names the output file of one level of a sweep, by replacing the first
+ * placeholder (e.g., "%k") in the -o option with value or, if there is none,
+ * appending suffix and value (e.g., ".k5").
+ */
+std::string sweep_output_filename( std::string pattern, const char *placeholder,
+	const char *suffix, std::string const& value ) {
+	const size_t position = pattern.find( placeholder );
+	if( position == std::string::npos ) { return pattern + suffix + value; }
+	return pattern.replace( position, strlen( placeholder ), value );
+}
+
+/**
+ * Anonymises one graph for every k of a -k-sweep. The degree sequence is
+ * computed once and each k is planned in parallel, then a table of the cost
+ * of every k is echoed to stdout. Each k's anonymised graph is a GraphOverlay
+ * of the (shared, unmodified) input graph, which is verified to be
+ * k-degree-anonymous with -hide-additional, written out with -o, and
+ * measured against the input graph with -report.
+ * @param g The input graph.
+ * @param sweep The value of the -k-sweep option.
+ * @param io_format The format of the input file, in which output files are
+ * written unless -oformat says otherwise.
+ * @returns As for run_identity_mode().
+ */
+uint32_t run_k_sweep( UnlabelledGraph const *g, int argc, char** argv, const char *sweep,
+	const graphAnon::FileFormat io_format ) {
+
+	std::vector< uint32_t > ks;
+	if( !parse_k_sweep( sweep, g->num_vertices(), &ks ) ) { return 1; }
+
+	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
+	graphAnon::FileFormat format;
+	bool varint;
+	graphAnon::Compression compression;
+	if( output_filename != NULL
+			&& !parse_output_options( argc, argv, io_format, &format, &varint, &compression ) ) {
+		return 1;
+	}
+
+	char *report_filename;
+	graphAnon::ReportFormat report_format;
+	HopPlotOptions hop_plot_options;
+	if( !parse_report( argc, argv, &report_filename, &report_format )
+			|| !parse_hop_plot_options( argc, argv, &hop_plot_options ) ) {
+		return 1;
+	}
+	if( report_filename != NULL && !test_analyses() ) { return 2; }
+
+	const bool hide_all = getCmdOption( argv, argv + argc, "-hide-additional", false ) != NULL;
+	DegreeSequence const degrees = g->retrieve_degree_sequence();
+	std::vector< IdentityPlan > const plans = plan_identity_sweep( degrees, ks, hide_all );
+
+	std::cout << "k\tmax_deficiency\tnew_vertices\tnew_edges" << std::endl;
+	for( auto const& plan : plans ) {
+		std::cout << plan.k() << "\t" << plan.max_deficiency() << "\t"
+			<< plan.num_new_vertices() << "\t" << plan.num_new_edges() << std::endl;
+	}
+
+	if( output_filename == NULL && report_filename == NULL && !hide_all ) { return 0; }
+
+	std::shared_ptr< const CsrGraph > const base = g->snapshot();
+	std::unique_ptr< UtilityReport > report;
+	if( report_filename != NULL ) {
+		report.reset( new UtilityReport( *base, parse_sc_tolerance( argc, argv ), hop_plot_options ) );
+	}
+	for( auto const& plan : plans ) {
+		GraphOverlay overlay( base );
+		overlay.apply( plan, degrees );
+		if( hide_all && !overlay.is_anonymous( plan.k() ) ) {
+			std::cerr << "The instance for k = " << plan.k() << " was evidently not solved."
+				<< std::endl;
+			return 2;
+		}
+		if( report ) { report->add_output( "k=" + std::to_string( plan.k() ), overlay ); }
+		if( output_filename == NULL ) { continue; }
+		const std::string filename = sweep_output_filename( output_filename, "%k", ".k",
+			std::to_string( plan.k() ) );
+		if( !overlay.write( filename, format, varint, compression ) ) {
+			std::cerr << "Could not write output file " << filename << std::endl;
+			return 1;
+		}
+	}
+	if( report && !write_report( *report, report_filename, report_format ) ) { return 1; }
+	return 0;
+}
+
 void print_usage_instructions( const char *bin_path ) {
 	std::cout << "Usage: "
 			<< bin_path << " [-option value]" << std::endl << std::endl;
 	std::cout << "\tPossible options include:" << std::endl;
 	std::cout << "\t\t[-h] or [--help] shows these usage instructions" << std::endl;
-	std::cout << "\t\t[-mode {identity,attribute} [type of anonymization to conduct]]" << std::endl;
+	std::cout << "\t\t[-mode {identity,attribute,hop-plot,serve} [type of anonymization to conduct, "
+		<< "only the exact hop plot, APL, and HM of the input, or a service that keeps graphs "
+		<< "loaded across requests]]" << std::endl;
 	std::cout << "\t\t[-f [path to input file]]" << std::endl;
-	std::cout << "\t\t[-format {adjList, edgeList, adjListVL} [format to read/write "
-		<< "input/output files (adjList by default)]]" << std::endl;
+	std::cout << "\t\t[-format {adjList, edgeList, adjListVL, binary} [format to read/write "
+		<< "input/output files (adjList by default; adjListVL or binary in attribute mode)]]" << std::endl;
 	std::cout << "\t\t[-o [path to output file]]" << std::endl;
+	std::cout << "\t\t[-oformat {adjList, edgeList, adjListVL, binary} [format of the output "
+		<< "file, if different to -format]]" << std::endl;
+	std::cout << "\t\t[-varint [delta+varint compresses binary output files]]" << std::endl;
+	std::cout << "\t\t[-compress {none, gzip, zstd} [streaming compression of ascii output "
+		<< "files (if supported by this build)]]" << std::endl;
 	std::cout << "\t\t[-k [identity privacy threshold]]" << std::endl;
+	std::cout << "\t\t[-k-sweep first:last[:step] [anonymises for every k in the range, "
+		<< "echoing the cost of each to stdout and, with -o, writing each to the output "
+		<< "path with \"%k\" replaced by k (or ending in .k<k>)]]" << std::endl;
 	std::cout << "\t\t[-alpha [attribute privacy threshold]]" << std::endl;
+	std::cout << "\t\t[-alpha-sweep a1,a2,... [anonymises for every alpha, from the loosest "
+		<< "to the tightest, each resuming from the last, echoing the cost of each to stdout "
+		<< "and, with -o, writing each to the output path with \"%a\" replaced by alpha (or "
+		<< "ending in .alpha<alpha>)]]" << std::endl;
 	std::cout << "\t\t[-n [number of vertices in random graph]]" << std::endl;
 	std::cout << "\t\t[-occ [occupancy rate in random graph (i.e., percentage of possible edges)]]" << std::endl;
 	std::cout << "\t\t[-l [label set size in random graph]]" << std::endl;
+	std::cout << "\t\t[-random-model {gnm, gnp} [exactly occ of the possible edges "
+		<< "(gnm, by default) or each one with probability occ (gnp)]]" << std::endl;
+	std::cout << "\t\t[-seed [seed for every random choice (the current time by default)]]"
+		<< std::endl;
+	std::cout << "\t\t[-reorder {none, degree, rcm, gorder} [relabels the vertices for locality "
+		<< "once loaded; output files keep the input ids (not with -k-sweep or -streaming)]]"
+		<< std::endl;
 	std::cout << "\t\t[-stats [enables printing of graph properties to stdout]]" << std::endl;
-	std::cout << "\t\t[-hide-additional [enables the anonymisation of newly added vertices]]" << std::endl << std::endl;
+	std::cout << "\t\t[-sc {sparse, dense} [method for subgraph centrality in -stats "
+		<< "(sparse Lanczos estimate by default; dense is exact but O(n^3))]]" << std::endl;
+	std::cout << "\t\t[-sc-tol [relative standard error of the sparse subgraph "
+		<< "centrality estimate (0.001 by default)]]" << std::endl;
+	std::cout << "\t\t[-report [path to which to write the statistics of the input and output "
+		<< "graphs, and their differences]]" << std::endl;
+	std::cout << "\t\t[-report-format {json, csv} [format of the -report file (csv if its "
+		<< "path ends in .csv, else json, by default)]]" << std::endl;
+	std::cout << "\t\t[-hop-plot {exact, sampled, sketch} [method for the hop plot, APL, and "
+		<< "HM in -stats and -report (exact all-pairs BFS by default)]]" << std::endl;
+	std::cout << "\t\t[-hop-plot-samples [number of BFS sources for -hop-plot sampled "
+		<< "(4096 by default)]]" << std::endl;
+	std::cout << "\t\t[-sketch-registers [HyperLogLog registers per vertex for -hop-plot "
+		<< "sketch, a power of two (64 by default)]]" << std::endl;
+	std::cout << "\t\t[-hop-plot-part {i/N, mpi} [in hop-plot mode, searches only from the i'th "
+		<< "of N shares of the vertices and writes the partial hop plot to -o (or stdout); "
+		<< "or, with mpi, splits the search across the MPI ranks]]" << std::endl;
+	std::cout << "\t\t[-merge file1,file2,... [in hop-plot mode, sums the partial hop plots "
+		<< "of every part instead of reading a graph]]" << std::endl;
+	std::cout << "\t\t[-requests [in serve mode, path (e.g., a named pipe) from which to read "
+		<< "requests, one per line (stdin by default)]]" << std::endl;
+	std::cout << "\t\t[-profile [path to which to write the time spent in each phase of the run "
+		<< "and counts of its costliest events, or - for stderr]]" << std::endl;
+	std::cout << "\t\t[-profile-format {json, csv} [format of the -profile output (csv if its "
+		<< "path ends in .csv, else json, by default)]]" << std::endl;
+	std::cout << "\t\t[-hide-additional [enables the anonymisation of newly added vertices]]" << std::endl;
+	std::cout << "\t\t[-parallel [runs the attribute mode's greedy algorithm on every OpenMP thread]]" << std::endl;
+	std::cout << "\t\t[-streaming [runs the identity mode in two passes over an edgeList "
+		<< "file, in O(n) memory (requires -format edgeList and -o, and each edge u v "
+		<< "on one line with u < v, sorted by u and then v)]]" << std::endl << std::endl;
 	std::cout << "\tNote that if an input file is specified, all random graph parametres are ignored. " << std::endl
 			<< "\tIf no input file is specified, -n, -occ, and -l are mandatory. " << std::endl
-			<< "\t-alpha, the privacy threshold, is always mandatory." << std::endl << std::endl;
+			<< "\t-alpha (or -alpha-sweep), the privacy threshold, is mandatory in attribute mode." << std::endl << std::endl;
 	std::cout << "\tExample usage:" << std::endl;
 	std::cout << "\t\t" << bin_path << " -mode attribute -alpha 0.10001 -f ./workloads/asonam11_example.adjList -o private_graph.adjList" << std::endl;
 	std::cout << "\t\t" << bin_path << " -mode attribute -alpha 0.05 -n 100 -occ .01 -l 2" << std::endl << std::endl;
@@ -99,17 +743,47 @@ void print_usage_instructions( const char *bin_path ) {
  * Echoes to stdout statistics (namely clustering coefficient, 
  * hop plot, and average path length) for a graph.
  * @param g The graph for which to print out statistics.
+ * @param argc The number of command line arguments provided by the user
+ * @param argv An array of strings, each string containing a command
+ * line argument (consulted for the -sc and -sc-tol options).
+ * @param hop_plot_options How to compute the hop plot. A sampled hop plot is
+ * followed by the 95% confidence half-width of each of its counts (HPCI).
  */
-void inline print_stats( UnlabelledGraph *g ) {
+void inline print_stats( UnlabelledGraph *g, int argc, char** argv,
+	HopPlotOptions const& hop_plot_options ) {
+	GRAPHANON_PROFILE_PHASE( "stats" );
+	g->freeze(); /* analysis routines run over the immutable CSR snapshot */
 	std::cout << "|V|: " << g->num_vertices() << std::endl;
 	std::cout << "|E|: " << g->num_edges() << std::endl;
 	std::cout << "Occ: " << g->get_occupancy() << std::endl;
-	std::cout << " CC: " << g->clustering_coefficient() << std::endl;
-	std::cout << " SC: " << g->subgraph_centrality( 120 ) << std::endl;
-	HopPlot hop_plot = g->hop_plot();
+	{
+		GRAPHANON_PROFILE_PHASE( "clustering_coefficient" );
+		std::cout << " CC: " << g->clustering_coefficient() << std::endl;
+	}
+	{
+		GRAPHANON_PROFILE_PHASE( "subgraph_centrality" );
+		char *sc_method = getCmdOption( argv, argv + argc, "-sc", true );
+		if( sc_method != NULL && strcmp( sc_method, "dense" ) == 0 ) {
+			std::cout << " SC: " << g->subgraph_centrality( 120 ) << std::endl;
+		}
+		else {
+			std::cout << " SC: " << g->sparse_subgraph_centrality( parse_sc_tolerance( argc, argv ) ) << std::endl;
+		}
+	}
+	HopPlotError error;
+	HopPlot hop_plot;
+	{
+		GRAPHANON_PROFILE_PHASE( "hop_plot" );
+		hop_plot = graphAnon::estimate_hop_plot( g->csr(), hop_plot_options, &error );
+	}
 	std::cout << " HP: ";
 	for( auto it = hop_plot.begin(); it != hop_plot.end(); ++it ) { std::cout << it->first << ":" << it->second << " "; }
 	std::cout << std::endl;
+	if( !error.empty() ) {
+		std::cout << "HPCI: ";
+		for( auto it = error.begin(); it != error.end(); ++it ) { std::cout << it->first << ":" << it->second << " "; }
+		std::cout << std::endl;
+	}
 	std::cout << "APL: " << g->average_path_length< true >( &hop_plot ) << std::endl;
 	std::cout << " HM: " << g->harmonic_mean( hop_plot ) << std::endl;
 }
@@ -117,7 +791,10 @@ void inline print_stats( UnlabelledGraph *g ) {
 
 /**
  * Runs the software to create a alpha-proximal graph, 
- * according to command-line specifications.
+ * according to command-line specifications. With -alpha-sweep, the graph is
+ * made alpha-proximal for every alpha in turn, from the loosest to the
+ * tightest, and the edges added at each level are echoed to stdout and (with
+ * -o) the graph is written out at each level.
  * @param argc The number of command line arguments provided by the user
  * @param argv An array of strings, each string containing a command
  * line argument.
@@ -132,17 +809,53 @@ uint32_t run_attribute_mode( int argc, char** argv ) {
 
 	char *filename = getCmdOption( argv, argv + argc, "-f", true );
 	char *alpha = getCmdOption( argv, argv + argc, "-alpha", true );
-	if( alpha == 0 ) {
+	char *alpha_sweep = getCmdOption( argv, argv + argc, "-alpha-sweep", true );
+	if( alpha == 0 && alpha_sweep == 0 ) {
 
 		//print_usage_instructions( *argv );
 		std::cerr << std::endl
 				<< "\tYou must specify a value for alpha (e.g., -alpha 0.1)"
+				<< " or a list of them (e.g., -alpha-sweep 0.2,0.1)"
 				<< std::endl;
 		return 1;
 	}
+
+	/* A single alpha is a sweep of one level, written to -o as is. */
+	std::vector< std::pair< std::string, float > > alphas;
+	if( alpha_sweep == 0 ) { alphas.push_back( std::make_pair( std::string( alpha ), atof( alpha ) ) ); }
+	else if( !parse_alpha_sweep( alpha_sweep, &alphas ) ) { return 1; }
+	else if( getCmdOption( argv, argv + argc, "-stats", false ) != NULL ) {
+		std::cerr << std::endl
+				<< "\t-stats is not supported with -alpha-sweep" << std::endl;
+		return 1;
+	}
+	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
+	graphAnon::FileFormat output_format;
+	bool varint;
+	graphAnon::Compression compression;
+	if( alpha_sweep != 0 && output_filename != NULL && !parse_output_options( argc, argv,
+			graphAnon::FileFormat::adjacencyList, &output_format, &varint, &compression ) ) {
+		return 1;
+	}
+	graphAnon::VertexOrder order;
+	if( !parse_vertex_order( argc, argv, &order ) ) { return 1; }
 	if( filename != 0 ) {
-		g = new LabelledGraph( filename );
+		graphAnon::FileFormat input_format = graphAnon::FileFormat::adjacencyListVertexLabelled;
+		char *format = getCmdOption( argv, argv + argc, "-format", true );
+		if( format != 0 && !parse_format( format, &input_format ) ) { return 1; }
+		if( input_format != graphAnon::FileFormat::adjacencyListVertexLabelled
+				&& input_format != graphAnon::FileFormat::binary ) {
+			std::cerr << std::endl
+				<< "\tAttribute mode requires a vertex-labelled input (adjListVL or binary)."
+				<< std::endl;
+			return 1;
+		}
+		g = new LabelledGraph( filename, input_format );
 		assert( g != NULL );
+		if( !check_loaded( filename, *g ) ) {
+			delete g;
+			return 1;
+		}
 	}
 	else {
 		/* Gather parametres for a random graph */
@@ -157,8 +870,10 @@ uint32_t run_attribute_mode( int argc, char** argv ) {
 		if( n > 0 && occ > 0 && l > 0 ) {
 			g = new LabelledGraph( n, l );
 			g->evenly_distribute_labels();
-			const uint32_t num_edges = occ * n * ( n - 1 ) / 2; /* 1/2 b/c undirected */
-			g->populate_uniformly( num_edges );
+			if( !populate_random_graph( g, argc, argv, occ ) ) {
+				delete g;
+				return 1;
+			}
 		}
 		else {
 			//print_usage_instructions( *argv );
@@ -170,40 +885,89 @@ uint32_t run_attribute_mode( int argc, char** argv ) {
 			return 1;
 		}
 	}
+	g->reorder( order );
 
-	/* Run unit tests first. */
-	if( !test_distance() ) {
-		std::cerr << "Failed unit test of LabelDistribution" <<
-				" distance function! Aborting." << std::endl;
-				
+	/* Run unit tests first, without profiling them. */
+	if( !test_attribute() ) {
 		delete g;
 		return 2;
 	}
-	
 
-	/* Execute algorithm. */
-	g->greedy( atof( alpha ) );
-	if( !g->is_alpha_proximal( atof( alpha ) ) ) {
-		std::cerr << "This instance was evidently not solved. ";
-		std::cerr << "The software must have a bug? ";
-		std::cerr << "You should contact the developer.";
-		
+	/* If requested, measure the input graph before anonymising it. */
+	char *report_filename;
+	graphAnon::ReportFormat report_format;
+	HopPlotOptions hop_plot_options;
+	if( !parse_report( argc, argv, &report_filename, &report_format )
+			|| !parse_hop_plot_options( argc, argv, &hop_plot_options ) ) {
 		delete g;
-		return 2;
+		return 1;
+	}
+	std::unique_ptr< UtilityReport > report;
+	std::shared_ptr< const CsrGraph > input;
+	if( report_filename != NULL ) {
+		if( !test_analyses() ) {
+			delete g;
+			return 2;
+		}
+		GRAPHANON_PROFILE_PHASE( "report_input" );
+		input = g->snapshot();
+		report.reset( new UtilityReport( *input, parse_sc_tolerance( argc, argv ), hop_plot_options ) );
+	}
+
+	/* Execute algorithm, from the loosest alpha to the tightest: every level
+	 * is also proximal for the looser ones, so each resumes from the edges
+	 * (and the label histograms) of the last. */
+	const bool parallel = getCmdOption( argv, argv + argc, "-parallel", false ) != NULL;
+	if( alpha_sweep != 0 ) { std::cout << "alpha\tnew_edges\tedges" << std::endl; }
+	for( auto const& level : alphas ) {
+		const uint64_t num_edges = g->num_edges();
+		if( parallel ) { g->parallel_greedy( level.second ); }
+		else { g->greedy( level.second ); }
+		if( !g->verify_alpha_proximal( level.second ) ) {
+			std::cerr << "This instance was evidently not solved. ";
+			std::cerr << "The software must have a bug? ";
+			std::cerr << "You should contact the developer.";
+
+			delete g;
+			return 2;
+		}
+
+		if( report ) {
+			GRAPHANON_PROFILE_PHASE( "report_output" );
+			report->add_output( "alpha=" + level.first, GraphOverlay::difference( input, g->csr() ) );
+		}
+		if( alpha_sweep == 0 ) { continue; }
+		std::cout << level.first << "\t" << g->num_edges() - num_edges << "\t" << g->num_edges()
+			<< std::endl;
+		if( output_filename == NULL ) { continue; }
+		GRAPHANON_PROFILE_PHASE( "write" );
+		const std::string filename = sweep_output_filename( output_filename, "%a", ".alpha", level.first );
+		if( !g->write( filename, output_format, varint, compression ) ) {
+			std::cerr << "Could not write output file " << filename << std::endl;
+			delete g;
+			return 1;
+		}
+	}
+	if( report && !write_report( *report, report_filename, report_format ) ) {
+		delete g;
+		return 1;
 	}
 
 	/* If requested in command line args, echo to stdout the orig graph stats. */
 	char *stats = getCmdOption( argv, argv + argc, "-stats", false );
-	if( stats != NULL ) { print_stats( g ); }
+	if( stats != NULL ) {
+		if( !test_analyses() ) {
+			delete g;
+			return 2;
+		}
+		print_stats( g, argc, argv, hop_plot_options );
+	}
 
 
 	/* If requested in command line args, write output Graph to file. */
-	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
-	if( output_filename != NULL ) {
-		std::ofstream outfile;
-		outfile.open( output_filename );
-		outfile << *g;
-		outfile.close();
+	if( alpha_sweep == 0 && !write_output( g, argc, argv, graphAnon::FileFormat::adjacencyList ) ) {
+		delete g;
+		return 1;
 	}
 	
 	/* clean up. */
@@ -212,6 +976,66 @@ uint32_t run_attribute_mode( int argc, char** argv ) {
 }
 
 
+/**
+ * Runs the identity mode over an edge list file in two streaming passes,
+ * without loading the graph into memory.
+ * @param argc The number of command line arguments provided by the user
+ * @param argv An array of strings, each string containing a command
+ * line argument.
+ * @param k The privacy threshold.
+ * @returns As for run_identity_mode().
+ * @see StreamingIdentityAnonymiser
+ */
+uint32_t run_streaming_identity_mode( int argc, char** argv, const uint32_t k ) {
+
+	char *filename = getCmdOption( argv, argv + argc, "-f", true );
+	char *format = getCmdOption( argv, argv + argc, "-format", true );
+	char *output_format = getCmdOption( argv, argv + argc, "-oformat", true );
+	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
+	if( filename == 0 || output_filename == 0 || format == 0 || strcmp( format, "edgeList" ) != 0
+			|| ( output_format != 0 && strcmp( output_format, "edgeList" ) != 0 ) ) {
+		std::cerr << std::endl
+				<< "\t-streaming requires an input file in edgeList format and an "
+				<< "output file (e.g., -f in.edges -format edgeList -o out.edges)"
+				<< std::endl;
+		return 1;
+	}
+	if( getCmdOption( argv, argv + argc, "-stats", false ) != NULL
+			|| getCmdOption( argv, argv + argc, "-report", true ) != NULL ) {
+		std::cerr << std::endl
+				<< "\t-stats and -report are not supported with -streaming" << std::endl;
+		return 1;
+	}
+	graphAnon::Compression compression;
+	if( !parse_compression( argc, argv, &compression ) ) { return 1; }
+
+	StreamingIdentityAnonymiser anonymiser( filename );
+	if( !anonymiser.count_degrees() ) {
+		if( !anonymiser.is_canonical() ) {
+			std::cerr << "-streaming requires each edge on exactly one line, as u v with "
+					<< "u < v, in ascending order of u and then v. Did the input list an "
+					<< "edge in both directions, or more than once?" << std::endl;
+			return 1;
+		}
+		std::cerr << "Did not parse a positive number of vertices from input file. "
+				<< "Did you format the file correctly and specify the correct path?"
+				<< std::endl;
+		return 1;
+	}
+	const bool hide_all = getCmdOption( argv, argv + argc, "-hide-additional", false ) != NULL;
+	if( !anonymiser.anonymise( k, hide_all ) ) {
+		std::cerr << "This instance was evidently not solved. ";
+		std::cerr << "Did you ensure k <= n?" << std::endl;
+		return 2;
+	}
+	if( !anonymiser.write( output_filename, compression ) ) {
+		std::cerr << "Could not write output file " << output_filename << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+
 /**
  * Runs the software to create a k-degree-anonymous graph, 
  * according to command-line specifications.
@@ -226,38 +1050,52 @@ uint32_t run_attribute_mode( int argc, char** argv ) {
 uint32_t run_identity_mode( int argc, char** argv ) {
 
 	UnlabelledGraph *g;
+	graphAnon::FileFormat io_format = graphAnon::FileFormat::adjacencyList;
 
 	char *filename = getCmdOption( argv, argv + argc, "-f", true );
 	char *k = getCmdOption( argv, argv + argc, "-k", true );
+	char *k_sweep = getCmdOption( argv, argv + argc, "-k-sweep", true );
 	
 	
-	if( k == 0 ) {
+	if( k == 0 && k_sweep == 0 ) {
 
 		std::cerr << std::endl
 				<< "\tYou must specify a privacy threshold, k (e.g., -k 5)"
+				<< " or a range of them (e.g., -k-sweep 2:10)"
 				<< std::endl;
 		return 1;
 	}
+	if( k_sweep != 0 && ( getCmdOption( argv, argv + argc, "-stats", false ) != NULL
+			|| getCmdOption( argv, argv + argc, "-streaming", false ) != NULL ) ) {
+		std::cerr << std::endl
+				<< "\t-stats and -streaming are not supported with -k-sweep" << std::endl;
+		return 1;
+	}
+	graphAnon::VertexOrder order;
+	if( !parse_vertex_order( argc, argv, &order ) ) { return 1; }
+	if( order != graphAnon::VertexOrder::none && ( k_sweep != 0
+			|| getCmdOption( argv, argv + argc, "-streaming", false ) != NULL ) ) {
+		std::cerr << std::endl
+				<< "\t-reorder is not supported with -k-sweep or -streaming" << std::endl;
+		return 1;
+	}
+
+	/* Run unit tests first, without profiling them. */
+	if( !test_identity() ) { return 2; }
+
+	if( getCmdOption( argv, argv + argc, "-streaming", false ) != NULL ) {
+		return run_streaming_identity_mode( argc, argv, atoi( k ) );
+	}
 	
 	if( filename != 0 ) {
 		char *format = getCmdOption( argv, argv + argc, "-format", true );
-		if( format == 0 || strcmp( format, "adjList" ) == 0 ) {
-			g = new UnlabelledGraph( filename, graphAnon::FileFormat::adjacencyList );
-		}
-		else if( strcmp( format, "edgeList" ) == 0 ) {
-			g = new UnlabelledGraph( filename, graphAnon::FileFormat::edgeList );
-		}
-		else if( strcmp( format, "adjListVL" ) == 0 ) {
-			g = new UnlabelledGraph( filename, graphAnon::FileFormat::adjacencyListVertexLabelled );
-		}
-		else {
-			std::cerr << std::endl
-				<< "\tFormat \"" << format << "\" not supported."
-				<< std::endl;
-			
+		if( format != 0 && !parse_format( format, &io_format ) ) { return 1; }
+		g = new UnlabelledGraph( filename, io_format );
+		assert( g != NULL );
+		if( !check_loaded( filename, *g ) ) {
+			delete g;
 			return 1;
 		}
-		assert( g != NULL );
 	}
 	else {
 		/* Gather parametres for a random graph */
@@ -269,8 +1107,10 @@ uint32_t run_identity_mode( int argc, char** argv ) {
 		
 		if( n > 0 && occ > 0 ) {
 			g = new UnlabelledGraph( n );
-			const uint32_t num_edges = occ * n * ( n - 1 ) / 2; /* 1/2 b/c undirected */
-			g->populate_uniformly( num_edges );
+			if( !populate_random_graph( g, argc, argv, occ ) ) {
+				delete g;
+				return 1;
+			}
 		}
 		else {
 			std::cerr << std::endl
@@ -282,7 +1122,35 @@ uint32_t run_identity_mode( int argc, char** argv ) {
 		}
 		assert( g != NULL );
 	}
+	g->reorder( order );
 	
+	if( k_sweep != 0 ) {
+		const uint32_t result = run_k_sweep( g, argc, argv, k_sweep, io_format );
+		delete g;
+		return result;
+	}
+
+	/* If requested, measure the input graph before anonymising it. */
+	char *report_filename;
+	graphAnon::ReportFormat report_format;
+	HopPlotOptions hop_plot_options;
+	if( !parse_report( argc, argv, &report_filename, &report_format )
+			|| !parse_hop_plot_options( argc, argv, &hop_plot_options ) ) {
+		delete g;
+		return 1;
+	}
+	std::unique_ptr< UtilityReport > report;
+	std::shared_ptr< const CsrGraph > input;
+	if( report_filename != NULL ) {
+		if( !test_analyses() ) {
+			delete g;
+			return 2;
+		}
+		GRAPHANON_PROFILE_PHASE( "report_input" );
+		input = g->snapshot();
+		report.reset( new UtilityReport( *input, parse_sc_tolerance( argc, argv ), hop_plot_options ) );
+	}
+
 	/* Determine whether or not all vertices should be hidden. */
 	char *hide_all = getCmdOption( argv, argv + argc, "-hide-additional", false );
 	
@@ -299,17 +1167,29 @@ uint32_t run_identity_mode( int argc, char** argv ) {
 	}
 	else { g->hide_waldo< false >( atoi( k ) ); }
 
+	if( report ) {
+		GRAPHANON_PROFILE_PHASE( "report_output" );
+		report->add_output( std::string( "k=" ) + k, GraphOverlay::difference( input, g->csr() ) );
+		if( !write_report( *report, report_filename, report_format ) ) {
+			delete g;
+			return 1;
+		}
+	}
+
 	/* If requested in command line args, echo to stdout the anon graph stats. */
 	char *stats = getCmdOption( argv, argv + argc, "-stats", false );
-	if( stats != NULL ) { print_stats( g ); }
+	if( stats != NULL ) {
+		if( !test_analyses() ) {
+			delete g;
+			return 2;
+		}
+		print_stats( g, argc, argv, hop_plot_options );
+	}
 	
 	/* If requested in command line args, write output Graph to file. */
-	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
-	if( output_filename != NULL ) {
-		std::ofstream outfile;
-		outfile.open( output_filename );
-		outfile << *g;
-		outfile.close();
+	if( !write_output( g, argc, argv, io_format ) ) {
+		delete g;
+		return 1;
 	}
 	
 	/* clean up. */
@@ -317,6 +1197,322 @@ uint32_t run_identity_mode( int argc, char** argv ) {
 	return 0;
 }
 
+/**
+ * Runs the software to compute the exact hop plot of a graph, APL, and HM,
+ * optionally split into shares of the BFS sources so that the all-pairs
+ * search can run in several processes (or on several machines). With
+ * -hop-plot-part i/N, only the i'th of N shares of the sources is searched,
+ * and the partial hop plot is written to the output file (or stdout), to be
+ * summed by a later run with -merge; with -hop-plot-part mpi, every MPI
+ * rank searches its own share and rank 0 reports the sum.
+ * @param argc The number of command line arguments provided by the user
+ * @param argv An array of strings, each string containing a command
+ * line argument.
+ * @returns <ul><li>0 on successful computation</li>
+ * <li>1 if there is an error in the user input</li>
+ * <li>2 if there is a software error (a unit test fails)</li></ul>
+ */
+uint32_t run_hop_plot_mode( int argc, char** argv ) {
+
+	char *merge = getCmdOption( argv, argv + argc, "-merge", true );
+	char *part_option = getCmdOption( argv, argv + argc, "-hop-plot-part", true );
+	char *filename = getCmdOption( argv, argv + argc, "-f", true );
+	char *output = getCmdOption( argv, argv + argc, "-o", true );
+	HopPlotPart result;
+
+	if( merge != NULL ) {
+		if( part_option != NULL || filename != NULL ) {
+			std::cerr << std::endl
+					<< "	-merge sums part files, and so takes neither -f nor -hop-plot-part"
+					<< std::endl;
+			return 1;
+		}
+		std::vector< HopPlotPart > parts;
+		for( const char *c = merge; c != NULL; ) {
+			const char *end = strchr( c, ',' );
+			const std::string part_filename = end == NULL ? std::string( c ) : std::string( c, end - c );
+			std::ifstream in( part_filename );
+			parts.push_back( HopPlotPart() );
+			if( !in || !graphAnon::read_hop_plot_part( &in, &parts.back() ) ) {
+				std::cerr << "Could not read hop plot part " << part_filename << std::endl;
+				return 1;
+			}
+			c = ( end == NULL ? NULL : end + 1 );
+		}
+		if( !graphAnon::merge_hop_plot_parts( parts, &result ) ) {
+			std::cerr << std::endl
+					<< "	-merge needs exactly one of each part of the same graph" << std::endl;
+			return 1;
+		}
+	}
+	else {
+		const bool use_mpi = part_option != NULL && strcmp( part_option, "mpi" ) == 0;
+		uint32_t part = 0, num_parts = 1;
+		if( use_mpi && !graphAnon::mpi_available() ) {
+			std::cerr << std::endl
+					<< "	-hop-plot-part mpi is not supported by this build" << std::endl;
+			return 1;
+		}
+		if( part_option != NULL && !use_mpi && !parse_hop_plot_part( part_option, &part, &num_parts ) ) {
+			return 1;
+		}
+		graphAnon::VertexOrder order;
+		if( !parse_vertex_order( argc, argv, &order ) ) { return 1; }
+		if( filename == NULL ) {
+			std::cerr << std::endl
+					<< "	You must provide an input file (-f) or part files to -merge"
+					<< std::endl;
+			return 1;
+		}
+
+		/* Run unit tests first, without profiling them. */
+		if( !test_analyses() ) { return 2; }
+		{
+			GRAPHANON_PROFILE_PAUSE();
+			if( !test_hop_plot_partition() ) {
+				std::cerr << "Failed unit test of the hop plot partition! Aborting." << std::endl;
+				return 2;
+			}
+		}
+
+		graphAnon::FileFormat io_format = graphAnon::FileFormat::adjacencyList;
+		char *format = getCmdOption( argv, argv + argc, "-format", true );
+		if( format != 0 && !parse_format( format, &io_format ) ) { return 1; }
+		UnlabelledGraph g( filename, io_format );
+		if( !check_loaded( filename, g ) ) { return 1; }
+		g.reorder( order );
+		g.freeze();
+
+		GRAPHANON_PROFILE_PHASE( "hop_plot" );
+		if( use_mpi ) {
+			bool is_root;
+			if( !graphAnon::mpi_hop_plot( g.csr(), &result, &is_root ) ) {
+				std::cerr << "Could not compute the hop plot with MPI" << std::endl;
+				return 2;
+			}
+			if( !is_root ) { return 0; }
+		}
+		else {
+			result = graphAnon::partial_hop_plot( g.csr(), part, num_parts );
+		}
+	}
+
+	/* A partial hop plot is only of use to -merge; the whole one is reported. */
+	if( output != NULL ) {
+		std::ofstream out( output );
+		graphAnon::write_hop_plot_part( result, &out );
+		if( !out ) {
+			std::cerr << "Could not write hop plot file " << output << std::endl;
+			return 1;
+		}
+	}
+	if( result.num_parts > 1 ) {
+		if( output == NULL ) { graphAnon::write_hop_plot_part( result, &std::cout ); }
+		return 0;
+	}
+	std::cout << " HP: ";
+	for( auto it = result.hop_plot.begin(); it != result.hop_plot.end(); ++it ) {
+		std::cout << it->first << ":" << it->second << " ";
+	}
+	std::cout << std::endl;
+	std::cout << "APL: " << graphAnon::average_path_length( result.hop_plot, result.num_vertices, true )
+		<< std::endl;
+	std::cout << " HM: " << graphAnon::harmonic_mean( result.hop_plot, result.num_vertices ) << std::endl;
+	return 0;
+}
+
+/**
+ * Appends the metrics of a graph to a response of the service mode, as
+ * space-separated key=value fields (except |V| and |E|).
+ */
+void append_metrics( UtilityMetrics const& metrics, std::ostringstream *response ) {
+	*response << " cc=" << metrics.clustering_coefficient << " sc=" << metrics.subgraph_centrality
+		<< " apl=" << metrics.average_path_length << " hm=" << metrics.harmonic_mean << " hp=";
+	for( auto it = metrics.hop_plot.begin(); it != metrics.hop_plot.end(); ++it ) {
+		*response << ( it == metrics.hop_plot.begin() ? "" : "," ) << it->first << ":" << it->second;
+	}
+}
+
+/**
+ * Handles one request of the service mode: a command and a graph name,
+ * followed by options as on the command line; e.g.,
+ * "identity g -k 5 -o g.k5.adjList -stats".
+ * @param service The loaded graphs.
+ * @param words The whitespace-separated words of the request.
+ * @param response Set to the one-line response: "ok" followed by any
+ * key=value results, or "error" followed by a message.
+ */
+void serve_request( GraphService *service, std::vector< std::string > &words,
+	std::ostringstream *response ) {
+
+	std::vector< char* > args;
+	for( std::string &word : words ) { args.push_back( &word[ 0 ] ); }
+	const int argc = args.size();
+	char **argv = args.data();
+	std::string const& command = words[ 0 ];
+	if( words.size() < 2 || words[ 1 ][ 0 ] == '-' ) {
+		*response << "error " << command << " expects a graph name";
+		return;
+	}
+	std::string const& name = words[ 1 ];
+	std::string error;
+
+	if( command == "load" ) {
+		char *filename = getCmdOption( argv, argv + argc, "-f", true );
+		char *format = getCmdOption( argv, argv + argc, "-format", true );
+		graphAnon::FileFormat io_format = graphAnon::FileFormat::adjacencyList;
+		if( filename == NULL ) { *response << "error load expects an input file (-f)"; }
+		else if( format != NULL && !parse_format( format, &io_format ) ) {
+			*response << "error invalid -format";
+		}
+		else if( !service->load( name, filename, io_format, &error ) ) {
+			*response << "error " << error;
+		}
+		else {
+			UnlabelledGraph const& g = service->graph( name );
+			*response << "ok n=" << g.num_vertices() << " m=" << g.num_edges();
+		}
+		return;
+	}
+	if( command == "unload" ) {
+		if( service->unload( name ) ) { *response << "ok"; }
+		else { *response << "error No graph is loaded as " << name; }
+		return;
+	}
+	if( command != "stats" && command != "identity" && command != "attribute" ) {
+		*response << "error Request \"" << command << "\" not supported";
+		return;
+	}
+	if( !service->is_loaded( name ) ) {
+		*response << "error No graph is loaded as " << name;
+		return;
+	}
+
+	MetricsOptions metrics_options;
+	metrics_options.sc_tolerance = parse_sc_tolerance( argc, argv );
+	if( !parse_hop_plot_options( argc, argv, &metrics_options.hop_plot ) ) {
+		*response << "error invalid hop plot options";
+		return;
+	}
+	UtilityMetrics metrics;
+	if( command == "stats" ) {
+		if( !service->measure( name, metrics_options, &metrics, &error ) ) {
+			*response << "error " << error;
+			return;
+		}
+		*response << "ok n=" << metrics.num_vertices << " m=" << metrics.num_edges;
+		append_metrics( metrics, response );
+		return;
+	}
+
+	/* An anonymisation: parse where to write it and whether to measure it. */
+	OutputOptions output;
+	char *output_filename = getCmdOption( argv, argv + argc, "-o", true );
+	const bool identity = command == "identity";
+	graphAnon::FileFormat default_format = service->input_format( name );
+	if( identity && default_format == graphAnon::FileFormat::adjacencyListVertexLabelled ) {
+		default_format = graphAnon::FileFormat::adjacencyList;
+	}
+	if( !identity ) { default_format = graphAnon::FileFormat::adjacencyList; }
+	if( output_filename != NULL ) {
+		if( !parse_output_options( argc, argv, default_format, &output.format, &output.varint,
+				&output.compression ) ) {
+			*response << "error invalid output options";
+			return;
+		}
+		output.filename = output_filename;
+	}
+	MetricsOptions const *measure = getCmdOption( argv, argv + argc, "-stats", false ) != NULL
+		? &metrics_options : NULL;
+
+	AnonymisationResult result;
+	bool solved;
+	if( identity ) {
+		char *k = getCmdOption( argv, argv + argc, "-k", true );
+		if( k == NULL ) {
+			*response << "error identity expects a privacy threshold (-k)";
+			return;
+		}
+		const bool hide_all = getCmdOption( argv, argv + argc, "-hide-additional", false ) != NULL;
+		solved = service->anonymise_identity( name, atoi( k ), hide_all, output, measure,
+			&result, &metrics, &error );
+	}
+	else {
+		char *alpha = getCmdOption( argv, argv + argc, "-alpha", true );
+		if( alpha == NULL ) {
+			*response << "error attribute expects a privacy threshold (-alpha)";
+			return;
+		}
+		if( getCmdOption( argv, argv + argc, "-seed", true ) != NULL ) {
+			srand( static_cast< unsigned >( parse_seed( argc, argv ) ) );
+		}
+		const bool parallel = getCmdOption( argv, argv + argc, "-parallel", false ) != NULL;
+		solved = service->anonymise_attribute( name, atof( alpha ), parallel, output, measure,
+			&result, &metrics, &error );
+	}
+	if( !solved ) {
+		*response << "error " << error;
+		return;
+	}
+	*response << "ok n=" << result.num_vertices << " m=" << result.num_edges
+		<< " new_vertices=" << result.new_vertices << " new_edges=" << result.new_edges;
+	if( measure != NULL ) { append_metrics( metrics, response ); }
+}
+
+/**
+ * Runs the software as a resident service that keeps graphs loaded across
+ * requests, so that each graph is read (and its CSR snapshot, degree
+ * sequence, label histograms, and metrics are built) only once, and the unit
+ * tests run only once. Requests are read one per line from the -requests
+ * file (e.g., a named pipe) or else stdin, until "quit" or the end of the
+ * input, and one response line is echoed to stdout for each.
+ * @param argc The number of command line arguments provided by the user
+ * @param argv An array of strings, each string containing a command
+ * line argument.
+ * @returns <ul><li>0 once the requests are exhausted</li>
+ * <li>1 if the -requests file cannot be opened</li>
+ * <li>2 if there is a software error (a unit test fails)</li></ul>
+ * @see serve_request()
+ */
+uint32_t run_serve_mode( int argc, char** argv ) {
+
+	char *requests_filename = getCmdOption( argv, argv + argc, "-requests", true );
+	std::ifstream requests_file;
+	if( requests_filename != NULL ) {
+		requests_file.open( requests_filename );
+		if( !requests_file ) {
+			std::cerr << "Could not open requests file " << requests_filename << std::endl;
+			return 1;
+		}
+	}
+	std::istream &requests = requests_filename != NULL ? requests_file : std::cin;
+
+	/* Run unit tests first, once for every request, without profiling them. */
+	if( !test_identity() || !test_attribute() || !test_analyses() ) { return 2; }
+	{
+		GRAPHANON_PROFILE_PAUSE();
+		if( !test_graph_service() ) {
+			std::cerr << "Failed unit test of GraphService! Aborting." << std::endl;
+			return 2;
+		}
+	}
+
+	GraphService service;
+	std::string line;
+	while( std::getline( requests, line ) ) {
+		std::istringstream tokens( line );
+		std::vector< std::string > words;
+		for( std::string word; tokens >> word; ) { words.push_back( word ); }
+		if( words.empty() || words[ 0 ][ 0 ] == '#' ) { continue; }
+		if( words[ 0 ] == "quit" ) { break; }
+
+		std::ostringstream response;
+		serve_request( &service, words, &response );
+		std::cout << response.str() << std::endl;
+	}
+	return 0;
+}
+
 /**
  * Main driver method that constructs a new Graph, anonymises it, and
  * then reports the change to the graph's occupancy rate.
@@ -336,6 +1532,9 @@ int main(int argc, char** argv) {
 		return 0;
 	}
 
+	/* Seed the labelling and the attribute mode's random choices. */
+	srand( static_cast< unsigned >( parse_seed( argc, argv ) ) );
+
 	char *mode = getCmdOption( argv, argv + argc, "-mode", true );
 	if( mode == NULL ) {
 			//print_usage_instructions( *argv );
@@ -345,16 +1544,38 @@ int main(int argc, char** argv) {
 			return 0;
 	}
 	
+	/* If requested, time each phase of the run and count its events. */
+	char *profile_filename;
+	graphAnon::ReportFormat profile_format;
+	if( !parse_profile( argc, argv, &profile_filename, &profile_format ) ) { return 0; }
+	Profile::global().enable( profile_filename != NULL );
+	
+	/* Exit with the status of the mode, so that scripts can tell, e.g., an
+	 * input that -streaming rejected from a graph that it anonymised. */
+	uint32_t status = 0;
 	if( strcmp( mode, "attribute" ) == 0 ) {
-		run_attribute_mode( argc, argv );
+		GRAPHANON_PROFILE_PHASE( "attribute" );
+		status = run_attribute_mode( argc, argv );
 	}
 	else if( strcmp( mode, "identity" ) == 0) {
-		run_identity_mode( argc, argv );
+		GRAPHANON_PROFILE_PHASE( "identity" );
+		status = run_identity_mode( argc, argv );
+	}
+	else if( strcmp( mode, "hop-plot" ) == 0 ) {
+		GRAPHANON_PROFILE_PHASE( "hop-plot" );
+		status = run_hop_plot_mode( argc, argv );
+	}
+	else if( strcmp( mode, "serve" ) == 0 ) {
+		GRAPHANON_PROFILE_PHASE( "serve" );
+		status = run_serve_mode( argc, argv );
 	}
 	else {
 		std::cerr << "Mode \"" << mode << "\" not supported. Please try either ";
-		std::cerr << "\"identity\" or \"attribute\" instead." << std::endl;
+		std::cerr << "\"identity\", \"attribute\", \"hop-plot\", or \"serve\" instead." << std::endl;
 	}
 
-	return 0;
+	if( profile_filename != NULL && !Profile::global().write( profile_filename, profile_format ) ) {
+		std::cerr << "Could not write profile file " << profile_filename << std::endl;
+	}
+	return static_cast< int >( status );
 }
@@ -0,0 +1,200 @@
+/**
+ * @file
+ * @brief Implementation of the GraphService class in graph_service.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <string>		/* for std::string, std::to_string */
+
+/* STL stuff in use. */
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "graph_service.h" /* implementing this class. */
+#include "../unlabelled_graph/graph_overlay.h"
+#include "../unlabelled_graph/identity_plan.h"
+#include "../unlabelled_graph/profile.h"
+
+namespace
+{
+	/**
+	 * Determines whether two sets of metrics options would measure a graph
+	 * identically.
+	 */
+	bool same_options( MetricsOptions const& a, MetricsOptions const& b ) {
+		return a.sc_tolerance == b.sc_tolerance && a.hop_plot.method == b.hop_plot.method
+			&& a.hop_plot.num_samples == b.hop_plot.num_samples
+			&& a.hop_plot.num_registers == b.hop_plot.num_registers
+			&& a.hop_plot.seed == b.hop_plot.seed;
+	}
+}
+
+bool GraphService::load( std::string const& name, std::string const& filename,
+	const graphAnon::FileFormat format, std::string *error ) {
+
+	std::unique_ptr< UnlabelledGraph > g;
+	if( format == graphAnon::FileFormat::adjacencyListVertexLabelled
+			|| format == graphAnon::FileFormat::binary ) {
+		g.reset( new LabelledGraph( filename, format ) );
+	}
+	else { g.reset( new UnlabelledGraph( filename, format ) ); }
+
+	if( g->num_vertices() == 0 ) {
+		*error = "Did not parse a positive number of vertices from " + filename;
+		return false;
+	}
+	add( name, std::move( g ), format );
+	return true;
+}
+
+void GraphService::add( std::string const& name, std::unique_ptr< UnlabelledGraph > graph,
+	const graphAnon::FileFormat format ) {
+
+	LoadedGraph &loaded = graphs_[ name ];
+	loaded.labelled = dynamic_cast< LabelledGraph* >( graph.get() );
+	loaded.graph = std::move( graph );
+	loaded.format = format;
+	loaded.snapshot = loaded.graph->snapshot();
+	loaded.degrees.clear();
+	loaded.report.reset();
+}
+
+bool GraphService::unload( std::string const& name ) { return graphs_.erase( name ) > 0; }
+
+GraphService::LoadedGraph* GraphService::find( std::string const& name, std::string *error ) {
+	auto const it = graphs_.find( name );
+	if( it == graphs_.end() ) {
+		*error = "No graph is loaded as " + name;
+		return NULL;
+	}
+	return &it->second;
+}
+
+UtilityReport const& GraphService::report( LoadedGraph *loaded, MetricsOptions const& options ) {
+	if( !loaded->report || !same_options( loaded->report_options, options ) ) {
+		GRAPHANON_PROFILE_PHASE( "report_input" );
+		loaded->report.reset( new UtilityReport( *loaded->snapshot, options.sc_tolerance,
+			options.hop_plot ) );
+		loaded->report_options = options;
+	}
+	return *loaded->report;
+}
+
+bool GraphService::measure( std::string const& name, MetricsOptions const& options,
+	UtilityMetrics *metrics, std::string *error ) {
+
+	LoadedGraph *const loaded = find( name, error );
+	if( loaded == NULL ) { return false; }
+	*metrics = report( loaded, options ).input();
+	return true;
+}
+
+bool GraphService::anonymise_identity( std::string const& name, const uint32_t k,
+	const bool hide_new_vertices, OutputOptions const& output,
+	MetricsOptions const *metrics_options, AnonymisationResult *result,
+	UtilityMetrics *metrics, std::string *error ) {
+
+	LoadedGraph *const loaded = find( name, error );
+	if( loaded == NULL ) { return false; }
+	const uint32_t n = loaded->snapshot->num_vertices();
+	if( k < 1 || k > n ) {
+		*error = "k must be in [ 1, " + std::to_string( n ) + " ]";
+		return false;
+	}
+	if( output.format == graphAnon::FileFormat::adjacencyListVertexLabelled ) {
+		*error = "A k-degree-anonymous graph is written without vertex labels";
+		return false;
+	}
+
+	/* Plan from the cached degree sequence, and overlay the new edges on the
+	 * shared snapshot rather than copying the graph. */
+	if( loaded->degrees.empty() ) { loaded->degrees = loaded->graph->retrieve_degree_sequence(); }
+	IdentityPlan const plan = plan_identity_sweep( loaded->degrees,
+		std::vector< uint32_t >( 1, k ), hide_new_vertices ).front();
+	GraphOverlay overlay( loaded->snapshot );
+	overlay.apply( plan, loaded->degrees );
+	if( hide_new_vertices && !overlay.is_anonymous( k ) ) {
+		*error = "The instance for k = " + std::to_string( k ) + " was evidently not solved";
+		return false;
+	}
+
+	result->num_vertices = overlay.num_vertices();
+	result->num_edges = overlay.num_edges();
+	result->new_vertices = overlay.num_vertices() - n;
+	result->new_edges = overlay.added_edges().size();
+	if( metrics_options != NULL ) {
+		*metrics = report( loaded, *metrics_options ).measure_output( overlay );
+	}
+	if( !output.filename.empty() ) {
+		GRAPHANON_PROFILE_PHASE( "write" );
+		if( !overlay.write( output.filename, output.format, output.varint, output.compression ) ) {
+			*error = "Could not write output file " + output.filename;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GraphService::anonymise_attribute( std::string const& name, const float alpha,
+	const bool parallel, OutputOptions const& output,
+	MetricsOptions const *metrics_options, AnonymisationResult *result,
+	UtilityMetrics *metrics, std::string *error ) {
+
+	LoadedGraph *const loaded = find( name, error );
+	if( loaded == NULL ) { return false; }
+	if( loaded->labelled == NULL ) {
+		*error = name + " is not vertex-labelled";
+		return false;
+	}
+
+	/* Querying the original builds its label histograms once, for every copy. */
+	loaded->labelled->is_alpha_proximal( alpha );
+	LabelledGraph g( *loaded->labelled );
+	if( parallel ) { g.parallel_greedy( alpha ); }
+	else { g.greedy( alpha ); }
+	if( !g.verify_alpha_proximal( alpha ) ) {
+		*error = "The instance for alpha = " + std::to_string( alpha ) + " was evidently not solved";
+		return false;
+	}
+
+	result->num_vertices = g.num_vertices();
+	result->num_edges = g.num_edges();
+	result->new_vertices = 0;
+	result->new_edges = g.num_edges() - loaded->snapshot->num_edges();
+	if( metrics_options != NULL ) {
+		*metrics = report( loaded, *metrics_options ).measure_output(
+			GraphOverlay::difference( loaded->snapshot, g.csr() ) );
+	}
+	if( !output.filename.empty() ) {
+		GRAPHANON_PROFILE_PHASE( "write" );
+		if( !g.write( output.filename, output.format, output.varint, output.compression ) ) {
+			*error = "Could not write output file " + output.filename;
+			return false;
+		}
+	}
+	return true;
+}
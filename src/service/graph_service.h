@@ -0,0 +1,251 @@
+/**
+ * @file
+ * @brief Definition of a GraphService, which keeps graphs loaded so that
+ * many anonymisations and analyses can be run against each one.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPH_SERVICE_H_
+#define GRAPH_SERVICE_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <string>	/* For std::string */
+
+/* STL libraries in use */
+#include <map>
+#include <memory>
+
+#include "../unlabelled_graph/unlabelled_graph.h"
+#include "../unlabelled_graph/csr_graph.h"
+#include "../unlabelled_graph/degree_anonymiser.h" /* for DegreeSequence */
+#include "../unlabelled_graph/graph_writer.h"
+#include "../unlabelled_graph/hop_plot_estimator.h"
+#include "../unlabelled_graph/utility_report.h"
+#include "../labelled_graph/labelled_graph.h"
+
+/**
+ * @brief Where and how to write an anonymised graph.
+ * @see UnlabelledGraph::write()
+ */
+struct OutputOptions {
+	std::string filename; /**< The path of the file to (over)write, or empty for none. */
+	graphAnon::FileFormat format; /**< The format in which to write the graph. */
+	bool varint; /**< Whether to delta+varint compress a binary file. */
+	graphAnon::Compression compression; /**< The compression of an ascii file. */
+
+	/**
+	 * Constructs the default settings: write nothing (or else an
+	 * uncompressed adjacency list).
+	 */
+	OutputOptions() : format( graphAnon::FileFormat::adjacencyList ), varint( false ),
+		compression( graphAnon::Compression::none ) {}
+};
+
+/**
+ * @brief How to measure the data utility of a graph.
+ * @see UtilityReport
+ */
+struct MetricsOptions {
+	double sc_tolerance; /**< The relative standard error of the subgraph centrality. */
+	HopPlotOptions hop_plot; /**< How to compute the hop plot. */
+
+	/**
+	 * Constructs the default settings, as for -stats: a relative standard
+	 * error of 0.001 and the exact hop plot.
+	 */
+	MetricsOptions() : sc_tolerance( 1e-3 ) {}
+};
+
+/**
+ * @brief What an anonymisation added to a graph.
+ */
+struct AnonymisationResult {
+	uint32_t num_vertices; /**< |V| of the anonymised graph. */
+	uint64_t num_edges; /**< |E| of the anonymised graph. */
+	uint32_t new_vertices; /**< The number of vertices added. */
+	uint64_t new_edges; /**< The number of edges added. */
+};
+
+/**
+ * @brief A set of named, loaded graphs against which any number of
+ * anonymisations and analyses can be run, without reloading them.
+ *
+ * Each graph is loaded once and never modified: its CSR snapshot, its degree
+ * sequence, its label histograms, and the metrics of its UtilityReport are
+ * all built the first time that they are needed and then reused by every
+ * later request. A k-degree anonymisation is a GraphOverlay of the shared
+ * snapshot, so it costs memory in proportion to the edges that it adds only;
+ * an alpha-proximal anonymisation runs on a copy of the graph.
+ *
+ * Nothing is written to stdout or stderr: every failure is reported through
+ * a return value and an error message for the caller to relay. Requests are
+ * not synchronised, so they should be issued from one thread at a time (each
+ * one still uses every OpenMP thread).
+ */
+class GraphService {
+public:
+
+	/**
+	 * Loads a graph from a file.
+	 * @param name The name by which to refer to the graph, which replaces
+	 * any graph already loaded under that name.
+	 * @param filename The path of the input file.
+	 * @param format The format of the input file. A vertex-labelled
+	 * adjacency list or binary file is loaded as a LabelledGraph, which can
+	 * also be made alpha-proximal; any other, as an UnlabelledGraph.
+	 * @param error Set to a description of the failure, if there is one.
+	 * @return False if no vertices could be read from the file.
+	 */
+	bool load( std::string const& name, std::string const& filename,
+		const graphAnon::FileFormat format, std::string *error );
+
+	/**
+	 * Adopts a graph that is already in memory (e.g., a random graph).
+	 * @param name The name by which to refer to the graph, which replaces
+	 * any graph already loaded under that name.
+	 * @param graph The graph, which need not be frozen but must not have
+	 * been reordered. If it is a LabelledGraph, it can also be made
+	 * alpha-proximal.
+	 * @param format The format in which to write its anonymisations by default.
+	 */
+	void add( std::string const& name, std::unique_ptr< UnlabelledGraph > graph,
+		const graphAnon::FileFormat format = graphAnon::FileFormat::adjacencyList );
+
+	/**
+	 * Releases a graph and everything cached for it.
+	 * @return False if no graph is loaded under name.
+	 */
+	bool unload( std::string const& name );
+
+	/**
+	 * Determines whether a graph is loaded under name.
+	 */
+	bool is_loaded( std::string const& name ) const { return graphs_.count( name ) > 0; }
+
+	/**
+	 * Accessor method to retrieve the format from which a graph was loaded,
+	 * in which its anonymisations are written by default.
+	 * @pre is_loaded( name ).
+	 */
+	graphAnon::FileFormat input_format( std::string const& name ) const {
+		return graphs_.at( name ).format;
+	}
+
+	/**
+	 * Accessor method to retrieve a loaded graph.
+	 * @pre is_loaded( name ).
+	 */
+	UnlabelledGraph const& graph( std::string const& name ) const {
+		return *graphs_.at( name ).graph;
+	}
+
+	/**
+	 * Measures the data utility of a loaded graph. The metrics are computed
+	 * on the first request and reused while options are unchanged.
+	 * @param name The name of the graph.
+	 * @param options How to measure it.
+	 * @param metrics Set to the metrics of the graph.
+	 * @param error Set to a description of the failure, if there is one.
+	 * @return False if no graph is loaded under name.
+	 */
+	bool measure( std::string const& name, MetricsOptions const& options,
+		UtilityMetrics *metrics, std::string *error );
+
+	/**
+	 * Makes a copy of a loaded graph k-degree-anonymous, as by
+	 * UnlabelledGraph::hide_waldo().
+	 * @param name The name of the graph, which is left unchanged.
+	 * @param k The privacy threshold, in [ 1, n ].
+	 * @param hide_new_vertices Whether the added pseudo-vertices must also
+	 * be anonymised (in which case the result is verified).
+	 * @param output Where to write the anonymised graph, if anywhere. It is
+	 * written without vertex labels.
+	 * @param metrics_options How to measure the anonymised graph, or NULL
+	 * not to.
+	 * @param result Set to the size of the anonymised graph.
+	 * @param metrics Set to the metrics of the anonymised graph, if
+	 * metrics_options is not NULL.
+	 * @param error Set to a description of the failure, if there is one.
+	 * @return False if there is no such graph, k is out of range, the
+	 * anonymisation failed, or the output could not be written.
+	 */
+	bool anonymise_identity( std::string const& name, const uint32_t k,
+		const bool hide_new_vertices, OutputOptions const& output,
+		MetricsOptions const *metrics_options, AnonymisationResult *result,
+		UtilityMetrics *metrics, std::string *error );
+
+	/**
+	 * Makes a copy of a loaded, vertex-labelled graph alpha-proximal, as by
+	 * LabelledGraph::greedy() (or parallel_greedy()).
+	 * @param name The name of the graph, which is left unchanged.
+	 * @param alpha The privacy threshold.
+	 * @param parallel Whether to run the greedy algorithm on every OpenMP thread.
+	 * @param output Where to write the anonymised graph, if anywhere.
+	 * @param metrics_options How to measure the anonymised graph, or NULL
+	 * not to.
+	 * @param result Set to the size of the anonymised graph.
+	 * @param metrics Set to the metrics of the anonymised graph, if
+	 * metrics_options is not NULL.
+	 * @param error Set to a description of the failure, if there is one.
+	 * @return False if there is no such graph, it is not vertex-labelled,
+	 * the anonymisation failed, or the output could not be written.
+	 */
+	bool anonymise_attribute( std::string const& name, const float alpha,
+		const bool parallel, OutputOptions const& output,
+		MetricsOptions const *metrics_options, AnonymisationResult *result,
+		UtilityMetrics *metrics, std::string *error );
+
+private:
+
+	/**
+	 * @brief A loaded graph and everything cached for it.
+	 */
+	struct LoadedGraph {
+		std::unique_ptr< UnlabelledGraph > graph; /**< The graph, never modified. */
+		LabelledGraph *labelled; /**< graph, if it is vertex-labelled; else NULL. */
+		graphAnon::FileFormat format; /**< The format from which graph was loaded. */
+		std::shared_ptr< const CsrGraph > snapshot; /**< The CSR snapshot of graph. */
+		DegreeSequence degrees; /**< The degree sequence of graph, if built. */
+		std::unique_ptr< UtilityReport > report; /**< The metrics of graph, if measured. */
+		MetricsOptions report_options; /**< The options with which report was built. */
+	};
+
+	/**
+	 * Finds a loaded graph.
+	 * @param error Set to a description of the failure, if there is none.
+	 * @return The graph, or NULL if none is loaded under name.
+	 */
+	LoadedGraph* find( std::string const& name, std::string *error );
+
+	/**
+	 * Retrieves the UtilityReport of a loaded graph, measuring the graph
+	 * first if it has not yet been measured with options.
+	 */
+	UtilityReport const& report( LoadedGraph *loaded, MetricsOptions const& options );
+
+	std::map< std::string, LoadedGraph > graphs_; /**< Every loaded graph, by name. */
+};
+
+#endif /* GRAPH_SERVICE_H_ */
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in graph_service.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for srand */
+#include <memory>
+#include <string>
+
+#include "graph_service.test.h"
+#include "graph_service.h"
+#include "../unlabelled_graph/unlabelled_graph.h"
+#include "../unlabelled_graph/utility_report.h"
+#include "../labelled_graph/labelled_graph.h"
+
+bool test_graph_service() {
+
+	bool passed = true;
+	GraphService service;
+	std::string error;
+	OutputOptions const no_output;
+	MetricsOptions const metrics_options;
+	AnonymisationResult result;
+	UtilityMetrics metrics;
+
+	UnlabelledGraph g( 200 );
+	g.populate_uniformly( 400, 2017 );
+	service.add( "g", std::unique_ptr< UnlabelledGraph >( new UnlabelledGraph( g ) ) );
+
+	/**
+	 * @test k-degree anonymisation
+	 * An anonymisation adds what hide_waldo() adds, is measured as its
+	 * materialised graph would be, and leaves the loaded graph unchanged,
+	 * so that the next one starts from the input again.
+	 */
+	for( uint32_t k = 2; k <= 8; k *= 2 ) {
+		UnlabelledGraph expected( g );
+		expected.hide_waldo< true >( k );
+		if( !service.anonymise_identity( "g", k, true, no_output, &metrics_options, &result,
+				&metrics, &error ) ) {
+			passed = false;
+			continue;
+		}
+		if( result.num_vertices != expected.num_vertices() || result.num_edges != expected.num_edges()
+				|| result.new_edges != expected.num_edges() - g.num_edges()
+				|| metrics.num_edges != expected.num_edges()
+				|| metrics.hop_plot != expected.hop_plot()
+				|| service.graph( "g" ).num_edges() != g.num_edges() ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test Metrics of a loaded graph
+	 * The cached metrics are those of a UtilityReport of the graph.
+	 */
+	UtilityMetrics const expected_metrics = UtilityReport( g.csr(), metrics_options.sc_tolerance ).input();
+	for( uint32_t i = 0; i < 2; ++i ) {
+		if( !service.measure( "g", metrics_options, &metrics, &error )
+				|| metrics.triangles != expected_metrics.triangles
+				|| metrics.hop_plot != expected_metrics.hop_plot ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test Alpha-proximal anonymisation
+	 * An anonymisation of a copy (with the original's label histograms) adds
+	 * what greedy() adds to the original, whichever anonymisations came
+	 * before it, and the from-scratch check agrees with the tracker.
+	 */
+	LabelledGraph l( 150, 3 );
+	srand( 2017 );
+	l.evenly_distribute_labels();
+	l.populate_uniformly( 300, 2017 );
+	service.add( "l", std::unique_ptr< UnlabelledGraph >( new LabelledGraph( l ) ) );
+	for( float alpha = 0.2f; alpha > 0.05f; alpha -= 0.05f ) {
+		LabelledGraph expected( l );
+		srand( 2017 );
+		if( l.verify_alpha_proximal( alpha ) != LabelledGraph( l ).is_alpha_proximal( alpha ) ) {
+			passed = false;
+		}
+		expected.greedy( alpha );
+		if( !expected.verify_alpha_proximal( alpha ) ) { passed = false; }
+		srand( 2017 );
+		if( !service.anonymise_attribute( "l", alpha, false, no_output, NULL, &result, NULL, &error )
+				|| result.num_edges != expected.num_edges()
+				|| result.new_edges != expected.num_edges() - l.num_edges()
+				|| service.graph( "l" ).num_edges() != l.num_edges() ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test Invalid requests
+	 * Requests for unknown graphs, for k out of range, or for an
+	 * alpha-proximal unlabelled graph fail with an error message.
+	 */
+	error.clear();
+	if( service.anonymise_identity( "h", 2, false, no_output, NULL, &result, NULL, &error )
+			|| error.empty() ) {
+		passed = false;
+	}
+	if( service.anonymise_identity( "g", 0, false, no_output, NULL, &result, NULL, &error )
+			|| service.anonymise_identity( "g", 201, false, no_output, NULL, &result, NULL, &error )
+			|| service.anonymise_attribute( "g", 0.1f, false, no_output, NULL, &result, NULL, &error ) ) {
+		passed = false;
+	}
+	if( service.load( "f", "/nonexistent/graph.adjList", graphAnon::FileFormat::adjacencyList, &error )
+			|| service.is_loaded( "f" ) ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Unloading
+	 * An unloaded graph can no longer be used, and cannot be unloaded twice.
+	 */
+	if( !service.unload( "g" ) || service.is_loaded( "g" ) || service.unload( "g" )
+			|| service.measure( "g", metrics_options, &metrics, &error ) ) {
+		passed = false;
+	}
+
+	return passed;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file
+ * @brief Implementation of the AllPairsBfs class in all_pairs_bfs.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::fill */
+#include <numeric>		/* for std::iota */
+#include <utility>		/* for std::swap */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "all_pairs_bfs.h" /* implementing this class. */
+#include "profile.h"
+#include "scratch_arena.h"
+
+namespace
+{
+	/**
+	 * The ratio of frontier edges to total edges above which a level is
+	 * expanded bottom-up rather than top-down (cf. Beamer et al.'s alpha).
+	 */
+	const uint64_t bottom_up_edge_ratio = 14;
+
+	/**
+	 * One bit per source in a batch, for a single vertex.
+	 */
+	struct SourceMask {
+		uint64_t words[ GRAPHANON_BFS_WORDS ];
+	};
+
+	inline bool is_empty( SourceMask const& m ) {
+		uint64_t any = 0;
+		for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) { any |= m.words[ i ]; }
+		return any == 0;
+	}
+
+	inline uint64_t popcount( SourceMask const& m ) {
+		uint64_t count = 0;
+		for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+			count += __builtin_popcountll( m.words[ i ] );
+		}
+		return count;
+	}
+
+	/**
+	 * The per-thread state of one batch of searches, reused across batches
+	 * and borrowed from the thread's ScratchArena, so that repeated hop plots
+	 * (e.g., one per sample group or per k) do not reallocate it.
+	 */
+	struct BatchState {
+		ScratchVector< SourceMask > seen; /**< Sources that have reached each vertex. */
+		ScratchVector< SourceMask > frontier; /**< Sources that reached each vertex last level. */
+		ScratchVector< SourceMask > next; /**< Sources that reach each vertex this level. */
+		ScratchVector< uint32_t > frontier_list; /**< Vertices with a non-empty frontier. */
+		ScratchVector< uint32_t > next_list; /**< Vertices with a non-empty next frontier. */
+		std::vector< uint64_t > histogram; /**< This thread's path-length counts. */
+		uint64_t num_visited = 0; /**< This thread's (source, vertex) pairs reached. */
+	};
+
+	/**
+	 * Runs searches from up to AllPairsBfs::batch_size sources at once and
+	 * adds the number of newly reached (source, vertex) pairs at each level
+	 * to state->histogram.
+	 */
+	template< typename Graph >
+	void run_batch( Graph const& g, uint32_t const *sources,
+		const uint32_t num_sources, BatchState *state ) {
+
+		const uint32_t n = g.num_vertices();
+		const uint64_t bottom_up_threshold = 2 * g.num_edges() / bottom_up_edge_ratio;
+
+		/* Bits for sources beyond the end of a partial batch start as "seen"
+		 * everywhere, so that they never appear in a frontier and the bottom-up
+		 * early exit still fires. */
+		SourceMask unused;
+		for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+			const uint32_t first_bit = i * 64;
+			if( num_sources <= first_bit ) { unused.words[ i ] = ~0ull; }
+			else if( num_sources >= first_bit + 64 ) { unused.words[ i ] = 0; }
+			else { unused.words[ i ] = ~0ull << ( num_sources - first_bit ); }
+		}
+		SourceMask const empty = SourceMask();
+		std::fill( state->seen.begin(), state->seen.end(), unused );
+		state->frontier_list.clear();
+		state->next_list.clear();
+
+		/* Level 0: every source has reached itself. */
+		uint64_t frontier_degree = 0;
+		for( uint32_t b = 0; b < num_sources; ++b ) {
+			const uint32_t s = sources[ b ];
+			if( is_empty( state->frontier[ s ] ) ) {
+				state->frontier_list.push_back( s );
+				frontier_degree += g.degree( s );
+			}
+			state->frontier[ s ].words[ b / 64 ] |= 1ull << ( b % 64 );
+			state->seen[ s ].words[ b / 64 ] |= 1ull << ( b % 64 );
+		}
+		if( state->histogram.empty() ) { state->histogram.push_back( 0 ); }
+		state->histogram[ 0 ] += num_sources;
+		state->num_visited += num_sources;
+
+		for( uint32_t level = 1; !state->frontier_list.empty(); ++level ) {
+
+			if( frontier_degree < bottom_up_threshold ) {
+				/* Top-down: push each frontier vertex's sources to its neighbours. */
+				for( uint32_t const v : state->frontier_list ) {
+					SourceMask const& f = state->frontier[ v ];
+					for( uint32_t const u : g.neighbours( v ) ) {
+						SourceMask const& s = state->seen[ u ];
+						SourceMask &nu = state->next[ u ];
+						const bool was_empty = is_empty( nu );
+						uint64_t added = 0;
+						for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+							const uint64_t w = f.words[ i ] & ~s.words[ i ];
+							nu.words[ i ] |= w;
+							added |= w;
+						}
+						if( was_empty && added != 0 ) { state->next_list.push_back( u ); }
+					}
+				}
+			}
+			else {
+				/* Bottom-up: each vertex not yet seen by every source pulls the
+				 * sources from its neighbours' frontiers, stopping early once it
+				 * has found all of the sources it was missing. */
+				for( uint32_t u = 0; u < n; ++u ) {
+					SourceMask const& s = state->seen[ u ];
+					uint64_t missing_any = 0;
+					for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+						missing_any |= ~s.words[ i ];
+					}
+					if( missing_any == 0 ) { continue; }
+
+					SourceMask found = empty;
+					for( uint32_t const v : g.neighbours( u ) ) {
+						SourceMask const& f = state->frontier[ v ];
+						uint64_t still_missing = 0;
+						for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+							found.words[ i ] |= f.words[ i ] & ~s.words[ i ];
+							still_missing |= ~( s.words[ i ] | found.words[ i ] );
+						}
+						if( still_missing == 0 ) { break; }
+					}
+					if( !is_empty( found ) ) {
+						state->next[ u ] = found;
+						state->next_list.push_back( u );
+					}
+				}
+			}
+
+			/* Retire the old frontier and promote the next one. */
+			for( uint32_t const v : state->frontier_list ) { state->frontier[ v ] = empty; }
+			uint64_t reached = 0;
+			frontier_degree = 0;
+			for( uint32_t const u : state->next_list ) {
+				SourceMask &nu = state->next[ u ];
+				for( uint32_t i = 0; i < GRAPHANON_BFS_WORDS; ++i ) {
+					state->seen[ u ].words[ i ] |= nu.words[ i ];
+				}
+				reached += popcount( nu );
+				frontier_degree += g.degree( u );
+				state->frontier[ u ] = nu;
+				nu = empty;
+			}
+			std::swap( state->frontier_list, state->next_list );
+			state->next_list.clear();
+
+			state->num_visited += reached;
+			if( reached > 0 ) {
+				if( state->histogram.size() <= level ) { state->histogram.resize( level + 1, 0 ); }
+				state->histogram[ level ] += reached;
+			}
+		}
+	}
+}
+
+AllPairsBfs::AllPairsBfs( CsrGraph const& g ) : csr_( &g ), overlay_( NULL ) {}
+
+AllPairsBfs::AllPairsBfs( OverlayView const& g ) : csr_( NULL ), overlay_( &g ) {}
+
+std::vector< uint64_t > AllPairsBfs::histogram() const {
+	std::vector< uint32_t > sources( csr_ ? csr_->num_vertices() : overlay_->num_vertices() );
+	std::iota( sources.begin(), sources.end(), 0 );
+	return histogram( sources.data(), sources.size() );
+}
+
+std::vector< uint64_t > AllPairsBfs::histogram( uint32_t const *sources,
+	const size_t num_sources ) const {
+	if( csr_ ) { return histogram( *csr_, sources, num_sources ); }
+	return histogram( *overlay_, sources, num_sources );
+}
+
+template< typename Graph >
+std::vector< uint64_t > AllPairsBfs::histogram( Graph const& g, uint32_t const *sources,
+	const size_t num_sources ) const {
+
+	const uint32_t n = g.num_vertices();
+	const size_t num_batches = ( num_sources + batch_size - 1 ) / batch_size;
+	std::vector< std::vector< uint64_t > > histograms;
+
+#pragma omp parallel
+	{
+#pragma omp single
+		{
+			histograms.resize( omp_get_num_threads() );
+		}
+
+		/* Allocated lazily, so that idle threads do not pay for state. */
+		ScratchArena::Scope scratch;
+		BatchState state;
+
+#pragma omp for schedule( dynamic, 1 )
+		for( size_t batch = 0; batch < num_batches; ++batch ) {
+			if( state.seen.empty() ) {
+				state.seen.resize( n );
+				state.frontier.resize( n, SourceMask() );
+				state.next.resize( n, SourceMask() );
+			}
+			const size_t first = batch * batch_size;
+			const size_t count = std::min< size_t >( batch_size, num_sources - first );
+			run_batch( g, sources + first, static_cast< uint32_t >( count ), &state );
+		}
+
+		GRAPHANON_PROFILE_COUNT( bfs_vertices_visited, state.num_visited );
+		histograms[ omp_get_thread_num() ] = std::move( state.histogram );
+	}
+
+	/* Reduce all the histograms from each thread. */
+	std::vector< uint64_t > result;
+	for( auto const& h : histograms ) {
+		if( result.size() < h.size() ) { result.resize( h.size(), 0 ); }
+		for( size_t i = 0; i < h.size(); ++i ) { result[ i ] += h[ i ]; }
+	}
+	if( result.empty() ) { result.push_back( 0 ); }
+	return result;
+}
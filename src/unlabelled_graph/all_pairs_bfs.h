@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief Definition of a bit-parallel, direction-optimising all-pairs
+ * breadth-first search engine for computing hop plots.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ALL_PAIRS_BFS_H_
+#define ALL_PAIRS_BFS_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For size_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+
+/**
+ * The number of 64-bit words of sources that each BFS batch carries per
+ * vertex. Defaults to the widest vector register available, so that the
+ * frontier operations compile down to one instruction per vertex.
+ */
+#ifndef GRAPHANON_BFS_WORDS
+#if defined( __AVX512F__ )
+#define GRAPHANON_BFS_WORDS 8
+#elif defined( __AVX2__ )
+#define GRAPHANON_BFS_WORDS 4
+#else
+#define GRAPHANON_BFS_WORDS 1
+#endif
+#endif
+
+/**
+ * @brief Computes shortest-path length histograms by running many
+ * breadth-first searches at once.
+ *
+ * Sources are processed in batches of batch_size. For every vertex, the
+ * engine keeps one bit per source in the batch for each of the seen, current
+ * frontier, and next frontier sets, so a single scan of a neighbour list
+ * advances the search of every source in the batch (MS-BFS). Each level is
+ * expanded either top-down (from the frontier outwards) or bottom-up (from
+ * the unseen vertices inwards), whichever touches fewer edges. Batches
+ * run in parallel across OpenMP threads. The graph is either a CsrGraph or
+ * an OverlayView of one.
+ */
+class AllPairsBfs {
+public:
+
+	/** The number of sources searched simultaneously by one batch. */
+	static constexpr uint32_t batch_size = 64 * GRAPHANON_BFS_WORDS;
+
+	/**
+	 * Constructs a BFS engine over the graph g.
+	 * @param g The graph to search. It must outlive this AllPairsBfs.
+	 */
+	explicit AllPairsBfs( CsrGraph const& g );
+
+	/**
+	 * Constructs a BFS engine over the overlaid graph g.
+	 * @param g The graph to search. It must outlive this AllPairsBfs.
+	 */
+	explicit AllPairsBfs( OverlayView const& g );
+
+	/**
+	 * Computes the histogram of shortest-path lengths from every vertex.
+	 * @returns A vector whose i'th element is the number of ordered vertex
+	 * pairs (u,v) for which the shortest path from u to v has exactly i hops.
+	 * Element 0 therefore counts the n paths (u,u). Disconnected pairs are not
+	 * counted, and the vector ends at the longest shortest path.
+	 */
+	std::vector< uint64_t > histogram() const;
+
+	/**
+	 * Computes the histogram of shortest-path lengths from a subset of sources.
+	 * @param sources The distinct vertex ids from which to search.
+	 * @param num_sources The number of elements in sources.
+	 * @returns As for histogram(), but only counting pairs (u,v) for which u
+	 * is one of the sources.
+	 */
+	std::vector< uint64_t > histogram( uint32_t const *sources, const size_t num_sources ) const;
+
+private:
+
+	/**
+	 * Computes the histogram of shortest-path lengths from sources in g.
+	 * @see histogram()
+	 */
+	template< typename Graph >
+	std::vector< uint64_t > histogram( Graph const& g, uint32_t const *sources,
+		const size_t num_sources ) const;
+
+	CsrGraph const *csr_; /**< The graph being searched, if a CsrGraph. */
+	OverlayView const *overlay_; /**< The graph being searched, if an OverlayView. */
+};
+
+#endif /* ALL_PAIRS_BFS_H_ */
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief A set of functions for unit testing the AllPairsBfs class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <vector>
+
+#include "all_pairs_bfs.test.h"
+#include "all_pairs_bfs.h"
+#include "csr_graph.h"
+#include "random_graph.h"
+
+namespace
+{
+	/**
+	 * A plain, one-source-at-a-time BFS against which to compare.
+	 */
+	std::vector< uint64_t > reference_histogram( CsrGraph const& g,
+		std::vector< uint32_t > const& sources ) {
+
+		const uint32_t n = g.num_vertices();
+		std::vector< uint64_t > histogram( 1, 0 );
+		for( uint32_t const s : sources ) {
+			std::vector< int > distance( n, -1 );
+			std::vector< uint32_t > queue( 1, s );
+			distance[ s ] = 0;
+			for( size_t head = 0; head < queue.size(); ++head ) {
+				const uint32_t v = queue[ head ];
+				const uint32_t d = distance[ v ];
+				if( histogram.size() <= d ) { histogram.resize( d + 1, 0 ); }
+				++histogram[ d ];
+				for( uint32_t const u : g.neighbours( v ) ) {
+					if( distance[ u ] < 0 ) {
+						distance[ u ] = d + 1;
+						queue.push_back( u );
+					}
+				}
+			}
+		}
+		return histogram;
+	}
+}
+
+bool test_all_pairs_bfs() {
+
+	bool passed = true;
+
+	/**
+	 * @test Path graph
+	 * The path 0-1-2-3 has 4 paths of length 0, 6 of length 1, 4 of
+	 * length 2, and 2 of length 3 (counting both directions).
+	 */
+	CsrGraph const path = graphAnon::csr_from_edges( 4, { { 0, 1 }, { 1, 2 }, { 2, 3 } } );
+	std::vector< uint64_t > const expected_path { 4, 6, 4, 2 };
+	if( AllPairsBfs( path ).histogram() != expected_path ) { passed = false; }
+
+	/**
+	 * @test Boundary case: no edges
+	 * A graph with isolated vertices only has the paths (u,u) of length 0.
+	 */
+	CsrGraph const isolated = graphAnon::csr_from_edges( 3, {} );
+	std::vector< uint64_t > const expected_isolated { 3 };
+	if( AllPairsBfs( isolated ).histogram() != expected_isolated ) { passed = false; }
+
+	/**
+	 * @test Random graphs spanning several batches
+	 * A sparse and a dense random graph, each with more vertices than fit in
+	 * two batches (so that the last batch is partial), should match a plain
+	 * BFS from every source. The dense graph exercises the bottom-up levels.
+	 */
+	for( uint32_t const avg_degree : { 2u, 40u } ) {
+		const uint32_t n = 2 * AllPairsBfs::batch_size + 37;
+		CsrGraph const g = graphAnon::random_gnm( n, n * avg_degree / 2, 2017 );
+		std::vector< uint32_t > all_sources( n );
+		for( uint32_t v = 0; v < n; ++v ) { all_sources[ v ] = v; }
+		if( AllPairsBfs( g ).histogram() != reference_histogram( g, all_sources ) ) {
+			passed = false;
+		}
+
+		/**
+		 * @test Subset of sources
+		 * Searching from only some of the vertices should count only the
+		 * paths starting at those vertices.
+		 */
+		std::vector< uint32_t > some_sources;
+		for( uint32_t v = 0; v < n; v += 3 ) { some_sources.push_back( v ); }
+		if( AllPairsBfs( g ).histogram( some_sources.data(), some_sources.size() )
+				!= reference_histogram( g, some_sources ) ) {
+			passed = false;
+		}
+	}
+
+	return passed;
+}
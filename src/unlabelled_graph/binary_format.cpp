@@ -0,0 +1,238 @@
+/**
+ * @file
+ * @brief Implementation of the binary graph format functions in binary_format.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cstddef>		/* for size_t */
+#include <algorithm>	/* for std::binary_search */
+#include <cstring>		/* for std::memcmp, std::memcpy */
+#include <fstream>		/* for std::ofstream */
+#include <utility>		/* for std::move */
+
+/* STL stuff in use. */
+#include <vector>
+#include <memory>
+
+#include "binary_format.h" /* implementing these functions. */
+
+namespace
+{
+	const char magic[ 8 ] = { 'G', 'A', 'N', 'O', 'N', 'B', 'I', 'N' };
+
+	/**
+	 * Rounds a byte count up to the next multiple of 8.
+	 */
+	inline uint64_t padded( const uint64_t bytes ) { return ( bytes + 7 ) & ~7ull; }
+
+	/**
+	 * Appends x to out as a LEB128 varint.
+	 */
+	inline void put_varint( uint64_t x, std::vector< uint8_t > *out ) {
+		while( x >= 0x80 ) {
+			out->push_back( static_cast< uint8_t >( x ) | 0x80 );
+			x >>= 7;
+		}
+		out->push_back( static_cast< uint8_t >( x ) );
+	}
+
+	/**
+	 * Decodes a LEB128 varint at *p, advancing *p past it.
+	 * @return False if the varint runs past end.
+	 */
+	inline bool get_varint( uint8_t const **p, uint8_t const *end, uint64_t *x ) {
+		uint64_t value = 0;
+		for( uint32_t shift = 0; *p != end && shift < 64; shift += 7 ) {
+			const uint8_t byte = *( *p )++;
+			value |= static_cast< uint64_t >( byte & 0x7f ) << shift;
+			if( ( byte & 0x80 ) == 0 ) {
+				*x = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Determines whether CSR arrays describe a simple graph on n vertices
+	 * that the analyses can trust: the offsets start at 0, never decrease,
+	 * and end at num_neighbours, and every neighbour list is strictly
+	 * increasing (i.e., sorted and duplicate-free), within [ 0, n ), and
+	 * free of self-loops. Also, the adjacency must be symmetric: u is found
+	 * by binary search in the list of each of its neighbours v. (If v's list
+	 * is itself unsorted, the search may miss u, but then v's list is
+	 * rejected anyway.)
+	 */
+	bool is_valid_csr( const uint32_t n, uint64_t const *offsets, uint32_t const *neighbours,
+		const uint64_t num_neighbours ) {
+
+		if( offsets[ 0 ] != 0 || offsets[ n ] != num_neighbours ) { return false; }
+		for( uint32_t u = 0; u < n; ++u ) {
+			if( offsets[ u + 1 ] < offsets[ u ] ) { return false; }
+		}
+		bool valid = true;
+#pragma omp parallel for schedule( dynamic, 256 ) reduction( && : valid )
+		for( uint32_t u = 0; u < n; ++u ) {
+			for( uint64_t i = offsets[ u ]; i < offsets[ u + 1 ]; ++i ) {
+				const uint32_t v = neighbours[ i ];
+				if( v >= n || v == u || ( i > offsets[ u ] && v <= neighbours[ i - 1 ] )
+						|| !std::binary_search( neighbours + offsets[ v ], neighbours + offsets[ v + 1 ], u ) ) {
+					valid = false;
+					break;
+				}
+			}
+		}
+		return valid;
+	}
+
+	/**
+	 * Writes bytes bytes from data, followed by zeroes up to a multiple of 8.
+	 */
+	inline void write_block( std::ofstream &out, void const *data, const uint64_t bytes ) {
+		static const char zeroes[ 8 ] = { 0 };
+		out.write( static_cast< char const* >( data ), bytes );
+		out.write( zeroes, padded( bytes ) - bytes );
+	}
+}
+
+bool is_binary_graph( char const *data, const size_t length ) {
+	return length >= sizeof( BinaryGraphHeader ) && std::memcmp( data, magic, sizeof( magic ) ) == 0;
+}
+
+bool read_binary_graph( char const *data, const size_t length,
+	std::shared_ptr< const void > const& backing, CsrGraph *g,
+	std::vector< uint32_t > *labels, uint32_t *num_labels ) {
+
+	if( !is_binary_graph( data, length ) ) { return false; }
+	BinaryGraphHeader header;
+	std::memcpy( &header, data, sizeof( header ) );
+	if( header.version != BINARY_FORMAT_VERSION || header.num_vertices > UINT32_MAX ) { return false; }
+
+	const uint32_t n = static_cast< uint32_t >( header.num_vertices );
+	const bool compressed = ( header.flags & binary_flag_compressed ) != 0;
+	uint64_t position = sizeof( header );
+
+	/* Locate the CSR blocks and check that they fit within the file. Every
+	 * size is first bounded by length, so that none of the sums overflow. */
+	const uint64_t max_neighbours = compressed ? header.payload_bytes : length / sizeof( uint32_t );
+	if( header.payload_bytes > length || header.num_neighbours > max_neighbours ) { return false; }
+	const uint64_t offsets_bytes = compressed ? 0 : ( header.num_vertices + 1 ) * sizeof( uint64_t );
+	const uint64_t neighbours_bytes = compressed ? header.payload_bytes
+		: header.num_neighbours * sizeof( uint32_t );
+	const uint64_t labels_position = position + padded( offsets_bytes ) + padded( neighbours_bytes );
+	const bool has_labels = ( header.flags & binary_flag_labels ) != 0;
+	const uint64_t labels_bytes = has_labels ? header.num_vertices * sizeof( uint32_t ) : 0;
+	if( labels_position + labels_bytes > length ) { return false; }
+
+	if( !compressed ) {
+		/* Zero-copy: view the arrays in place. */
+		uint64_t const *offsets = reinterpret_cast< uint64_t const* >( data + position );
+		uint32_t const *neighbours = reinterpret_cast< uint32_t const* >( data + position + padded( offsets_bytes ) );
+		if( !is_valid_csr( n, offsets, neighbours, header.num_neighbours ) ) { return false; }
+		*g = CsrGraph( n, offsets, neighbours, backing );
+	}
+	else {
+		/* Decode the degrees and gaps into owned arrays. Each neighbour takes
+		 * at least one byte, so num_neighbours is at most payload_bytes. */
+		uint8_t const *p = reinterpret_cast< uint8_t const* >( data + position );
+		uint8_t const *end = p + header.payload_bytes;
+		std::vector< uint64_t > offsets( n + 1, 0 );
+		std::vector< uint32_t > neighbours;
+		neighbours.reserve( header.num_neighbours );
+		for( uint32_t u = 0; u < n; ++u ) {
+			uint64_t degree, gap;
+			if( !get_varint( &p, end, &degree ) || degree > static_cast< uint64_t >( end - p ) ) {
+				return false;
+			}
+			uint64_t v = 0;
+			for( uint64_t i = 0; i < degree; ++i ) {
+				if( !get_varint( &p, end, &gap ) || gap >= n || ( v += gap ) >= n ) { return false; }
+				neighbours.push_back( static_cast< uint32_t >( v ) );
+			}
+			offsets[ u + 1 ] = neighbours.size();
+		}
+		if( !is_valid_csr( n, offsets.data(), neighbours.data(), header.num_neighbours ) ) {
+			return false;
+		}
+		*g = CsrGraph( std::move( offsets ), std::move( neighbours ) );
+	}
+
+	/* Labels, if present, are small enough to copy. */
+	labels->clear();
+	*num_labels = 0;
+	if( has_labels ) {
+		uint32_t const *first = reinterpret_cast< uint32_t const* >( data + labels_position );
+		for( uint32_t const *label = first; label != first + n; ++label ) {
+			if( *label >= header.num_labels ) { return false; }
+		}
+		labels->assign( first, first + n );
+		*num_labels = header.num_labels;
+	}
+	return true;
+}
+
+bool write_binary_graph( const std::string filename, CsrGraph const& g,
+	std::vector< uint32_t > const *labels, const uint32_t num_labels, const bool compress ) {
+
+	std::ofstream out( filename, std::ios::binary | std::ios::trunc );
+	if( !out ) { return false; }
+
+	const uint32_t n = g.num_vertices();
+	BinaryGraphHeader header;
+	std::memcpy( header.magic, magic, sizeof( magic ) );
+	header.version = BINARY_FORMAT_VERSION;
+	header.flags = ( labels != NULL ? binary_flag_labels : 0 ) | ( compress ? binary_flag_compressed : 0 );
+	header.num_vertices = n;
+	header.num_neighbours = g.offsets()[ n ];
+	header.payload_bytes = 0;
+	header.num_labels = labels != NULL ? num_labels : 0;
+	header.reserved = 0;
+
+	if( !compress ) {
+		out.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+		write_block( out, g.offsets(), ( n + 1 ) * sizeof( uint64_t ) );
+		write_block( out, g.neighbour_array(), header.num_neighbours * sizeof( uint32_t ) );
+	}
+	else {
+		std::vector< uint8_t > payload;
+		payload.reserve( header.num_neighbours + n );
+		for( uint32_t u = 0; u < n; ++u ) {
+			NeighbourRange const neighbours = g.neighbours( u );
+			put_varint( neighbours.size(), &payload );
+			uint32_t previous = 0;
+			for( uint32_t const v : neighbours ) {
+				put_varint( v - previous, &payload );
+				previous = v;
+			}
+		}
+		header.payload_bytes = payload.size();
+		out.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+		write_block( out, payload.data(), payload.size() );
+	}
+	if( labels != NULL ) { write_block( out, labels->data(), n * sizeof( uint32_t ) ); }
+
+	return static_cast< bool >( out );
+}
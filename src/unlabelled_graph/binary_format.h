@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Definition of the reader and writer for graphAnon::FileFormat::binary,
+ * a compact, versioned binary graph format.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BINARY_FORMAT_H_
+#define BINARY_FORMAT_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For size_t */
+#include <string>	/* For std::string */
+
+/* STL libraries in use */
+#include <vector>
+#include <memory>
+
+#include "csr_graph.h"
+
+/**
+ * The current version of the binary format. Readers reject other versions.
+ */
+#define BINARY_FORMAT_VERSION 1
+
+/**
+ * @brief The fixed-size header at the start of every binary graph file.
+ *
+ * The header is followed by 8-byte aligned blocks. If the neighbours are
+ * stored uncompressed, these are the n + 1 uint64_t CSR offsets and then the
+ * offsets[ n ] uint32_t CSR neighbours (every edge in both directions, each
+ * list sorted), exactly as in a CsrGraph, so that a memory-mapped file can
+ * be used in place. If compressed, a single block of payload_bytes bytes
+ * instead holds, for each vertex in turn, its degree and then the gaps
+ * between its consecutive sorted neighbours (the first measured from 0), all
+ * as LEB128 varints. An optional block of n uint32_t vertex labels comes
+ * last. All integers are little-endian.
+ */
+struct BinaryGraphHeader {
+	char magic[ 8 ]; /**< Always "GANONBIN". */
+	uint32_t version; /**< BINARY_FORMAT_VERSION. */
+	uint32_t flags; /**< A combination of the binary_flag_* bits. */
+	uint64_t num_vertices; /**< The number of vertices, n. */
+	uint64_t num_neighbours; /**< The number of CSR neighbour entries, 2|E|. */
+	uint64_t payload_bytes; /**< The size of the compressed block, if any. */
+	uint32_t num_labels; /**< The label alphabet size, if labelled. */
+	uint32_t reserved; /**< Zero; pads the header to a multiple of 8 bytes. */
+};
+
+/** Set in BinaryGraphHeader::flags if a labels block is present. */
+const uint32_t binary_flag_labels = 1;
+
+/** Set in BinaryGraphHeader::flags if neighbours are delta+varint compressed. */
+const uint32_t binary_flag_compressed = 2;
+
+/**
+ * Determines whether the length bytes at data begin with a binary graph header.
+ */
+bool is_binary_graph( char const *data, const size_t length );
+
+/**
+ * Reads a binary graph that is resident in memory.
+ * @param data The file contents, which must be 8-byte aligned.
+ * @param length The number of bytes at data.
+ * @param backing The owner of data. Uncompressed graphs borrow their arrays
+ * directly from data, keeping backing alive, rather than copying them.
+ * @param g Set to the graph.
+ * @param labels Set to the vertex labels, or emptied if there are none.
+ * @param num_labels Set to the label alphabet size, or 0 if there are no labels.
+ * @return False if data is not a well-formed binary graph of this version:
+ * e.g., if a block runs past length, a neighbour list is unsorted or has an
+ * id that is out of range, an edge is stored in one direction only, or a
+ * label is outside the declared alphabet.
+ */
+bool read_binary_graph( char const *data, const size_t length,
+	std::shared_ptr< const void > const& backing, CsrGraph *g,
+	std::vector< uint32_t > *labels, uint32_t *num_labels );
+
+/**
+ * Writes a graph in the binary format.
+ * @param filename The path of the file to (over)write.
+ * @param g The graph to write.
+ * @param labels The vertex labels to store, or NULL to store none.
+ * @param num_labels The label alphabet size (ignored if labels is NULL).
+ * @param compress Whether to delta+varint compress the neighbour lists.
+ * @return False if the file could not be written.
+ */
+bool write_binary_graph( const std::string filename, CsrGraph const& g,
+	std::vector< uint32_t > const *labels, const uint32_t num_labels, const bool compress );
+
+#endif /* BINARY_FORMAT_H_ */
@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Implementation of unit tests for the binary graph format.
+ *
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for mkstemp */
+#include <cstring> /* for std::memcpy */
+#include <stdio.h> /* for remove */
+#include <unistd.h> /* for close */
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "binary_format.test.h"
+#include "binary_format.h"
+#include "random_graph.h"
+#include "csr_graph.h"
+
+namespace
+{
+	/**
+	 * Writes a graph in the binary format and reads the file back into an
+	 * 8-byte aligned buffer.
+	 * @return The file contents, or empty if the file could not be written.
+	 */
+	std::vector< uint64_t > write_and_read( CsrGraph const& g,
+		std::vector< uint32_t > const *labels, const uint32_t num_labels,
+		const bool compress, size_t *length ) {
+
+		std::string path = "/tmp/graphAnon_test_XXXXXX";
+		const int fd = mkstemp( &path[ 0 ] );
+		if( fd < 0 ) { return std::vector< uint64_t >(); }
+		close( fd );
+		std::vector< char > bytes;
+		if( write_binary_graph( path, g, labels, num_labels, compress ) ) {
+			std::ifstream file( path, std::ios::binary );
+			bytes.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+		}
+		remove( path.c_str() );
+		std::vector< uint64_t > buffer( ( bytes.size() + 7 ) / 8, 0 );
+		if( !bytes.empty() ) { std::memcpy( buffer.data(), bytes.data(), bytes.size() ); }
+		*length = bytes.size();
+		return buffer;
+	}
+
+	/**
+	 * Determines whether a file reads back as exactly g and labels.
+	 */
+	bool reads_as( std::vector< uint64_t > const& buffer, const size_t length,
+		CsrGraph const& g, std::vector< uint32_t > const& labels, const uint32_t num_labels ) {
+
+		/* buffer outlives read, so the backing need not own it. */
+		std::shared_ptr< const void > const backing( buffer.data(), []( void const* ) {} );
+		CsrGraph read;
+		std::vector< uint32_t > read_labels;
+		uint32_t read_num_labels;
+		if( !read_binary_graph( reinterpret_cast< char const* >( buffer.data() ), length,
+				backing, &read, &read_labels, &read_num_labels ) ) {
+			return false;
+		}
+		const uint32_t n = g.num_vertices();
+		return read.num_vertices() == n && read_labels == labels && read_num_labels == num_labels
+			&& std::equal( g.offsets(), g.offsets() + n + 1, read.offsets() )
+			&& std::equal( g.neighbour_array(), g.neighbour_array() + g.offsets()[ n ],
+				read.neighbour_array() );
+	}
+
+	/**
+	 * Determines whether read_binary_graph() rejects a copy of a file in which
+	 * the uint32_t at byte position has been overwritten with value.
+	 */
+	bool rejects_corrupted( std::vector< uint64_t > buffer, const size_t length,
+		const size_t position, const uint32_t value ) {
+
+		std::memcpy( reinterpret_cast< char* >( buffer.data() ) + position, &value, sizeof( value ) );
+		CsrGraph g;
+		std::vector< uint32_t > labels;
+		uint32_t num_labels;
+		return !read_binary_graph( reinterpret_cast< char const* >( buffer.data() ), length,
+			std::shared_ptr< const void >(), &g, &labels, &num_labels );
+	}
+}
+
+bool test_binary_format() {
+
+	bool passed = true;
+	size_t length;
+
+	/**
+	 * @test Round trips
+	 * A random labelled graph reads back as it was written, both
+	 * uncompressed and delta+varint compressed.
+	 */
+	CsrGraph const g = graphAnon::random_gnm( 1000, 5000, 2017 );
+	std::vector< uint32_t > labels( g.num_vertices() );
+	for( uint32_t v = 0; v < g.num_vertices(); ++v ) { labels[ v ] = v % 3; }
+	for( bool const compress : { false, true } ) {
+		std::vector< uint64_t > const buffer = write_and_read( g, &labels, 3, compress, &length );
+		if( !reads_as( buffer, length, g, labels, 3 ) ) { passed = false; }
+	}
+
+	/**
+	 * @test Corrupted files
+	 * In the path 0-1-2-3, with labels 0 1 0 1, stored uncompressed, the
+	 * neighbours lie at byte 88 (after the 48-byte header and 5 offsets),
+	 * as 1 | 0 2 | 1 3 | 2, and the labels at byte 112. Each corruption
+	 * below leaves a file whose blocks are the right size, but which is
+	 * rejected rather than loaded.
+	 */
+	CsrGraph const path = graphAnon::csr_from_edges( 4, { { 0, 1 }, { 1, 2 }, { 2, 3 } } );
+	std::vector< uint32_t > const path_labels { 0, 1, 0, 1 };
+	std::vector< uint64_t > const file = write_and_read( path, &path_labels, 2, false, &length );
+	const size_t offsets = sizeof( BinaryGraphHeader );
+	const size_t neighbours = offsets + 5 * sizeof( uint64_t );
+	const size_t labels_block = neighbours + 6 * sizeof( uint32_t );
+	if( !reads_as( file, length, path, path_labels, 2 ) ) { passed = false; }
+
+	/* An asymmetric edge: (0,2) without (2,0), and (1,0) without (0,1). */
+	if( !rejects_corrupted( file, length, neighbours, 2 ) ) { passed = false; }
+	/* A neighbour id that is out of range. */
+	if( !rejects_corrupted( file, length, neighbours, 4000000000u ) ) { passed = false; }
+	/* An unsorted neighbour list: 2 0 instead of 0 2. */
+	if( !rejects_corrupted( file, length, neighbours + 2 * sizeof( uint32_t ), 3 ) ) { passed = false; }
+	/* A self-loop: 1 1 instead of 1 3. */
+	if( !rejects_corrupted( file, length, neighbours + 5 * sizeof( uint32_t ), 1 ) ) { passed = false; }
+	/* A decreasing offset, and one far past the neighbours. */
+	if( !rejects_corrupted( file, length, offsets + 2 * sizeof( uint64_t ), 0 ) ) { passed = false; }
+	if( !rejects_corrupted( file, length, offsets + 3 * sizeof( uint64_t ) + 4, 1u << 28 ) ) {
+		passed = false;
+	}
+	/* A label outside the alphabet. */
+	if( !rejects_corrupted( file, length, labels_block + 3 * sizeof( uint32_t ), 2 ) ) { passed = false; }
+
+	return passed;
+}
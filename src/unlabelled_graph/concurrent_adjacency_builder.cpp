@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Implementation of the ConcurrentAdjacencyBuilder class in
+ * concurrent_adjacency_builder.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>	/* for uint32_t */
+
+#include "omp.h"
+
+#include "concurrent_adjacency_builder.h" /* implementing this class. */
+
+namespace
+{
+	/**
+	 * The number of stripes per thread: enough that two threads rarely want
+	 * the same stripe at once.
+	 */
+	const uint32_t stripes_per_thread = 256;
+}
+
+ConcurrentAdjacencyBuilder::ConcurrentAdjacencyBuilder( AdjacencyList *adjacency_list )
+	: adjacency_list_( adjacency_list ), pending_( adjacency_list->size() ), num_queued_( 0 ) {
+
+	uint32_t num_stripes = 1;
+	while( num_stripes < stripes_per_thread * static_cast< uint32_t >( omp_get_max_threads() ) ) {
+		num_stripes *= 2;
+	}
+	stripes_.reset( new Stripe[ num_stripes ] );
+	for( uint32_t i = 0; i < num_stripes; ++i ) { stripes_[ i ].locked.clear(); }
+	stripe_mask_ = num_stripes - 1;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Definition of a builder through which many threads can insert
+ * edges into an adjacency list at once.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONCURRENT_ADJACENCY_BUILDER_H_
+#define CONCURRENT_ADJACENCY_BUILDER_H_
+
+#include <cstdint>		/* For uint32_t, uint64_t */
+#include <algorithm>	/* For std::sort, std::unique */
+#include <atomic>		/* For std::atomic, std::atomic_flag */
+#include <memory>		/* For std::unique_ptr */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "omp.h"
+
+#include "unlabelled_graph.h" /* for AdjacencyList */
+#include "profile.h"
+
+/**
+ * @brief Collects undirected edges from any number of threads and then
+ * inserts them all into an AdjacencyList in parallel.
+ *
+ * add_edge() appends each endpoint to the other's pending list under one of
+ * a fixed number of striped spinlocks (a vertex's stripe is its id modulo
+ * the number of stripes), so concurrent calls only contend when they touch
+ * vertices of the same stripe at the same moment. commit() then sorts and
+ * deduplicates every pending list and inserts it into its NeighbourList, in
+ * parallel across vertices, so that no NeighbourList is ever modified by two
+ * threads and each receives its new neighbours in ascending order, however
+ * the calls to add_edge() interleaved. Duplicate edges, edges that already
+ * exist, and self-loops are all discarded.
+ */
+class ConcurrentAdjacencyBuilder {
+public:
+
+	/**
+	 * Constructs a builder that inserts into adjacency_list.
+	 * @param adjacency_list The adjacency list to extend. It must outlive the
+	 * builder and must not be modified otherwise until commit().
+	 */
+	explicit ConcurrentAdjacencyBuilder( AdjacencyList *adjacency_list );
+
+	/**
+	 * Queues the undirected edge (u,v) for insertion. Safe to call
+	 * concurrently from any number of threads.
+	 */
+	void add_edge( const uint32_t u, const uint32_t v ) {
+		if( u == v ) { return; }
+		append( u, v );
+		append( v, u );
+		num_queued_.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	/**
+	 * Accessor method to retrieve the number of edges queued since the last
+	 * commit(), including any duplicates.
+	 */
+	uint64_t num_queued() const { return num_queued_.load( std::memory_order_relaxed ); }
+
+	/**
+	 * Inserts every queued edge that is not already in the adjacency list.
+	 * @param on_new_neighbour Invoked as on_new_neighbour( u, v ) for each
+	 * side of each inserted edge, by the only thread that is inserting into
+	 * u's neighbour list (so it may update per-vertex state of u unguarded).
+	 * @return The number of undirected edges that were inserted.
+	 * @post No edges are queued.
+	 * @pre No thread is calling add_edge().
+	 */
+	template < typename NeighbourSink >
+	uint64_t commit( NeighbourSink on_new_neighbour );
+
+	/**
+	 * Inserts every queued edge that is not already in the adjacency list.
+	 * @see commit( NeighbourSink )
+	 */
+	uint64_t commit() { return commit( []( const uint32_t, const uint32_t ) {} ); }
+
+private:
+
+	/**
+	 * A spinlock, padded so that adjacent stripes do not share a cache line.
+	 */
+	struct Stripe {
+		std::atomic_flag locked; /**< Set while a thread holds the stripe. */
+		char padding[ 64 - sizeof( std::atomic_flag ) ]; /**< Unused. */
+	};
+
+	/**
+	 * Appends v to the pending neighbours of u, under u's stripe.
+	 */
+	void append( const uint32_t u, const uint32_t v ) {
+		std::atomic_flag &lock = stripes_[ u & stripe_mask_ ].locked;
+		while( lock.test_and_set( std::memory_order_acquire ) ) {}
+		pending_[ u ].push_back( v );
+		lock.clear( std::memory_order_release );
+	}
+
+	AdjacencyList *adjacency_list_; /**< The adjacency list being extended. */
+	std::vector< std::vector< uint32_t > > pending_; /**< The queued neighbours of each vertex. */
+	std::unique_ptr< Stripe[] > stripes_; /**< The locks guarding pending_. */
+	uint32_t stripe_mask_; /**< The number of stripes (a power of two), minus one. */
+	std::atomic< uint64_t > num_queued_; /**< The number of add_edge() calls since commit(). */
+};
+
+template < typename NeighbourSink >
+uint64_t ConcurrentAdjacencyBuilder::commit( NeighbourSink on_new_neighbour ) {
+
+	const uint32_t n = static_cast< uint32_t >( pending_.size() );
+	uint64_t num_inserted = 0;
+#pragma omp parallel for schedule( dynamic, 256 ) reduction( +: num_inserted )
+	for( uint32_t u = 0; u < n; ++u ) {
+		std::vector< uint32_t > &pending = pending_[ u ];
+		if( pending.empty() ) { continue; }
+		std::sort( pending.begin(), pending.end() );
+		pending.erase( std::unique( pending.begin(), pending.end() ), pending.end() );
+
+		/* Grow the neighbour list at most once, rather than once per doubling. */
+		NeighbourList &neighbours = ( *adjacency_list_ )[ u ];
+		const size_t capacity = neighbours.capacity();
+		neighbours.reserve( neighbours.size() + pending.size() );
+		if( neighbours.capacity() != capacity ) { GRAPHANON_PROFILE_COUNT( hash_rehashes, 1 ); }
+		for( uint32_t const v : pending ) {
+			if( neighbours.insert( v ) ) {
+				on_new_neighbour( u, v );
+				if( u < v ) { ++num_inserted; } /* count each edge from one side only */
+			}
+		}
+		std::vector< uint32_t >().swap( pending );
+	}
+	num_queued_.store( 0, std::memory_order_relaxed );
+	GRAPHANON_PROFILE_COUNT( edges_added, num_inserted );
+	return num_inserted;
+}
+
+#endif /* CONCURRENT_ADJACENCY_BUILDER_H_ */
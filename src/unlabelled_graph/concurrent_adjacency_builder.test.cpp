@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in concurrent_adjacency_builder.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for rand */
+#include <set>
+#include <vector>
+#include <utility>
+
+#include "omp.h"
+
+#include "concurrent_adjacency_builder.test.h"
+#include "concurrent_adjacency_builder.h"
+
+bool test_concurrent_adjacency_builder() {
+	for( uint32_t trial = 0; trial < 10; ++trial ) {
+		const uint32_t n = 1 + rand() % 300;
+
+		/* Start from a random graph, recorded as a set of ordered pairs. */
+		AdjacencyList adjacency_list( n );
+		std::set< std::pair< uint32_t, uint32_t > > expected;
+		for( uint32_t i = 0; i < n; ++i ) {
+			const uint32_t u = rand() % n, v = rand() % n;
+			if( u == v ) { continue; }
+			adjacency_list[ u ].insert( v );
+			adjacency_list[ v ].insert( u );
+			expected.insert( std::make_pair( u, v ) );
+			expected.insert( std::make_pair( v, u ) );
+		}
+		const uint64_t num_initial = expected.size() / 2;
+
+		/* Then queue many edges, including self-loops, duplicates, existing
+		 * edges, and both orientations of the same edge. */
+		std::vector< std::pair< uint32_t, uint32_t > > edges( 20 * n );
+		uint64_t num_loops = 0;
+		for( auto &e : edges ) {
+			e = std::make_pair( rand() % n, rand() % n );
+			if( e.first == e.second ) { ++num_loops; }
+			else {
+				expected.insert( e );
+				expected.insert( std::make_pair( e.second, e.first ) );
+			}
+		}
+
+		/**
+		 * @test Concurrent insertion
+		 * Every thread queues edges at once; committing them inserts exactly
+		 * the new ones, reporting each side of each to its own vertex.
+		 */
+		ConcurrentAdjacencyBuilder builder( &adjacency_list );
+#pragma omp parallel for schedule( dynamic, 16 )
+		for( size_t i = 0; i < edges.size(); ++i ) { builder.add_edge( edges[ i ].first, edges[ i ].second ); }
+		if( builder.num_queued() != edges.size() - num_loops ) { return false; }
+
+		std::vector< uint32_t > num_new_neighbours( n, 0 );
+		const uint64_t num_inserted = builder.commit( [ &num_new_neighbours ]( const uint32_t u, const uint32_t ) {
+			++num_new_neighbours[ u ];
+		} );
+		if( num_inserted != expected.size() / 2 - num_initial || builder.num_queued() != 0 ) { return false; }
+
+		uint64_t num_neighbours = 0;
+		for( uint32_t u = 0; u < n; ++u ) {
+			num_neighbours += adjacency_list[ u ].size();
+			for( uint32_t const v : adjacency_list[ u ] ) {
+				if( expected.count( std::make_pair( u, v ) ) == 0 ) { return false; }
+			}
+		}
+		uint64_t num_reported = 0;
+		for( uint32_t const count : num_new_neighbours ) { num_reported += count; }
+		if( num_neighbours != expected.size() || num_reported != 2 * num_inserted ) { return false; }
+
+		/**
+		 * @test Boundary case: nothing queued
+		 * A second commit inserts nothing.
+		 */
+		if( builder.commit() != 0 ) { return false; }
+
+		/**
+		 * @test Deterministic order
+		 * The same edges queued in the opposite order leave every neighbour
+		 * list iterating in the same order.
+		 */
+		AdjacencyList forwards( n ), backwards( n );
+		ConcurrentAdjacencyBuilder forwards_builder( &forwards ), backwards_builder( &backwards );
+		for( size_t i = 0; i < edges.size(); ++i ) {
+			forwards_builder.add_edge( edges[ i ].first, edges[ i ].second );
+			backwards_builder.add_edge( edges[ edges.size() - 1 - i ].second, edges[ edges.size() - 1 - i ].first );
+		}
+		forwards_builder.commit();
+		backwards_builder.commit();
+		for( uint32_t u = 0; u < n; ++u ) {
+			if( std::vector< uint32_t >( forwards[ u ].begin(), forwards[ u ].end() )
+					!= std::vector< uint32_t >( backwards[ u ].begin(), backwards[ u ].end() ) ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @brief Unit tests for the ConcurrentAdjacencyBuilder class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONCURRENT_ADJACENCY_BUILDER_TEST_H_
+#define CONCURRENT_ADJACENCY_BUILDER_TEST_H_
+
+/**
+ * Asserts that edges queued in a ConcurrentAdjacencyBuilder by many threads
+ * at once are inserted exactly as sequential insertion would, and in an
+ * order that does not depend on how the threads interleaved, by executing a
+ * series of randomised unit tests.
+ * @return True if all the tests pass; false if any test fails.
+ */
+bool test_concurrent_adjacency_builder();
+
+#endif /* CONCURRENT_ADJACENCY_BUILDER_TEST_H_ */
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Implementation of the CsrGraph class in csr_graph.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::binary_search, std::sort, std::unique */
+#include <utility>		/* for std::move */
+#include <cassert>
+
+#include "csr_graph.h" /* implementing this class. */
+
+CsrGraph::CsrGraph() : n_( 0 ), owned_offsets_( 1, 0 ) {
+	offsets_ = owned_offsets_.data();
+	neighbours_ = owned_neighbours_.data();
+}
+
+CsrGraph::CsrGraph( std::vector< uint64_t > &&offsets, std::vector< uint32_t > &&neighbours )
+	: n_( static_cast< uint32_t >( offsets.size() - 1 ) ),
+	owned_offsets_( std::move( offsets ) ), owned_neighbours_( std::move( neighbours ) )
+{
+	assert( !owned_offsets_.empty() );
+	assert( owned_offsets_.back() == owned_neighbours_.size() );
+	offsets_ = owned_offsets_.data();
+	neighbours_ = owned_neighbours_.data();
+}
+
+CsrGraph::CsrGraph( const uint32_t num_vertices, uint64_t const *offsets,
+	uint32_t const *neighbours, std::shared_ptr< const void > backing )
+	: n_( num_vertices ), offsets_( offsets ), neighbours_( neighbours ),
+	backing_( std::move( backing ) ) {}
+
+CsrGraph::CsrGraph( CsrGraph &&other ) { *this = std::move( other ); }
+
+CsrGraph& CsrGraph::operator=( CsrGraph &&other ) {
+	if( this == &other ) { return *this; }
+
+	/* Moving a vector keeps its buffer, so owned arrays can be re-pointed. */
+	const bool owned = other.backing_ == nullptr;
+	n_ = other.n_;
+	owned_offsets_ = std::move( other.owned_offsets_ );
+	owned_neighbours_ = std::move( other.owned_neighbours_ );
+	backing_ = std::move( other.backing_ );
+	offsets_ = owned ? owned_offsets_.data() : other.offsets_;
+	neighbours_ = owned ? owned_neighbours_.data() : other.neighbours_;
+
+	/* Leave other as a valid, empty graph. */
+	other.n_ = 0;
+	other.owned_offsets_.assign( 1, 0 );
+	other.owned_neighbours_.clear();
+	other.offsets_ = other.owned_offsets_.data();
+	other.neighbours_ = other.owned_neighbours_.data();
+	return *this;
+}
+
+bool CsrGraph::has_edge( const uint32_t u, const uint32_t v ) const {
+
+	/* Search the shorter of the two sorted neighbour lists. */
+	if( degree( u ) > degree( v ) ) {
+		NeighbourRange const nv = neighbours( v );
+		return std::binary_search( nv.begin(), nv.end(), u );
+	}
+	NeighbourRange const nu = neighbours( u );
+	return std::binary_search( nu.begin(), nu.end(), v );
+}
+
+namespace graphAnon
+{
+	CsrGraph csr_from_edges( const uint32_t num_vertices, EdgeList const& edges ) {
+		std::vector< uint64_t > offsets( static_cast< uint64_t >( num_vertices ) + 1, 0 );
+		for( auto const& e : edges ) {
+			assert( e.first < num_vertices && e.second < num_vertices );
+			if( e.first == e.second ) { continue; }
+			++offsets[ e.first + 1 ];
+			++offsets[ e.second + 1 ];
+		}
+		for( uint32_t u = 0; u < num_vertices; ++u ) { offsets[ u + 1 ] += offsets[ u ]; }
+
+		std::vector< uint32_t > neighbours( offsets[ num_vertices ] );
+		std::vector< uint64_t > next( offsets.begin(), offsets.end() - 1 );
+		for( auto const& e : edges ) {
+			if( e.first == e.second ) { continue; }
+			neighbours[ next[ e.first ]++ ] = e.second;
+			neighbours[ next[ e.second ]++ ] = e.first;
+		}
+
+		/* Sort each list and drop its repeats, compacting the lists leftward. */
+		uint64_t kept = 0;
+		for( uint32_t u = 0; u < num_vertices; ++u ) {
+			auto const first = neighbours.begin() + offsets[ u ];
+			auto const last = neighbours.begin() + offsets[ u + 1 ];
+			std::sort( first, last );
+			auto const unique_last = std::unique( first, last );
+			std::move( first, unique_last, neighbours.begin() + kept );
+			offsets[ u ] = kept;
+			kept += unique_last - first;
+		}
+		offsets[ num_vertices ] = kept;
+		neighbours.resize( kept );
+		return CsrGraph( std::move( offsets ), std::move( neighbours ) );
+	}
+
+	EdgeList edge_list( CsrGraph const& g ) {
+		EdgeList edges;
+		edges.reserve( g.num_edges() );
+		for( uint32_t u = 0; u < g.num_vertices(); ++u ) {
+			for( uint32_t const v : g.neighbours( u ) ) {
+				if( u < v ) { edges.push_back( std::make_pair( u, v ) ); }
+			}
+		}
+		return edges;
+	}
+}
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @brief Definition of an immutable, compressed sparse row (CSR) graph
+ * representation over which the analysis routines run.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CSR_GRAPH_H_
+#define CSR_GRAPH_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+/* STL libraries in use */
+#include <vector>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief A contiguous, read-only view of the neighbours of one vertex
+ * in a CsrGraph, sorted in ascending order of vertex id.
+ */
+class NeighbourRange {
+public:
+
+	/**
+	 * Constructs a range over the half-open interval [first, last).
+	 */
+	NeighbourRange( uint32_t const *first, uint32_t const *last )
+		: first_( first ), last_( last ) {}
+
+	uint32_t const* begin() const { return first_; }
+	uint32_t const* end() const { return last_; }
+
+	/**
+	 * The number of neighbours in the range (i.e., the vertex degree).
+	 */
+	uint32_t size() const { return static_cast< uint32_t >( last_ - first_ ); }
+
+private:
+	uint32_t const *first_; /**< The first neighbour in the range. */
+	uint32_t const *last_; /**< One past the last neighbour in the range. */
+};
+
+/**
+ * @brief An immutable, undirected graph stored in compressed sparse row format.
+ *
+ * The neighbours of vertex v occupy the sorted, contiguous slice
+ * [ offsets[ v ], offsets[ v + 1 ] ) of a single neighbour array, and every
+ * undirected edge (u,v) is stored twice: once as v in u's slice and once
+ * as u in v's slice. An UnlabelledGraph freezes into a CsrGraph once it has
+ * finished mutating, so that the analysis routines can scan neighbourhoods
+ * without chasing a pointer per edge.
+ *
+ * The arrays are either owned by the CsrGraph or borrowed from a backing
+ * object that it keeps alive (e.g., a memory-mapped binary graph file), so
+ * that a graph stored in graphAnon::FileFormat::binary can be analysed
+ * without copying it.
+ */
+class CsrGraph {
+public:
+
+	/**
+	 * Constructs an empty CsrGraph with no vertices and no edges.
+	 */
+	CsrGraph();
+
+	/**
+	 * Constructs a CsrGraph by taking ownership of pre-built CSR arrays.
+	 * @param offsets An array of n + 1 monotonically non-decreasing
+	 * positions into neighbours, with offsets[ 0 ] = 0.
+	 * @param neighbours The concatenation of all n neighbour lists, each of
+	 * which is sorted in ascending order and contains no duplicates.
+	 * @pre Every edge appears in both directions in neighbours.
+	 */
+	CsrGraph( std::vector< uint64_t > &&offsets, std::vector< uint32_t > &&neighbours );
+
+	/**
+	 * Constructs a CsrGraph that views CSR arrays owned by another object.
+	 * @param num_vertices The number of vertices, n.
+	 * @param offsets An array of n + 1 positions, as for the owning constructor.
+	 * @param neighbours An array of offsets[ n ] neighbours, as for the owning
+	 * constructor.
+	 * @param backing The owner of both arrays, which is kept alive for as long
+	 * as this CsrGraph (or any CsrGraph moved from it) exists.
+	 */
+	CsrGraph( const uint32_t num_vertices, uint64_t const *offsets,
+		uint32_t const *neighbours, std::shared_ptr< const void > backing );
+
+	CsrGraph( CsrGraph &&other );
+	CsrGraph& operator=( CsrGraph &&other );
+	CsrGraph( CsrGraph const& ) = delete;
+	CsrGraph& operator=( CsrGraph const& ) = delete;
+
+	/**
+	 * Accessor method to retrieve the number of vertices in the graph, |V|.
+	 */
+	uint32_t num_vertices() const { return n_; }
+
+	/**
+	 * Accessor method to retrieve the number of undirected edges in the graph, |E|.
+	 */
+	uint64_t num_edges() const { return offsets_[ n_ ] / 2; }
+
+	/**
+	 * Retrieves the number of neighbours of vertex v.
+	 */
+	uint32_t degree( const uint32_t v ) const {
+		return static_cast< uint32_t >( offsets_[ v + 1 ] - offsets_[ v ] );
+	}
+
+	/**
+	 * Retrieves the sorted neighbours of vertex v.
+	 */
+	NeighbourRange neighbours( const uint32_t v ) const {
+		return NeighbourRange( neighbours_ + offsets_[ v ], neighbours_ + offsets_[ v + 1 ] );
+	}
+
+	/**
+	 * Determines whether the undirected edge (u,v) exists, by binary searching
+	 * the neighbours of whichever endpoint has the smaller degree.
+	 */
+	bool has_edge( const uint32_t u, const uint32_t v ) const;
+
+	/**
+	 * Direct access to the n + 1 offsets into the neighbour array.
+	 */
+	uint64_t const* offsets() const { return offsets_; }
+
+	/**
+	 * Direct access to the concatenated, sorted neighbour lists.
+	 */
+	uint32_t const* neighbour_array() const { return neighbours_; }
+
+private:
+
+	uint32_t n_; /**< The number of vertices in the graph. */
+	uint64_t const *offsets_; /**< Start of each vertex's neighbours. */
+	uint32_t const *neighbours_; /**< All neighbour lists, back to back. */
+
+	std::vector< uint64_t > owned_offsets_; /**< The offsets, if owned. */
+	std::vector< uint32_t > owned_neighbours_; /**< The neighbours, if owned. */
+	std::shared_ptr< const void > backing_; /**< The owner of borrowed arrays. */
+};
+
+namespace graphAnon
+{
+	/**
+	 * A list of undirected edges (u,v), each given once in either direction.
+	 */
+	typedef std::vector< std::pair< uint32_t, uint32_t > > EdgeList;
+
+	/**
+	 * Builds a CsrGraph from a list of undirected edges by counting sort.
+	 * @param num_vertices The number of vertices, n.
+	 * @param edges The edges, each of whose endpoints is less than n.
+	 * Self-loops are ignored, as are repeats of an edge (in either direction).
+	 */
+	CsrGraph csr_from_edges( const uint32_t num_vertices, EdgeList const& edges );
+
+	/**
+	 * Lists every edge (u,v) of g once, with u < v, in ascending order.
+	 */
+	EdgeList edge_list( CsrGraph const& g );
+}
+
+#endif /* CSR_GRAPH_H_ */
@@ -0,0 +1,178 @@
+/**
+ * @file
+ * @brief Implementation of the DegreeSequenceAnonymiser class in degree_anonymiser.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, int64_t */
+#include <algorithm>	/* for std::push_heap, std::pop_heap, std::min, std::reverse */
+#include <limits>		/* for std::numeric_limits */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+#include <utility>
+
+#include "degree_anonymiser.h" /* implementing this class. */
+
+void DegreeSequenceAnonymiser::set( std::vector< Candidate > *tree, uint32_t slot,
+	Candidate const& candidate ) {
+
+	Candidate *const nodes = tree->data();
+	slot += capacity_;
+	nodes[ slot ] = candidate;
+	for( slot /= 2; slot > 0; slot /= 2 ) {
+		nodes[ slot ] = std::min( nodes[ 2 * slot ], nodes[ 2 * slot + 1 ] );
+	}
+}
+
+uint32_t DegreeSequenceAnonymiser::anonymise( DegreeSequence *degrees, const uint32_t k ) {
+
+	std::vector< uint32_t > block_starts;
+	const uint32_t max_deficiency = partition( *degrees, k, &block_starts );
+
+	/* Raise every vertex in each block to the degree of the first. */
+	std::pair< uint32_t, uint32_t > *const sequence = degrees->data();
+	const uint32_t n = degrees->size();
+	for( uint32_t b = 0; b < block_starts.size(); ++b ) {
+		const uint32_t block_end = b + 1 < block_starts.size() ? block_starts[ b + 1 ] : n;
+		for( uint32_t j = block_starts[ b ] + 1; j < block_end; ++j ) {
+			sequence[ j ].first = sequence[ block_starts[ b ] ].first;
+		}
+	}
+	return max_deficiency;
+}
+
+uint32_t DegreeSequenceAnonymiser::partition( DegreeSequence const& degrees, const uint32_t k,
+	std::vector< uint32_t > *block_starts ) {
+
+	assert( k > 0 );
+	const uint32_t n = degrees.size();
+	std::pair< uint32_t, uint32_t > const *const sequence = degrees.data();
+	block_starts->clear();
+
+	// Check if the graph is large enough to meaningfully anonymise. 
+	// Cannot split fewer than 2k vertices into two groups; so, a graph 
+	// of n < 2k vertices must already be transformed into the complete graph.
+	if( n < 2 * k ) {
+		uint32_t deficiency = 0;
+		for( uint32_t i = 0; i < n; ++i ) {
+			if( i > 0 ) { deficiency += sequence[ 0 ].first - sequence[ i ].first; }
+			block_starts->push_back( i );
+		}
+		return deficiency;
+	}
+
+	values_.resize( n );
+	for( uint32_t i = 0; i < n; ++i ) { values_[ i ] = sequence[ i ].first; }
+	uint32_t const *const d = values_.data();
+	costs_.resize( n );
+	starts_.resize( n );
+
+	/* trivially populate first 2k - 1 positions, since cannot split. */
+	for( uint32_t i = 0; i < 2 * k - 1; ++i ) {
+		starts_[ i ] = 0;
+		costs_[ i ] = d[ 0 ] - d[ i ];
+	}
+
+	/* The window of splits holds at most k positions, each in slot j % capacity_. */
+	capacity_ = 1;
+	while( capacity_ < k ) { capacity_ *= 2; }
+	const uint32_t mask = capacity_ - 1;
+	Candidate const none = { std::numeric_limits< int64_t >::max(),
+		std::numeric_limits< int64_t >::max(), std::numeric_limits< uint32_t >::max() };
+	max_cost_tree_.assign( 2 * capacity_, none );
+	max_gap_tree_.assign( 2 * capacity_, none );
+	thresholds_.clear();
+
+	/* compute best split for remaining n - (2k - 1) positions. */
+	uint32_t next_split = k - 1; /* the next position to enter the window. */
+	uint32_t first_split = k - 1; /* the first position still in the window. */
+	for( uint32_t i = 2 * k - 1; i < n; ++i ) {
+		const uint32_t range_end = i - k;
+		const uint32_t range_start = ( k - 1 > i - 2 * k + 1 ? k - 1 : i - 2 * k + 1 );
+		const int64_t last = d[ i ];
+
+		/* Slide the window to [ range_start, range_end ]. */
+		for( ; first_split < range_start; ++first_split ) {
+			set( &max_cost_tree_, first_split & mask, none );
+			set( &max_gap_tree_, first_split & mask, none );
+		}
+		for( ; next_split <= range_end; ++next_split ) {
+			const int64_t cost = costs_[ next_split ];
+			const int64_t gap_start = d[ next_split + 1 ];
+			if( gap_start - cost <= last ) {
+				Candidate const c = { cost, cost + gap_start, next_split };
+				set( &max_cost_tree_, next_split & mask, c );
+				thresholds_.push_back( std::make_pair( gap_start - cost, next_split ) );
+				std::push_heap( thresholds_.begin(), thresholds_.end() );
+			}
+			else {
+				Candidate const c = { gap_start, cost + gap_start, next_split };
+				set( &max_gap_tree_, next_split & mask, c );
+			}
+		}
+
+		/* Splits whose last block's deficiency, d[ j + 1 ] - d[ i ], now
+		 * exceeds cost[ j ] move to the other tree (for good, as d[ i ] only
+		 * decreases). Splits that have already left the window are dropped. */
+		while( !thresholds_.empty() && thresholds_.front().first > last ) {
+			const uint32_t j = thresholds_.front().second;
+			std::pop_heap( thresholds_.begin(), thresholds_.end() );
+			thresholds_.pop_back();
+			if( j >= first_split ) {
+				Candidate const c = { d[ j + 1 ], max_cost_tree_[ capacity_ + ( j & mask ) ].sum, j };
+				set( &max_cost_tree_, j & mask, none );
+				set( &max_gap_tree_, j & mask, c );
+			}
+		}
+
+		/* Compare the best of each tree on (max deficiency, sum, position). */
+		Candidate const& by_cost = max_cost_tree_[ 1 ];
+		Candidate const& by_gap = max_gap_tree_[ 1 ];
+		Candidate const cost_best = { by_cost.key, by_cost.sum - last, by_cost.split };
+		Candidate const gap_best = { by_gap.key - last, by_gap.sum - last, by_gap.split };
+		Candidate const& best = by_gap.split == none.split
+			|| ( by_cost.split != none.split && cost_best < gap_best ) ? cost_best : gap_best;
+		starts_[ i ] = best.split + 1;
+		costs_[ i ] = static_cast< uint32_t >( best.key );
+	}
+
+	/* Recover the blocks by replaying the dynamic programming results
+	 * backwards. 
+	 * Be aware of crazy loop logic arising from use of unsigned ints: 
+	 * the termination condition is when i == -1, which for unsigned ints 
+	 * means that i == max_int > n.
+	 */
+	for( uint32_t i = n - 1; i < n; i = starts_[ i ] - 1 ) {
+		assert( starts_[ i ] <= i );
+		assert( d[ starts_[ i ] ] <= n );
+		block_starts->push_back( starts_[ i ] );
+	}
+	std::reverse( block_starts->begin(), block_starts->end() );
+	
+	/* Return max deficiency. */
+	return costs_[ n - 1 ];
+}
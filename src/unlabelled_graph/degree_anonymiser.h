@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief Definition of an O( n log k ) dynamic programme for optimally
+ * k-anonymising a degree sequence.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DEGREE_ANONYMISER_H_
+#define DEGREE_ANONYMISER_H_
+
+#include <cstdint>	/* For uint32_t, int64_t */
+
+/* STL libraries in use */
+#include <vector>
+#include <utility>
+
+/**
+ * A DegreeSequence is a list of the degrees for each of the n_ 
+ * vertices in a graph, sorted in descending order.
+ */
+typedef std::vector< std::pair< uint32_t, uint32_t > > DegreeSequence;
+
+/**
+ * @brief Optimally k-anonymises degree sequences with the dynamic programme
+ * of @cite waldo (Section 3.1), reusing its tables across calls.
+ *
+ * The programme computes, for every prefix of the sorted sequence, the
+ * smallest possible maximum deficiency when the prefix is split into blocks
+ * of k to 2k - 1 vertices, each raised to the degree of its first vertex.
+ * For prefix i, the candidate last blocks start just after a position j in
+ * a window that slides right as i grows, and a split at j costs
+ * max( cost[ j ], d[ j + 1 ] - d[ i ] ). Rather than rescanning the window
+ * (O( nk ) overall), the candidates are kept in two min-trees over the
+ * window: those for which cost[ j ] is the maximum, keyed on cost[ j ], and
+ * those for which d[ j + 1 ] - d[ i ] is, keyed on d[ j + 1 ]. Because d[ i ]
+ * only decreases, a candidate can only ever move from the first tree to the
+ * second, which a heap of thresholds detects. Each position is thus inserted,
+ * moved, and removed at most once, for O( n log k ) time and O( n ) space.
+ * @note Ties are broken exactly as by the original O( nk ) scan (smallest
+ * sum of the two costs, then the earliest split), so the anonymised
+ * sequence is identical.
+ */
+class DegreeSequenceAnonymiser {
+public:
+
+	/**
+	 * Optimally k-anonymizes the degree sequence such that max_deficiency is minimized.
+	 * @param degrees The original degree sequence as pairs of (degree, vertex id),
+	 * sorted in descending order
+	 * @param k The privacy threshold, k >= 1.
+	 * @return The maximum deficiency calculated to transform the original degree sequence 
+	 * into a k-anonymous one.
+	 * @post The degree sequence, degrees, is modified such that every element that appears 
+	 * in the list appears at least k times.
+	 * @see Section 3.1 and Table 1 of @cite waldo
+	 */
+	uint32_t anonymise( DegreeSequence *degrees, const uint32_t k );
+
+	/**
+	 * Computes the same anonymisation as anonymise() without applying it.
+	 * @param degrees The original degree sequence, sorted in descending order.
+	 * @param k The privacy threshold, k >= 1.
+	 * @param block_starts Overwritten with the first position of each block,
+	 * in ascending order: anonymise() raises every vertex of a block to the
+	 * degree of its first vertex. (If n < 2k, no degree is changed, and
+	 * every vertex forms its own block.)
+	 * @return The value that anonymise() returns.
+	 */
+	uint32_t partition( DegreeSequence const& degrees, const uint32_t k,
+		std::vector< uint32_t > *block_starts );
+
+private:
+
+	/**
+	 * A candidate split, ordered by (key, sum, split).
+	 */
+	struct Candidate {
+		int64_t key; /**< The cost[ j ] or d[ j + 1 ] by which candidates are ranked. */
+		int64_t sum; /**< cost[ j ] + d[ j + 1 ], the tie-breaker. */
+		uint32_t split; /**< The position j. */
+
+		bool operator<( Candidate const& other ) const {
+			if( key != other.key ) { return key < other.key; }
+			if( sum != other.sum ) { return sum < other.sum; }
+			return split < other.split;
+		}
+	};
+
+	/**
+	 * Sets the leaf for window slot slot in tree to candidate and repairs the
+	 * path to the root, which therefore always holds the minimum candidate.
+	 */
+	void set( std::vector< Candidate > *tree, uint32_t slot, Candidate const& candidate );
+
+	std::vector< uint32_t > values_; /**< The degrees, without vertex ids. */
+	std::vector< uint32_t > costs_; /**< The best maximum deficiency of each prefix. */
+	std::vector< uint32_t > starts_; /**< The start of the last block of each prefix. */
+	std::vector< Candidate > max_cost_tree_; /**< Candidates ranked by cost[ j ]. */
+	std::vector< Candidate > max_gap_tree_; /**< Candidates ranked by d[ j + 1 ]. */
+	std::vector< std::pair< int64_t, uint32_t > > thresholds_; /**< Heap of d[ j + 1 ] - cost[ j ]. */
+	uint32_t capacity_; /**< The number of window slots (leaves) per tree. */
+};
+
+#endif /* DEGREE_ANONYMISER_H_ */
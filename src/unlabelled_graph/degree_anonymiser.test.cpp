@@ -0,0 +1,129 @@
+/**
+ * @file
+ * @brief A set of functions for unit testing the DegreeSequenceAnonymiser class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <cstdlib> /* for rand */
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "degree_anonymiser.test.h"
+#include "degree_anonymiser.h"
+
+namespace
+{
+	/**
+	 * The original O( nk ) dynamic programme of @cite waldo , which scans
+	 * every split in the window for every position.
+	 */
+	uint32_t naive_anonymise( DegreeSequence *degrees, const uint32_t k ) {
+		const uint32_t n = degrees->size();
+		if( n < 2 * k ) {
+			uint32_t deficiency = 0;
+			for( uint32_t i = 1; i < n; ++i ) {
+				deficiency += degrees->at( 0 ).first - degrees->at( i ).first;
+			}
+			return deficiency;
+		}
+		std::vector< uint32_t > costs( n ), starts( n );
+		for( uint32_t i = 0; i < 2 * k - 1; ++i ) {
+			starts[ i ] = 0;
+			costs[ i ] = degrees->at( 0 ).first - degrees->at( i ).first;
+		}
+		for( uint32_t i = 2 * k - 1; i < n; ++i ) {
+			const uint32_t range_end = i - k;
+			const uint32_t range_start = ( k - 1 > i - 2 * k + 1 ? k - 1 : i - 2 * k + 1 );
+			uint32_t best_split_pos = range_start + 1;
+			const uint32_t cost_left = costs[ range_start ];
+			const uint32_t cost_right = degrees->at( range_start + 1 ).first - degrees->at( i ).first;
+			uint32_t best_cost = std::max( cost_left, cost_right );
+			uint32_t best_sum = cost_left + cost_right;
+			for( uint32_t j = range_start + 1; j <= range_end; ++j ) {
+				const uint32_t left = costs[ j ];
+				const uint32_t right = degrees->at( j + 1 ).first - degrees->at( i ).first;
+				const uint32_t full = std::max( left, right );
+				if( full < best_cost || ( full == best_cost && left + right < best_sum ) ) {
+					best_split_pos = j + 1;
+					best_cost = full;
+					best_sum = left + right;
+				}
+			}
+			starts[ i ] = best_split_pos;
+			costs[ i ] = best_cost;
+		}
+		for( uint32_t i = n - 1; i < n; i = starts[ i ] - 1 ) {
+			for( uint32_t j = starts[ i ] + 1; j <= i; ++j ) {
+				degrees->at( j ).first = degrees->at( starts[ i ] ).first;
+			}
+		}
+		return costs[ n - 1 ];
+	}
+}
+
+bool test_degree_anonymiser() {
+
+	bool passed = true;
+	DegreeSequenceAnonymiser anonymiser;
+
+	/**
+	 * @test Already anonymous
+	 * A regular degree sequence needs no additional edges for any k <= n / 2.
+	 */
+	DegreeSequence regular( 10, std::make_pair( 3u, 0u ) );
+	for( uint32_t v = 0; v < regular.size(); ++v ) { regular[ v ].second = v; }
+	DegreeSequence const expected_regular( regular );
+	if( anonymiser.anonymise( &regular, 5 ) != 0 || regular != expected_regular ) { passed = false; }
+
+	/**
+	 * @test Random degree sequences
+	 * Sequences with few distinct degrees (and so many ties between splits)
+	 * and with many should be anonymised exactly as by the original dynamic
+	 * programme, for every k, reusing one anonymiser for all of them.
+	 */
+	for( uint32_t trial = 0; trial < 60; ++trial ) {
+		const uint32_t n = 1 + rand() % 150;
+		const uint32_t max_degree = 1 + rand() % ( trial % 2 ? std::min( n, 5u ) : n );
+		DegreeSequence original( n );
+		for( uint32_t v = 0; v < n; ++v ) {
+			original[ v ] = std::make_pair( static_cast< uint32_t >( rand() % max_degree ), v );
+		}
+		std::sort( original.begin(), original.end(),
+			std::greater< std::pair< uint32_t, uint32_t > >() );
+
+		for( uint32_t k = 1; k <= n; k += 1 + k / 8 ) {
+			DegreeSequence expected( original ), actual( original );
+			const uint32_t expected_cost = naive_anonymise( &expected, k );
+			if( anonymiser.anonymise( &actual, k ) != expected_cost || actual != expected ) {
+				passed = false;
+			}
+		}
+	}
+
+	return passed;
+}
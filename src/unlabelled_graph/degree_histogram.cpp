@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Implementation of the DegreeHistogram class in degree_histogram.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "degree_histogram.h" /* implementing this class. */
+
+DegreeHistogram::DegreeHistogram() : k_( 0 ), num_small_( 0 ), built_( false ) {}
+
+void DegreeHistogram::invalidate() {
+	counts_.clear();
+	classes_.clear();
+	positions_.clear();
+	num_small_ = 0;
+	built_ = false;
+}
+
+void DegreeHistogram::reset( const uint32_t num_vertices ) {
+	invalidate();
+	built_ = true;
+	add_vertices( num_vertices );
+}
+
+void DegreeHistogram::add_vertices( const uint32_t num_vertices ) {
+	if( num_vertices == 0 ) { return; }
+	if( counts_.empty() ) {
+		counts_.push_back( 0 );
+		positions_.push_back( 0 );
+	}
+	if( counts_[ 0 ] == 0 ) {
+		positions_[ 0 ] = static_cast< uint32_t >( classes_.size() );
+		classes_.push_back( 0 );
+	}
+	num_small_ -= is_small( counts_[ 0 ] );
+	counts_[ 0 ] += num_vertices;
+	num_small_ += is_small( counts_[ 0 ] );
+}
+
+void DegreeHistogram::move( const uint32_t from, const uint32_t to ) {
+	assert( count( from ) > 0 );
+	if( from == to ) { return; }
+
+	/* Leave the old class, dropping it from classes_ if it empties. */
+	num_small_ -= is_small( counts_[ from ] );
+	if( --counts_[ from ] == 0 ) {
+		const uint32_t last = classes_.back();
+		classes_[ positions_[ from ] ] = last;
+		positions_[ last ] = positions_[ from ];
+		classes_.pop_back();
+	}
+	num_small_ += is_small( counts_[ from ] );
+
+	/* Then join the new one, which may be a degree never seen before. */
+	if( to >= counts_.size() ) {
+		counts_.resize( to + 1, 0 );
+		positions_.resize( to + 1, 0 );
+	}
+	num_small_ -= is_small( counts_[ to ] );
+	if( counts_[ to ]++ == 0 ) {
+		positions_[ to ] = static_cast< uint32_t >( classes_.size() );
+		classes_.push_back( to );
+	}
+	num_small_ += is_small( counts_[ to ] );
+}
+
+bool DegreeHistogram::is_anonymous( const uint32_t k ) {
+	if( k != k_ ) {
+		k_ = k;
+		num_small_ = 0;
+		for( uint32_t const degree : classes_ ) { num_small_ += is_small( counts_[ degree ] ); }
+	}
+	return num_small_ == 0;
+}
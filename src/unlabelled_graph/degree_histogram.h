@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @brief Definition of a degree-count histogram that is maintained as edges
+ * and vertices are added, for constant-time k-degree anonymity checks.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DEGREE_HISTOGRAM_H_
+#define DEGREE_HISTOGRAM_H_
+
+#include <cstdint>	/* For uint32_t */
+
+/* STL libraries in use */
+#include <vector>
+
+/**
+ * @brief Counts how many vertices have each degree, and how many of those
+ * degree classes are smaller than a threshold k.
+ *
+ * A graph is k-degree-anonymous exactly when no (non-empty) degree class
+ * has fewer than k vertices. Every update moves one vertex between two
+ * classes in O( 1 ) and keeps the number of such small classes up to date
+ * for the current k, so that is_anonymous() with the same k is O( 1 ).
+ * Asking about a different k recounts the small classes once, in
+ * O( distinct degrees ), and then tracks that k instead.
+ */
+class DegreeHistogram {
+public:
+
+	/**
+	 * Constructs an empty histogram, which is not built until reset().
+	 */
+	DegreeHistogram();
+
+	/**
+	 * Discards all counts, so that the owner must reset() the histogram
+	 * before it is next used (e.g., after a bulk change of the edge set).
+	 */
+	void invalidate();
+
+	/**
+	 * Determines whether the histogram has been built since it was last
+	 * invalidated.
+	 */
+	bool is_built() const { return built_; }
+
+	/**
+	 * Rebuilds the histogram for num_vertices isolated vertices.
+	 * @post is_built() is true and every vertex is in the class of degree zero.
+	 */
+	void reset( const uint32_t num_vertices );
+
+	/**
+	 * Adds isolated vertices.
+	 * @param num_vertices The number of vertices of degree zero to add.
+	 */
+	void add_vertices( const uint32_t num_vertices );
+
+	/**
+	 * Moves one vertex from the class of degree from to that of degree to.
+	 * @pre The class of degree from is non-empty.
+	 */
+	void move( const uint32_t from, const uint32_t to );
+
+	/**
+	 * Moves one vertex up a degree, as when it gains an edge.
+	 * @see move()
+	 */
+	void increment( const uint32_t degree ) { move( degree, degree + 1 ); }
+
+	/**
+	 * Retrieves the number of vertices of the given degree.
+	 */
+	uint32_t count( const uint32_t degree ) const {
+		return degree < counts_.size() ? counts_[ degree ] : 0;
+	}
+
+	/**
+	 * Retrieves the number of distinct degrees (i.e., non-empty classes).
+	 */
+	uint32_t num_classes() const { return static_cast< uint32_t >( classes_.size() ); }
+
+	/**
+	 * Determines whether every non-empty degree class has at least k vertices.
+	 * @param k The privacy threshold, k.
+	 * @return True if the counted vertices are k-degree-anonymous.
+	 * @post Subsequent updates track the small classes for this k.
+	 * @note O( 1 ) if k is the same as in the previous call; otherwise
+	 * O( num_classes() ).
+	 */
+	bool is_anonymous( const uint32_t k );
+
+private:
+
+	/**
+	 * Whether a class of count vertices is non-empty but smaller than k_.
+	 */
+	bool is_small( const uint32_t count ) const { return count > 0 && count < k_; }
+
+	std::vector< uint32_t > counts_; /**< The number of vertices of each degree. */
+	std::vector< uint32_t > classes_; /**< The non-empty degrees, in no order. */
+	std::vector< uint32_t > positions_; /**< Where each non-empty degree is in classes_. */
+	uint32_t k_; /**< The threshold for which num_small_ is maintained. */
+	uint32_t num_small_; /**< The number of non-empty classes smaller than k_. */
+	bool built_; /**< Whether the counts are current. */
+};
+
+#endif /* DEGREE_HISTOGRAM_H_ */
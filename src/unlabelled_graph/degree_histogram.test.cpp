@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in degree_histogram.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <cstdlib> /* for rand */
+#include <vector>
+#include <map>
+
+#include "degree_histogram.test.h"
+#include "degree_histogram.h"
+
+namespace
+{
+	/**
+	 * Determines k-degree anonymity by recounting every degree.
+	 */
+	bool naive_is_anonymous( std::vector< uint32_t > const& degrees, const uint32_t k ) {
+		std::map< uint32_t, uint32_t > counts;
+		for( uint32_t const d : degrees ) { ++counts[ d ]; }
+		for( auto const& count : counts ) {
+			if( count.second < k ) { return false; }
+		}
+		return true;
+	}
+}
+
+bool test_degree_histogram() {
+	for( uint32_t trial = 0; trial < 50; ++trial ) {
+		std::vector< uint32_t > degrees( 1 + rand() % 40, 0 );
+		DegreeHistogram histogram;
+		histogram.reset( degrees.size() );
+		uint32_t k = 1 + rand() % 6;
+
+		for( uint32_t step = 0; step < 400; ++step ) {
+			const uint32_t action = rand() % 20;
+			if( action == 0 ) {
+				/* Add a few isolated vertices. */
+				const uint32_t count = rand() % 3;
+				degrees.resize( degrees.size() + count, 0 );
+				histogram.add_vertices( count );
+			}
+			else if( action == 1 ) {
+				/* Move a vertex to an arbitrary, possibly lower, degree. */
+				uint32_t &d = degrees[ rand() % degrees.size() ];
+				const uint32_t to = rand() % 12;
+				histogram.move( d, to );
+				d = to;
+			}
+			else if( action == 2 ) { k = 1 + rand() % 6; }
+			else {
+				uint32_t &d = degrees[ rand() % degrees.size() ];
+				histogram.increment( d++ );
+			}
+
+			if( histogram.is_anonymous( k ) != naive_is_anonymous( degrees, k ) ) { return false; }
+		}
+
+		/* The per-degree counts agree too. */
+		std::map< uint32_t, uint32_t > counts;
+		for( uint32_t const d : degrees ) { ++counts[ d ]; }
+		if( histogram.num_classes() != counts.size() ) { return false; }
+		for( auto const& count : counts ) {
+			if( histogram.count( count.first ) != count.second ) { return false; }
+		}
+	}
+
+	/* An invalidated histogram forgets everything. */
+	DegreeHistogram histogram;
+	histogram.reset( 3 );
+	histogram.invalidate();
+	return !histogram.is_built() && histogram.num_classes() == 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file
+ * @brief Implementation of the graph analyses in graph_analysis.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <numeric>		/* for std::accumulate */
+#include <algorithm>	/* for std::binary_search */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "graph_analysis.h" /* implementing these functions. */
+#include "all_pairs_bfs.h"
+#include "triangle_count.h"
+#include "degree_histogram.h"
+
+namespace
+{
+	template< typename Graph >
+	HopPlot hop_plot_of( Graph const& g ) {
+
+		/* Search from every vertex with the bit-parallel BFS engine. */
+		std::vector< uint64_t > const histogram = AllPairsBfs( g ).histogram();
+
+		/* Convert to a hop plot. Length 1 is always recorded for a non-empty
+		 * graph, even if it has no edges; other lengths only if they occur. */
+		HopPlot result;
+		for( uint32_t d = 1; d < histogram.size(); ++d ) {
+			if( histogram[ d ] > 0 || d == 1 ) { result[ d ] = histogram[ d ]; }
+		}
+		if( g.num_vertices() > 0 && result.empty() ) { result[ 1 ] = 0; }
+		return result;
+	}
+
+	template< typename Graph >
+	float clustering_coefficient_of( Graph const& g ) {
+
+		/* First count denominator -- how many open triangles exist. */
+		uint64_t possible_triangles = 0;
+		for( uint32_t u = 0; u < g.num_vertices(); ++u ) {
+			const uint64_t degree = g.degree( u );
+			possible_triangles += degree * ( degree - 1 );
+		}
+
+		/* Then count numerator -- how many closed triangles exist. Each triangle
+		 * closes two ordered pairs of neighbours at each of its three corners. */
+		const uint64_t closed_triangles = 6 * TriangleCounter( g ).count();
+
+		return closed_triangles / static_cast< float >( possible_triangles );
+	}
+
+	template< typename Graph >
+	bool is_anonymous_of( Graph const& g, const uint32_t k ) {
+
+		/* First calculate the counts for every degree in the graph, and then
+		 * ensure every count is at least k. */
+		DegreeHistogram degree_counts;
+		degree_counts.reset( g.num_vertices() );
+		for( uint32_t v = 0; v < g.num_vertices(); ++v ) { degree_counts.move( 0, g.degree( v ) ); }
+		return degree_counts.is_anonymous( k );
+	}
+}
+
+namespace graphAnon
+{
+	uint64_t count_added_triangles( OverlayView const& g ) {
+
+		/* For each added edge (u,v), classify the common neighbours w by
+		 * how many added edges their triangle has: a triangle with j added
+		 * edges is found once from each of them. */
+		uint64_t once = 0, twice = 0, thrice = 0;
+		const uint32_t n = g.num_vertices();
+#pragma omp parallel for reduction( +: once, twice, thrice ) schedule( dynamic, 64 )
+		for( uint32_t u = 0; u < n; ++u ) {
+			NeighbourRange const u_added = g.neighbours( u ).added();
+			for( uint32_t const v : u_added ) {
+				if( v < u ) { continue; }
+
+				/* Scan the endpoint with fewer neighbours. */
+				const bool scan_u = g.degree( u ) <= g.degree( v );
+				const uint32_t a = scan_u ? u : v, b = scan_u ? v : u;
+				OverlayNeighbourRange const b_range = g.neighbours( b );
+				NeighbourRange const a_added = g.neighbours( a ).added();
+				for( uint32_t const w : g.neighbours( a ) ) {
+					const bool bw_base = std::binary_search( b_range.base().begin(), b_range.base().end(), w );
+					const bool bw_added = !bw_base
+						&& std::binary_search( b_range.added().begin(), b_range.added().end(), w );
+					if( !bw_base && !bw_added ) { continue; }
+					const uint32_t added_edges = 1 + bw_added
+						+ std::binary_search( a_added.begin(), a_added.end(), w );
+					if( added_edges == 1 ) { ++once; }
+					else if( added_edges == 2 ) { ++twice; }
+					else { ++thrice; }
+				}
+			}
+		}
+		return once + twice / 2 + thrice / 3;
+	}
+
+	HopPlot hop_plot( CsrGraph const& g ) { return hop_plot_of( g ); }
+	HopPlot hop_plot( OverlayView const& g ) { return hop_plot_of( g ); }
+
+	float clustering_coefficient( CsrGraph const& g ) { return clustering_coefficient_of( g ); }
+	float clustering_coefficient( OverlayView const& g ) { return clustering_coefficient_of( g ); }
+
+	bool is_anonymous( CsrGraph const& g, const uint32_t k ) { return is_anonymous_of( g, k ); }
+	bool is_anonymous( OverlayView const& g, const uint32_t k ) { return is_anonymous_of( g, k ); }
+
+	float average_path_length( HopPlot const& hop_plot, const uint32_t num_vertices,
+		const bool include_self_paths ) {
+
+		/* init with/without the paths (i,i) of length 0 */
+		uint64_t sum = 0;
+		uint64_t count = ( include_self_paths ? num_vertices : 0 );
+
+		/* Iterate hop plot to process all length > 0 paths */
+		for( auto const& hp : hop_plot ) {
+			if( hp.second > 0 ) {
+				sum += hp.first * hp.second;
+				count += hp.second;
+			}
+		}
+
+		return ( count == 0 ? 0 : sum / static_cast< float >( count ) );
+	}
+
+	float harmonic_mean( HopPlot const& hop_plot, const uint32_t num_vertices ) {
+
+		float const mean = std::accumulate( hop_plot.cbegin(), hop_plot.cend(), 0.0,
+			[]( float const f, auto const& hp )
+			{
+				return f + hp.second / static_cast< float >( hp.first );
+			}
+		);
+
+		const uint64_t ordered_pairs = static_cast< uint64_t >( num_vertices ) * ( num_vertices - 1 );
+		return mean == 0 ? -1.0 : ordered_pairs / mean;
+	}
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief Declarations of the graph analyses that run over either a base
+ * graph (a CsrGraph) or an overlaid one (an OverlayView).
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPH_ANALYSIS_H_
+#define GRAPH_ANALYSIS_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+/* STL libraries in use */
+#include <map>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+
+/**
+ * A HopPlot is a histogram of path lengths in a graph.
+ * It maps from each integer i = 1,... the number of 
+ * vertex pairs in the graph that are reachable with a 
+ * shortest path of exactly i hops.
+ */
+typedef std::map< uint32_t, uint64_t > HopPlot;
+
+namespace graphAnon
+{
+	/**
+	 * Computes the hop plot of a graph.
+	 * @see UnlabelledGraph::hop_plot()
+	 */
+	HopPlot hop_plot( CsrGraph const& g );
+
+	/** @copydoc hop_plot( CsrGraph const& ) */
+	HopPlot hop_plot( OverlayView const& g );
+
+	/**
+	 * Counts the triangles of an overlaid graph that its base graph lacks,
+	 * without recounting those of the base.
+	 * @returns The number of distinct triangles with at least one added edge.
+	 */
+	uint64_t count_added_triangles( OverlayView const& g );
+
+	/**
+	 * Calculates the clustering coefficient of a graph.
+	 * @see UnlabelledGraph::clustering_coefficient()
+	 */
+	float clustering_coefficient( CsrGraph const& g );
+
+	/** @copydoc clustering_coefficient( CsrGraph const& ) */
+	float clustering_coefficient( OverlayView const& g );
+
+	/**
+	 * Determines whether a graph is k-degree-anonymous.
+	 * @see UnlabelledGraph::is_anonymous()
+	 */
+	bool is_anonymous( CsrGraph const& g, const uint32_t k );
+
+	/** @copydoc is_anonymous( CsrGraph const&, const uint32_t ) */
+	bool is_anonymous( OverlayView const& g, const uint32_t k );
+
+	/**
+	 * Calculates the average path length of a graph from its hop plot.
+	 * @param hop_plot The hop plot of the graph.
+	 * @param num_vertices The number of vertices in the graph, n.
+	 * @param include_self_paths Whether the n paths (u,u) of length 0 count.
+	 * @see UnlabelledGraph::average_path_length()
+	 */
+	float average_path_length( HopPlot const& hop_plot, const uint32_t num_vertices,
+		const bool include_self_paths );
+
+	/**
+	 * Calculates the harmonic mean of the path lengths of a graph from its hop plot.
+	 * @param hop_plot The hop plot of the graph.
+	 * @param num_vertices The number of vertices in the graph, n.
+	 * @see UnlabelledGraph::harmonic_mean()
+	 */
+	float harmonic_mean( HopPlot const& hop_plot, const uint32_t num_vertices );
+}
+
+#endif /* GRAPH_ANALYSIS_H_ */
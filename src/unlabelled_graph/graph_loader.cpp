@@ -0,0 +1,385 @@
+/**
+ * @file
+ * @brief Implementation of the GraphLoader class in graph_loader.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t, UINT32_MAX */
+#include <cstddef>		/* for size_t */
+#include <algorithm>	/* for std::sort, std::unique, std::count, std::max, std::any_of */
+#include <cstdio>		/* for FILE, fopen, fread, fclose */
+#include <fstream>		/* for std::ifstream */
+#include <iterator>		/* for std::istreambuf_iterator */
+#include <utility>		/* for std::pair, std::move */
+
+/* STL stuff in use. */
+#include <vector>
+#include <memory>
+
+/* POSIX memory mapping. */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "omp.h"
+
+#include "graph_loader.h" /* implementing this class. */
+#include "binary_format.h"
+
+namespace
+{
+	typedef std::vector< std::pair< uint32_t, uint32_t > > EdgeList;
+
+	/**
+	 * Skips spaces and tabs (but not line breaks).
+	 */
+	inline char const* skip_blanks( char const *p, char const *end ) {
+		while( p != end && ( *p == ' ' || *p == '\t' || *p == '\r' ) ) { ++p; }
+		return p;
+	}
+
+	/**
+	 * Advances past the next line break (or to end).
+	 */
+	inline char const* next_line( char const *p, char const *end ) {
+		while( p != end && *p != '\n' ) { ++p; }
+		return p == end ? end : p + 1;
+	}
+
+	/**
+	 * Parses an unsigned integer at p, if there is one before the end of the line.
+	 * @param p The position at which to start, advanced past the integer.
+	 * @param value Set to the parsed integer, or to UINT32_MAX if it does not
+	 * fit in 32 bits, so that it is out of range as a vertex id rather than
+	 * wrapping around to another vertex.
+	 * @return False (without consuming the rest of the line) if the next
+	 * non-blank character does not begin an integer, as for an
+	 * std::istringstream extraction.
+	 */
+	inline bool parse_uint( char const **p, char const *end, uint32_t *value ) {
+		char const *q = skip_blanks( *p, end );
+		if( q == end || static_cast< uint32_t >( *q - '0' ) > 9 ) {
+			*p = q;
+			return false;
+		}
+		uint32_t x = 0;
+		uint32_t digit;
+		while( q != end && ( digit = static_cast< uint32_t >( *q - '0' ) ) <= 9 ) {
+			x = x > ( UINT32_MAX - digit ) / 10 ? UINT32_MAX : x * 10 + digit;
+			++q;
+		}
+		*p = q;
+		*value = x;
+		return true;
+	}
+
+	/**
+	 * Parses the adjacency list lines in [ p, end ), the first of which
+	 * belongs to vertex first_vertex, appending every edge to edges.
+	 */
+	void parse_adjacency_lines( char const *p, char const *end, uint32_t first_vertex,
+		const uint32_t n, const bool labelled, uint32_t *labels, EdgeList *edges ) {
+
+		for( uint32_t u = first_vertex; p != end && u < n; ++u ) {
+			/* if labelled, the first number is the label. */
+			uint32_t v;
+			if( labelled && parse_uint( &p, end, &v ) ) { labels[ u ] = v; }
+			while( parse_uint( &p, end, &v ) ) {
+				if( v < n && v != u ) { edges->push_back( std::pair< uint32_t, uint32_t >( u, v ) ); }
+			}
+			p = next_line( p, end );
+		}
+	}
+
+	/**
+	 * Parses the edge list lines in [ p, end ), appending every edge to edges.
+	 * Lines without two integers are ignored.
+	 */
+	void parse_edge_lines( char const *p, char const *end, const uint32_t n, EdgeList *edges ) {
+		while( p != end ) {
+			uint32_t u, v;
+			if( parse_uint( &p, end, &u ) && parse_uint( &p, end, &v ) ) {
+				if( u < n && v < n && u != v ) { edges->push_back( std::pair< uint32_t, uint32_t >( u, v ) ); }
+			}
+			p = next_line( p, end );
+		}
+	}
+
+	/**
+	 * Splits [ begin, end ) into at most num_chunks pieces that each start
+	 * at the beginning of a line.
+	 * @return The num_chunks + 1 chunk boundaries.
+	 */
+	std::vector< char const* > split_lines( char const *begin, char const *end,
+		const uint32_t num_chunks ) {
+
+		std::vector< char const* > bounds( 1, begin );
+		const size_t length = end - begin;
+		for( uint32_t i = 1; i < num_chunks; ++i ) {
+			char const *p = std::max( bounds.back(), begin + length / num_chunks * i );
+			if( p != begin && p != end && p[ -1 ] != '\n' ) { p = next_line( p, end ); }
+			bounds.push_back( p );
+		}
+		bounds.push_back( end );
+		return bounds;
+	}
+
+	/**
+	 * Builds a symmetric, sorted, duplicate-free CsrGraph over n vertices
+	 * from per-thread lists of (possibly one-directional or repeated) edges.
+	 */
+	CsrGraph build_csr( const uint32_t n, std::vector< EdgeList > const& edge_lists,
+		const bool parallel ) {
+
+		/* Count degrees, with each edge contributing to both endpoints. */
+		std::vector< uint64_t > degrees( n + 1, 0 );
+		for( EdgeList const& edges : edge_lists ) {
+#pragma omp parallel for schedule( static ) if( parallel )
+			for( size_t i = 0; i < edges.size(); ++i ) {
+#pragma omp atomic
+				++degrees[ edges[ i ].first + 1 ];
+#pragma omp atomic
+				++degrees[ edges[ i ].second + 1 ];
+			}
+		}
+		std::vector< uint64_t > offsets( degrees );
+		for( uint32_t u = 0; u < n; ++u ) { offsets[ u + 1 ] += offsets[ u ]; }
+
+		/* Scatter each edge into both endpoints' slices. */
+		std::vector< uint32_t > neighbours( offsets[ n ] );
+		std::vector< uint64_t > cursors( offsets.begin(), offsets.end() - 1 );
+		for( EdgeList const& edges : edge_lists ) {
+#pragma omp parallel for schedule( static ) if( parallel )
+			for( size_t i = 0; i < edges.size(); ++i ) {
+				const uint32_t u = edges[ i ].first, v = edges[ i ].second;
+				uint64_t pos;
+#pragma omp atomic capture
+				pos = cursors[ u ]++;
+				neighbours[ pos ] = v;
+#pragma omp atomic capture
+				pos = cursors[ v ]++;
+				neighbours[ pos ] = u;
+			}
+		}
+
+		/* Sort and deduplicate each slice in place, recording its new degree. */
+#pragma omp parallel for schedule( dynamic, 256 ) if( parallel )
+		for( uint32_t u = 0; u < n; ++u ) {
+			auto const first = neighbours.begin() + offsets[ u ];
+			auto const last = neighbours.begin() + offsets[ u + 1 ];
+			std::sort( first, last );
+			degrees[ u + 1 ] = std::unique( first, last ) - first;
+		}
+
+		/* Compact the deduplicated slices. */
+		degrees[ 0 ] = 0;
+		for( uint32_t u = 0; u < n; ++u ) { degrees[ u + 1 ] += degrees[ u ]; }
+		if( degrees[ n ] != offsets[ n ] ) {
+			std::vector< uint32_t > compacted( degrees[ n ] );
+#pragma omp parallel for schedule( dynamic, 256 ) if( parallel )
+			for( uint32_t u = 0; u < n; ++u ) {
+				std::copy( neighbours.begin() + offsets[ u ],
+					neighbours.begin() + offsets[ u ] + ( degrees[ u + 1 ] - degrees[ u ] ),
+					compacted.begin() + degrees[ u ] );
+			}
+			neighbours.swap( compacted );
+		}
+		return CsrGraph( std::move( degrees ), std::move( neighbours ) );
+	}
+}
+
+GraphLoader::GraphLoader( const std::string filename ) : data_( NULL ), end_( NULL ),
+	n_( 0 ), l_( 0 ) {
+
+	const int fd = open( filename.c_str(), O_RDONLY );
+	if( fd < 0 ) { return; }
+
+	struct stat st;
+	if( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0 ) {
+		const size_t length = st.st_size;
+		void *mapping = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( mapping != MAP_FAILED ) {
+			madvise( mapping, length, MADV_SEQUENTIAL );
+			contents_ = std::shared_ptr< const void >( mapping,
+				[ length ]( void const *p ) { munmap( const_cast< void* >( p ), length ); } );
+			data_ = static_cast< char const* >( mapping );
+			end_ = data_ + length;
+		}
+	}
+	close( fd );
+
+	/* Fall back to reading the whole file (e.g., for pipes, or empty files). */
+	if( contents_ == nullptr ) {
+		std::ifstream infile( filename, std::ios::binary );
+		if( !infile ) { return; }
+		std::shared_ptr< std::vector< char > > buffer = std::make_shared< std::vector< char > >(
+			std::istreambuf_iterator< char >( infile ), std::istreambuf_iterator< char >() );
+		buffer->push_back( '\n' );
+		data_ = buffer->data();
+		end_ = data_ + buffer->size();
+		contents_ = buffer;
+	}
+}
+
+bool GraphLoader::load( const graphAnon::FileFormat format, const bool parallel ) {
+	n_ = 0;
+	l_ = 0;
+	labels_.clear();
+	if( !is_open() ) { return false; }
+
+	/* Binary files already contain the CSR arrays. */
+	if( format == graphAnon::FileFormat::binary ) {
+		if( !read_binary_graph( data_, end_ - data_, contents_, &csr_, &labels_, &l_ )
+			|| csr_.num_vertices() == 0 ) {
+			return false;
+		}
+		n_ = csr_.num_vertices();
+		return true;
+	}
+
+	/* first parse the graph (and label alphabet) sizes from
+	 * the first line of the file */
+	char const *p = data_;
+	const bool labelled = format == graphAnon::FileFormat::adjacencyListVertexLabelled;
+	if( !parse_uint( &p, end_, &n_ ) || n_ == 0 || n_ == UINT32_MAX ) {
+		n_ = 0;
+		return false;
+	}
+	if( labelled && !parse_uint( &p, end_, &l_ ) ) { l_ = 0; }
+	p = next_line( p, end_ );
+	if( labelled ) { labels_.assign( n_, 0 ); }
+
+	/* Split the body into one chunk per thread. For adjacency lists, each
+	 * chunk must also know the vertex to which its first line belongs. */
+	const uint32_t num_chunks = parallel ? omp_get_max_threads() : 1;
+	std::vector< char const* > const bounds = split_lines( p, end_, num_chunks );
+	std::vector< uint32_t > first_vertex( bounds.size(), 0 );
+	if( format != graphAnon::FileFormat::edgeList ) {
+		std::vector< uint32_t > lines( bounds.size(), 0 );
+#pragma omp parallel for schedule( static, 1 ) if( parallel )
+		for( uint32_t c = 0; c < num_chunks; ++c ) {
+			lines[ c + 1 ] = std::count( bounds[ c ], bounds[ c + 1 ], '\n' );
+		}
+		for( uint32_t c = 0; c < num_chunks; ++c ) { first_vertex[ c + 1 ] = first_vertex[ c ] + lines[ c + 1 ]; }
+	}
+
+	std::vector< EdgeList > edges( num_chunks );
+#pragma omp parallel for schedule( static, 1 ) if( parallel )
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		if( format == graphAnon::FileFormat::edgeList ) {
+			parse_edge_lines( bounds[ c ], bounds[ c + 1 ], n_, &edges[ c ] );
+		}
+		else {
+			parse_adjacency_lines( bounds[ c ], bounds[ c + 1 ], first_vertex[ c ], n_,
+				labelled, labels_.data(), &edges[ c ] );
+		}
+	}
+
+	/* A label outside the declared alphabet cannot be counted, so reject the file. */
+	if( labelled && std::any_of( labels_.begin(), labels_.end(),
+			[ this ]( const uint32_t label ) { return label >= l_; } ) ) {
+		n_ = 0;
+		return false;
+	}
+
+	csr_ = build_csr( n_, edges, parallel );
+	return true;
+}
+
+EdgeListReader::EdgeListReader( const std::string filename, const size_t chunk_bytes )
+	: file_( std::fopen( filename.c_str(), "rb" ) ), buffer_( std::max< size_t >( chunk_bytes, 2 ) ),
+	kept_( 0 ), n_( 0 ), eof_( file_ == NULL ), failed_( file_ == NULL ) {
+
+	/* Parse the number of vertices from the first line (fill() keeps only whole lines). */
+	if( !fill() ) { failed_ = true; return; }
+	char const *p = buffer_.data();
+	char const *const end = p + lines_;
+	if( !parse_uint( &p, end, &n_ ) || n_ == 0 || n_ == UINT32_MAX ) {
+		n_ = 0;
+		failed_ = true;
+		return;
+	}
+	consume( next_line( p, end ) - buffer_.data() );
+}
+
+EdgeListReader::~EdgeListReader() {
+	if( file_ != NULL ) { std::fclose( file_ ); }
+}
+
+bool EdgeListReader::fill() {
+
+	/* Top up the buffer after the bytes kept from the previous chunk, growing
+	 * it if a single line does not fit. */
+	while( true ) {
+		if( !eof_ ) {
+			const size_t wanted = buffer_.size() - kept_;
+			const size_t got = std::fread( buffer_.data() + kept_, 1, wanted, file_ );
+			kept_ += got;
+			if( got < wanted ) {
+				eof_ = true;
+				failed_ = std::ferror( file_ ) != 0;
+			}
+		}
+		if( eof_ ) {
+			lines_ = kept_; /* the last line need not end with a line break. */
+			return kept_ != 0;
+		}
+		char const *const first = buffer_.data();
+		char const *last = first + kept_;
+		while( last != first && last[ -1 ] != '\n' ) { --last; }
+		if( last != first ) {
+			lines_ = last - first;
+			return true;
+		}
+		buffer_.resize( 2 * buffer_.size() );
+	}
+}
+
+void EdgeListReader::consume( const size_t bytes ) {
+	std::copy( buffer_.begin() + bytes, buffer_.begin() + kept_, buffer_.begin() );
+	kept_ -= bytes;
+}
+
+bool EdgeListReader::next( std::vector< std::pair< uint32_t, uint32_t > > *edges,
+	const bool parallel ) {
+
+	edges->clear();
+	if( failed_ || !fill() ) { return false; }
+
+	/* Parse the whole lines of this chunk with every thread, then gather. */
+	char const *const begin = buffer_.data();
+	const uint32_t num_chunks = parallel ? omp_get_max_threads() : 1;
+	std::vector< char const* > const bounds = split_lines( begin, begin + lines_, num_chunks );
+	std::vector< EdgeList > parsed( num_chunks );
+#pragma omp parallel for schedule( static, 1 ) if( parallel )
+	for( uint32_t c = 0; c < num_chunks; ++c ) {
+		parse_edge_lines( bounds[ c ], bounds[ c + 1 ], n_, &parsed[ c ] );
+	}
+	for( EdgeList const& chunk : parsed ) { edges->insert( edges->end(), chunk.begin(), chunk.end() ); }
+
+	consume( lines_ );
+	return !failed_;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file
+ * @brief Definition of a bulk loader that memory-maps a graph file, parses
+ * it (optionally in parallel chunks), and builds a CsrGraph directly.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPH_LOADER_H_
+#define GRAPH_LOADER_H_
+
+#include <cstdint>	/* For uint32_t */
+#include <cstddef>	/* For size_t */
+#include <string>	/* For std::string */
+#include <cstdio>	/* For FILE */
+
+/* STL libraries in use */
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "csr_graph.h"
+#include "unlabelled_graph.h"
+
+/**
+ * @brief Loads a graph from an ascii file in any of the graphAnon::FileFormat
+ * formats without per-line or per-edge allocations.
+ *
+ * The file is memory-mapped (or, failing that, read into memory in one go)
+ * and then scanned in place. The body of the file is split into one chunk
+ * per OpenMP thread at line boundaries, each chunk is parsed independently
+ * into a list of edges, and the CsrGraph is then built in bulk: degrees are
+ * counted, neighbours are scattered into their slices, and each slice is
+ * sorted and deduplicated. Self-loops, duplicate edges, and edges to vertex
+ * ids of n or more are discarded, and every edge is stored in both directions.
+ * Files in graphAnon::FileFormat::binary are not parsed at all: the CsrGraph
+ * views the mapped file directly (unless it is compressed).
+ */
+class GraphLoader {
+public:
+
+	/**
+	 * Opens (and memory-maps) a graph file.
+	 * @param filename The path to the input file.
+	 */
+	explicit GraphLoader( const std::string filename );
+
+	GraphLoader( GraphLoader const& ) = delete;
+	GraphLoader& operator=( GraphLoader const& ) = delete;
+
+	/**
+	 * Determines whether the file could be opened.
+	 */
+	bool is_open() const { return contents_ != nullptr; }
+
+	/**
+	 * Parses the file.
+	 * @param format The format of the file.
+	 * @param parallel Whether to parse in one chunk per OpenMP thread.
+	 * @return False if the file could not be opened or did not begin with a
+	 * positive number of vertices that fits in 32 bits, gave a vertex a label
+	 * outside the declared alphabet, or (for binary files) was malformed;
+	 * otherwise true. Vertex ids that are out of range (including any that
+	 * do not fit in 32 bits) are dropped.
+	 * @post num_vertices(), num_labels(), vertex_labels(), and csr() describe
+	 * the parsed graph.
+	 */
+	bool load( const graphAnon::FileFormat format, const bool parallel = true );
+
+	/**
+	 * Accessor method to retrieve the number of vertices declared in the header.
+	 */
+	uint32_t num_vertices() const { return n_; }
+
+	/**
+	 * Accessor method to retrieve the label alphabet size declared in the
+	 * header of a vertex-labelled file (0 for other formats).
+	 */
+	uint32_t num_labels() const { return l_; }
+
+	/**
+	 * The label of each vertex in a vertex-labelled file (empty for other
+	 * formats). May be moved from.
+	 */
+	std::vector< uint32_t >& vertex_labels() { return labels_; }
+
+	/**
+	 * The parsed graph. May be moved from.
+	 */
+	CsrGraph& csr() { return csr_; }
+
+private:
+
+	/**
+	 * The owner of the file contents: either the memory mapping, which is
+	 * unmapped once the last CsrGraph borrowing from it is destroyed, or a
+	 * buffer into which the file was read.
+	 */
+	std::shared_ptr< const void > contents_;
+	char const *data_; /**< The file contents. */
+	char const *end_; /**< One past the last byte of the file contents. */
+
+	uint32_t n_; /**< The number of vertices declared in the header. */
+	uint32_t l_; /**< The label alphabet size declared in the header. */
+	std::vector< uint32_t > labels_; /**< The label of each vertex. */
+	CsrGraph csr_; /**< The parsed graph. */
+};
+
+/**
+ * @brief Reads the edges of a graphAnon::FileFormat::edgeList file a chunk at
+ * a time, so that graphs much larger than memory can be scanned.
+ *
+ * Each chunk of whole lines is parsed by every OpenMP thread exactly as
+ * GraphLoader parses edge lists (self-loops, edges to vertex ids of n or
+ * more, and lines without two integers are skipped), but the edges are
+ * neither stored in both directions nor deduplicated.
+ */
+class EdgeListReader {
+public:
+
+	/**
+	 * Opens an edge list file and parses the number of vertices from its first line.
+	 * @param filename The path to the input file.
+	 * @param chunk_bytes The (initial) number of bytes read per chunk.
+	 */
+	explicit EdgeListReader( const std::string filename, const size_t chunk_bytes = 1 << 26 );
+
+	~EdgeListReader();
+
+	EdgeListReader( EdgeListReader const& ) = delete;
+	EdgeListReader& operator=( EdgeListReader const& ) = delete;
+
+	/**
+	 * Determines whether the file was opened and began with a positive number
+	 * of vertices, and no read has failed since.
+	 */
+	bool is_open() const { return !failed_; }
+
+	/**
+	 * Accessor method to retrieve the number of vertices declared in the header.
+	 */
+	uint32_t num_vertices() const { return n_; }
+
+	/**
+	 * Reads and parses the next chunk of the file.
+	 * @param edges Overwritten with the edges of the chunk, in file order.
+	 * @param parallel Whether to parse with every OpenMP thread.
+	 * @return False once the whole file has been read (or a read failed),
+	 * in which case edges is empty.
+	 */
+	bool next( std::vector< std::pair< uint32_t, uint32_t > > *edges, const bool parallel = true );
+
+private:
+
+	/**
+	 * Reads from the file until the buffer holds at least one whole line (or
+	 * the rest of the file).
+	 * @return False if there is nothing left to parse.
+	 * @post The first lines_ bytes of buffer_ are whole lines.
+	 */
+	bool fill();
+
+	/**
+	 * Discards the first bytes bytes of the buffer, keeping the rest.
+	 */
+	void consume( const size_t bytes );
+
+	FILE *file_; /**< The file being read. */
+	std::vector< char > buffer_; /**< The bytes read but not yet parsed. */
+	size_t kept_; /**< The number of valid bytes in buffer_. */
+	size_t lines_; /**< The length of the whole lines at the start of buffer_. */
+	uint32_t n_; /**< The number of vertices declared in the header. */
+	bool eof_; /**< Whether the whole file has been read into the buffer. */
+	bool failed_; /**< Whether the file could not be opened, parsed, or read. */
+};
+
+#endif /* GRAPH_LOADER_H_ */
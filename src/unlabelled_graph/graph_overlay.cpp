@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Implementation of the GraphOverlay class in graph_overlay.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::merge */
+#include <utility>		/* for std::move */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+#include <string>
+
+#include "omp.h"
+
+#include "graph_overlay.h" /* implementing this class. */
+#include "binary_format.h"
+#include "graph_analysis.h"
+#include "scratch_arena.h"
+
+GraphOverlay::GraphOverlay( std::shared_ptr< const CsrGraph > base )
+	: base_( std::move( base ) ), num_new_vertices_( 0 ) {}
+
+GraphOverlay GraphOverlay::difference( std::shared_ptr< const CsrGraph > base,
+	CsrGraph const& supergraph ) {
+
+	assert( supergraph.num_vertices() >= base->num_vertices() );
+	GraphOverlay overlay( base );
+	overlay.add_vertices( supergraph.num_vertices() - base->num_vertices() );
+	for( uint32_t u = 0; u < supergraph.num_vertices(); ++u ) {
+		NeighbourRange const after = supergraph.neighbours( u );
+		uint32_t const *before = NULL, *before_last = NULL;
+		if( u < base->num_vertices() ) {
+			before = base->neighbours( u ).begin();
+			before_last = base->neighbours( u ).end();
+		}
+
+		/* Both lists are sorted and before is a subset of after. */
+		for( uint32_t const v : after ) {
+			if( v < u ) { continue; }
+			while( before != before_last && *before < v ) { ++before; }
+			if( before != before_last && *before == v ) { continue; }
+			overlay.add_edge( u, v );
+		}
+	}
+	return overlay;
+}
+
+void GraphOverlay::apply( IdentityPlan const& plan, DegreeSequence const& degrees ) {
+	const uint32_t first_new_vertex = num_vertices();
+	add_vertices( plan.num_new_vertices() );
+	added_edges_.reserve( added_edges_.size() + plan.num_new_edges() );
+	plan.generate_edges( degrees, first_new_vertex,
+		[ this ]( const uint32_t u, const uint32_t v ) { add_edge( u, v ); } );
+}
+
+CsrGraph GraphOverlay::materialise() const {
+	OverlayView const g = view();
+	const uint32_t n = g.num_vertices();
+
+	std::vector< uint64_t > offsets( n + 1, 0 );
+	for( uint32_t u = 0; u < n; ++u ) { offsets[ u + 1 ] = offsets[ u ] + g.degree( u ); }
+
+	/* Merge each vertex's sorted base and added neighbours. */
+	std::vector< uint32_t > neighbours( offsets[ n ] );
+#pragma omp parallel for schedule( dynamic, 256 )
+	for( uint32_t u = 0; u < n; ++u ) {
+		OverlayNeighbourRange const range = g.neighbours( u );
+		std::merge( range.base().begin(), range.base().end(),
+			range.added().begin(), range.added().end(), neighbours.begin() + offsets[ u ] );
+	}
+	return CsrGraph( std::move( offsets ), std::move( neighbours ) );
+}
+
+float GraphOverlay::clustering_coefficient() const {
+	return graphAnon::clustering_coefficient( view() );
+}
+
+HopPlot GraphOverlay::hop_plot() const { return graphAnon::hop_plot( view() ); }
+
+bool GraphOverlay::is_anonymous( const uint32_t k ) const {
+	return graphAnon::is_anonymous( view(), k );
+}
+
+bool GraphOverlay::write( const std::string filename, const graphAnon::FileFormat format,
+	const bool varint, const graphAnon::Compression compression ) const {
+
+	if( format == graphAnon::FileFormat::binary ) {
+		return compression == graphAnon::Compression::none
+			&& write_binary_graph( filename, materialise(), NULL, 0, varint );
+	}
+
+	OverlayView const g = view();
+	const bool edge_list = format == graphAnon::FileFormat::edgeList;
+	std::string header;
+	GraphWriter::append( &header, g.num_vertices() );
+	header.push_back( '\n' );
+
+	GraphWriter writer( filename, compression );
+	const bool written = writer.is_open() && writer.write( header, g.num_vertices(),
+		[ &g, edge_list ]( const uint32_t u, std::string *buffer ) {
+			/* List the base and added neighbours in one ascending order, as
+			 * UnlabelledGraph::write() does. */
+			ScratchArena::Scope scratch;
+			OverlayNeighbourRange const range = g.neighbours( u );
+			uint32_t *const neighbours = ScratchArena::local().allocate< uint32_t >( g.degree( u ) );
+			uint32_t const *const last = std::merge( range.base().begin(), range.base().end(),
+				range.added().begin(), range.added().end(), neighbours );
+			for( uint32_t const *v_ptr = neighbours; v_ptr != last; ++v_ptr ) {
+				const uint32_t v = *v_ptr;
+				if( u > v ) { continue; } // only print undirected
+				if( edge_list ) {
+					GraphWriter::append( buffer, u );
+					buffer->push_back( ' ' );
+					GraphWriter::append( buffer, v );
+					buffer->push_back( '\n' );
+				}
+				else {
+					GraphWriter::append( buffer, v );
+					buffer->push_back( ' ' );
+				}
+			}
+			if( !edge_list ) { buffer->push_back( '\n' ); }
+		} );
+	return writer.close() && written;
+}
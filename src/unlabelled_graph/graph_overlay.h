@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Definition of a graph that layers added vertices and edges over a
+ * shared, immutable base graph.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPH_OVERLAY_H_
+#define GRAPH_OVERLAY_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <string>	/* For std::string */
+
+/* STL libraries in use */
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+#include "unlabelled_graph.h"
+#include "graph_writer.h"
+#include "identity_plan.h"
+
+/**
+ * @brief An undirected graph consisting of a shared, read-only CsrGraph plus
+ * a delta of new vertices and new edges.
+ *
+ * Anonymising a graph only ever adds to it, so the anonymised graph can be
+ * represented by the original plus what was added, at a cost in memory
+ * proportional to the delta only. Many overlays (e.g., one per k) can share
+ * one base, which none of them ever copies or modifies, so "before" and
+ * "after" statistics (or those of several anonymisations) can be compared
+ * without loading or copying the base graph more than once.
+ *
+ * The analyses index the delta in an OverlayView for their duration only,
+ * which costs O( n + delta ) memory rather than the O( n + m ) of
+ * materialise().
+ */
+class GraphOverlay {
+public:
+
+	/**
+	 * Constructs an overlay that (initially) adds nothing to base.
+	 * @param base The base graph, shared with its other owners.
+	 */
+	explicit GraphOverlay( std::shared_ptr< const CsrGraph > base );
+
+	/**
+	 * Constructs the overlay that turns base into supergraph, e.g., to
+	 * compare a graph that was anonymised in place with a snapshot of it
+	 * from before.
+	 * @param base The base graph, shared with its other owners.
+	 * @param supergraph A graph that contains every vertex and edge of base.
+	 * @return An overlay of base whose delta is every vertex and edge of
+	 * supergraph that base lacks.
+	 */
+	static GraphOverlay difference( std::shared_ptr< const CsrGraph > base,
+		CsrGraph const& supergraph );
+
+	/**
+	 * Accessor method to retrieve the number of vertices, |V|, including
+	 * the new vertices.
+	 */
+	uint32_t num_vertices() const { return base_->num_vertices() + num_new_vertices_; }
+
+	/**
+	 * Accessor method to retrieve the number of undirected edges, |E|,
+	 * including the new edges.
+	 */
+	uint64_t num_edges() const { return base_->num_edges() + added_edges_.size(); }
+
+	/**
+	 * Accessor method to retrieve the base graph.
+	 */
+	CsrGraph const& base() const { return *base_; }
+
+	/**
+	 * Accessor method to retrieve the edges added to the base graph.
+	 */
+	std::vector< std::pair< uint32_t, uint32_t > > const& added_edges() const { return added_edges_; }
+
+	/**
+	 * Adds isolated vertices after the existing ones.
+	 * @param num_vertices The number of vertices to add.
+	 */
+	void add_vertices( const uint32_t num_vertices ) { num_new_vertices_ += num_vertices; }
+
+	/**
+	 * Adds the undirected edge (u,v).
+	 * @pre u != v, both are less than num_vertices(), and (u,v) is neither in
+	 * the base graph nor already added.
+	 */
+	void add_edge( const uint32_t u, const uint32_t v ) {
+		added_edges_.push_back( std::make_pair( u, v ) );
+	}
+
+	/**
+	 * Adds the pseudo-vertices and edges of a planned k-degree anonymisation.
+	 * @param plan The plan, built from degrees.
+	 * @param degrees The degree sequence of the base graph.
+	 * @post This overlay describes the graph that hide_waldo() would produce.
+	 * @see UnlabelledGraph::apply()
+	 */
+	void apply( IdentityPlan const& plan, DegreeSequence const& degrees );
+
+	/**
+	 * Indexes the delta so that the overlaid graph can be analysed.
+	 * @return A view of this overlay, which must not outlive it.
+	 */
+	OverlayView view() const { return OverlayView( *base_, num_vertices(), added_edges_ ); }
+
+	/**
+	 * Merges the base graph and the delta into a single CsrGraph.
+	 */
+	CsrGraph materialise() const;
+
+	/**
+	 * Calculates the clustering coefficient of the overlaid graph.
+	 * @see UnlabelledGraph::clustering_coefficient()
+	 */
+	float clustering_coefficient() const;
+
+	/**
+	 * Computes the hop plot of the overlaid graph.
+	 * @see UnlabelledGraph::hop_plot()
+	 */
+	HopPlot hop_plot() const;
+
+	/**
+	 * Determines whether or not the overlaid graph is k-degree-anonymous.
+	 * @see UnlabelledGraph::is_anonymous()
+	 */
+	bool is_anonymous( const uint32_t k ) const;
+
+	/**
+	 * Writes the graph to a file.
+	 * @param filename The path of the file to (over)write.
+	 * @param format The format in which to write the graph. In the adjacency
+	 * list formats, each vertex's base neighbours come before its new ones.
+	 * @param varint Whether to delta+varint compress a binary file.
+	 * @param compression The streaming compression with which to write an
+	 * ascii file (which must be none for the binary format).
+	 * @return False if the file could not be written.
+	 * @see UnlabelledGraph::write()
+	 */
+	bool write( const std::string filename, const graphAnon::FileFormat format,
+		const bool varint = false,
+		const graphAnon::Compression compression = graphAnon::Compression::none ) const;
+
+private:
+
+	std::shared_ptr< const CsrGraph > base_; /**< The shared base graph. */
+	uint32_t num_new_vertices_; /**< The number of vertices added after the base's. */
+	std::vector< std::pair< uint32_t, uint32_t > > added_edges_; /**< The edges added to the base. */
+};
+
+#endif /* GRAPH_OVERLAY_H_ */
@@ -0,0 +1,178 @@
+/**
+ * @file
+ * @brief A set of functions for unit testing the GraphOverlay class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <set>
+
+#include "graph_overlay.test.h"
+#include "graph_overlay.h"
+#include "graph_analysis.h"
+#include "all_pairs_bfs.h"
+#include "triangle_count.h"
+#include "csr_graph.h"
+#include "random_graph.h"
+
+namespace
+{
+	typedef std::set< std::pair< uint32_t, uint32_t > > EdgeSet;
+
+	/**
+	 * Builds a CsrGraph on n vertices from a set of edges (u,v) with u < v.
+	 */
+	CsrGraph make_graph( const uint32_t n, EdgeSet const& edges ) {
+		return graphAnon::csr_from_edges( n, graphAnon::EdgeList( edges.begin(), edges.end() ) );
+	}
+
+	/**
+	 * Determines whether an overlay of base and the same graph built directly
+	 * agree on every analysis.
+	 */
+	bool agrees( GraphOverlay const& overlay, std::shared_ptr< const CsrGraph > const& base,
+		CsrGraph const& expected, const uint32_t k ) {
+		OverlayView const view = overlay.view();
+		if( view.num_vertices() != expected.num_vertices() ) { return false; }
+		if( view.num_edges() != expected.num_edges() ) { return false; }
+
+		std::vector< uint32_t > neighbours;
+		for( uint32_t v = 0; v < view.num_vertices(); ++v ) {
+			if( view.degree( v ) != expected.degree( v ) ) { return false; }
+			neighbours.assign( view.neighbours( v ).begin(), view.neighbours( v ).end() );
+			std::sort( neighbours.begin(), neighbours.end() );
+			NeighbourRange const range = expected.neighbours( v );
+			if( !std::equal( neighbours.begin(), neighbours.end(), range.begin(), range.end() ) ) {
+				return false;
+			}
+		}
+
+		CsrGraph const merged = overlay.materialise();
+		for( uint32_t v = 0; v < merged.num_vertices(); ++v ) {
+			NeighbourRange const a = merged.neighbours( v ), b = expected.neighbours( v );
+			if( !std::equal( a.begin(), a.end(), b.begin(), b.end() ) ) { return false; }
+		}
+
+		/* The triangles that the overlay adds, plus those of its base. */
+		if( TriangleCounter( overlay.base() ).count() + graphAnon::count_added_triangles( view )
+				!= TriangleCounter( expected ).count() ) {
+			return false;
+		}
+
+		/* Recovering the delta from the materialised graph. */
+		GraphOverlay const recovered = GraphOverlay::difference( base, expected );
+		EdgeSet added, recovered_added;
+		for( auto const& e : overlay.added_edges() ) {
+			added.insert( std::make_pair( std::min( e.first, e.second ), std::max( e.first, e.second ) ) );
+		}
+		recovered_added.insert( recovered.added_edges().begin(), recovered.added_edges().end() );
+		if( recovered.num_vertices() != overlay.num_vertices() || recovered_added != added ) {
+			return false;
+		}
+
+		return AllPairsBfs( view ).histogram() == AllPairsBfs( expected ).histogram()
+			&& TriangleCounter( view ).count() == TriangleCounter( expected ).count()
+			&& overlay.hop_plot() == graphAnon::hop_plot( expected )
+			&& overlay.clustering_coefficient() == graphAnon::clustering_coefficient( expected )
+			&& overlay.is_anonymous( k ) == graphAnon::is_anonymous( expected, k );
+	}
+}
+
+bool test_graph_overlay() {
+
+	bool passed = true;
+
+	/**
+	 * @test Empty delta
+	 * An overlay that adds nothing is the base graph.
+	 */
+	EdgeSet const path { { 0, 1 }, { 1, 2 }, { 2, 3 } };
+	auto const path_graph = std::make_shared< const CsrGraph >( make_graph( 4, path ) );
+	GraphOverlay unchanged( path_graph );
+	if( !agrees( unchanged, path_graph, *path_graph, 2 ) ) { passed = false; }
+
+	/**
+	 * @test Closing a cycle with a new vertex
+	 * Adding vertex 4 adjacent to both ends of the path 0-1-2-3 yields a
+	 * 5-cycle, which is 5-degree-anonymous.
+	 */
+	GraphOverlay cycle( path_graph );
+	cycle.add_vertices( 1 );
+	cycle.add_edge( 3, 4 );
+	cycle.add_edge( 4, 0 );
+	EdgeSet cycle_edges = path;
+	cycle_edges.insert( { { 3, 4 }, { 0, 4 } } );
+	if( !agrees( cycle, path_graph, make_graph( 5, cycle_edges ), 5 ) || !cycle.is_anonymous( 5 ) ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Triangles with one, two, and three added edges
+	 * Over the path 0-1-2-3, adding (0,2) closes 0-1-2; adding vertices 4
+	 * and 5 with edges (0,4), (1,4), (0,5), (4,5) forms 0-1-4 (two added
+	 * edges) and 0-4-5 (three added edges).
+	 */
+	GraphOverlay triangles( path_graph );
+	triangles.add_vertices( 2 );
+	EdgeSet triangle_edges = path;
+	for( auto const& e : EdgeSet { { 0, 2 }, { 0, 4 }, { 1, 4 }, { 0, 5 }, { 4, 5 } } ) {
+		triangles.add_edge( e.second, e.first );
+		triangle_edges.insert( e );
+	}
+	if( !agrees( triangles, path_graph, make_graph( 6, triangle_edges ), 2 )
+			|| graphAnon::count_added_triangles( triangles.view() ) != 3 ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Random deltas over a shared base
+	 * Several overlays of one random base, each with its own new vertices
+	 * and edges (some amongst old vertices, some touching new ones), should
+	 * each agree with their own graph and leave the base untouched.
+	 */
+	const uint32_t n = 300;
+	auto const base = std::make_shared< const CsrGraph >( graphAnon::random_gnm( n, 3 * n, 2017 ) );
+	graphAnon::EdgeList const base_list = graphAnon::edge_list( *base );
+	EdgeSet const base_edges( base_list.begin(), base_list.end() );
+	for( uint32_t const num_new_vertices : { 0u, 1u, 17u } ) {
+		GraphOverlay overlay( base );
+		overlay.add_vertices( num_new_vertices );
+		EdgeSet all_edges = base_edges;
+		CsrGraph const delta = graphAnon::random_gnm( n + num_new_vertices, n, 2018 + num_new_vertices );
+		for( auto const& e : graphAnon::edge_list( delta ) ) {
+			if( all_edges.insert( e ).second ) { overlay.add_edge( e.first, e.second ); }
+		}
+		if( !agrees( overlay, base, make_graph( n + num_new_vertices, all_edges ), 2 ) ) {
+			passed = false;
+		}
+	}
+	if( base->num_edges() != base_edges.size() ) { passed = false; }
+
+	return passed;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file
+ * @brief Implementation of the GraphWriter class in graph_writer.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t */
+#include <cstdio>		/* for FILE, fopen, fwrite, fclose */
+#include <algorithm>	/* for std::min */
+
+/* STL stuff in use. */
+#include <vector>
+#include <string>
+
+#include "omp.h"
+
+#ifdef GRAPHANON_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef GRAPHANON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "graph_writer.h" /* implementing this class. */
+
+/**
+ * @brief The destination of a GraphWriter's bytes.
+ */
+class GraphWriter::Sink {
+public:
+	virtual ~Sink() {}
+
+	/**
+	 * Writes length bytes, returning false (and remaining false) on failure.
+	 */
+	virtual bool write( char const *data, const size_t length ) = 0;
+
+	/**
+	 * Flushes and closes the destination; further writes fail.
+	 */
+	virtual bool close() = 0;
+
+	virtual bool is_open() const = 0;
+};
+
+namespace
+{
+	/**
+	 * The number of rows formatted into one buffer by one thread.
+	 */
+	const uint32_t rows_per_block = 16384;
+
+	/**
+	 * The number of blocks per OpenMP thread formatted before any is written.
+	 */
+	const uint32_t blocks_per_thread = 2;
+
+	/**
+	 * The size of the buffer in which compressed output is staged.
+	 */
+	const size_t output_buffer_bytes = 1 << 20;
+
+	class StreamSink : public GraphWriter::Sink {
+	public:
+		explicit StreamSink( std::ostream *os ) : os_( os ) {}
+		bool write( char const *data, const size_t length ) override {
+			if( os_ == NULL ) { return false; }
+			os_->write( data, length );
+			return static_cast< bool >( *os_ );
+		}
+		bool close() override {
+			if( os_ == NULL ) { return false; }
+			os_->flush();
+			const bool ok = static_cast< bool >( *os_ );
+			os_ = NULL;
+			return ok;
+		}
+		bool is_open() const override { return os_ != NULL && *os_; }
+	private:
+		std::ostream *os_;
+	};
+
+	class FileSink : public GraphWriter::Sink {
+	public:
+		explicit FileSink( const std::string filename )
+			: file_( std::fopen( filename.c_str(), "wb" ) ), ok_( file_ != NULL ) {}
+		~FileSink() { close(); }
+		bool write( char const *data, const size_t length ) override {
+			ok_ = ok_ && std::fwrite( data, 1, length, file_ ) == length;
+			return ok_;
+		}
+		bool close() override {
+			if( file_ == NULL ) { return false; }
+			ok_ = ( std::fclose( file_ ) == 0 ) && ok_;
+			file_ = NULL;
+			return ok_;
+		}
+		bool is_open() const override { return file_ != NULL && ok_; }
+	private:
+		FILE *file_;
+		bool ok_;
+	};
+
+#ifdef GRAPHANON_HAVE_ZLIB
+	class GzipSink : public GraphWriter::Sink {
+	public:
+		explicit GzipSink( const std::string filename )
+			: file_( gzopen( filename.c_str(), "wb" ) ), ok_( file_ != NULL ) {
+			if( ok_ ) { gzbuffer( file_, output_buffer_bytes ); }
+		}
+		~GzipSink() { close(); }
+		bool write( char const *data, const size_t length ) override {
+			/* gzwrite takes an unsigned int length, so write in pieces. */
+			for( size_t done = 0; ok_ && done < length; ) {
+				const unsigned piece = static_cast< unsigned >(
+					std::min< size_t >( length - done, 1u << 30 ) );
+				ok_ = gzwrite( file_, data + done, piece ) == static_cast< int >( piece );
+				done += piece;
+			}
+			return ok_;
+		}
+		bool close() override {
+			if( file_ == NULL ) { return false; }
+			ok_ = ( gzclose( file_ ) == Z_OK ) && ok_;
+			file_ = NULL;
+			return ok_;
+		}
+		bool is_open() const override { return file_ != NULL && ok_; }
+	private:
+		gzFile file_;
+		bool ok_;
+	};
+#endif
+
+#ifdef GRAPHANON_HAVE_ZSTD
+	class ZstdSink : public GraphWriter::Sink {
+	public:
+		explicit ZstdSink( const std::string filename )
+			: file_( filename ), context_( ZSTD_createCCtx() ), staging_( ZSTD_CStreamOutSize() ),
+			ok_( file_.is_open() && context_ != NULL ) {}
+		~ZstdSink() { close(); }
+		bool write( char const *data, const size_t length ) override {
+			ZSTD_inBuffer in = { data, length, 0 };
+			while( ok_ && in.pos < in.size ) { compress( &in, ZSTD_e_continue ); }
+			return ok_;
+		}
+		bool close() override {
+			if( context_ == NULL ) { return false; }
+			ZSTD_inBuffer in = { NULL, 0, 0 };
+			while( ok_ && compress( &in, ZSTD_e_end ) != 0 ) {}
+			ZSTD_freeCCtx( context_ );
+			context_ = NULL;
+			ok_ = file_.close() && ok_;
+			return ok_;
+		}
+		bool is_open() const override { return context_ != NULL && ok_; }
+	private:
+		/**
+		 * Compresses (some of) in and writes whatever compressed bytes are ready.
+		 * @return The number of bytes still buffered inside ZSTD (0 when done).
+		 */
+		size_t compress( ZSTD_inBuffer *in, const ZSTD_EndDirective mode ) {
+			ZSTD_outBuffer out = { staging_.data(), staging_.size(), 0 };
+			const size_t remaining = ZSTD_compressStream2( context_, &out, in, mode );
+			if( ZSTD_isError( remaining ) ) { ok_ = false; return 0; }
+			ok_ = file_.write( staging_.data(), out.pos );
+			return remaining;
+		}
+		FileSink file_;
+		ZSTD_CCtx *context_;
+		std::vector< char > staging_;
+		bool ok_;
+	};
+#endif
+}
+
+GraphWriter::GraphWriter( std::ostream *os ) : sink_( new StreamSink( os ) ) {}
+
+GraphWriter::GraphWriter( const std::string filename, const graphAnon::Compression compression ) {
+	switch( compression ) {
+		case graphAnon::Compression::none:
+			sink_.reset( new FileSink( filename ) );
+			break;
+#ifdef GRAPHANON_HAVE_ZLIB
+		case graphAnon::Compression::gzip:
+			sink_.reset( new GzipSink( filename ) );
+			break;
+#endif
+#ifdef GRAPHANON_HAVE_ZSTD
+		case graphAnon::Compression::zstd:
+			sink_.reset( new ZstdSink( filename ) );
+			break;
+#endif
+		default:
+			break; /* unsupported: leave closed. */
+	}
+}
+
+GraphWriter::~GraphWriter() { if( is_open() ) { close(); } }
+
+bool GraphWriter::supported( const graphAnon::Compression compression ) {
+	switch( compression ) {
+		case graphAnon::Compression::none: return true;
+#ifdef GRAPHANON_HAVE_ZLIB
+		case graphAnon::Compression::gzip: return true;
+#endif
+#ifdef GRAPHANON_HAVE_ZSTD
+		case graphAnon::Compression::zstd: return true;
+#endif
+		default: return false;
+	}
+}
+
+bool GraphWriter::is_open() const { return sink_ != nullptr && sink_->is_open(); }
+
+bool GraphWriter::close() { return sink_ != nullptr && sink_->close(); }
+
+bool GraphWriter::write( std::string const& text ) {
+	return is_open() && sink_->write( text.data(), text.size() );
+}
+
+bool GraphWriter::write( std::string const& header, const uint32_t num_rows,
+	RowFormatter const& format_row, const bool parallel ) {
+
+	if( !write( header ) ) { return false; }
+
+	const uint32_t num_blocks = ( static_cast< uint64_t >( num_rows ) + rows_per_block - 1 ) / rows_per_block;
+	const uint32_t blocks_per_round = parallel ? blocks_per_thread * omp_get_max_threads() : 1;
+	std::vector< std::string > buffers( std::min( num_blocks, blocks_per_round ) );
+
+	/* Format a round of blocks at once, then write them out in order; the
+	 * buffers keep their capacity from one round to the next. */
+	for( uint32_t first_block = 0; first_block < num_blocks; first_block += blocks_per_round ) {
+		const uint32_t round_size = std::min( blocks_per_round, num_blocks - first_block );
+
+#pragma omp parallel for schedule( dynamic, 1 ) if( parallel )
+		for( uint32_t i = 0; i < round_size; ++i ) {
+			std::string &buffer = buffers[ i ];
+			buffer.clear();
+			const uint32_t first = ( first_block + i ) * rows_per_block;
+			const uint32_t last = std::min< uint64_t >( num_rows, static_cast< uint64_t >( first ) + rows_per_block );
+			for( uint32_t row = first; row < last; ++row ) { format_row( row, &buffer ); }
+		}
+
+		for( uint32_t i = 0; i < round_size; ++i ) {
+			if( !sink_->write( buffers[ i ].data(), buffers[ i ].size() ) ) { return false; }
+		}
+	}
+	return true;
+}
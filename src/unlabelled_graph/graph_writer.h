@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief Definition of a buffered writer that formats a graph file in
+ * parallel and optionally compresses it as it is written.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPH_WRITER_H_
+#define GRAPH_WRITER_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For size_t */
+#include <string>	/* For std::string */
+#include <ostream>	/* For std::ostream */
+
+/* STL libraries in use */
+#include <functional>
+#include <memory>
+
+namespace graphAnon {
+	/**
+	 * The streaming compression with which a GraphWriter writes a file.
+	 */
+	enum class Compression {
+		none, /**< The file is written as is. */
+		gzip, /**< The file is gzip compressed (requires zlib). */
+		zstd /**< The file is Zstandard compressed (requires libzstd). */
+	};
+}
+
+/**
+ * @brief Writes a graph file as a header followed by one formatted row per
+ * vertex, with few, large writes.
+ *
+ * Rows are formatted into per-block buffers by every OpenMP thread at once,
+ * a round of blocks at a time, and the blocks are then handed to the output
+ * in order. The output is a std::ostream, a plain file, or a gzip or
+ * Zstandard stream, depending on the constructor and on which compression
+ * libraries were found when graphAnon was configured.
+ */
+class GraphWriter {
+public:
+
+	/**
+	 * Formats row (i.e., vertex) row of the file by appending it to buffer.
+	 * Must be safe to call concurrently for different rows.
+	 */
+	typedef std::function< void( const uint32_t row, std::string *buffer ) > RowFormatter;
+
+	/**
+	 * Constructs a writer that appends to an existing stream.
+	 * @param os The stream to write to, which must outlive this GraphWriter.
+	 */
+	explicit GraphWriter( std::ostream *os );
+
+	/**
+	 * Constructs a writer that (over)writes a file.
+	 * @param filename The path of the file to write.
+	 * @param compression How to compress the file.
+	 * @post is_open() is false if the file could not be created or the
+	 * compression is not supported().
+	 */
+	GraphWriter( const std::string filename, const graphAnon::Compression compression );
+
+	/**
+	 * Destroys the GraphWriter, closing the output if it is still open.
+	 */
+	~GraphWriter();
+
+	GraphWriter( GraphWriter const& ) = delete;
+	GraphWriter& operator=( GraphWriter const& ) = delete;
+
+	/**
+	 * Determines whether graphAnon was built with support for a compression.
+	 */
+	static bool supported( const graphAnon::Compression compression );
+
+	/**
+	 * Determines whether the output is open and every write so far succeeded.
+	 */
+	bool is_open() const;
+
+	/**
+	 * Writes a header and then num_rows formatted rows.
+	 * @param header The first line(s) of the file, written verbatim.
+	 * @param num_rows The number of rows to format.
+	 * @param format_row Appends the text of one row to a buffer.
+	 * @param parallel Whether to format rows with every OpenMP thread.
+	 * @return False if any write failed.
+	 */
+	bool write( std::string const& header, const uint32_t num_rows,
+		RowFormatter const& format_row, const bool parallel = true );
+
+	/**
+	 * Writes text verbatim.
+	 * @return False if the write failed.
+	 */
+	bool write( std::string const& text );
+
+	/**
+	 * Flushes and closes the output (finishing any compressed stream).
+	 * @return False if any write (including this final one) failed.
+	 */
+	bool close();
+
+	/**
+	 * Appends the decimal representation of x to buffer, like
+	 * std::ostream::operator<<( uint64_t ) but without locales or virtual calls.
+	 */
+	static void append( std::string *buffer, uint64_t x ) {
+		char digits[ 20 ];
+		uint32_t length = 0;
+		do {
+			digits[ length++ ] = static_cast< char >( '0' + x % 10 );
+			x /= 10;
+		} while( x != 0 );
+		while( length != 0 ) { buffer->push_back( digits[ --length ] ); }
+	}
+
+	/**
+	 * The destination of the formatted bytes (defined in graph_writer.cpp).
+	 */
+	class Sink;
+
+private:
+
+	std::unique_ptr< Sink > sink_; /**< Where formatted bytes are written. */
+};
+
+#endif /* GRAPH_WRITER_H_ */
@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Implementation of the hop plot estimators in hop_plot_estimator.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cstddef>		/* for size_t */
+#include <cmath>		/* for std::sqrt, std::log, std::ldexp, std::llround */
+#include <algorithm>	/* for std::max, std::copy */
+#include <random>		/* for std::mt19937_64 */
+#include <numeric>		/* for std::iota */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "hop_plot_estimator.h" /* implementing these functions. */
+#include "all_pairs_bfs.h"
+
+namespace
+{
+	/** The number of groups of sources whose spread gives the confidence interval. */
+	const uint32_t num_sample_groups = 32;
+
+	/** The two-sided 95% quantile of the normal distribution. */
+	const double z_95 = 1.959964;
+
+	/**
+	 * Estimates the hop plot from a BFS from each of a uniform random sample
+	 * of sources. The sample is split into groups, and the spread of the
+	 * group estimates (batch means) gives the confidence interval.
+	 */
+	template< typename Graph >
+	HopPlot sampled_hop_plot( Graph const& g, HopPlotOptions const& options, HopPlotError *error ) {
+
+		const uint32_t n = g.num_vertices();
+		const uint32_t s = std::min( options.num_samples, n );
+		if( s == n ) { return graphAnon::hop_plot( g ); }
+
+		/* Draw the sample without replacement with a partial shuffle. */
+		std::vector< uint32_t > sources( n );
+		std::iota( sources.begin(), sources.end(), 0 );
+		std::mt19937_64 rng( options.seed );
+		for( uint32_t i = 0; i < s; ++i ) {
+			std::uniform_int_distribution< uint32_t > pick( i, n - 1 );
+			std::swap( sources[ i ], sources[ pick( rng ) ] );
+		}
+
+		/* One (serial) multi-source BFS per group, in parallel across groups. */
+		const uint32_t num_groups = std::max( 2u, std::min( num_sample_groups, s ) );
+		std::vector< std::vector< uint64_t > > histograms( num_groups );
+		AllPairsBfs const bfs( g );
+#pragma omp parallel for schedule( dynamic, 1 )
+		for( uint32_t group = 0; group < num_groups; ++group ) {
+			const size_t first = static_cast< uint64_t >( s ) * group / num_groups;
+			const size_t last = static_cast< uint64_t >( s ) * ( group + 1 ) / num_groups;
+			histograms[ group ] = bfs.histogram( sources.data() + first, last - first );
+		}
+		size_t max_length = 0;
+		for( auto const& h : histograms ) { max_length = std::max( max_length, h.size() ); }
+
+		/* Scale by the sampling rate, with a finite population correction. */
+		const double correction = std::sqrt( 1.0 - s / static_cast< double >( n ) );
+		HopPlot result;
+		if( error != NULL ) { error->clear(); }
+		for( uint32_t d = 1; d < max_length; ++d ) {
+			uint64_t total = 0;
+			std::vector< double > group_estimates( num_groups );
+			for( uint32_t group = 0; group < num_groups; ++group ) {
+				const uint64_t count = d < histograms[ group ].size() ? histograms[ group ][ d ] : 0;
+				const size_t size = static_cast< uint64_t >( s ) * ( group + 1 ) / num_groups
+					- static_cast< uint64_t >( s ) * group / num_groups;
+				total += count;
+				group_estimates[ group ] = n * static_cast< double >( count ) / size;
+			}
+			const double estimate = n * static_cast< double >( total ) / s;
+			double variance = 0;
+			for( double const x : group_estimates ) { variance += ( x - estimate ) * ( x - estimate ); }
+			variance /= static_cast< double >( num_groups ) * ( num_groups - 1 );
+
+			if( total > 0 || d == 1 ) {
+				result[ d ] = static_cast< uint64_t >( std::llround( estimate ) );
+				if( error != NULL ) { ( *error )[ d ] = z_95 * correction * std::sqrt( variance ); }
+			}
+		}
+		if( n > 0 && result.empty() ) { result[ 1 ] = 0; }
+		return result;
+	}
+
+	/** Mixes the bits of x (SplitMix64's finaliser), to hash vertex ids. */
+	inline uint64_t mix( uint64_t x ) {
+		x += 0x9e3779b97f4a7c15ull;
+		x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+		x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+		return x ^ ( x >> 31 );
+	}
+
+	/**
+	 * Estimates the cardinality of one HyperLogLog counter, with the
+	 * linear counting correction for small cardinalities.
+	 */
+	double cardinality( uint8_t const *registers, const uint32_t m ) {
+		double sum = 0;
+		uint32_t zeros = 0;
+		for( uint32_t j = 0; j < m; ++j ) {
+			sum += std::ldexp( 1.0, -registers[ j ] );
+			zeros += registers[ j ] == 0;
+		}
+		const double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709
+			: 0.7213 / ( 1 + 1.079 / m );
+		const double estimate = alpha * m * m / sum;
+		if( estimate <= 2.5 * m && zeros > 0 ) { return m * std::log( m / static_cast< double >( zeros ) ); }
+		return estimate;
+	}
+
+	/**
+	 * Estimates the hop plot with HyperANF: after level t, the counter of
+	 * vertex v holds the set of vertices within t hops of v, so the sum of
+	 * the counters' cardinalities estimates the number of pairs within t hops.
+	 */
+	template< typename Graph >
+	HopPlot sketched_hop_plot( Graph const& g, HopPlotOptions const& options ) {
+
+		const uint32_t n = g.num_vertices();
+		const uint32_t m = options.num_registers;
+		assert( m >= 16 && m <= 65536 && ( m & ( m - 1 ) ) == 0 );
+		const uint32_t b = __builtin_ctz( m );
+
+		/* Level 0: each counter holds only its own vertex. */
+		std::vector< uint8_t > current( static_cast< uint64_t >( n ) * m, 0 );
+		std::vector< uint8_t > next( current.size() );
+		std::vector< double > sizes( n );
+		std::vector< char > changed( n, 1 ), next_changed( n );
+		double previous_total = 0;
+#pragma omp parallel for reduction( +: previous_total )
+		for( uint32_t v = 0; v < n; ++v ) {
+			const uint64_t h = mix( v ^ options.seed );
+			const uint64_t rest = h << b;
+			const uint8_t rank = rest == 0 ? 64 - b + 1 : __builtin_clzll( rest ) + 1;
+			current[ static_cast< uint64_t >( v ) * m + ( h >> ( 64 - b ) ) ] = rank;
+			sizes[ v ] = cardinality( current.data() + static_cast< uint64_t >( v ) * m, m );
+			previous_total += sizes[ v ];
+		}
+
+		HopPlot result;
+		for( uint32_t level = 1; level <= n; ++level ) {
+			double total = 0;
+			uint32_t num_changed = 0;
+
+			/* Only a vertex with a neighbour that changed can change. */
+#pragma omp parallel for reduction( +: total, num_changed ) schedule( dynamic, 256 )
+			for( uint32_t v = 0; v < n; ++v ) {
+				uint8_t const *own = current.data() + static_cast< uint64_t >( v ) * m;
+				uint8_t *merged = next.data() + static_cast< uint64_t >( v ) * m;
+				std::copy( own, own + m, merged );
+				bool grew = false;
+				for( uint32_t const u : g.neighbours( v ) ) {
+					if( !changed[ u ] ) { continue; }
+					uint8_t const *theirs = current.data() + static_cast< uint64_t >( u ) * m;
+					for( uint32_t j = 0; j < m; ++j ) { merged[ j ] = std::max( merged[ j ], theirs[ j ] ); }
+				}
+				for( uint32_t j = 0; j < m && !grew; ++j ) { grew = merged[ j ] != own[ j ]; }
+				if( grew ) {
+					sizes[ v ] = cardinality( merged, m );
+					++num_changed;
+				}
+				next_changed[ v ] = grew;
+				total += sizes[ v ];
+			}
+			if( num_changed == 0 ) { break; }
+
+			const double pairs = std::max( 0.0, total - previous_total );
+			result[ level ] = static_cast< uint64_t >( std::llround( pairs ) );
+			previous_total = total;
+			std::swap( current, next );
+			std::swap( changed, next_changed );
+		}
+		if( n > 0 && result.empty() ) { result[ 1 ] = 0; }
+		return result;
+	}
+
+	template< typename Graph >
+	HopPlot estimate( Graph const& g, HopPlotOptions const& options, HopPlotError *error ) {
+		if( error != NULL ) { error->clear(); }
+		switch( options.method ) {
+			case graphAnon::HopPlotMethod::sampled: return sampled_hop_plot( g, options, error );
+			case graphAnon::HopPlotMethod::sketch: return sketched_hop_plot( g, options );
+			default: return graphAnon::hop_plot( g );
+		}
+	}
+}
+
+namespace graphAnon
+{
+	HopPlot estimate_hop_plot( CsrGraph const& g, HopPlotOptions const& options, HopPlotError *error ) {
+		return estimate( g, options, error );
+	}
+
+	HopPlot estimate_hop_plot( OverlayView const& g, HopPlotOptions const& options,
+		HopPlotError *error ) {
+		return estimate( g, options, error );
+	}
+}
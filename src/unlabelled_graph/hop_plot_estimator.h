@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief Definition of the approximate (sampled and sketched) hop plot
+ * estimators, for graphs on which the exact all-pairs BFS is too slow.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOP_PLOT_ESTIMATOR_H_
+#define HOP_PLOT_ESTIMATOR_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+/* STL libraries in use */
+#include <map>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+#include "graph_analysis.h" /* for HopPlot */
+
+namespace graphAnon
+{
+	/** The supported methods of computing a hop plot. */
+	enum class HopPlotMethod {
+		/** A BFS from every vertex: exact, but O( nm ) time. */
+		exact,
+
+		/**
+		 * A BFS from each of a uniform random sample of vertices, scaled by
+		 * the sampling rate, with a confidence interval on each count: O( sm )
+		 * time for s samples.
+		 */
+		sampled,
+
+		/**
+		 * HyperANF: a HyperLogLog counter per vertex, unioned with those of its
+		 * neighbours once per level, so that the hop plot takes one pass over
+		 * the edges per level of the diameter, in O( n * registers ) memory.
+		 */
+		sketch
+	};
+}
+
+/**
+ * The 95% confidence half-width of each count in an estimated HopPlot.
+ */
+typedef std::map< uint32_t, double > HopPlotError;
+
+/**
+ * @brief The settings of an (approximate) hop plot.
+ */
+struct HopPlotOptions {
+	graphAnon::HopPlotMethod method; /**< How to compute the hop plot. */
+	uint32_t num_samples; /**< The number of BFS sources for the sampled method. */
+	uint32_t num_registers; /**< The HyperLogLog registers per vertex for the sketch method. */
+	uint64_t seed; /**< Seeds the sample or the sketch hash function. */
+
+	/**
+	 * Constructs the default settings: exact, or 4096 samples, or 64
+	 * registers (a relative standard error of about 13% per counter).
+	 */
+	HopPlotOptions() : method( graphAnon::HopPlotMethod::exact ), num_samples( 4096 ),
+		num_registers( 64 ), seed( 1 ) {}
+};
+
+namespace graphAnon
+{
+	/**
+	 * Computes a hop plot, exactly or approximately.
+	 * @param g The graph.
+	 * @param options The method of computing it and its settings.
+	 * @param error If not NULL, set to the 95% confidence half-width of each
+	 * count of a sampled hop plot (and left empty for the other methods).
+	 * @returns A HopPlot, which average_path_length() and harmonic_mean()
+	 * accept as for an exact one. Counts are rounded to integers.
+	 * @pre options.num_registers is a power of two in [ 16, 65536 ].
+	 */
+	HopPlot estimate_hop_plot( CsrGraph const& g, HopPlotOptions const& options,
+		HopPlotError *error = NULL );
+
+	/** @copydoc estimate_hop_plot( CsrGraph const&, HopPlotOptions const&, HopPlotError* ) */
+	HopPlot estimate_hop_plot( OverlayView const& g, HopPlotOptions const& options,
+		HopPlotError *error = NULL );
+}
+
+#endif /* HOP_PLOT_ESTIMATOR_H_ */
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @brief A set of functions for unit testing the hop plot estimators.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cmath>   /* for std::fabs */
+#include <vector>
+
+#include "hop_plot_estimator.test.h"
+#include "hop_plot_estimator.h"
+#include "graph_analysis.h"
+#include "csr_graph.h"
+#include "random_graph.h"
+
+namespace
+{
+	/** The number of connected ordered pairs (u,v), u != v, in a hop plot. */
+	double reachable_pairs( HopPlot const& hop_plot ) {
+		double pairs = 0;
+		for( auto const& hp : hop_plot ) { pairs += hp.second; }
+		return pairs;
+	}
+
+	bool within( const double estimate, const double exact, const double relative_error ) {
+		return std::fabs( estimate - exact ) <= relative_error * std::fabs( exact );
+	}
+}
+
+bool test_hop_plot_estimator() {
+
+	bool passed = true;
+	/* A fixed seed checks the statistical tolerances below against the same
+	 * graph on every run (whatever the -seed). */
+	CsrGraph const g = graphAnon::random_gnm( 3000, 9000, 2017 );
+	HopPlot const exact = graphAnon::hop_plot( g );
+	const float exact_apl = graphAnon::average_path_length( exact, g.num_vertices(), false );
+
+	/**
+	 * @test Boundary case: sampling every vertex
+	 * A sample at least as large as the graph is the exact hop plot.
+	 */
+	HopPlotOptions options;
+	options.method = graphAnon::HopPlotMethod::sampled;
+	options.num_samples = g.num_vertices();
+	HopPlotError error;
+	if( graphAnon::estimate_hop_plot( g, options, &error ) != exact ) { passed = false; }
+
+	/**
+	 * @test Sampled sources
+	 * A 10% sample should estimate the APL to within 2% and (nearly) every
+	 * count to within a few times its confidence half-width.
+	 */
+	options.num_samples = 300;
+	HopPlot const sampled = graphAnon::estimate_hop_plot( g, options, &error );
+	if( !within( graphAnon::average_path_length( sampled, g.num_vertices(), false ), exact_apl, 0.02 ) ) {
+		passed = false;
+	}
+	for( auto const& hp : exact ) {
+		auto const estimate = sampled.find( hp.first );
+		if( hp.second > g.num_vertices() &&
+				( estimate == sampled.end() || std::fabs( static_cast< double >( estimate->second )
+					- hp.second ) > 4 * error[ hp.first ] ) ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test HyperLogLog sketches
+	 * With 256 registers per vertex (a relative standard error of about 6.5%
+	 * per counter), the APL and the number of reachable pairs should be
+	 * within 10% of exact.
+	 */
+	options.method = graphAnon::HopPlotMethod::sketch;
+	options.num_registers = 256;
+	HopPlot const sketched = graphAnon::estimate_hop_plot( g, options, &error );
+	if( !within( graphAnon::average_path_length( sketched, g.num_vertices(), false ), exact_apl, 0.1 )
+			|| !within( reachable_pairs( sketched ), reachable_pairs( exact ), 0.1 )
+			|| !error.empty() ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Boundary case: no edges
+	 * Every method reports a zero count at length 1 only.
+	 */
+	CsrGraph const isolated = graphAnon::csr_from_edges( 5, {} );
+	HopPlot const empty { { 1, 0 } };
+	for( auto const method : { graphAnon::HopPlotMethod::sampled, graphAnon::HopPlotMethod::sketch } ) {
+		options.method = method;
+		options.num_samples = 2;
+		if( graphAnon::estimate_hop_plot( isolated, options ) != empty ) { passed = false; }
+	}
+
+	return passed;
+}
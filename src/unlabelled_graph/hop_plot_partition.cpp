@@ -0,0 +1,190 @@
+/**
+ * @file
+ * @brief Implementation of the hop plot partition in hop_plot_partition.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::min, std::max */
+#include <string>		/* for std::string, std::getline */
+#include <sstream>		/* for std::istringstream */
+
+/* STL stuff in use. */
+#include <vector>
+
+#ifdef GRAPHANON_HAVE_MPI
+#define OMPI_SKIP_MPICXX	/* only the C bindings are in use. */
+#define MPICH_SKIP_MPICXX
+#include "mpi.h"
+#endif
+
+#include "hop_plot_partition.h" /* implementing these functions. */
+#include "all_pairs_bfs.h"
+
+namespace
+{
+	/**
+	 * The number of consecutive vertex ids dealt to each part in turn: the
+	 * largest AllPairsBfs::batch_size, so that part files written by builds
+	 * for different vector widths still cover the same sources.
+	 */
+	const uint32_t partition_block = 512;
+
+	static_assert( partition_block % AllPairsBfs::batch_size == 0,
+		"every BFS batch must lie within one block of the partition" );
+
+	/** The first token of a partial hop plot file. */
+	const char *const part_magic = "graphAnon-hop-plot-part";
+
+	/**
+	 * Converts a histogram of path lengths to a hop plot. As for hop_plot(),
+	 * length 1 is always recorded for a non-empty graph, and other lengths
+	 * only if they occur, so that the parts sum to the exact hop plot.
+	 */
+	HopPlot to_hop_plot( std::vector< uint64_t > const& histogram, const uint32_t num_vertices ) {
+		HopPlot result;
+		for( uint32_t d = 1; d < histogram.size(); ++d ) {
+			if( histogram[ d ] > 0 || d == 1 ) { result[ d ] = histogram[ d ]; }
+		}
+		if( num_vertices > 0 && result.empty() ) { result[ 1 ] = 0; }
+		return result;
+	}
+}
+
+namespace graphAnon
+{
+	HopPlotPart partial_hop_plot( CsrGraph const& g, const uint32_t part, const uint32_t num_parts ) {
+		const uint32_t n = g.num_vertices();
+		std::vector< uint32_t > sources;
+		for( uint64_t first = static_cast< uint64_t >( part ) * partition_block; first < n;
+				first += static_cast< uint64_t >( num_parts ) * partition_block ) {
+			const uint64_t last = std::min< uint64_t >( n, first + partition_block );
+			for( uint64_t v = first; v < last; ++v ) { sources.push_back( static_cast< uint32_t >( v ) ); }
+		}
+
+		HopPlotPart result;
+		result.part = part;
+		result.num_parts = num_parts;
+		result.num_vertices = n;
+		result.hop_plot = to_hop_plot( AllPairsBfs( g ).histogram( sources.data(), sources.size() ), n );
+		return result;
+	}
+
+	bool merge_hop_plot_parts( std::vector< HopPlotPart > const& parts, HopPlotPart *total ) {
+		if( parts.empty() || parts.size() != parts[ 0 ].num_parts ) { return false; }
+		std::vector< char > seen( parts.size(), 0 );
+		HopPlotPart result;
+		result.num_vertices = parts[ 0 ].num_vertices;
+		for( HopPlotPart const& p : parts ) {
+			if( p.num_parts != parts.size() || p.part >= p.num_parts || seen[ p.part ]
+					|| p.num_vertices != result.num_vertices ) {
+				return false;
+			}
+			seen[ p.part ] = 1;
+			for( auto const& hp : p.hop_plot ) { result.hop_plot[ hp.first ] += hp.second; }
+		}
+		*total = result;
+		return true;
+	}
+
+	void write_hop_plot_part( HopPlotPart const& part, std::ostream *os ) {
+		*os << part_magic << " " << part.part << " " << part.num_parts << " "
+			<< part.num_vertices << "\n";
+		for( auto const& hp : part.hop_plot ) { *os << hp.first << " " << hp.second << "\n"; }
+	}
+
+	bool read_hop_plot_part( std::istream *is, HopPlotPart *part ) {
+		std::string magic;
+		HopPlotPart result;
+		if( !( *is >> magic >> result.part >> result.num_parts >> result.num_vertices )
+				|| magic != part_magic || result.part >= result.num_parts ) {
+			return false;
+		}
+		/* One length and its count per line, so that a dangling length is not
+		 * mistaken for the end of the file. */
+		std::string line;
+		std::getline( *is, line );
+		while( std::getline( *is, line ) ) {
+			if( line.empty() ) { continue; }
+			std::istringstream record( line );
+			uint32_t length;
+			uint64_t count;
+			std::string trailing;
+			if( !( record >> length >> count ) || record >> trailing
+					|| length == 0 || result.hop_plot.count( length ) != 0 ) {
+				return false;
+			}
+			result.hop_plot[ length ] = count;
+		}
+		*part = result;
+		return true;
+	}
+
+#ifdef GRAPHANON_HAVE_MPI
+	bool mpi_available() { return true; }
+
+	bool mpi_hop_plot( CsrGraph const& g, HopPlotPart *total, bool *is_root ) {
+		int initialised;
+		MPI_Initialized( &initialised );
+		if( !initialised && MPI_Init( NULL, NULL ) != MPI_SUCCESS ) { return false; }
+		int rank, size;
+		MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+		MPI_Comm_size( MPI_COMM_WORLD, &size );
+		*is_root = rank == 0;
+
+		HopPlotPart const part = partial_hop_plot( g, rank, size );
+		std::vector< uint64_t > histogram;
+		for( auto const& hp : part.hop_plot ) {
+			histogram.resize( std::max< size_t >( histogram.size(), hp.first + 1 ), 0 );
+			histogram[ hp.first ] = hp.second;
+		}
+
+		/* Every rank must have loaded the same graph, and the histograms are
+		 * padded to the longest path length of any rank. */
+		uint64_t local[ 3 ] = { histogram.size(), part.num_vertices, ~static_cast< uint64_t >( part.num_vertices ) };
+		uint64_t global[ 3 ];
+		bool ok = MPI_Allreduce( local, global, 3, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD ) == MPI_SUCCESS
+			&& global[ 1 ] == ~global[ 2 ];
+		if( ok ) {
+			histogram.resize( global[ 0 ], 0 );
+			std::vector< uint64_t > sum( histogram.size(), 0 );
+			ok = MPI_Reduce( histogram.data(), sum.data(), static_cast< int >( histogram.size() ),
+				MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD ) == MPI_SUCCESS;
+			if( ok && *is_root ) {
+				total->part = 0;
+				total->num_parts = 1;
+				total->num_vertices = part.num_vertices;
+				total->hop_plot = to_hop_plot( sum, part.num_vertices );
+			}
+		}
+		if( !initialised ) { MPI_Finalize(); }
+		return ok;
+	}
+#else
+	bool mpi_available() { return false; }
+
+	bool mpi_hop_plot( CsrGraph const&, HopPlotPart*, bool* ) { return false; }
+#endif
+}
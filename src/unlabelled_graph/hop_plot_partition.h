@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Definition of the partition of an exact hop plot's BFS sources
+ * across processes, and of the reduction of their partial hop plots.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOP_PLOT_PARTITION_H_
+#define HOP_PLOT_PARTITION_H_
+
+#include <cstdint>	/* For uint32_t */
+#include <istream>	/* For std::istream */
+#include <ostream>	/* For std::ostream */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "csr_graph.h"
+#include "graph_analysis.h" /* for HopPlot */
+
+/**
+ * @brief The hop plot of the paths from one share of the vertices of a graph.
+ *
+ * The sources are split into blocks of consecutive vertex ids (a multiple of
+ * every AllPairsBfs::batch_size, so that each batch searches from nearby
+ * vertices), which are dealt to the parts in turn. The partial hop plots of
+ * all num_parts parts thus sum to the exact hop plot, whichever process
+ * (or machine) computed each one.
+ */
+struct HopPlotPart {
+	uint32_t part; /**< Which share of the sources, in [ 0, num_parts ). */
+	uint32_t num_parts; /**< The number of shares into which the sources are split. */
+	uint32_t num_vertices; /**< The number of vertices in the graph, n. */
+	HopPlot hop_plot; /**< The path lengths from this share of the sources. */
+
+	/**
+	 * Constructs the (empty) only part of an empty graph.
+	 */
+	HopPlotPart() : part( 0 ), num_parts( 1 ), num_vertices( 0 ) {}
+};
+
+namespace graphAnon
+{
+	/**
+	 * Computes the hop plot of the paths from one share of the vertices of g.
+	 * @param g The graph.
+	 * @param part Which share of the sources to search from.
+	 * @param num_parts The number of shares into which the sources are split.
+	 * @pre part < num_parts.
+	 * @note With num_parts = 1, the hop plot is that of hop_plot( g ).
+	 */
+	HopPlotPart partial_hop_plot( CsrGraph const& g, const uint32_t part, const uint32_t num_parts );
+
+	/**
+	 * Sums the partial hop plots of every part of a graph.
+	 * @param parts The partial hop plots, in any order.
+	 * @param total Set to the (only) part 0 of 1: the exact hop plot.
+	 * @return False if parts is not exactly one of each of the parts of
+	 * the same graph, in which case total is left unchanged.
+	 */
+	bool merge_hop_plot_parts( std::vector< HopPlotPart > const& parts, HopPlotPart *total );
+
+	/**
+	 * Writes a partial hop plot to os: a header line naming the part, the
+	 * number of parts, and n, then one "length count" line per path length.
+	 */
+	void write_hop_plot_part( HopPlotPart const& part, std::ostream *os );
+
+	/**
+	 * Reads a partial hop plot written by write_hop_plot_part().
+	 * @return False if is does not hold a well-formed partial hop plot.
+	 */
+	bool read_hop_plot_part( std::istream *is, HopPlotPart *part );
+
+	/**
+	 * Determines whether this build can split hop plots across MPI ranks.
+	 */
+	bool mpi_available();
+
+	/**
+	 * Computes the exact hop plot of g with every MPI rank, each searching
+	 * from its own share of the sources (part = rank, num_parts = size), and
+	 * reduces the partial hop plots onto rank 0. Every rank must call this
+	 * with the same graph, and it initialises (and then finalises) MPI if
+	 * nobody else has, so it may only be called once per process.
+	 * @param total On rank 0, set to the exact hop plot.
+	 * @param is_root Set to whether this is rank 0.
+	 * @return False if this build does not support MPI or MPI fails.
+	 */
+	bool mpi_hop_plot( CsrGraph const& g, HopPlotPart *total, bool *is_root );
+}
+
+#endif /* HOP_PLOT_PARTITION_H_ */
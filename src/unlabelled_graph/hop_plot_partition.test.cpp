@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in hop_plot_partition.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <sstream> /* for std::stringstream */
+#include <vector>
+
+#include "hop_plot_partition.test.h"
+#include "hop_plot_partition.h"
+#include "graph_analysis.h"
+#include "random_graph.h"
+#include "csr_graph.h"
+
+bool test_hop_plot_partition() {
+
+	bool passed = true;
+
+	/* Several blocks of the partition, and more than one component. */
+	CsrGraph const g = graphAnon::random_gnm( 1500, 1600, 2017 );
+	HopPlot const exact = graphAnon::hop_plot( g );
+
+	/**
+	 * @test Sum of parts
+	 * For any number of parts, merged in any order, the partial hop plots
+	 * sum to the exact hop plot.
+	 */
+	for( uint32_t num_parts = 1; num_parts <= 5; ++num_parts ) {
+		std::vector< HopPlotPart > parts;
+		for( uint32_t part = num_parts; part > 0; --part ) {
+			parts.push_back( graphAnon::partial_hop_plot( g, part - 1, num_parts ) );
+		}
+		HopPlotPart total;
+		if( !graphAnon::merge_hop_plot_parts( parts, &total ) || total.hop_plot != exact
+				|| total.num_parts != 1 || total.num_vertices != g.num_vertices() ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test Part files
+	 * A partial hop plot reads back as it was written, and a truncated or
+	 * foreign file is rejected.
+	 */
+	HopPlotPart const part = graphAnon::partial_hop_plot( g, 1, 3 );
+	std::stringstream file;
+	graphAnon::write_hop_plot_part( part, &file );
+	HopPlotPart read;
+	if( !graphAnon::read_hop_plot_part( &file, &read ) || read.part != 1 || read.num_parts != 3
+			|| read.num_vertices != part.num_vertices || read.hop_plot != part.hop_plot ) {
+		passed = false;
+	}
+	std::stringstream truncated( "graphAnon-hop-plot-part 1 3" );
+	std::stringstream foreign( "1 3 1500\n1 20\n" );
+	std::stringstream broken( "graphAnon-hop-plot-part 1 3 1500\n1 20\n2\n" );
+	if( graphAnon::read_hop_plot_part( &truncated, &read )
+			|| graphAnon::read_hop_plot_part( &foreign, &read )
+			|| graphAnon::read_hop_plot_part( &broken, &read ) ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Incomplete merges
+	 * A missing or repeated part, or a part of a different graph, is rejected.
+	 */
+	std::vector< HopPlotPart > parts;
+	parts.push_back( graphAnon::partial_hop_plot( g, 0, 2 ) );
+	HopPlotPart total;
+	if( graphAnon::merge_hop_plot_parts( parts, &total ) ) { passed = false; }
+	parts.push_back( parts[ 0 ] );
+	if( graphAnon::merge_hop_plot_parts( parts, &total ) ) { passed = false; }
+	parts[ 1 ] = graphAnon::partial_hop_plot( graphAnon::random_gnm( 1400, 1600, 2017 ), 1, 2 );
+	if( graphAnon::merge_hop_plot_parts( parts, &total ) ) { passed = false; }
+
+	/**
+	 * @test Boundary case: parts without sources
+	 * With more parts than blocks, the empty parts report a zero count at
+	 * length 1, as does the hop plot of a graph with no edges.
+	 */
+	CsrGraph const isolated = graphAnon::random_gnm( 5, 0, 2017 );
+	HopPlot const empty { { 1, 0 } };
+	for( uint32_t p = 0; p < 3; ++p ) {
+		if( graphAnon::partial_hop_plot( isolated, p, 3 ).hop_plot != empty ) { passed = false; }
+	}
+
+	return passed;
+}
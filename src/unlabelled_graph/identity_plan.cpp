@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief Implementation of the IdentityPlan class in identity_plan.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cstddef>		/* for size_t */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+#include <unordered_map>
+
+#include "omp.h"
+
+#include "identity_plan.h" /* implementing this class. */
+
+IdentityPlan::IdentityPlan() : k_( 0 ), max_deficiency_( 0 ), num_new_vertices_( 0 ),
+	pair_new_vertices_( false ), num_new_edges_( 0 ) {}
+
+void IdentityPlan::build( DegreeSequence const& degrees, const uint32_t k,
+	const bool hide_new_vertices, DegreeSequenceAnonymiser *anonymiser ) {
+
+	assert( k > 0 && k <= degrees.size() );
+	const uint32_t n = degrees.size();
+	k_ = k;
+
+	/* Section 3.1: First anonymize degree sequence. */
+	max_deficiency_ = anonymiser->partition( degrees, k, &block_starts_ );
+
+	/* Section 3.2: Augment graph with min # vertices. */
+	if( max_deficiency_ == 0 ) { num_new_vertices_ = 0; }
+	else if( !hide_new_vertices ) { num_new_vertices_ = max_deficiency_; }
+	else {
+		const uint32_t md_or_k = ( max_deficiency_ > k ? max_deficiency_ : k );
+		num_new_vertices_ = ( md_or_k % 2 ? md_or_k : md_or_k + 1 );
+	}
+
+	/* Section 3.3: the cyclic edges give the first (total % p) of the p
+	 * pseudo-vertices one more edge than the rest; only then may the new
+	 * vertices fail to be k-anonymous and need pairing. */
+	uint64_t total = 0;
+	std::unordered_map< uint64_t, uint64_t > degree_counts;
+	for( uint32_t b = 0; b < block_starts_.size(); ++b ) {
+		const uint32_t block_end = b + 1 < block_starts_.size() ? block_starts_[ b + 1 ] : n;
+		const uint32_t block_degree = degrees[ block_starts_[ b ] ].first;
+		for( uint32_t i = block_starts_[ b ]; i < block_end; ++i ) { total += block_degree - degrees[ i ].first; }
+		degree_counts[ block_degree ] += block_end - block_starts_[ b ];
+	}
+	pair_new_vertices_ = false;
+	if( hide_new_vertices && num_new_vertices_ > 0 && total % num_new_vertices_ != 0 ) {
+		const uint64_t extra = total % num_new_vertices_;
+		degree_counts[ total / num_new_vertices_ + 1 ] += extra;
+		degree_counts[ total / num_new_vertices_ ] += num_new_vertices_ - extra;
+		for( auto const count : degree_counts ) {
+			if( count.second < k ) { pair_new_vertices_ = true; }
+		}
+	}
+
+	num_new_edges_ = total;
+	if( pair_new_vertices_ ) {
+		const uint32_t cursor = n + static_cast< uint32_t >( total % num_new_vertices_ );
+		pair_new_vertices( n, cursor, [ this ]( const uint32_t, const uint32_t ) { ++num_new_edges_; } );
+	}
+}
+
+std::vector< IdentityPlan > plan_identity_sweep( DegreeSequence const& degrees,
+	std::vector< uint32_t > const& ks, const bool hide_new_vertices ) {
+
+	std::vector< IdentityPlan > plans( ks.size() );
+#pragma omp parallel
+	{
+		/* One dynamic programme (and set of tables) per thread. */
+		DegreeSequenceAnonymiser anonymiser;
+#pragma omp for schedule( dynamic, 1 )
+		for( size_t i = 0; i < ks.size(); ++i ) {
+			plans[ i ].build( degrees, ks[ i ], hide_new_vertices, &anonymiser );
+		}
+	}
+	return plans;
+}
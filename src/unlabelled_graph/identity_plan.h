@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @brief Definition of a compact plan of the edges that k-degree
+ * anonymisation adds to a graph.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef IDENTITY_PLAN_H_
+#define IDENTITY_PLAN_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "degree_anonymiser.h"
+
+/**
+ * @brief The outcome of the k-degree anonymisation of @cite waldo for one
+ * degree sequence and one k, separated from its application to a graph.
+ *
+ * The anonymisation only depends on the sorted degree sequence: it raises
+ * blocks of vertices to a common degree (Section 3.1), adds pseudo-vertices
+ * (Section 3.2), and connects each original vertex cyclically to as many
+ * pseudo-vertices as its deficiency (Section 3.3), pairing up the
+ * pseudo-vertices if they must themselves be hidden but are not yet. A plan
+ * stores only the block boundaries and a few counts, so plans for many k can
+ * be kept at once and share a single degree sequence; generate_edges()
+ * replays the new edges on demand.
+ * @see UnlabelledGraph::hide_waldo()
+ */
+class IdentityPlan {
+public:
+
+	/**
+	 * Constructs an empty plan, which adds nothing.
+	 */
+	IdentityPlan();
+
+	/**
+	 * Plans the anonymisation of a degree sequence.
+	 * @param degrees The degree sequence, sorted as by
+	 * UnlabelledGraph::retrieve_degree_sequence(). It must be passed
+	 * unchanged to generate_edges().
+	 * @param k The privacy threshold, 1 <= k <= n.
+	 * @param hide_new_vertices Whether the new pseudo-vertices must also be
+	 * anonymised.
+	 * @param anonymiser The dynamic programme to use (whose tables are reused).
+	 */
+	void build( DegreeSequence const& degrees, const uint32_t k, const bool hide_new_vertices,
+		DegreeSequenceAnonymiser *anonymiser );
+
+	/**
+	 * Accessor method to retrieve the privacy threshold, k.
+	 */
+	uint32_t k() const { return k_; }
+
+	/**
+	 * Accessor method to retrieve the maximum deficiency of the anonymised
+	 * degree sequence, as returned by anonymize_degree_sequence().
+	 */
+	uint32_t max_deficiency() const { return max_deficiency_; }
+
+	/**
+	 * Accessor method to retrieve the number of pseudo-vertices added.
+	 */
+	uint32_t num_new_vertices() const { return num_new_vertices_; }
+
+	/**
+	 * Accessor method to retrieve the number of edges added.
+	 */
+	uint64_t num_new_edges() const { return num_new_edges_; }
+
+	/**
+	 * Generates every edge that the plan adds, in the order that
+	 * hide_waldo() has always added them.
+	 * @param degrees The degree sequence that was passed to build().
+	 * @param first_new_vertex The id of the first pseudo-vertex (i.e., n).
+	 * @param add_edge Invoked with each new edge (u,v), where v is a
+	 * pseudo-vertex. No edge is generated twice.
+	 */
+	template < typename EdgeSink >
+	void generate_edges( DegreeSequence const& degrees, const uint32_t first_new_vertex,
+		EdgeSink add_edge ) const;
+
+private:
+
+	/**
+	 * Generates the edges between pseudo-vertices that equalise their degrees
+	 * once the cyclic edges have left some with one more edge than the others
+	 * (the pairing procedure of @cite waldo ).
+	 */
+	template < typename EdgeSink >
+	void pair_new_vertices( const uint32_t first_new_vertex, uint32_t cursor,
+		EdgeSink add_edge ) const;
+
+	uint32_t k_; /**< The privacy threshold. */
+	uint32_t max_deficiency_; /**< The maximum deficiency of the degree sequence. */
+	uint32_t num_new_vertices_; /**< The number of pseudo-vertices to add. */
+	bool pair_new_vertices_; /**< Whether pseudo-vertices must be paired up. */
+	uint64_t num_new_edges_; /**< The number of edges to add. */
+	std::vector< uint32_t > block_starts_; /**< The first position of each block. */
+};
+
+template < typename EdgeSink >
+void IdentityPlan::generate_edges( DegreeSequence const& degrees, const uint32_t first_new_vertex,
+	EdgeSink add_edge ) const {
+
+	if( num_new_vertices_ == 0 ) { return; }
+	const uint32_t n = first_new_vertex + num_new_vertices_;
+
+	/* Section 3.3: Add new edges cyclically to anonymize original graph. */
+	uint32_t cursor = first_new_vertex;
+	for( uint32_t b = 0; b < block_starts_.size(); ++b ) {
+		const uint32_t block_end = b + 1 < block_starts_.size() ? block_starts_[ b + 1 ] : degrees.size();
+		const uint32_t block_degree = degrees[ block_starts_[ b ] ].first;
+		for( uint32_t i = block_starts_[ b ]; i < block_end; ++i ) {
+			const uint32_t deficiency = block_degree - degrees[ i ].first;
+			for( uint32_t j = 0; j < deficiency; ++j ) {
+				add_edge( degrees[ i ].second, cursor );
+				if( cursor == n - 1 ) { cursor = first_new_vertex; }
+				else { ++cursor; }
+			}
+		}
+	}
+
+	if( pair_new_vertices_ ) { pair_new_vertices( first_new_vertex, cursor, add_edge ); }
+}
+
+template < typename EdgeSink >
+void IdentityPlan::pair_new_vertices( const uint32_t first_new_vertex, uint32_t cursor,
+	EdgeSink add_edge ) const {
+
+	const uint32_t n = first_new_vertex + num_new_vertices_;
+	while( cursor < n - 1 ) {
+		add_edge( cursor, cursor + 1 );
+		cursor += 2;
+	}
+	if( cursor == n - 1 ) {
+		add_edge( n - 1, first_new_vertex );
+		for( cursor = first_new_vertex + 1; cursor < n; cursor += 2 ) {
+			add_edge( cursor, cursor + 1 );
+		}
+	}
+}
+
+/**
+ * Plans the k-degree anonymisation of one degree sequence for many k at once,
+ * in parallel across k.
+ * @param degrees The degree sequence, sorted as by
+ * UnlabelledGraph::retrieve_degree_sequence().
+ * @param ks The privacy thresholds, each in [ 1, n ].
+ * @param hide_new_vertices Whether the new pseudo-vertices must also be anonymised.
+ * @return One plan per element of ks, in the same order.
+ */
+std::vector< IdentityPlan > plan_identity_sweep( DegreeSequence const& degrees,
+	std::vector< uint32_t > const& ks, const bool hide_new_vertices );
+
+#endif /* IDENTITY_PLAN_H_ */
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Implementation of the NeighbourList class in neighbour_list.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::copy, std::fill */
+#include <cstring>		/* for std::memcpy */
+
+#include "neighbour_list.h" /* implementing this class. */
+
+constexpr uint32_t NeighbourList::inline_capacity;
+constexpr uint32_t NeighbourList::linear_capacity;
+constexpr uint32_t NeighbourList::empty_slot;
+
+NeighbourList::NeighbourList( NeighbourList const& other )
+	: size_( other.size_ ), capacity_( other.capacity_ ) {
+	if( is_inline() ) { std::copy( other.inline_, other.inline_ + size_, inline_ ); }
+	else {
+		const size_t num_words = block_size( capacity_ );
+		heap_ = new uint32_t[ num_words ];
+		std::memcpy( heap_, other.heap_, num_words * sizeof( uint32_t ) );
+	}
+}
+
+NeighbourList::NeighbourList( NeighbourList &&other ) noexcept
+	: size_( other.size_ ), capacity_( other.capacity_ ) {
+	if( is_inline() ) { std::copy( other.inline_, other.inline_ + size_, inline_ ); }
+	else { heap_ = other.heap_; }
+	other.size_ = 0;
+	other.capacity_ = inline_capacity;
+}
+
+NeighbourList& NeighbourList::operator=( NeighbourList const& other ) {
+	if( this != &other ) { *this = NeighbourList( other ); }
+	return *this;
+}
+
+NeighbourList& NeighbourList::operator=( NeighbourList &&other ) noexcept {
+	if( this == &other ) { return *this; }
+	release();
+	size_ = other.size_;
+	capacity_ = other.capacity_;
+	if( is_inline() ) { std::copy( other.inline_, other.inline_ + size_, inline_ ); }
+	else { heap_ = other.heap_; }
+	other.size_ = 0;
+	other.capacity_ = inline_capacity;
+	return *this;
+}
+
+void NeighbourList::grow( const uint64_t min_capacity ) {
+
+	/* Heap capacities are powers of two, starting just above inline_capacity. */
+	uint64_t capacity = linear_capacity / 2;
+	while( capacity < min_capacity ) { capacity *= 2; }
+
+	uint32_t *block = new uint32_t[ block_size( capacity ) ];
+	std::copy( begin(), end(), block );
+	release();
+	heap_ = block;
+	capacity_ = static_cast< uint32_t >( capacity );
+
+	/* Rehash every neighbour into the (larger) table, if there is one. */
+	if( is_hashed() ) {
+		std::fill( heap_ + capacity_, heap_ + 3 * capacity, empty_slot );
+		for( uint32_t i = 0; i < size_; ++i ) { *probe( heap_[ i ] ) = heap_[ i ]; }
+	}
+}
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief Definition of a compact set of neighbours for one vertex, tuned for
+ * the skewed degree distributions of social graphs.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NEIGHBOUR_LIST_H_
+#define NEIGHBOUR_LIST_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For size_t */
+
+/**
+ * @brief A set of vertex ids (the neighbours of one vertex) that, unlike
+ * std::unordered_set, allocates no memory per element and stores small sets
+ * inside the object itself.
+ *
+ * The neighbours are kept densely, in insertion order, in one of three layouts:
+ * - Up to inline_capacity neighbours live in the object itself, so the
+ * many low-degree vertices of a social graph never touch the heap.
+ * - Up to linear_capacity neighbours live in a single heap array, which
+ * count() scans linearly (a loop the compiler vectorises).
+ * - Beyond that, the heap array is followed by a flat, open-addressing hash
+ * table of twice the capacity that maps each neighbour to itself, probed
+ * linearly from a Fibonacci hash of the id, so that count() stays O( 1 ).
+ *
+ * Capacities above inline_capacity are powers of two, and every growth
+ * doubles it, so insert() is amortised O( 1 ). Iteration visits the dense
+ * array, so it is as cache-friendly as a std::vector and (unlike
+ * std::unordered_set) deterministic: neighbours come out in the order in
+ * which they were inserted.
+ */
+class NeighbourList {
+public:
+
+	typedef uint32_t const* const_iterator; /**< Iterates the neighbours in insertion order. */
+	typedef const_iterator iterator; /**< Neighbours are never modified in place. */
+
+	/** The number of neighbours stored without a heap allocation. */
+	static constexpr uint32_t inline_capacity = 6;
+
+	/** The largest capacity that is searched linearly rather than hashed. */
+	static constexpr uint32_t linear_capacity = 16;
+
+	/**
+	 * Constructs an empty NeighbourList.
+	 */
+	NeighbourList() : size_( 0 ), capacity_( inline_capacity ) {}
+
+	NeighbourList( NeighbourList const& other );
+	NeighbourList( NeighbourList &&other ) noexcept;
+	NeighbourList& operator=( NeighbourList const& other );
+	NeighbourList& operator=( NeighbourList &&other ) noexcept;
+	~NeighbourList() { release(); }
+
+	/**
+	 * Accessor method to retrieve the number of neighbours in the set.
+	 */
+	size_t size() const { return size_; }
+
+	/**
+	 * Determines whether the set has no neighbours.
+	 */
+	bool empty() const { return size_ == 0; }
+
+	/**
+	 * Accessor method to retrieve the number of neighbours that the set can
+	 * hold before it next reallocates its storage.
+	 */
+	size_t capacity() const { return capacity_; }
+
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + size_; }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	/**
+	 * Counts the occurrences of v in the set.
+	 * @return 1 if v is a neighbour and 0 otherwise.
+	 */
+	size_t count( const uint32_t v ) const {
+		if( is_hashed() ) { return *probe( v ) == v ? 1 : 0; }
+		uint32_t const *neighbours = data();
+		bool found = false;
+		for( uint32_t i = 0; i < size_; ++i ) { found |= neighbours[ i ] == v; }
+		return found ? 1 : 0;
+	}
+
+	/**
+	 * Inserts v into the set if it is not already a neighbour.
+	 * @return True if v was inserted; false if it was already present.
+	 * @note Returns only the flag (not the std::pair of std::unordered_set),
+	 * because the hash table stores ids rather than positions in the array.
+	 */
+	bool insert( const uint32_t v ) {
+		if( size_ == capacity_ ) {
+			if( count( v ) > 0 ) { return false; }
+			grow( static_cast< uint64_t >( capacity_ ) + 1 );
+		}
+		if( is_hashed() ) {
+			uint32_t *slot = probe( v );
+			if( *slot == v ) { return false; }
+			*slot = v;
+		}
+		else if( count( v ) > 0 ) { return false; }
+		data()[ size_++ ] = v;
+		return true;
+	}
+
+	/**
+	 * Inserts every id in the range [first, last) that is not already a neighbour.
+	 */
+	template < typename InputIterator >
+	void insert( InputIterator first, InputIterator last ) {
+		for( ; first != last; ++first ) { insert( *first ); }
+	}
+
+	/**
+	 * Ensures that the set can hold num_neighbours without reallocating,
+	 * so that a bulk insertion grows its storage at most once.
+	 */
+	void reserve( const size_t num_neighbours ) {
+		if( num_neighbours > capacity_ ) { grow( num_neighbours ); }
+	}
+
+private:
+
+	/** Marks an unused slot of the hash table (never a valid vertex id). */
+	static constexpr uint32_t empty_slot = 0xFFFFFFFF;
+
+	bool is_inline() const { return capacity_ <= inline_capacity; }
+	bool is_hashed() const { return capacity_ > linear_capacity; }
+
+	uint32_t* data() { return is_inline() ? inline_ : heap_; }
+	uint32_t const* data() const { return is_inline() ? inline_ : heap_; }
+
+	/**
+	 * Finds the slot of the hash table that holds v or, if v is absent, the
+	 * empty slot at which v would be inserted.
+	 * @pre is_hashed()
+	 */
+	uint32_t* probe( const uint32_t v ) const {
+		uint32_t *table = heap_ + capacity_;
+		const uint32_t mask = 2 * capacity_ - 1;
+		const uint32_t shift = 31 - __builtin_ctz( capacity_ );
+		uint32_t slot = ( v * 2654435769u ) >> shift;
+		while( table[ slot ] != v && table[ slot ] != empty_slot ) { slot = ( slot + 1 ) & mask; }
+		return table + slot;
+	}
+
+	/**
+	 * The number of uint32_t in the heap block of a set with capacity
+	 * elements: the dense array plus, if hashed, the table.
+	 */
+	static size_t block_size( const uint64_t capacity ) {
+		return capacity > linear_capacity ? 3 * capacity : capacity;
+	}
+
+	/**
+	 * Moves the neighbours into a heap block with room for at least
+	 * min_capacity of them, rebuilding the hash table if there is one.
+	 */
+	void grow( const uint64_t min_capacity );
+
+	/**
+	 * Frees the heap block, if any.
+	 */
+	void release() { if( !is_inline() ) { delete[] heap_; } }
+
+	uint32_t size_; /**< The number of neighbours. */
+	uint32_t capacity_; /**< The number of neighbours that fit in the storage. */
+	union {
+		uint32_t inline_[ inline_capacity ]; /**< The neighbours, if is_inline(). */
+		uint32_t *heap_; /**< The dense array (and then the hash table), otherwise. */
+	};
+};
+
+#endif /* NEIGHBOUR_LIST_H_ */
@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in neighbour_list.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <cstdlib> /* for rand */
+#include <set>
+#include <vector>
+#include <utility>
+
+#include "neighbour_list.test.h"
+#include "neighbour_list.h"
+
+namespace
+{
+	/**
+	 * Determines whether list holds exactly the ids in expected, in the
+	 * order in which they were inserted.
+	 */
+	bool matches( NeighbourList const& list, std::vector< uint32_t > const& expected ) {
+		return list.size() == expected.size()
+			&& std::vector< uint32_t >( list.begin(), list.end() ) == expected;
+	}
+}
+
+bool test_neighbour_list() {
+
+	/**
+	 * @test Boundary case: empty list
+	 * A new list is inline, holds nothing, and contains no id.
+	 */
+	NeighbourList empty;
+	if( !empty.empty() || empty.begin() != empty.end()
+			|| empty.capacity() != NeighbourList::inline_capacity || empty.count( 0 ) != 0 ) {
+		return false;
+	}
+
+	for( uint32_t trial = 0; trial < 20; ++trial ) {
+
+		/* Spread the sizes across every layout, and the ids from dense to sparse. */
+		const uint32_t num_inserts = rand() % ( trial < 10 ? 4 * NeighbourList::linear_capacity : 2000 );
+		const uint32_t range = 1 + rand() % ( trial % 2 == 0 ? num_inserts + 1 : 1000000 );
+
+		/**
+		 * @test Insertion and membership
+		 * Inserting random ids (with repeats) reports exactly the new ones,
+		 * and afterwards count() agrees with a std::set for a range of ids.
+		 */
+		NeighbourList list;
+		std::set< uint32_t > expected_set;
+		std::vector< uint32_t > expected_order;
+		for( uint32_t i = 0; i < num_inserts; ++i ) {
+			const uint32_t v = rand() % range;
+			const bool is_new = expected_set.insert( v ).second;
+			if( is_new ) { expected_order.push_back( v ); }
+			if( list.insert( v ) != is_new ) { return false; }
+			if( list.capacity() < list.size() ) { return false; }
+		}
+		if( !matches( list, expected_order ) ) { return false; }
+		for( uint32_t v = 0; v < range && v < 5000; ++v ) {
+			if( list.count( v ) != expected_set.count( v ) ) { return false; }
+		}
+		for( uint32_t const v : expected_order ) {
+			if( list.count( v ) != 1 ) { return false; }
+		}
+
+		/**
+		 * @test Copies and moves
+		 * A copy is independent of the original, and a move leaves the
+		 * source empty but usable.
+		 */
+		NeighbourList copy( list );
+		copy.insert( range );
+		if( !matches( list, expected_order ) || copy.count( range ) != 1 || list.count( range ) != 0 ) {
+			return false;
+		}
+		NeighbourList moved( std::move( copy ) );
+		if( !copy.empty() || moved.size() != expected_order.size() + 1 ) { return false; }
+		copy.insert( 7 );
+		if( copy.size() != 1 || copy.count( 7 ) != 1 ) { return false; }
+		copy = list;
+		moved = std::move( copy );
+		if( !matches( moved, expected_order ) || !copy.empty() ) { return false; }
+
+		/**
+		 * @test Bulk insertion
+		 * Reserving and then inserting a range (with repeats) reallocates at
+		 * most once and yields the same list as inserting one id at a time.
+		 */
+		NeighbourList bulk;
+		bulk.reserve( expected_order.size() );
+		const size_t capacity = bulk.capacity();
+		bulk.insert( expected_order.begin(), expected_order.end() );
+		bulk.insert( expected_order.rbegin(), expected_order.rend() );
+		if( bulk.capacity() != capacity || !matches( bulk, expected_order ) ) { return false; }
+	}
+	return true;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Implementation of the OverlayView class in overlay_view.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::sort */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+#include <utility>
+
+#include "omp.h"
+
+#include "overlay_view.h" /* implementing this class. */
+
+OverlayView::OverlayView( CsrGraph const& base, const uint32_t num_vertices,
+	std::vector< std::pair< uint32_t, uint32_t > > const& added_edges )
+	: base_( base ), base_n_( base.num_vertices() ), n_( num_vertices ),
+	added_offsets_( num_vertices + 1, 0 ) {
+
+	assert( n_ >= base_n_ );
+	assert( added_edges.size() < ( 1ull << 31 ) );
+
+	/* Bucket the added edges by endpoint, in both directions. */
+	for( auto const& e : added_edges ) {
+		++added_offsets_[ e.first + 1 ];
+		++added_offsets_[ e.second + 1 ];
+	}
+	for( uint32_t u = 0; u < n_; ++u ) { added_offsets_[ u + 1 ] += added_offsets_[ u ]; }
+	added_neighbours_.resize( added_offsets_[ n_ ] );
+	std::vector< uint32_t > cursors( added_offsets_.begin(), added_offsets_.end() - 1 );
+	for( auto const& e : added_edges ) {
+		added_neighbours_[ cursors[ e.first ]++ ] = e.second;
+		added_neighbours_[ cursors[ e.second ]++ ] = e.first;
+	}
+
+#pragma omp parallel for schedule( dynamic, 256 )
+	for( uint32_t u = 0; u < n_; ++u ) {
+		std::sort( added_neighbours_.begin() + added_offsets_[ u ],
+			added_neighbours_.begin() + added_offsets_[ u + 1 ] );
+	}
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Definition of a read-only view of a CsrGraph plus a delta of added
+ * vertices and edges, over which the analysis routines can run.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OVERLAY_VIEW_H_
+#define OVERLAY_VIEW_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <cstddef>	/* For ptrdiff_t */
+#include <iterator>	/* For std::forward_iterator_tag */
+
+/* STL libraries in use */
+#include <vector>
+#include <utility>
+
+#include "csr_graph.h"
+
+/**
+ * @brief A read-only view of the neighbours of one vertex in an OverlayView:
+ * its sorted base neighbours followed by its sorted added neighbours.
+ */
+class OverlayNeighbourRange {
+public:
+
+	/**
+	 * @brief A forward iterator that crosses from the base neighbours to the
+	 * added neighbours.
+	 */
+	class Iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef uint32_t value_type;
+		typedef ptrdiff_t difference_type;
+		typedef uint32_t const* pointer;
+		typedef uint32_t const& reference;
+
+		Iterator( uint32_t const *p, uint32_t const *base_last, uint32_t const *added_first )
+			: p_( p ), base_last_( base_last ), added_first_( added_first ) {
+			if( p_ == base_last_ ) { to_added(); }
+		}
+
+		reference operator*() const { return *p_; }
+		Iterator& operator++() {
+			if( ++p_ == base_last_ ) { to_added(); }
+			return *this;
+		}
+		bool operator==( Iterator const& other ) const {
+			return p_ == other.p_ && base_last_ == other.base_last_;
+		}
+		bool operator!=( Iterator const& other ) const { return !( *this == other ); }
+
+	private:
+		/* Leave the base neighbours for good, so that end() compares equal
+		 * even if the two arrays happen to abut in memory. */
+		void to_added() {
+			p_ = added_first_;
+			base_last_ = NULL;
+		}
+
+		uint32_t const *p_; /**< The current neighbour. */
+		uint32_t const *base_last_; /**< The end of the base neighbours, or NULL once past them. */
+		uint32_t const *added_first_; /**< The first added neighbour. */
+	};
+
+	OverlayNeighbourRange( NeighbourRange const base, NeighbourRange const added )
+		: base_( base ), added_( added ) {}
+
+	Iterator begin() const { return Iterator( base_.begin(), base_.end(), added_.begin() ); }
+	Iterator end() const { return Iterator( added_.end(), NULL, added_.end() ); }
+
+	/**
+	 * The number of neighbours in the range (i.e., the vertex degree).
+	 */
+	uint32_t size() const { return base_.size() + added_.size(); }
+
+	/**
+	 * The sorted neighbours that the base graph already had.
+	 */
+	NeighbourRange const& base() const { return base_; }
+
+	/**
+	 * The sorted neighbours that were added.
+	 */
+	NeighbourRange const& added() const { return added_; }
+
+private:
+	NeighbourRange base_; /**< The neighbours in the base graph. */
+	NeighbourRange added_; /**< The neighbours added by the overlay. */
+};
+
+/**
+ * @brief A CsrGraph plus a delta of added vertices and edges, indexed so that
+ * it presents the same interface as a CsrGraph to the analysis routines
+ * (e.g., AllPairsBfs and TriangleCounter).
+ *
+ * The view copies nothing from the base graph: it indexes only the added
+ * edges, in a CSR of its own with one offset per vertex. It is therefore
+ * cheap to build just for the duration of an analysis and to discard after.
+ */
+class OverlayView {
+public:
+
+	/**
+	 * Indexes a delta over a base graph.
+	 * @param base The base graph. It must outlive this OverlayView.
+	 * @param num_vertices The number of vertices, at least the base's.
+	 * @param added_edges The added undirected edges, each listed once.
+	 * @pre No added edge is a self-loop, a duplicate, or in the base graph.
+	 */
+	OverlayView( CsrGraph const& base, const uint32_t num_vertices,
+		std::vector< std::pair< uint32_t, uint32_t > > const& added_edges );
+
+	/**
+	 * Accessor method to retrieve the number of vertices in the graph, |V|.
+	 */
+	uint32_t num_vertices() const { return n_; }
+
+	/**
+	 * Accessor method to retrieve the number of undirected edges in the graph, |E|.
+	 */
+	uint64_t num_edges() const { return base_.num_edges() + added_neighbours_.size() / 2; }
+
+	/**
+	 * Retrieves the number of neighbours of vertex v.
+	 */
+	uint32_t degree( const uint32_t v ) const {
+		return ( v < base_n_ ? base_.degree( v ) : 0 ) + added_offsets_[ v + 1 ] - added_offsets_[ v ];
+	}
+
+	/**
+	 * Retrieves the neighbours of vertex v: first those in the base graph,
+	 * then those added, each sorted in ascending order of vertex id.
+	 */
+	OverlayNeighbourRange neighbours( const uint32_t v ) const {
+		uint32_t const *added = added_neighbours_.data();
+		NeighbourRange const added_range( added + added_offsets_[ v ], added + added_offsets_[ v + 1 ] );
+		if( v < base_n_ ) { return OverlayNeighbourRange( base_.neighbours( v ), added_range ); }
+		return OverlayNeighbourRange( NeighbourRange( added, added ), added_range );
+	}
+
+	/**
+	 * Accessor method to retrieve the base graph.
+	 */
+	CsrGraph const& base() const { return base_; }
+
+private:
+
+	CsrGraph const& base_; /**< The base graph. */
+	uint32_t base_n_; /**< The number of vertices in the base graph. */
+	uint32_t n_; /**< The number of vertices, including added ones. */
+	std::vector< uint32_t > added_offsets_; /**< Start of each vertex's added neighbours. */
+	std::vector< uint32_t > added_neighbours_; /**< All added neighbour lists, back to back. */
+};
+
+#endif /* OVERLAY_VIEW_H_ */
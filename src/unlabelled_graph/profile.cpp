@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief Implementation of the Profile class in profile.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cstdio>		/* for fopen, fgets, sscanf */
+#include <cstring>		/* for strcmp, strncmp */
+#include <iostream>		/* for std::cerr */
+#include <fstream>		/* for std::ofstream */
+#include <utility>		/* for std::make_pair */
+
+/* STL stuff in use. */
+#include <vector>
+#include <map>
+#include <string>
+
+#include <sys/resource.h>	/* for getrusage */
+
+#include "omp.h"
+
+#include "profile.h" /* implementing this class. */
+
+Profile& Profile::global() {
+	static Profile profile;
+	return profile;
+}
+
+Profile::Profile() : enabled_( false ) { reset(); }
+
+void Profile::reset() {
+	for( auto &count : counts_ ) { count.store( 0, std::memory_order_relaxed ); }
+	phases_.clear();
+	phase_index_.clear();
+	open_phases_.clear();
+}
+
+const char* Profile::counter_name( const graphAnon::ProfileCounter counter ) {
+	switch( counter ) {
+		case graphAnon::ProfileCounter::edges_added: return "edges_added";
+		case graphAnon::ProfileCounter::greedy_iterations: return "greedy_iterations";
+		case graphAnon::ProfileCounter::random_edge_fallbacks: return "random_edge_fallbacks";
+		case graphAnon::ProfileCounter::targeted_fallback_edges: return "targeted_fallback_edges";
+		case graphAnon::ProfileCounter::rejection_retries: return "rejection_retries";
+		case graphAnon::ProfileCounter::hash_rehashes: return "hash_rehashes";
+		case graphAnon::ProfileCounter::bfs_vertices_visited: return "bfs_vertices_visited";
+		case graphAnon::ProfileCounter::scratch_allocations: return "scratch_allocations";
+		case graphAnon::ProfileCounter::scratch_bytes: return "scratch_bytes";
+		case graphAnon::ProfileCounter::scratch_allocation_ns: return "scratch_allocation_ns";
+		default: return "";
+	}
+}
+
+uint64_t Profile::peak_rss_kib() {
+	FILE *status = fopen( "/proc/self/status", "r" );
+	if( status != NULL ) {
+		char line[ 256 ];
+		unsigned long long kib = 0;
+		bool found = false;
+		while( !found && fgets( line, sizeof( line ), status ) != NULL ) {
+			found = strncmp( line, "VmHWM:", 6 ) == 0 && sscanf( line + 6, "%llu", &kib ) == 1;
+		}
+		fclose( status );
+		if( found ) { return kib; }
+	}
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return usage.ru_maxrss;
+}
+
+bool Profile::begin_phase( const char *name ) {
+	if( !enabled_ || omp_in_parallel() ) { return false; }
+
+	std::string path = open_phases_.empty() ? std::string() : phases_[ open_phases_.back().first ].name + "/";
+	path += name;
+	auto const found = phase_index_.find( path );
+	size_t index;
+	if( found == phase_index_.end() ) {
+		index = phases_.size();
+		phase_index_[ path ] = index;
+		phases_.push_back( ProfilePhase{ path, static_cast< uint32_t >( open_phases_.size() ), 0, 0 } );
+	}
+	else { index = found->second; }
+	++phases_[ index ].calls;
+	open_phases_.push_back( std::make_pair( index, std::chrono::steady_clock::now() ) );
+	return true;
+}
+
+void Profile::end_phase() {
+	auto const stop = std::chrono::steady_clock::now();
+	if( open_phases_.empty() ) { return; }
+	phases_[ open_phases_.back().first ].seconds +=
+		std::chrono::duration< double >( stop - open_phases_.back().second ).count();
+	open_phases_.pop_back();
+}
+
+void Profile::write( std::ostream *os, const graphAnon::ReportFormat format ) const {
+
+	const uint32_t num_counters = static_cast< uint32_t >( graphAnon::ProfileCounter::num_counters );
+#ifdef GRAPHANON_NO_INSTRUMENTATION
+	const bool instrumented = false;
+#else
+	const bool instrumented = true;
+#endif
+	os->precision( 6 );
+
+	if( format == graphAnon::ReportFormat::csv ) {
+		*os << "kind,name,depth,calls,value" << std::endl;
+		for( auto const& phase : phases_ ) {
+			*os << "phase," << phase.name << "," << phase.depth << "," << phase.calls
+				<< "," << phase.seconds << std::endl;
+		}
+		for( uint32_t c = 0; c < num_counters; ++c ) {
+			auto const counter = static_cast< graphAnon::ProfileCounter >( c );
+			*os << "counter," << counter_name( counter ) << ",,," << this->counter( counter ) << std::endl;
+		}
+		*os << "memory,peak_rss_kib,,," << peak_rss_kib() << std::endl;
+		return;
+	}
+
+	*os << "{" << std::endl << "\t\"schema\": " << GRAPHANON_PROFILE_SCHEMA << "," << std::endl
+		<< "\t\"instrumented\": " << ( instrumented ? "true" : "false" ) << "," << std::endl
+		<< "\t\"peak_rss_kib\": " << peak_rss_kib() << "," << std::endl
+		<< "\t\"phases\": [";
+	for( size_t p = 0; p < phases_.size(); ++p ) {
+		*os << ( p == 0 ? "" : "," ) << std::endl << "\t\t{ \"name\": \"" << phases_[ p ].name
+			<< "\", \"depth\": " << phases_[ p ].depth << ", \"calls\": " << phases_[ p ].calls
+			<< ", \"seconds\": " << phases_[ p ].seconds << " }";
+	}
+	*os << std::endl << "\t]," << std::endl << "\t\"counters\": {";
+	for( uint32_t c = 0; c < num_counters; ++c ) {
+		auto const counter = static_cast< graphAnon::ProfileCounter >( c );
+		*os << ( c == 0 ? "" : "," ) << std::endl << "\t\t\"" << counter_name( counter ) << "\": "
+			<< this->counter( counter );
+	}
+	*os << std::endl << "\t}" << std::endl << "}" << std::endl;
+}
+
+bool Profile::write( const char *filename, const graphAnon::ReportFormat format ) const {
+	if( strcmp( filename, "-" ) == 0 ) {
+		write( &std::cerr, format );
+		return bool( std::cerr );
+	}
+	std::ofstream file( filename );
+	if( !file ) { return false; }
+	write( &file, format );
+	file.close();
+	return !file.fail();
+}
@@ -0,0 +1,262 @@
+/**
+ * @file
+ * @brief Definition of the lightweight phase timers and event counters
+ * behind the -profile option.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <string>	/* For std::string */
+#include <ostream>	/* For std::ostream */
+#include <atomic>	/* For std::atomic */
+#include <chrono>	/* For std::chrono::steady_clock */
+
+/* STL libraries in use */
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "report_format.h"
+
+/**
+ * The version of the -profile output schema, which changes only when a
+ * phase or counter is renamed, removed, or reinterpreted.
+ */
+#define GRAPHANON_PROFILE_SCHEMA 2
+
+namespace graphAnon
+{
+	/** The events that a Profile counts. */
+	enum class ProfileCounter {
+		edges_added, /**< Edges inserted by the anonymisation algorithms (not by bulk loads). */
+		greedy_iterations, /**< Iterations of the greedy alpha-proximity algorithm. */
+		random_edge_fallbacks, /**< Random edges added because no better edge was found. */
+		targeted_fallback_edges, /**< Edges added for violating vertices when a greedy iteration adds none. */
+		rejection_retries, /**< Random vertex pairs drawn but rejected as existing edges. */
+		hash_rehashes, /**< Neighbour lists that reallocated their storage on insertion. */
+		bfs_vertices_visited, /**< (Source, vertex) pairs reached by breadth-first searches. */
+		scratch_allocations, /**< Blocks that ScratchArenas obtained from the heap. */
+		scratch_bytes, /**< Bytes that ScratchArenas obtained from the heap. */
+		scratch_allocation_ns, /**< Nanoseconds that ScratchArenas spent in the heap allocator. */
+		num_counters /**< The number of counters (not itself a counter). */
+	};
+}
+
+/**
+ * @brief The total time spent in one (nested) phase of a run.
+ */
+struct ProfilePhase {
+	std::string name; /**< The phase's path from the outermost phase (e.g., "hide_waldo/plan"). */
+	uint32_t depth; /**< The number of phases enclosing this one. */
+	uint64_t calls; /**< The number of times the phase was entered. */
+	double seconds; /**< The total wall-clock time spent in the phase. */
+};
+
+/**
+ * @brief Accumulates phase timings and event counters over a run, so that
+ * a slow job can be broken down by where its time went.
+ *
+ * Recording is off until enable() is called, after which every counter
+ * increment costs one relaxed atomic addition (and is safe from any
+ * OpenMP thread) and every phase costs two clock reads. Phases nest: a phase
+ * entered while another is open is recorded under the outer one's name,
+ * and repeated entries of the same phase are summed. Phases are only
+ * recorded outside of parallel regions. Code is instrumented through the
+ * GRAPHANON_PROFILE_PHASE() and GRAPHANON_PROFILE_COUNT() macros, which
+ * compile to nothing if GRAPHANON_NO_INSTRUMENTATION is defined.
+ */
+class Profile {
+public:
+
+	/**
+	 * Retrieves the process-wide profile that the macros record to.
+	 */
+	static Profile& global();
+
+	/**
+	 * Constructs an empty, disabled profile.
+	 */
+	Profile();
+
+	/**
+	 * Starts or stops recording.
+	 */
+	void enable( const bool enabled ) { enabled_ = enabled; }
+
+	/**
+	 * Determines whether phases and counters are being recorded.
+	 */
+	bool is_enabled() const { return enabled_; }
+
+	/**
+	 * Discards all recorded phases and counts.
+	 * @pre No phase is open.
+	 */
+	void reset();
+
+	/**
+	 * Adds amount to counter, if recording.
+	 */
+	void count( const graphAnon::ProfileCounter counter, const uint64_t amount ) {
+		if( enabled_ ) {
+			counts_[ static_cast< uint32_t >( counter ) ].fetch_add( amount, std::memory_order_relaxed );
+		}
+	}
+
+	/**
+	 * Retrieves the current value of counter.
+	 */
+	uint64_t counter( const graphAnon::ProfileCounter counter ) const {
+		return counts_[ static_cast< uint32_t >( counter ) ].load( std::memory_order_relaxed );
+	}
+
+	/**
+	 * Retrieves the name of counter, as it appears in reports (e.g., "edges_added").
+	 */
+	static const char* counter_name( const graphAnon::ProfileCounter counter );
+
+	/**
+	 * Retrieves the peak resident set size of the process (since it started
+	 * or since its peak was last reset through /proc/self/clear_refs).
+	 * @return The peak in KiB.
+	 */
+	static uint64_t peak_rss_kib();
+
+	/**
+	 * Enters the phase called name, nested within any phase still open.
+	 * @return False if the phase is not being recorded (because recording is
+	 * off or this is a parallel region), in which case it must not be ended.
+	 */
+	bool begin_phase( const char *name );
+
+	/**
+	 * Leaves the innermost open phase, adding the time since it was entered.
+	 */
+	void end_phase();
+
+	/**
+	 * Retrieves every phase entered since the last reset(), in the order in
+	 * which each was first entered (so each phase follows the one enclosing it).
+	 */
+	std::vector< ProfilePhase > const& phases() const { return phases_; }
+
+	/**
+	 * Writes the phases and counters.
+	 * @param os The stream to which to write them.
+	 * @param format Either a JSON object with a "phases" array and a
+	 * "counters" object, or a CSV table with one "phase" row per phase and
+	 * one "counter" row per counter.
+	 */
+	void write( std::ostream *os, const graphAnon::ReportFormat format ) const;
+
+	/**
+	 * Writes the phases and counters to a file, or to stderr if filename is "-".
+	 * @return False if the file could not be written.
+	 * @see write()
+	 */
+	bool write( const char *filename, const graphAnon::ReportFormat format ) const;
+
+private:
+
+	bool enabled_; /**< Whether to record phases and counters. */
+	std::atomic< uint64_t > counts_[ static_cast< uint32_t >( graphAnon::ProfileCounter::num_counters ) ]; /**< The value of each counter. */
+	std::vector< ProfilePhase > phases_; /**< Every phase recorded so far. */
+	std::map< std::string, size_t > phase_index_; /**< The position of each phase name in phases_. */
+
+	/** The position in phases_ and the start time of every open phase, innermost last. */
+	std::vector< std::pair< size_t, std::chrono::steady_clock::time_point > > open_phases_;
+};
+
+/**
+ * @brief Records the enclosing scope as a phase of the global Profile.
+ */
+class ScopedPhase {
+public:
+
+	/**
+	 * Enters the phase called name.
+	 * @param name A string that outlives the phase (e.g., a literal).
+	 */
+	explicit ScopedPhase( const char *name ) : recording_( Profile::global().begin_phase( name ) ) {}
+
+	/**
+	 * Leaves the phase.
+	 */
+	~ScopedPhase() { if( recording_ ) { Profile::global().end_phase(); } }
+
+	ScopedPhase( ScopedPhase const& ) = delete;
+	ScopedPhase& operator=( ScopedPhase const& ) = delete;
+
+private:
+	const bool recording_; /**< Whether the phase was entered (and so must be left). */
+};
+
+/**
+ * @brief Stops the global Profile from recording within the enclosing scope
+ * (e.g., while unit tests run), and then restores it.
+ */
+class ScopedPause {
+public:
+	ScopedPause() : was_enabled_( Profile::global().is_enabled() ) { Profile::global().enable( false ); }
+	~ScopedPause() { Profile::global().enable( was_enabled_ ); }
+
+	ScopedPause( ScopedPause const& ) = delete;
+	ScopedPause& operator=( ScopedPause const& ) = delete;
+
+private:
+	const bool was_enabled_; /**< Whether the profile was recording beforehand. */
+};
+
+#define GRAPHANON_PROFILE_CONCAT_( a, b ) a ## b
+#define GRAPHANON_PROFILE_CONCAT( a, b ) GRAPHANON_PROFILE_CONCAT_( a, b )
+
+#ifdef GRAPHANON_NO_INSTRUMENTATION
+#define GRAPHANON_PROFILE_PHASE( name )
+#define GRAPHANON_PROFILE_COUNT( counter, amount )
+#define GRAPHANON_PROFILE_PAUSE()
+#else
+/**
+ * Times the rest of the enclosing scope as the phase called name.
+ */
+#define GRAPHANON_PROFILE_PHASE( name ) \
+	ScopedPhase const GRAPHANON_PROFILE_CONCAT( graphanon_phase_, __LINE__ )( name )
+
+/**
+ * Adds amount to the counter graphAnon::ProfileCounter::counter.
+ */
+#define GRAPHANON_PROFILE_COUNT( counter, amount ) \
+	::Profile::global().count( graphAnon::ProfileCounter::counter, amount )
+
+/**
+ * Stops recording for the rest of the enclosing scope.
+ */
+#define GRAPHANON_PROFILE_PAUSE() \
+	ScopedPause const GRAPHANON_PROFILE_CONCAT( graphanon_pause_, __LINE__ )
+#endif
+
+#endif /* PROFILE_H_ */
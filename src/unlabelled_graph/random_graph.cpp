@@ -0,0 +1,257 @@
+/**
+ * @file
+ * @brief Implementation of the random graph generators in random_graph.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cmath>		/* for std::log, std::log1p, std::sqrt, std::floor */
+#include <algorithm>	/* for std::sort, std::merge, std::unique, std::min */
+#include <random>		/* for std::mt19937_64, std::seed_seq */
+#include <utility>		/* for std::move, std::swap */
+#include <cassert>
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "random_graph.h" /* implementing these functions. */
+
+namespace
+{
+	/**
+	 * The number of independent random streams among which the work is
+	 * split. It is fixed, rather than one per thread, so that the graph is
+	 * the same however many threads generate it.
+	 */
+	const uint32_t num_streams = 256;
+
+	/**
+	 * Seeds the random stream with the given index from the user's seed.
+	 */
+	std::mt19937_64 make_stream( const uint64_t seed, const uint32_t round, const uint32_t index ) {
+		std::seed_seq sequence{ static_cast< uint32_t >( seed ), static_cast< uint32_t >( seed >> 32 ),
+			round, index };
+		return std::mt19937_64( sequence );
+	}
+
+	/**
+	 * Merges sorted runs into one, pairwise and in parallel.
+	 * @post runs holds exactly one run, the sorted union of them all.
+	 */
+	void merge_runs( std::vector< std::vector< uint64_t > > *runs ) {
+		while( runs->size() > 1 ) {
+			std::vector< std::vector< uint64_t > > merged( ( runs->size() + 1 ) / 2 );
+#pragma omp parallel for schedule( dynamic, 1 )
+			for( size_t i = 0; i < merged.size(); ++i ) {
+				if( 2 * i + 1 == runs->size() ) {
+					merged[ i ] = std::move( runs->at( 2 * i ) );
+					continue;
+				}
+				std::vector< uint64_t > const& a = runs->at( 2 * i );
+				std::vector< uint64_t > const& b = runs->at( 2 * i + 1 );
+				merged[ i ].resize( a.size() + b.size() );
+				std::merge( a.begin(), a.end(), b.begin(), b.end(), merged[ i ].begin() );
+			}
+			runs->swap( merged );
+		}
+	}
+
+	/**
+	 * Draws m distinct pairs by drawing (more than) enough pairs uniformly
+	 * with replacement, in parallel, discarding duplicates, and repeating
+	 * until there are at least m. The distinct pairs are a uniformly random
+	 * subset, as is what remains after dropping a random surplus.
+	 * @return The keys u * n + v (u < v) of the edges, in ascending order.
+	 */
+	std::vector< uint64_t > draw_pairs( const uint32_t n, const uint64_t m, const uint64_t seed ) {
+		const double pairs = static_cast< double >( graphAnon::num_vertex_pairs( n ) );
+		std::vector< uint64_t > keys;
+
+		for( uint32_t round = 0; keys.size() < m; ++round ) {
+
+			/* Draw enough to expect the missing edges, plus a few deviations. */
+			const double untaken = pairs - keys.size();
+			const double missing = static_cast< double >( m - keys.size() );
+			const double expected = -pairs * std::log1p( -missing / untaken );
+			const uint64_t draws = static_cast< uint64_t >( expected + 4 * std::sqrt( expected ) ) + 16;
+
+			/* Small rounds use fewer streams, so that they stay cheap. */
+			const uint32_t streams = static_cast< uint32_t >(
+				std::min< uint64_t >( num_streams, draws / 4096 + 1 ) );
+			std::vector< std::vector< uint64_t > > runs( streams + 1 );
+#pragma omp parallel for schedule( dynamic, 1 )
+			for( uint32_t stream = 0; stream < streams; ++stream ) {
+				const uint64_t count = draws / streams + ( stream < draws % streams );
+				std::mt19937_64 rng = make_stream( seed, round, stream );
+				std::uniform_int_distribution< uint32_t > vertex( 0, n - 1 );
+				std::vector< uint64_t > &run = runs[ stream ];
+				run.reserve( count );
+				while( run.size() < count ) {
+					uint32_t u = vertex( rng ), v = vertex( rng );
+					if( u == v ) { continue; }
+					if( u > v ) { std::swap( u, v ); }
+					run.push_back( static_cast< uint64_t >( u ) * n + v );
+				}
+				std::sort( run.begin(), run.end() );
+			}
+			runs[ streams ] = std::move( keys );
+			merge_runs( &runs );
+			keys = std::move( runs[ 0 ] );
+			keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+		}
+
+		/* Drop a uniformly random surplus (Floyd's sampling of positions). */
+		const uint64_t surplus = keys.size() - m;
+		if( surplus > 0 ) {
+			std::mt19937_64 rng = make_stream( seed, ~0u, 0 );
+			std::vector< bool > dropped( keys.size(), false );
+			for( uint64_t j = keys.size() - surplus; j < keys.size(); ++j ) {
+				const uint64_t t = std::uniform_int_distribution< uint64_t >( 0, j )( rng );
+				if( dropped[ t ] ) { dropped[ j ] = true; }
+				else { dropped[ t ] = true; }
+			}
+			uint64_t kept = 0;
+			for( uint64_t i = 0; i < keys.size(); ++i ) {
+				if( !dropped[ i ] ) { keys[ kept++ ] = keys[ i ]; }
+			}
+			keys.resize( kept );
+		}
+		return keys;
+	}
+
+	/**
+	 * Selects m distinct pairs by visiting every pair in order and selecting
+	 * it with probability ( m - selected ) / ( pairs - visited ) (Knuth's
+	 * Algorithm S), which suits dense graphs.
+	 * @return The keys of the edges, as for draw_pairs().
+	 */
+	std::vector< uint64_t > select_pairs( const uint32_t n, const uint64_t m, const uint64_t seed ) {
+		std::mt19937_64 rng = make_stream( seed, 0, 0 );
+		std::uniform_real_distribution< double > uniform( 0, 1 );
+		std::vector< uint64_t > keys;
+		keys.reserve( m );
+		uint64_t remaining = graphAnon::num_vertex_pairs( n );
+		for( uint32_t u = 0; u < n && keys.size() < m; ++u ) {
+			for( uint32_t v = u + 1; v < n && keys.size() < m; ++v, --remaining ) {
+				if( remaining * uniform( rng ) < m - keys.size() ) {
+					keys.push_back( static_cast< uint64_t >( u ) * n + v );
+				}
+			}
+		}
+		return keys;
+	}
+
+	/**
+	 * Builds a CsrGraph from the keys u * n + v (u < v) of its edges.
+	 * @pre keys is sorted and contains no duplicates.
+	 */
+	CsrGraph build_graph( const uint32_t n, std::vector< uint64_t > const& keys ) {
+		std::vector< uint64_t > offsets( static_cast< uint64_t >( n ) + 1, 0 );
+		for( uint64_t const key : keys ) {
+			++offsets[ key / n + 1 ];
+			++offsets[ key % n + 1 ];
+		}
+		for( uint32_t u = 0; u < n; ++u ) { offsets[ u + 1 ] += offsets[ u ]; }
+
+		/* Visiting the keys in order appends each vertex's smaller neighbours
+		 * in ascending order, and then its larger ones, so every list is sorted. */
+		std::vector< uint32_t > neighbours( offsets[ n ] );
+		std::vector< uint64_t > next( offsets.begin(), offsets.end() - 1 );
+		for( uint64_t const key : keys ) {
+			const uint32_t u = static_cast< uint32_t >( key / n );
+			const uint32_t v = static_cast< uint32_t >( key % n );
+			neighbours[ next[ u ]++ ] = v;
+			neighbours[ next[ v ]++ ] = u;
+		}
+		return CsrGraph( std::move( offsets ), std::move( neighbours ) );
+	}
+}
+
+namespace graphAnon
+{
+	CsrGraph random_gnm( const uint32_t num_vertices, const uint64_t num_edges,
+		const uint64_t seed ) {
+
+		const uint64_t pairs = num_vertex_pairs( num_vertices );
+		assert( num_edges <= pairs );
+		if( num_edges == 0 ) { return build_graph( num_vertices, std::vector< uint64_t >() ); }
+		if( num_edges > pairs / 4 ) {
+			return build_graph( num_vertices, select_pairs( num_vertices, num_edges, seed ) );
+		}
+		return build_graph( num_vertices, draw_pairs( num_vertices, num_edges, seed ) );
+	}
+
+	CsrGraph random_gnp( const uint32_t num_vertices, const double probability,
+		const uint64_t seed ) {
+
+		const uint32_t n = num_vertices;
+		if( probability <= 0 || n < 2 ) { return build_graph( n, std::vector< uint64_t >() ); }
+
+		/* Split the rows (u, u + 1..n - 1) into ranges with about as many
+		 * pairs each; the Bernoulli trials of disjoint ranges are independent. */
+		const uint32_t num_ranges = std::min( num_streams, n - 1 );
+		std::vector< uint32_t > first_rows( 1, 0 );
+		const uint64_t pairs_per_range = num_vertex_pairs( n ) / num_ranges + 1;
+		uint64_t pairs_in_range = 0;
+		for( uint32_t u = 0; u + 1 < n; ++u ) {
+			pairs_in_range += n - 1 - u;
+			if( pairs_in_range >= pairs_per_range && first_rows.size() < num_ranges ) {
+				first_rows.push_back( u + 1 );
+				pairs_in_range = 0;
+			}
+		}
+		first_rows.push_back( n - 1 );
+
+		const double log_q = std::log1p( -std::min( probability, 1.0 ) );
+		const double max_skip = static_cast< double >( num_vertex_pairs( n ) );
+		std::vector< std::vector< uint64_t > > runs( first_rows.size() - 1 );
+#pragma omp parallel for schedule( dynamic, 1 )
+		for( size_t range = 0; range < runs.size(); ++range ) {
+			std::mt19937_64 rng = make_stream( seed, 0, static_cast< uint32_t >( range ) );
+			std::uniform_real_distribution< double > uniform( 0, 1 );
+			const uint32_t last_row = first_rows[ range + 1 ];
+			uint64_t u = first_rows[ range ], v = u;
+			while( u < last_row ) {
+
+				/* Skip the pairs that fail before the next success. */
+				const double skip = probability >= 1 ? 0
+					: std::floor( std::log1p( -uniform( rng ) ) / log_q );
+				v += 1 + static_cast< uint64_t >( std::min( skip, max_skip ) );
+				while( v >= n && u < last_row ) {
+					v = v - n + u + 2;
+					++u;
+				}
+				if( u < last_row ) { runs[ range ].push_back( u * n + v ); }
+			}
+		}
+
+		/* The ranges are in order, so their concatenation is sorted. */
+		std::vector< uint64_t > keys;
+		for( auto const& run : runs ) { keys.insert( keys.end(), run.begin(), run.end() ); }
+		return build_graph( n, keys );
+	}
+}
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Definition of seeded, parallel generators of uniformly random graphs.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RANDOM_GRAPH_H_
+#define RANDOM_GRAPH_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+#include "csr_graph.h"
+
+namespace graphAnon
+{
+	/**
+	 * Counts the possible undirected edges on n vertices, n( n - 1 ) / 2.
+	 */
+	inline uint64_t num_vertex_pairs( const uint32_t num_vertices ) {
+		return static_cast< uint64_t >( num_vertices ) * ( num_vertices - ( num_vertices > 0 ) ) / 2;
+	}
+
+	/**
+	 * Generates an Erdos-Renyi G( n, m ) graph: one chosen uniformly at random
+	 * from all simple, undirected graphs with n vertices and m edges.
+	 * @param num_vertices The number of vertices, n.
+	 * @param num_edges The number of edges, m.
+	 * @param seed Seeds the generator. The graph depends only on the seed,
+	 * not on the number of OpenMP threads.
+	 * @pre num_edges <= num_vertex_pairs( num_vertices ).
+	 * @note Sparse graphs (m at most a quarter of the possible edges) draw
+	 * edges in parallel, until m distinct edges are found, in O( m log m )
+	 * time and O( m ) memory; denser graphs select each possible edge with
+	 * the probability that leaves the right number to choose, in
+	 * O( n^2 ) = O( m ) time.
+	 */
+	CsrGraph random_gnm( const uint32_t num_vertices, const uint64_t num_edges,
+		const uint64_t seed );
+
+	/**
+	 * Generates an Erdos-Renyi G( n, p ) graph, in which each possible
+	 * undirected edge is present independently with probability p.
+	 * @param num_vertices The number of vertices, n.
+	 * @param probability The edge probability, p.
+	 * @param seed Seeds the generator, as for random_gnm().
+	 * @note Skips geometrically from one edge to the next (Batagelj and
+	 * Brandes' method), in O( n + m ) time, in parallel over ranges of rows.
+	 */
+	CsrGraph random_gnp( const uint32_t num_vertices, const double probability,
+		const uint64_t seed );
+}
+
+#endif /* RANDOM_GRAPH_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in random_graph.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cmath>   /* for std::sqrt, std::fabs */
+#include <vector>
+
+#include "omp.h"
+
+#include "random_graph.test.h"
+#include "random_graph.h"
+#include "csr_graph.h"
+
+namespace
+{
+	/**
+	 * Determines whether g is simple and undirected, with sorted neighbour lists.
+	 */
+	bool is_simple( CsrGraph const& g ) {
+		for( uint32_t u = 0; u < g.num_vertices(); ++u ) {
+			uint32_t const *previous = NULL;
+			for( uint32_t const &v : g.neighbours( u ) ) {
+				if( v == u || v >= g.num_vertices() || !g.has_edge( v, u ) ) { return false; }
+				if( previous != NULL && *previous >= v ) { return false; }
+				previous = &v;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Determines whether two graphs have identical CSR arrays.
+	 */
+	bool are_identical( CsrGraph const& a, CsrGraph const& b ) {
+		if( a.num_vertices() != b.num_vertices() || a.num_edges() != b.num_edges() ) { return false; }
+		for( uint32_t u = 0; u <= a.num_vertices(); ++u ) {
+			if( a.offsets()[ u ] != b.offsets()[ u ] ) { return false; }
+		}
+		for( uint64_t i = 0; i < 2 * a.num_edges(); ++i ) {
+			if( a.neighbour_array()[ i ] != b.neighbour_array()[ i ] ) { return false; }
+		}
+		return true;
+	}
+
+	/**
+	 * Generates many random_gnm() graphs on n vertices with m edges and
+	 * checks that every possible edge appears about equally often.
+	 */
+	bool is_uniform( const uint32_t n, const uint32_t m, const uint32_t trials ) {
+		std::vector< uint32_t > counts( n * n, 0 );
+		for( uint32_t trial = 0; trial < trials; ++trial ) {
+			CsrGraph const g = graphAnon::random_gnm( n, m, trial );
+			if( g.num_edges() != m || !is_simple( g ) ) { return false; }
+			for( uint32_t u = 0; u < n; ++u ) {
+				for( uint32_t const v : g.neighbours( u ) ) { ++counts[ u * n + v ]; }
+			}
+		}
+
+		/* Each pair is an edge with probability m / pairs: allow five deviations. */
+		const double p = m / static_cast< double >( graphAnon::num_vertex_pairs( n ) );
+		const double expected = trials * p;
+		const double tolerance = 5 * std::sqrt( trials * p * ( 1 - p ) );
+		for( uint32_t u = 0; u < n; ++u ) {
+			for( uint32_t v = u + 1; v < n; ++v ) {
+				if( std::fabs( counts[ u * n + v ] - expected ) > tolerance ) { return false; }
+			}
+		}
+		return true;
+	}
+}
+
+bool test_random_graph() {
+
+	/* G( n, m ) has exactly m edges, sparse or dense, independent of threads. */
+	const int max_threads = omp_get_max_threads();
+	const uint32_t sizes[][ 2 ] = { { 1, 0 }, { 2, 1 }, { 50, 0 }, { 50, 100 }, { 50, 1000 },
+		{ 50, 1225 }, { 3000, 20000 } };
+	for( auto const& size : sizes ) {
+		omp_set_num_threads( 1 );
+		CsrGraph const one = graphAnon::random_gnm( size[ 0 ], size[ 1 ], 42 );
+		omp_set_num_threads( 3 );
+		CsrGraph const three = graphAnon::random_gnm( size[ 0 ], size[ 1 ], 42 );
+		omp_set_num_threads( max_threads );
+		if( one.num_vertices() != size[ 0 ] || one.num_edges() != size[ 1 ] || !is_simple( one )
+				|| !are_identical( one, three ) ) {
+			return false;
+		}
+	}
+	if( are_identical( graphAnon::random_gnm( 3000, 20000, 1 ), graphAnon::random_gnm( 3000, 20000, 2 ) ) ) {
+		return false;
+	}
+
+	/* Every edge is equally likely, whether drawn (sparse) or selected (dense). */
+	if( !is_uniform( 6, 2, 2000 ) || !is_uniform( 5, 6, 2000 ) ) { return false; }
+
+	/* G( n, p ) has about p of the possible edges, in each part of the graph. */
+	const uint32_t n = 2000;
+	const double p = 0.01;
+	omp_set_num_threads( 1 );
+	CsrGraph const one = graphAnon::random_gnp( n, p, 7 );
+	omp_set_num_threads( 3 );
+	CsrGraph const three = graphAnon::random_gnp( n, p, 7 );
+	omp_set_num_threads( max_threads );
+	if( !is_simple( one ) || !are_identical( one, three ) ) { return false; }
+	uint64_t low_edges = 0;
+	for( uint32_t u = 0; u < n / 2; ++u ) {
+		for( uint32_t const v : one.neighbours( u ) ) { low_edges += ( u < v && v < n / 2 ); }
+	}
+	const double pairs[] = { static_cast< double >( graphAnon::num_vertex_pairs( n ) ),
+		static_cast< double >( graphAnon::num_vertex_pairs( n / 2 ) ) };
+	const double counts[] = { static_cast< double >( one.num_edges() ), static_cast< double >( low_edges ) };
+	for( uint32_t i = 0; i < 2; ++i ) {
+		if( std::fabs( counts[ i ] - p * pairs[ i ] ) > 5 * std::sqrt( pairs[ i ] * p * ( 1 - p ) ) ) {
+			return false;
+		}
+	}
+
+	/* And the extremes of p give the empty and complete graphs. */
+	return graphAnon::random_gnp( 20, 0, 1 ).num_edges() == 0
+		&& graphAnon::random_gnp( 20, 1, 1 ).num_edges() == 190
+		&& is_simple( graphAnon::random_gnp( 20, 1, 1 ) );
+}
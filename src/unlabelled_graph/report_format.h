@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Definition of the file formats of the structured reports (i.e.,
+ * -report, -profile, and graphAnon_bench output).
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REPORT_FORMAT_H_
+#define REPORT_FORMAT_H_
+
+namespace graphAnon
+{
+	/** The supported file formats for structured reports. */
+	enum class ReportFormat {
+		/**
+		 * A single JSON object. For a utility report, it holds the metrics of the "input" graph and an
+		 * array of "outputs", each with its "parameter" (e.g., "k=5"), its
+		 * "metrics", and the "delta" of each metric from the input.
+		 */
+		json,
+
+		/**
+		 * A header row and then one row per record. For a utility report,
+		 * there is one row for the input graph and, for each output,
+		 * one row of its metrics and one of their deltas (distinguished by the
+		 * "graph" column). The hop plot is a single space-separated field of
+		 * length:count pairs.
+		 */
+		csv
+	};
+}
+
+#endif /* REPORT_FORMAT_H_ */
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Implementation of the ScratchArena class in scratch_arena.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint64_t */
+#include <algorithm>	/* for std::max */
+#include <chrono>		/* for std::chrono::steady_clock */
+#include <cassert>
+
+#include "scratch_arena.h" /* implementing this class. */
+#include "profile.h"
+
+namespace
+{
+	/**
+	 * The smallest block obtained from the heap, so that many small
+	 * allocations share a block.
+	 */
+	const size_t min_block_size = 64 * 1024;
+}
+
+constexpr size_t ScratchArena::alignment;
+
+ScratchArena& ScratchArena::local() {
+	static thread_local ScratchArena arena;
+	return arena;
+}
+
+void ScratchArena::release() {
+	assert( depth_ == 0 );
+	blocks_.clear();
+	block_ = 0;
+	offset_ = 0;
+}
+
+size_t ScratchArena::capacity() const {
+	size_t bytes = 0;
+	for( auto const& block : blocks_ ) { bytes += block.size; }
+	return bytes;
+}
+
+void* ScratchArena::allocate_block( const size_t bytes ) {
+	assert( depth_ > 0 );
+
+	/* Blocks beyond the current one are unused (Scopes close in stack order),
+	 * so move to the next one if it fits, and otherwise replace them all. */
+	const size_t next = block_ < blocks_.size() ? block_ + 1 : 0;
+	if( next >= blocks_.size() || blocks_[ next ].size < bytes ) {
+		const size_t previous = blocks_.empty() ? 0 : blocks_.back().size;
+		blocks_.resize( next );
+		blocks_.push_back( new_block( std::max( bytes, std::max( min_block_size, 2 * previous ) ) ) );
+	}
+	block_ = next;
+	offset_ = bytes;
+	return base( block_ );
+}
+
+ScratchArena::Block ScratchArena::new_block( const size_t bytes ) {
+	Block block;
+#ifdef GRAPHANON_NO_INSTRUMENTATION
+	block.memory.reset( new char[ bytes + alignment - 1 ] );
+#else
+	auto const start = std::chrono::steady_clock::now();
+	block.memory.reset( new char[ bytes + alignment - 1 ] );
+	auto const stop = std::chrono::steady_clock::now();
+	GRAPHANON_PROFILE_COUNT( scratch_allocations, 1 );
+	GRAPHANON_PROFILE_COUNT( scratch_bytes, bytes );
+	GRAPHANON_PROFILE_COUNT( scratch_allocation_ns,
+		std::chrono::duration_cast< std::chrono::nanoseconds >( stop - start ).count() );
+#endif
+	block.size = bytes;
+	return block;
+}
+
+void ScratchArena::rewind( const size_t block, const size_t offset ) {
+	assert( depth_ > 0 );
+	block_ = block;
+	offset_ = offset;
+
+	/* Once nothing is borrowed, merge the blocks, so that the next use of the
+	 * same size fits in one block without touching the heap. */
+	if( --depth_ == 0 && blocks_.size() > 1 ) {
+		const size_t total = capacity() + blocks_.size() * alignment;
+		blocks_.clear();
+		blocks_.push_back( new_block( total ) );
+		block_ = 0;
+		offset_ = 0;
+	}
+}
@@ -0,0 +1,212 @@
+/**
+ * @file
+ * @brief Definition of per-thread, reusable scratch memory for the analysis
+ * and anonymisation routines.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCRATCH_ARENA_H_
+#define SCRATCH_ARENA_H_
+
+#include <cstdint>	/* For uint32_t, uintptr_t */
+#include <cstddef>	/* For size_t */
+#include <memory>	/* For std::unique_ptr */
+
+/* STL libraries in use */
+#include <vector>
+
+/**
+ * @brief A per-thread bump allocator whose memory is reused by every
+ * routine that runs on its thread, rather than returned to the heap.
+ *
+ * Each thread has its own arena (see local()), so borrowing from it never
+ * contends with other OpenMP threads. Memory is borrowed within a Scope and
+ * all of it is handed back, at once, when the Scope closes; Scopes nest like
+ * a stack. The arena keeps its blocks after the outermost Scope closes
+ * (merged into one, large enough for the largest use so far), so a routine
+ * that is called repeatedly (or a loop body that opens a Scope per iteration)
+ * reaches the heap only until its footprint stops growing. The heap blocks
+ * are counted by the scratch_* profile counters.
+ */
+class ScratchArena {
+public:
+
+	/** Every allocation is aligned to a cache line. */
+	static constexpr size_t alignment = 64;
+
+	/**
+	 * @brief Borrows the memory of an arena for a block of code: every
+	 * allocation made from the arena while the Scope is open is released
+	 * when it closes.
+	 */
+	class Scope {
+	public:
+		/**
+		 * Opens a Scope on arena (by default, that of the calling thread).
+		 */
+		explicit Scope( ScratchArena &arena = ScratchArena::local() )
+			: arena_( arena ), block_( arena.block_ ), offset_( arena.offset_ ) { ++arena_.depth_; }
+
+		/**
+		 * Closes the Scope, releasing everything allocated since it opened.
+		 */
+		~Scope() { arena_.rewind( block_, offset_ ); }
+
+		Scope( Scope const& ) = delete;
+		Scope& operator=( Scope const& ) = delete;
+
+	private:
+		ScratchArena &arena_; /**< The arena whose memory is borrowed. */
+		const size_t block_; /**< The arena's current block when the Scope opened. */
+		const size_t offset_; /**< The arena's offset into that block when the Scope opened. */
+	};
+
+	/**
+	 * Retrieves the arena of the calling thread.
+	 */
+	static ScratchArena& local();
+
+	/**
+	 * Constructs an empty arena, which holds no memory until it is first used.
+	 */
+	ScratchArena() : block_( 0 ), offset_( 0 ), depth_( 0 ) {}
+
+	ScratchArena( ScratchArena const& ) = delete;
+	ScratchArena& operator=( ScratchArena const& ) = delete;
+
+	/**
+	 * Borrows uninitialised memory for count objects of type T.
+	 * @pre A Scope is open on this arena.
+	 * @return Memory that stays valid until the innermost open Scope closes.
+	 * @note T must be trivially destructible (or destroyed by the caller),
+	 * because the arena never runs destructors.
+	 */
+	template < typename T >
+	T* allocate( const size_t count ) {
+		static_assert( alignof( T ) <= alignment, "ScratchArena cannot align T" );
+		return static_cast< T* >( allocate_bytes( count * sizeof( T ) ) );
+	}
+
+	/**
+	 * Frees every block of the arena.
+	 * @pre No Scope is open on this arena.
+	 */
+	void release();
+
+	/**
+	 * Accessor method to retrieve the number of bytes that the arena holds
+	 * from the heap.
+	 */
+	size_t capacity() const;
+
+private:
+
+	/**
+	 * A contiguous region of heap memory from which allocations are bumped.
+	 */
+	struct Block {
+		std::unique_ptr< char[] > memory; /**< The region, plus slack for alignment. */
+		size_t size; /**< The usable bytes in the region. */
+	};
+
+	/**
+	 * Bumps the offset into the current block past bytes (aligned) bytes,
+	 * moving to a new block if they do not fit.
+	 */
+	void* allocate_bytes( const size_t bytes ) {
+		if( block_ < blocks_.size() ) {
+			const size_t start = ( offset_ + alignment - 1 ) & ~( alignment - 1 );
+			if( start + bytes <= blocks_[ block_ ].size ) {
+				offset_ = start + bytes;
+				return base( block_ ) + start;
+			}
+		}
+		return allocate_block( bytes );
+	}
+
+	/**
+	 * Retrieves the first aligned byte of block i.
+	 */
+	char* base( const size_t i ) const {
+		const uintptr_t address = reinterpret_cast< uintptr_t >( blocks_[ i ].memory.get() );
+		return reinterpret_cast< char* >( ( address + alignment - 1 ) & ~( alignment - 1 ) );
+	}
+
+	/**
+	 * Allocates bytes from a fresh block, obtaining one from the heap if the
+	 * arena has no unused block that is large enough.
+	 */
+	void* allocate_block( const size_t bytes );
+
+	/**
+	 * Obtains a block of at least bytes usable bytes from the heap.
+	 */
+	static Block new_block( const size_t bytes );
+
+	/**
+	 * Releases everything allocated since the arena was at (block, offset),
+	 * and merges the blocks into one if that closes the outermost Scope.
+	 */
+	void rewind( const size_t block, const size_t offset );
+
+	std::vector< Block > blocks_; /**< The blocks, in the order they are bumped through. */
+	size_t block_; /**< The block currently being bumped through. */
+	size_t offset_; /**< The first free byte of the current block. */
+	uint32_t depth_; /**< The number of open Scopes. */
+};
+
+/**
+ * @brief A standard allocator that borrows from the calling thread's
+ * ScratchArena, so that STL containers can be used as scratch space.
+ *
+ * Deallocation is a no-op: the memory is reclaimed when the enclosing
+ * ScratchArena::Scope closes, so a container that uses this allocator must
+ * be declared after (and so destroyed before) that Scope, and its elements
+ * must only be added on the thread that opened it.
+ */
+template < typename T >
+struct ScratchAllocator {
+	typedef T value_type;
+
+	ScratchAllocator() = default;
+	template < typename U > ScratchAllocator( ScratchAllocator< U > const& ) {}
+
+	T* allocate( const size_t count ) { return ScratchArena::local().allocate< T >( count ); }
+	void deallocate( T*, const size_t ) {}
+};
+
+template < typename T, typename U >
+bool operator==( ScratchAllocator< T > const&, ScratchAllocator< U > const& ) { return true; }
+
+template < typename T, typename U >
+bool operator!=( ScratchAllocator< T > const&, ScratchAllocator< U > const& ) { return false; }
+
+/**
+ * A std::vector whose storage is borrowed from the calling thread's ScratchArena.
+ */
+template < typename T >
+using ScratchVector = std::vector< T, ScratchAllocator< T > >;
+
+#endif /* SCRATCH_ARENA_H_ */
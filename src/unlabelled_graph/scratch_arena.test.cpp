@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in scratch_arena.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uintptr_t */
+#include <cstdlib> /* for rand */
+#include <numeric> /* for std::iota */
+#include <vector>
+
+#include "omp.h"
+
+#include "scratch_arena.test.h"
+#include "scratch_arena.h"
+
+namespace
+{
+	/**
+	 * Fills count blocks of random sizes from arena, each with its own index,
+	 * and then checks that every block is aligned and still holds its index.
+	 */
+	bool fill_and_check( ScratchArena *arena, const uint32_t count, const uint32_t max_size ) {
+		std::vector< uint32_t* > blocks( count );
+		std::vector< uint32_t > sizes( count );
+		for( uint32_t i = 0; i < count; ++i ) {
+			sizes[ i ] = 1 + rand() % max_size;
+			blocks[ i ] = arena->allocate< uint32_t >( sizes[ i ] );
+			if( reinterpret_cast< uintptr_t >( blocks[ i ] ) % ScratchArena::alignment != 0 ) { return false; }
+			std::fill( blocks[ i ], blocks[ i ] + sizes[ i ], i );
+		}
+		for( uint32_t i = 0; i < count; ++i ) {
+			for( uint32_t j = 0; j < sizes[ i ]; ++j ) {
+				if( blocks[ i ][ j ] != i ) { return false; }
+			}
+		}
+		return true;
+	}
+}
+
+bool test_scratch_arena() {
+	for( uint32_t trial = 0; trial < 10; ++trial ) {
+		ScratchArena arena;
+		const uint32_t count = 1 + rand() % 100;
+		const uint32_t max_size = 1 + rand() % ( trial % 2 == 0 ? 100 : 100000 );
+
+		/**
+		 * @test Disjoint allocations
+		 * Blocks allocated within one Scope, spanning several heap blocks,
+		 * are aligned and do not overlap.
+		 */
+		{
+			ScratchArena::Scope scope( arena );
+			if( !fill_and_check( &arena, count, max_size ) ) { return false; }
+		}
+
+		/**
+		 * @test Reuse
+		 * Once the first use has been merged into one block, the same use
+		 * again starts at the same address and needs no more memory.
+		 */
+		size_t capacity = arena.capacity();
+		uint32_t *first = NULL;
+		{
+			ScratchArena::Scope scope( arena );
+			first = arena.allocate< uint32_t >( 1 );
+		}
+		for( uint32_t repeat = 0; repeat < 3; ++repeat ) {
+			ScratchArena::Scope scope( arena );
+			if( arena.allocate< uint32_t >( 1 ) != first ) { return false; }
+		}
+		srand( trial );
+		{
+			ScratchArena::Scope scope( arena );
+			if( !fill_and_check( &arena, count, max_size ) ) { return false; }
+		}
+		capacity = arena.capacity();
+		srand( trial );
+		{
+			ScratchArena::Scope scope( arena );
+			if( !fill_and_check( &arena, count, max_size ) || arena.capacity() != capacity ) { return false; }
+		}
+
+		/**
+		 * @test Nested scopes
+		 * Closing an inner Scope reclaims only what was allocated within it.
+		 */
+		{
+			ScratchArena::Scope outer( arena );
+			uint32_t *kept = arena.allocate< uint32_t >( 16 );
+			std::iota( kept, kept + 16, 0 );
+			uint32_t *inner_first = NULL;
+			{
+				ScratchArena::Scope inner( arena );
+				inner_first = arena.allocate< uint32_t >( 16 );
+				if( inner_first == kept ) { return false; }
+				std::fill( inner_first, inner_first + 16, 99 );
+			}
+			for( uint32_t i = 0; i < 16; ++i ) {
+				if( kept[ i ] != i ) { return false; }
+			}
+			if( arena.allocate< uint32_t >( 16 ) != inner_first ) { return false; }
+		}
+
+		/**
+		 * @test Boundary case: release
+		 * Releasing an arena frees all its memory, after which it still works.
+		 */
+		arena.release();
+		if( arena.capacity() != 0 ) { return false; }
+		{
+			ScratchArena::Scope scope( arena );
+			if( !fill_and_check( &arena, count, max_size ) ) { return false; }
+		}
+	}
+
+	/**
+	 * @test Per-thread scratch vectors
+	 * Every thread fills a ScratchVector from its own arena at once.
+	 */
+	bool all_correct = true;
+#pragma omp parallel reduction( &&: all_correct )
+	{
+		ScratchArena::Scope scope;
+		ScratchVector< uint32_t > values;
+		for( uint32_t i = 0; i < 10000; ++i ) { values.push_back( i * omp_get_thread_num() ); }
+		for( uint32_t i = 0; i < values.size(); ++i ) {
+			all_correct = all_correct && values[ i ] == i * omp_get_thread_num();
+		}
+	}
+	return all_correct;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @brief Implementation of the StreamingIdentityAnonymiser class in
+ * streaming_identity.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::sort */
+#include <functional>	/* for std::greater */
+#include <utility>		/* for std::pair */
+
+/* STL stuff in use. */
+#include <vector>
+#include <string>
+
+#include "omp.h"
+
+#include "streaming_identity.h" /* implementing this class. */
+#include "graph_loader.h"
+
+namespace
+{
+	/**
+	 * The number of formatted bytes of new edges buffered before a write.
+	 */
+	const size_t output_buffer_bytes = 1 << 20;
+
+	typedef std::vector< std::pair< uint32_t, uint32_t > > EdgeList;
+
+	/**
+	 * Determines whether a chunk of edges continues a canonical edge list,
+	 * in which every edge (u,v) has u < v and is lexicographically greater
+	 * than the edge before it, so that a repeated edge would sit next to its
+	 * first occurrence.
+	 * @param edges The chunk, in file order.
+	 * @param last The last edge of the previous chunk, or ( 0, 0 ) before the
+	 * first chunk; updated to the last edge of this one.
+	 * @param parallel Whether to check with every OpenMP thread.
+	 */
+	bool continues_canonically( EdgeList const& edges, std::pair< uint32_t, uint32_t > *last,
+		const bool parallel ) {
+
+		bool canonical = true;
+#pragma omp parallel for schedule( static ) reduction( && : canonical ) if( parallel )
+		for( size_t i = 0; i < edges.size(); ++i ) {
+			if( edges[ i ].first >= edges[ i ].second
+					|| !( ( i > 0 ? edges[ i - 1 ] : *last ) < edges[ i ] ) ) {
+				canonical = false;
+			}
+		}
+		if( !edges.empty() ) { *last = edges.back(); }
+		return canonical;
+	}
+
+	inline void append_edge( std::string *buffer, const uint32_t u, const uint32_t v ) {
+		GraphWriter::append( buffer, u );
+		buffer->push_back( ' ' );
+		GraphWriter::append( buffer, v );
+		buffer->push_back( '\n' );
+	}
+}
+
+StreamingIdentityAnonymiser::StreamingIdentityAnonymiser( const std::string filename )
+	: filename_( filename ), n_( 0 ), m_( 0 ), canonical_( true ) {}
+
+bool StreamingIdentityAnonymiser::count_degrees( const bool parallel ) {
+	EdgeListReader reader( filename_ );
+	if( !reader.is_open() ) { return false; }
+	n_ = reader.num_vertices();
+	m_ = 0;
+	canonical_ = true;
+	degrees_.assign( n_, 0 );
+
+	EdgeList edges;
+	std::pair< uint32_t, uint32_t > last( 0, 0 );
+	while( reader.next( &edges, parallel ) ) {
+		if( !continues_canonically( edges, &last, parallel ) ) {
+			canonical_ = false;
+			degrees_.clear();
+			return false;
+		}
+		m_ += edges.size();
+#pragma omp parallel for schedule( static ) if( parallel )
+		for( size_t i = 0; i < edges.size(); ++i ) {
+#pragma omp atomic
+			++degrees_[ edges[ i ].first ];
+#pragma omp atomic
+			++degrees_[ edges[ i ].second ];
+		}
+	}
+	return reader.is_open();
+}
+
+bool StreamingIdentityAnonymiser::anonymise( const uint32_t k, const bool hide_new_vertices ) {
+	if( degrees_.empty() || k == 0 || k > n_ ) { return false; }
+
+	/* Plan from the degree sequence, sorted exactly as by
+	 * UnlabelledGraph::retrieve_degree_sequence(). */
+	sorted_degrees_.resize( n_ );
+	for( uint32_t v = 0; v < n_; ++v ) { sorted_degrees_[ v ] = std::make_pair( degrees_[ v ], v ); }
+	std::sort( sorted_degrees_.begin(), sorted_degrees_.end(),
+		std::greater< std::pair< uint32_t, uint32_t > >() );
+	DegreeSequenceAnonymiser anonymiser;
+	plan_.build( sorted_degrees_, k, hide_new_vertices, &anonymiser );
+	return true;
+}
+
+bool StreamingIdentityAnonymiser::write( const std::string filename,
+	const graphAnon::Compression compression, const bool parallel ) const {
+
+	GraphWriter writer( filename, compression );
+	EdgeListReader reader( filename_ );
+	if( !writer.is_open() || !reader.is_open() || reader.num_vertices() != n_ ) { return false; }
+
+	std::string buffer;
+	GraphWriter::append( &buffer, n_ + plan_.num_new_vertices() );
+	buffer.push_back( '\n' );
+	bool ok = writer.write( buffer );
+	buffer.clear();
+
+	/* Copy the original edges a chunk at a time, as long as they are still
+	 * the canonical edges that were counted. */
+	EdgeList edges;
+	std::pair< uint32_t, uint32_t > last( 0, 0 );
+	while( ok && reader.next( &edges, parallel ) ) {
+		ok = continues_canonically( edges, &last, parallel ) && writer.write( std::string(), edges.size(),
+			[ &edges ]( const uint32_t i, std::string *out ) {
+				append_edge( out, edges[ i ].first, edges[ i ].second );
+			}, parallel );
+	}
+	ok = ok && reader.is_open();
+
+	/* Then append the generated edges. */
+	plan_.generate_edges( sorted_degrees_, n_, [ &writer, &buffer, &ok ]( const uint32_t u, const uint32_t v ) {
+		append_edge( &buffer, u, v );
+		if( buffer.size() >= output_buffer_bytes ) {
+			ok = writer.write( buffer ) && ok;
+			buffer.clear();
+		}
+	} );
+	ok = writer.write( buffer ) && ok;
+	return writer.close() && ok;
+}
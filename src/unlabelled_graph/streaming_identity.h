@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Definition of a two-pass, streaming k-degree anonymiser for edge
+ * lists that are too large to load into memory.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STREAMING_IDENTITY_H_
+#define STREAMING_IDENTITY_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <string>	/* For std::string */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "unlabelled_graph.h"
+#include "graph_writer.h"
+#include "identity_plan.h"
+
+/**
+ * @brief Applies the same k-degree anonymisation as
+ * UnlabelledGraph::hide_waldo() to a graphAnon::FileFormat::edgeList file
+ * without ever materialising the graph.
+ *
+ * The anonymisation of @cite waldo only depends on the degree of each vertex:
+ * the degree sequence is anonymised, and then edges from the original
+ * vertices to new pseudo-vertices are generated in a fixed cyclic pattern.
+ * So, a first pass over the file counts degrees, the anonymisation is then
+ * planned from the degrees alone, and a second pass copies the original
+ * edges to the output followed by the generated ones. Memory use is O( n )
+ * regardless of the number of edges; the output has exactly the edge set
+ * that hide_waldo() would produce.
+ *
+ * The input must be canonical: each line is an edge (u,v) with u < v, and the
+ * lines are in strictly increasing order of u and then v (as written by
+ * UnlabelledGraph::write()). Then every undirected edge appears exactly once,
+ * which can be checked in O( 1 ) memory by comparing each edge with the
+ * previous one; an edge stored in both directions or repeated would
+ * otherwise inflate the degrees and be copied to the output twice. Inputs
+ * that are not canonical are rejected. Self-loops and edges to vertex ids of
+ * n or more are skipped, as by GraphLoader.
+ */
+class StreamingIdentityAnonymiser {
+public:
+
+	/**
+	 * Constructs an anonymiser for an edge list file. The file is not read
+	 * until count_degrees().
+	 * @param filename The path to the input file.
+	 */
+	explicit StreamingIdentityAnonymiser( const std::string filename );
+
+	/**
+	 * First pass: counts the degree of every vertex in the input file.
+	 * @param parallel Whether to parse with every OpenMP thread.
+	 * @return False if the file could not be read, did not begin with a
+	 * positive number of vertices, or is not canonical.
+	 */
+	bool count_degrees( const bool parallel = true );
+
+	/**
+	 * Plans the anonymisation from the degrees counted by count_degrees().
+	 * @param k The privacy threshold, k.
+	 * @param hide_new_vertices Whether the new pseudo-vertices must also be
+	 * anonymised, as for hide_waldo< true >().
+	 * @return False if the degrees have not been counted or k is not in [ 1, n ].
+	 * @see UnlabelledGraph::hide_waldo()
+	 */
+	bool anonymise( const uint32_t k, const bool hide_new_vertices );
+
+	/**
+	 * Second pass: writes the anonymised graph in edge list format.
+	 * @param filename The path of the file to (over)write.
+	 * @param compression The streaming compression with which to write it.
+	 * @param parallel Whether to parse and format with every OpenMP thread.
+	 * @return False if the input could not be re-read (or is no longer
+	 * canonical) or the output written.
+	 */
+	bool write( const std::string filename, const graphAnon::Compression compression,
+		const bool parallel = true ) const;
+
+	/**
+	 * Accessor method to retrieve the number of vertices in the input, n.
+	 */
+	uint32_t num_vertices() const { return n_; }
+
+	/**
+	 * Determines whether the edges read so far by count_degrees() were
+	 * canonical, i.e., each had u < v and followed the previous edge.
+	 */
+	bool is_canonical() const { return canonical_; }
+
+	/**
+	 * Accessor method to retrieve the number of edges read from the input.
+	 */
+	uint64_t num_edges() const { return m_; }
+
+	/**
+	 * Accessor method to retrieve the number of pseudo-vertices that the
+	 * planned anonymisation adds.
+	 */
+	uint32_t num_new_vertices() const { return plan_.num_new_vertices(); }
+
+	/**
+	 * Accessor method to retrieve the number of edges that the planned
+	 * anonymisation adds.
+	 */
+	uint64_t num_new_edges() const { return plan_.num_new_edges(); }
+
+private:
+
+	std::string filename_; /**< The path to the input file. */
+	uint32_t n_; /**< The number of vertices in the input. */
+	uint64_t m_; /**< The number of edges read from the input. */
+	bool canonical_; /**< Whether the edges read were canonical. */
+	std::vector< uint32_t > degrees_; /**< The degree of each input vertex. */
+
+	DegreeSequence sorted_degrees_; /**< The degree sequence, sorted as by hide_waldo(). */
+	IdentityPlan plan_; /**< The planned anonymisation. */
+};
+
+#endif /* STREAMING_IDENTITY_H_ */
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Implementation of unit tests for the StreamingIdentityAnonymiser.
+ *
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for mkstemp */
+#include <stdio.h> /* for remove */
+#include <unistd.h> /* for close */
+#include <fstream>
+#include <string>
+
+#include "streaming_identity.test.h"
+#include "streaming_identity.h"
+#include "unlabelled_graph.h"
+#include "random_graph.h"
+#include "csr_graph.h"
+
+namespace
+{
+	/**
+	 * Creates a temporary file.
+	 * @return The path of the file, or empty if none could be created.
+	 */
+	std::string temporary_file() {
+		std::string path = "/tmp/graphAnon_test_XXXXXX";
+		const int fd = mkstemp( &path[ 0 ] );
+		if( fd < 0 ) { return std::string(); }
+		close( fd );
+		return path;
+	}
+
+	/**
+	 * Writes an edge list file on n vertices with the given edges, in order.
+	 */
+	void write_edge_list( std::string const& path, const uint32_t n,
+		graphAnon::EdgeList const& edges ) {
+		std::ofstream file( path );
+		file << n << '\n';
+		for( auto const& e : edges ) { file << e.first << ' ' << e.second << '\n'; }
+	}
+
+	/**
+	 * Determines whether StreamingIdentityAnonymiser rejects an edge list
+	 * file without planning an anonymisation of it.
+	 */
+	bool is_rejected( std::string const& path ) {
+		StreamingIdentityAnonymiser anonymiser( path );
+		return !anonymiser.count_degrees() && !anonymiser.is_canonical()
+			&& !anonymiser.anonymise( 1, true );
+	}
+}
+
+bool test_streaming_identity() {
+
+	std::string const input = temporary_file();
+	std::string const output = temporary_file();
+	if( input.empty() || output.empty() ) { return false; }
+	bool passed = true;
+
+	/**
+	 * @test Canonical input
+	 * A random graph, written with u < v in ascending order, is anonymised
+	 * with the same edge count as by hide_waldo(), and the output is
+	 * k-degree-anonymous.
+	 */
+	const uint32_t n = 400, k = 5;
+	graphAnon::EdgeList const edges = graphAnon::edge_list( graphAnon::random_gnm( n, 3 * n, 2017 ) );
+	write_edge_list( input, n, edges );
+	StreamingIdentityAnonymiser anonymiser( input );
+	if( !anonymiser.count_degrees() || !anonymiser.is_canonical()
+			|| anonymiser.num_edges() != edges.size() || !anonymiser.anonymise( k, true )
+			|| !anonymiser.write( output, graphAnon::Compression::none ) ) {
+		passed = false;
+	}
+	else {
+		UnlabelledGraph in_memory( input, graphAnon::FileFormat::edgeList );
+		in_memory.hide_waldo< true >( k );
+		UnlabelledGraph const streamed( output, graphAnon::FileFormat::edgeList );
+		if( streamed.num_vertices() != in_memory.num_vertices()
+				|| streamed.num_edges() != in_memory.num_edges()
+				|| streamed.num_edges() != edges.size() + anonymiser.num_new_edges()
+				|| !streamed.is_anonymous( k ) ) {
+			passed = false;
+		}
+	}
+
+	/**
+	 * @test Boundary case: every edge in both directions
+	 * An edge list that stores (u,v) and (v,u), as the SNAP data sets do,
+	 * is rejected rather than anonymised with doubled degrees.
+	 */
+	graphAnon::EdgeList both;
+	for( auto const& e : edges ) {
+		both.push_back( e );
+		both.push_back( std::make_pair( e.second, e.first ) );
+	}
+	write_edge_list( input, n, both );
+	if( !is_rejected( input ) ) { passed = false; }
+
+	/**
+	 * @test Boundary case: one edge in both directions
+	 * Even a single edge (0,1) followed by (1,0) is rejected.
+	 */
+	write_edge_list( input, 2, { { 0, 1 }, { 1, 0 } } );
+	if( !is_rejected( input ) ) { passed = false; }
+
+	/**
+	 * @test Boundary case: a repeated or misordered edge
+	 * A duplicate line, or distinct edges out of order, are rejected.
+	 */
+	write_edge_list( input, 4, { { 0, 1 }, { 1, 2 }, { 1, 2 }, { 2, 3 } } );
+	if( !is_rejected( input ) ) { passed = false; }
+	write_edge_list( input, 4, { { 1, 2 }, { 0, 1 }, { 2, 3 } } );
+	if( !is_rejected( input ) ) { passed = false; }
+
+	remove( input.c_str() );
+	remove( output.c_str() );
+	return passed;
+}
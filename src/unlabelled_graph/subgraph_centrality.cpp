@@ -0,0 +1,369 @@
+/**
+ * @file
+ * @brief Implementation of the SubgraphCentrality class in subgraph_centrality.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cmath>		/* for std::expm1, std::sqrt, std::hypot */
+#include <limits>		/* for std::numeric_limits */
+#include <random>		/* for std::mt19937_64 */
+#include <algorithm>	/* for std::fill */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "subgraph_centrality.h" /* implementing this class. */
+#include "scratch_arena.h"
+
+namespace
+{
+	/** The largest Krylov subspace built from any one start vector. */
+	const uint32_t max_lanczos_steps = 64;
+
+	/** The number of probes evaluated between two stopping-rule checks. */
+	const uint32_t probes_per_round = 16;
+
+	/** The fewest probes from which a standard error is trusted. */
+	const uint32_t min_probes = 2 * probes_per_round;
+
+	/** The number of dominant directions deflated exactly before probing. */
+	const uint32_t deflation_rank = 8;
+
+	/** The number of block power iterations used to find those directions. */
+	const uint32_t deflation_iterations = 40;
+
+	/** The walk weighting counted by subgraph centrality, excluding lengths 0 and 1. */
+	inline double walk_weight( const double x ) { return std::expm1( x ) - x; }
+
+	/**
+	 * Computes e_1^T f( T ) e_1 for the symmetric tridiagonal matrix T with
+	 * diagonal d and off-diagonal e, using the implicit QL algorithm and tracking
+	 * only the first component of each eigenvector.
+	 * @param d The k diagonal entries of T (overwritten with its eigenvalues).
+	 * @param e The k - 1 off-diagonal entries of T, padded to length k (destroyed).
+	 */
+	double gauss_quadrature( std::vector< double > &d, std::vector< double > &e ) {
+		const uint32_t k = d.size();
+		std::vector< double > z( k, 0 );
+		z[ 0 ] = 1;
+		e[ k - 1 ] = 0;
+
+		for( uint32_t l = 0; l < k; ++l ) {
+			for( uint32_t iteration = 0; iteration < 64; ++iteration ) {
+
+				/* Find a negligible off-diagonal element to split at. */
+				uint32_t m = l;
+				for( ; m + 1 < k; ++m ) {
+					const double dd = std::fabs( d[ m ] ) + std::fabs( d[ m + 1 ] );
+					if( std::fabs( e[ m ] ) <= std::numeric_limits< double >::epsilon() * dd ) { break; }
+				}
+				if( m == l ) { break; } /* d[ l ] has converged. */
+
+				/* Wilkinson-shifted QL sweep from m up to l. */
+				double g = ( d[ l + 1 ] - d[ l ] ) / ( 2 * e[ l ] );
+				double r = std::hypot( g, 1.0 );
+				g = d[ m ] - d[ l ] + e[ l ] / ( g + ( g >= 0 ? r : -r ) );
+				double s = 1, c = 1, p = 0;
+				bool underflow = false;
+				for( uint32_t i = m; i-- > l; ) {
+					double f = s * e[ i ];
+					const double b = c * e[ i ];
+					r = std::hypot( f, g );
+					e[ i + 1 ] = r;
+					if( r == 0 ) {
+						d[ i + 1 ] -= p;
+						e[ m ] = 0;
+						underflow = true;
+						break;
+					}
+					s = f / r;
+					c = g / r;
+					g = d[ i + 1 ] - p;
+					r = ( d[ i ] - g ) * s + 2 * c * b;
+					p = s * r;
+					d[ i + 1 ] = g + p;
+					g = c * r - b;
+
+					f = z[ i + 1 ];
+					z[ i + 1 ] = s * z[ i ] + c * f;
+					z[ i ] = c * z[ i ] - s * f;
+				}
+				if( underflow ) { continue; }
+				d[ l ] -= p;
+				e[ l ] = g;
+				e[ m ] = 0;
+			}
+		}
+
+		double result = 0;
+		for( uint32_t i = 0; i < k; ++i ) { result += z[ i ] * z[ i ] * walk_weight( d[ i ] ); }
+		return result;
+	}
+
+	/**
+	 * Computes y = A x by summing, for each vertex, x over its neighbours.
+	 */
+	template< typename Graph >
+	void multiply( Graph const& g, double const *x, double *y ) {
+		const uint32_t n = g.num_vertices();
+#pragma omp parallel for schedule( dynamic, 1024 )
+		for( uint32_t v = 0; v < n; ++v ) {
+			double sum = 0;
+			for( uint32_t const u : g.neighbours( v ) ) { sum += x[ u ]; }
+			y[ v ] = sum;
+		}
+	}
+
+	/**
+	 * Orthonormalises the vectors in basis by modified Gram-Schmidt, discarding
+	 * any that are (numerically) linearly dependent on their predecessors.
+	 */
+	void orthonormalise( std::vector< std::vector< double > > *basis ) {
+		std::vector< std::vector< double > > result;
+		for( auto &v : *basis ) {
+			for( auto const& u : result ) {
+				double dot = 0;
+				for( size_t i = 0; i < v.size(); ++i ) { dot += u[ i ] * v[ i ]; }
+				for( size_t i = 0; i < v.size(); ++i ) { v[ i ] -= dot * u[ i ]; }
+			}
+			double norm = 0;
+			for( double const x : v ) { norm += x * x; }
+			norm = std::sqrt( norm );
+			if( norm > 1e-8 ) {
+				for( double &x : v ) { x /= norm; }
+				result.push_back( std::move( v ) );
+			}
+		}
+		basis->swap( result );
+	}
+
+	/**
+	 * Reusable per-thread vectors for the Lanczos process. The three of
+	 * length n are borrowed from the thread's ScratchArena, so that each
+	 * round of probes does not reallocate them.
+	 */
+	struct LanczosWorkspace {
+		ScratchVector< double > q, q_prev, w;
+		std::vector< double > alpha, beta, d, e;
+	};
+
+	/**
+	 * Computes q^T f( A ) q for the unit vector in workspace->q by Lanczos
+	 * quadrature, stopping when successive quadrature values agree to within
+	 * the relative tolerance or the Krylov subspace becomes invariant.
+	 * @post workspace->q is destroyed.
+	 */
+	template< typename Graph >
+	double quadratic_form( Graph const& g, const double tolerance,
+		LanczosWorkspace *workspace ) {
+
+		const uint32_t n = g.num_vertices();
+		ScratchVector< double > &q = workspace->q;
+		ScratchVector< double > &q_prev = workspace->q_prev;
+		ScratchVector< double > &w = workspace->w;
+		workspace->alpha.clear();
+		workspace->beta.clear();
+		std::fill( q_prev.begin(), q_prev.end(), 0 );
+
+		double previous = 0;
+		double beta_prev = 0;
+		for( uint32_t j = 0; j < max_lanczos_steps; ++j ) {
+
+			/* w = A q - beta_{j-1} q_{j-1}, then orthogonalise against q. */
+			double alpha = 0;
+			for( uint32_t v = 0; v < n; ++v ) {
+				double sum = 0;
+				for( uint32_t const u : g.neighbours( v ) ) { sum += q[ u ]; }
+				w[ v ] = sum - beta_prev * q_prev[ v ];
+				alpha += q[ v ] * w[ v ];
+			}
+			double beta = 0;
+			for( uint32_t v = 0; v < n; ++v ) {
+				w[ v ] -= alpha * q[ v ];
+				beta += w[ v ] * w[ v ];
+			}
+			beta = std::sqrt( beta );
+			workspace->alpha.push_back( alpha );
+
+			/* Evaluate the quadrature rule on the current tridiagonal matrix. */
+			workspace->d = workspace->alpha;
+			workspace->e = workspace->beta;
+			workspace->e.push_back( 0 );
+			const double current = gauss_quadrature( workspace->d, workspace->e );
+			if( ( j > 0 && std::fabs( current - previous ) <= tolerance * std::fabs( current ) )
+					|| beta <= 1e-12 ) {
+				return current;
+			}
+			previous = current;
+
+			/* Advance to the next Lanczos vector. */
+			workspace->beta.push_back( beta );
+			for( uint32_t v = 0; v < n; ++v ) {
+				q_prev[ v ] = q[ v ];
+				q[ v ] = w[ v ] / beta;
+			}
+			beta_prev = beta;
+		}
+		return previous;
+	}
+}
+
+SubgraphCentrality::SubgraphCentrality( CsrGraph const& g ) : csr_( &g ), overlay_( NULL ) {}
+
+SubgraphCentrality::SubgraphCentrality( OverlayView const& g ) : csr_( NULL ), overlay_( &g ) {}
+
+double SubgraphCentrality::estimate( const double relative_tolerance,
+	const uint32_t max_probes, const uint64_t seed ) const {
+	if( csr_ ) { return estimate( *csr_, relative_tolerance, max_probes, seed ); }
+	return estimate( *overlay_, relative_tolerance, max_probes, seed );
+}
+
+template< typename Graph >
+double SubgraphCentrality::estimate( Graph const& g, const double relative_tolerance,
+	const uint32_t max_probes, const uint64_t seed ) const {
+
+	const uint32_t n = g.num_vertices();
+	if( n == 0 ) { return 0; }
+
+	/* The Lanczos processes converge much more tightly than the probe average. */
+	const double lanczos_tolerance = relative_tolerance * 1e-3;
+
+	/* Small graphs: sum the diagonal of f( A ) exactly, one vertex at a time. */
+	if( n <= max_probes ) {
+		double sum = 0;
+#pragma omp parallel reduction( +: sum )
+		{
+			ScratchArena::Scope scratch;
+			LanczosWorkspace workspace;
+			workspace.q.assign( n, 0 );
+			workspace.q_prev.resize( n );
+			workspace.w.resize( n );
+
+#pragma omp for schedule( dynamic, 1 )
+			for( uint32_t i = 0; i < n; ++i ) {
+				std::fill( workspace.q.begin(), workspace.q.end(), 0 );
+				workspace.q[ i ] = 1;
+				sum += quadratic_form( g, lanczos_tolerance, &workspace );
+			}
+		}
+		return sum / n;
+	}
+
+	/* Large graphs: the trace is dominated by the few largest eigenvalues, which
+	 * would make plain Hutchinson probes very noisy. So first find an orthonormal
+	 * basis V that approximates the dominant eigenvectors by block power iteration
+	 * and split tr f( A ) = tr( V^T f( A ) V ) + tr( ( I - VV^T ) f( A ) ( I - VV^T ) ).
+	 * The first term is evaluated exactly; only the second is probed. The split
+	 * holds for any orthonormal V, so the estimate stays unbiased. */
+	std::vector< std::vector< double > > basis( std::min( deflation_rank, n ),
+		std::vector< double >( n ) );
+	std::mt19937_64 basis_rng( seed );
+	for( auto &v : basis ) {
+		for( double &x : v ) { x = ( basis_rng() & 1 ) ? 1.0 : -1.0; }
+	}
+	std::vector< double > product( n );
+	for( uint32_t iteration = 0; iteration < deflation_iterations && !basis.empty(); ++iteration ) {
+		for( auto &v : basis ) {
+			multiply( g, v.data(), product.data() );
+			v.swap( product );
+		}
+		orthonormalise( &basis );
+	}
+
+	double deflated = 0;
+	{
+		ScratchArena::Scope scratch;
+		LanczosWorkspace workspace;
+		workspace.q_prev.resize( n );
+		workspace.w.resize( n );
+		for( auto const& v : basis ) {
+			workspace.q.assign( v.begin(), v.end() );
+			deflated += quadratic_form( g, lanczos_tolerance, &workspace );
+		}
+	}
+
+	/* Then average y^T f( A ) y / n for y = ( I - VV^T ) z over Rademacher probes z,
+	 * in rounds, until the standard error of the estimate is small enough. */
+	std::vector< double > samples;
+	double estimate = deflated / n;
+	while( samples.size() < max_probes ) {
+		const uint32_t first = samples.size();
+		const uint32_t count = std::min( probes_per_round, max_probes - first );
+		samples.resize( first + count );
+
+#pragma omp parallel
+		{
+			ScratchArena::Scope scratch;
+			LanczosWorkspace workspace;
+			workspace.q.resize( n );
+			workspace.q_prev.resize( n );
+			workspace.w.resize( n );
+
+#pragma omp for schedule( dynamic, 1 )
+			for( uint32_t p = first; p < first + count; ++p ) {
+				ScratchVector< double > &q = workspace.q;
+				std::mt19937_64 rng( seed + 1 + p );
+				const double entry = 1 / std::sqrt( static_cast< double >( n ) );
+				for( uint32_t v = 0; v < n; v += 64 ) {
+					const uint64_t bits = rng();
+					for( uint32_t b = 0; b < 64 && v + b < n; ++b ) {
+						q[ v + b ] = ( bits >> b ) & 1 ? entry : -entry;
+					}
+				}
+
+				/* Project out the deflated directions, then normalise: the
+				 * quadratic form scales with the squared norm. */
+				for( auto const& u : basis ) {
+					double dot = 0;
+					for( uint32_t v = 0; v < n; ++v ) { dot += u[ v ] * q[ v ]; }
+					for( uint32_t v = 0; v < n; ++v ) { q[ v ] -= dot * u[ v ]; }
+				}
+				double norm_sq = 0;
+				for( uint32_t v = 0; v < n; ++v ) { norm_sq += q[ v ] * q[ v ]; }
+				if( norm_sq <= 0 ) { samples[ p ] = 0; continue; }
+				const double norm = std::sqrt( norm_sq );
+				for( uint32_t v = 0; v < n; ++v ) { q[ v ] /= norm; }
+				samples[ p ] = norm_sq * quadratic_form( g, lanczos_tolerance, &workspace );
+			}
+		}
+
+		/* Stopping rule on the standard error of the sample mean. */
+		double mean = 0, variance = 0;
+		for( double const x : samples ) { mean += x; }
+		mean /= samples.size();
+		for( double const x : samples ) { variance += ( x - mean ) * ( x - mean ); }
+		variance /= ( samples.size() > 1 ? samples.size() - 1 : 1 );
+		const double standard_error = std::sqrt( variance / samples.size() );
+		estimate = deflated / n + mean;
+		if( samples.size() >= min_probes
+				&& standard_error <= relative_tolerance * std::fabs( estimate ) ) {
+			break;
+		}
+	}
+	return estimate;
+}
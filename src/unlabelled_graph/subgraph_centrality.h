@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @brief Definition of a sparse, Krylov-subspace estimator of subgraph
+ * centrality that scales to graphs far beyond the dense matrix method.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SUBGRAPH_CENTRALITY_H_
+#define SUBGRAPH_CENTRALITY_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+
+/**
+ * @brief Estimates the subgraph centrality of a graph with Lanczos quadrature
+ * and sparse matrix-vector products over its CSR adjacency structure (or that
+ * of an OverlayView).
+ *
+ * The subgraph centrality reported by UnlabelledGraph is the average over all
+ * vertices of the weighted count of closed walks of length >= 2, i.e.,
+ * ( trace( exp( A ) ) - n ) / n for adjacency matrix A (recall that
+ * trace( A ) = 0). This class evaluates z^T f( A ) z for f( x ) = e^x - 1 - x by
+ * running a short Lanczos process from z and applying Gauss quadrature to the
+ * resulting tridiagonal matrix, which costs O( m ) per Lanczos step.
+ *
+ * If the graph has no more vertices than the probe budget, every basis vector
+ * e_i is used as a start vector and the result is exact (up to the Lanczos
+ * tolerance). Otherwise, the few dominant eigendirections (found by block power
+ * iteration) are evaluated exactly, and the remainder of the trace is estimated
+ * stochastically from Rademacher probe vectors projected away from those
+ * directions (Hutchinson's estimator with deflation), adding probes until the
+ * standard error falls below the requested relative tolerance.
+ */
+class SubgraphCentrality {
+public:
+
+	/**
+	 * Constructs an estimator over the graph g.
+	 * @param g The graph to analyse. It must outlive this SubgraphCentrality.
+	 */
+	explicit SubgraphCentrality( CsrGraph const& g );
+
+	/**
+	 * Constructs an estimator over the overlaid graph g.
+	 * @param g The graph to analyse. It must outlive this SubgraphCentrality.
+	 */
+	explicit SubgraphCentrality( OverlayView const& g );
+
+	/**
+	 * Estimates the subgraph centrality of the graph.
+	 * @param relative_tolerance The target standard error of the estimate,
+	 * relative to the estimate itself. Also bounds the relative change in each
+	 * quadrature value at which the Lanczos process is considered converged.
+	 * @param max_probes The maximum number of probe vectors. Graphs with at
+	 * most this many vertices are evaluated exactly, one basis vector per vertex.
+	 * @param seed Seeds the probe vectors, so that estimates are reproducible
+	 * (irrespective of the number of threads).
+	 * @returns The (estimated) subgraph centrality, ( trace( exp( A ) ) - n ) / n.
+	 */
+	double estimate( const double relative_tolerance, const uint32_t max_probes = 1000,
+		const uint64_t seed = 1 ) const;
+
+private:
+
+	/**
+	 * Estimates the subgraph centrality of g.
+	 * @see estimate()
+	 */
+	template< typename Graph >
+	double estimate( Graph const& g, const double relative_tolerance,
+		const uint32_t max_probes, const uint64_t seed ) const;
+
+	CsrGraph const *csr_; /**< The graph being analysed, if a CsrGraph. */
+	OverlayView const *overlay_; /**< The graph being analysed, if an OverlayView. */
+};
+
+#endif /* SUBGRAPH_CENTRALITY_H_ */
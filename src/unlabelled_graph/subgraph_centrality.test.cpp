@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Implementation of unit tests for the sparse subgraph centrality.
+ *
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t */
+#include <cmath>   /* for std::fabs */
+
+#include "subgraph_centrality.test.h"
+#include "subgraph_centrality.h"
+#include "unlabelled_graph.h"
+
+namespace
+{
+	/**
+	 * The walk length at which to truncate the dense reference. The graphs
+	 * below have largest eigenvalues under 8, so the terms beyond it are
+	 * negligible.
+	 */
+	const uint32_t dense_limit = 30;
+
+	/**
+	 * Determines whether the sparse estimate for a random G( n, m ) graph is
+	 * within relative_error of the dense subgraph centrality.
+	 */
+	bool agrees( const uint32_t n, const uint64_t m, const double relative_tolerance,
+		const uint32_t max_probes, const double relative_error ) {
+
+		UnlabelledGraph g( n );
+		g.populate_uniformly( m, 2017 );
+		const double exact = g.subgraph_centrality( dense_limit );
+		const double estimate = SubgraphCentrality( g.csr() ).estimate( relative_tolerance, max_probes );
+		return std::fabs( estimate - exact ) <= relative_error * exact;
+	}
+}
+
+bool test_subgraph_centrality() {
+
+	bool passed = true;
+
+	/**
+	 * @test Exact probing
+	 * A graph with no more vertices than the probe budget is evaluated from
+	 * every basis vector, so matches the dense result to within the Lanczos
+	 * tolerance.
+	 */
+	if( !agrees( 100, 300, 1e-6, 1000, 1e-5 ) ) { passed = false; }
+
+	/**
+	 * @test Stochastic estimate
+	 * A graph with more vertices than max_probes is estimated from deflated
+	 * Rademacher probes until the standard error is within the requested 1%,
+	 * so it should be within three standard errors of the dense result (the
+	 * probes are seeded, so the same estimate is checked on every run).
+	 */
+	if( !agrees( 160, 480, 1e-2, 100, 3e-2 ) ) { passed = false; }
+
+	/**
+	 * @test Boundary case: no edges
+	 * An edgeless graph has no closed walks of length >= 2.
+	 */
+	UnlabelledGraph const isolated( 5 );
+	if( SubgraphCentrality( isolated.csr() ).estimate( 1e-3 ) != 0 ) { passed = false; }
+
+	return passed;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Implementation of the TriangleCounter class in triangle_count.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <algorithm>	/* for std::sort */
+#include <numeric>		/* for std::iota */
+
+/* STL stuff in use. */
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "omp.h"
+
+#include "triangle_count.h" /* implementing this class. */
+
+namespace
+{
+	/**
+	 * Counts the common elements of the sorted, duplicate-free arrays
+	 * [a, a + na) and [b, b + nb).
+	 */
+	inline uint64_t intersection_size( uint32_t const *a, uint64_t na,
+		uint32_t const *b, uint64_t nb ) {
+
+		uint64_t count = 0;
+		uint64_t i = 0, j = 0;
+
+#ifdef __AVX2__
+		/* Compare blocks of eight against all eight rotations of each other,
+		 * then advance whichever block has the smaller maximum (or both). Each
+		 * pair of blocks is compared at most once, so no match is double counted. */
+		while( i + 8 <= na && j + 8 <= nb ) {
+			const __m256i va = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( a + i ) );
+			__m256i vb = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( b + j ) );
+			__m256i matches = _mm256_setzero_si256();
+			for( uint32_t swap = 0; swap < 2; ++swap ) {
+				matches = _mm256_or_si256( matches, _mm256_cmpeq_epi32( va, vb ) );
+				__m256i rotated = _mm256_shuffle_epi32( vb, _MM_SHUFFLE( 0, 3, 2, 1 ) );
+				matches = _mm256_or_si256( matches, _mm256_cmpeq_epi32( va, rotated ) );
+				rotated = _mm256_shuffle_epi32( vb, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+				matches = _mm256_or_si256( matches, _mm256_cmpeq_epi32( va, rotated ) );
+				rotated = _mm256_shuffle_epi32( vb, _MM_SHUFFLE( 2, 1, 0, 3 ) );
+				matches = _mm256_or_si256( matches, _mm256_cmpeq_epi32( va, rotated ) );
+				vb = _mm256_permute2x128_si256( vb, vb, 1 ); /* swap 128-bit lanes */
+			}
+			count += __builtin_popcount( _mm256_movemask_ps( _mm256_castsi256_ps( matches ) ) );
+
+			const uint32_t a_max = a[ i + 7 ];
+			const uint32_t b_max = b[ j + 7 ];
+			if( a_max <= b_max ) { i += 8; }
+			if( b_max <= a_max ) { j += 8; }
+		}
+#endif
+
+		/* Scalar merge of whatever remains. */
+		while( i < na && j < nb ) {
+			if( a[ i ] < b[ j ] ) { ++i; }
+			else if( b[ j ] < a[ i ] ) { ++j; }
+			else { ++count; ++i; ++j; }
+		}
+		return count;
+	}
+}
+
+TriangleCounter::TriangleCounter( CsrGraph const& g ) : n_( g.num_vertices() ) { orient( g ); }
+
+TriangleCounter::TriangleCounter( OverlayView const& g ) : n_( g.num_vertices() ) { orient( g ); }
+
+template< typename Graph >
+void TriangleCounter::orient( Graph const& g ) {
+
+	const uint32_t n = n_;
+
+	/* Rank vertices by ascending degree, breaking ties by id. */
+	rank_to_vertex_.resize( n );
+	std::iota( rank_to_vertex_.begin(), rank_to_vertex_.end(), 0 );
+	std::sort( rank_to_vertex_.begin(), rank_to_vertex_.end(),
+		[ &g ]( uint32_t const u, uint32_t const v ) {
+			return g.degree( u ) < g.degree( v ) || ( g.degree( u ) == g.degree( v ) && u < v );
+		}
+	);
+	std::vector< uint32_t > vertex_to_rank( n );
+	for( uint32_t r = 0; r < n; ++r ) { vertex_to_rank[ rank_to_vertex_[ r ] ] = r; }
+
+	/* Orient every edge towards its higher-ranked endpoint. */
+	out_offsets_.assign( n + 1, 0 );
+	for( uint32_t r = 0; r < n; ++r ) {
+		uint64_t out_degree = 0;
+		for( uint32_t const v : g.neighbours( rank_to_vertex_[ r ] ) ) {
+			if( vertex_to_rank[ v ] > r ) { ++out_degree; }
+		}
+		out_offsets_[ r + 1 ] = out_offsets_[ r ] + out_degree;
+	}
+	out_neighbours_.resize( out_offsets_[ n ] );
+#pragma omp parallel for schedule( dynamic, 256 )
+	for( uint32_t r = 0; r < n; ++r ) {
+		uint64_t pos = out_offsets_[ r ];
+		for( uint32_t const v : g.neighbours( rank_to_vertex_[ r ] ) ) {
+			if( vertex_to_rank[ v ] > r ) { out_neighbours_[ pos++ ] = vertex_to_rank[ v ]; }
+		}
+		std::sort( out_neighbours_.begin() + out_offsets_[ r ], out_neighbours_.begin() + pos );
+	}
+}
+
+uint64_t TriangleCounter::count() const {
+
+	const uint32_t n = n_;
+	uint32_t const *out = out_neighbours_.data();
+	uint64_t triangles = 0;
+
+	/* Dynamic scheduling: out-degrees, and hence work per rank, are skewed. */
+#pragma omp parallel for reduction( +: triangles ) schedule( dynamic, 64 )
+	for( uint32_t u = 0; u < n; ++u ) {
+		const uint64_t u_first = out_offsets_[ u ];
+		const uint64_t u_size = out_offsets_[ u + 1 ] - u_first;
+		for( uint64_t i = u_first; i < out_offsets_[ u + 1 ]; ++i ) {
+			const uint32_t v = out[ i ];
+			triangles += intersection_size( out + u_first, u_size,
+				out + out_offsets_[ v ], out_offsets_[ v + 1 ] - out_offsets_[ v ] );
+		}
+	}
+	return triangles;
+}
+
+std::vector< uint64_t > TriangleCounter::count_per_vertex() const {
+
+	const uint32_t n = n_;
+	uint32_t const *out = out_neighbours_.data();
+	std::vector< uint64_t > by_rank( n, 0 );
+
+	/* Each triangle u < v < w (by rank) is credited to all three corners. The
+	 * lowest corner u is only ever updated by the thread that owns u, but v and
+	 * w may be shared, so those updates are atomic. */
+#pragma omp parallel for schedule( dynamic, 64 )
+	for( uint32_t u = 0; u < n; ++u ) {
+		uint64_t u_triangles = 0;
+		for( uint64_t i = out_offsets_[ u ]; i < out_offsets_[ u + 1 ]; ++i ) {
+			const uint32_t v = out[ i ];
+			uint64_t a = out_offsets_[ u ], b = out_offsets_[ v ];
+			uint64_t v_triangles = 0;
+			while( a < out_offsets_[ u + 1 ] && b < out_offsets_[ v + 1 ] ) {
+				if( out[ a ] < out[ b ] ) { ++a; }
+				else if( out[ b ] < out[ a ] ) { ++b; }
+				else {
+#pragma omp atomic
+					++by_rank[ out[ a ] ];
+					++v_triangles;
+					++a;
+					++b;
+				}
+			}
+			if( v_triangles > 0 ) {
+#pragma omp atomic
+				by_rank[ v ] += v_triangles;
+				u_triangles += v_triangles;
+			}
+		}
+#pragma omp atomic
+		by_rank[ u ] += u_triangles;
+	}
+
+	/* Translate from ranks back to vertex ids. */
+	std::vector< uint64_t > per_vertex( n );
+	for( uint32_t r = 0; r < n; ++r ) { per_vertex[ rank_to_vertex_[ r ] ] = by_rank[ r ]; }
+	return per_vertex;
+}
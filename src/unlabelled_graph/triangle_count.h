@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Definition of a degree-ordered, sorted-intersection triangle
+ * counting kernel for (local) clustering coefficients.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TRIANGLE_COUNT_H_
+#define TRIANGLE_COUNT_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+
+/**
+ * @brief Counts the triangles of a graph with the compact-forward algorithm.
+ *
+ * Vertices are ranked by ascending degree (ties broken by id) and every edge is
+ * oriented from its lower-ranked to its higher-ranked endpoint. Then each
+ * triangle is found exactly once, from its lowest-ranked vertex u, as a common
+ * out-neighbour w of u and of one of u's out-neighbours v. Because hubs are
+ * ranked last, their out-neighbourhoods are small, which bounds the work by
+ * O( m^1.5 ). The out-neighbourhoods are sorted arrays, intersected by merging
+ * (with AVX2, eight-by-eight blocks at a time).
+ */
+class TriangleCounter {
+public:
+
+	/**
+	 * Constructs a triangle counter for the graph g by building its
+	 * degree-ordered orientation.
+	 * @param g The graph to analyse, which need not outlive this TriangleCounter.
+	 */
+	explicit TriangleCounter( CsrGraph const& g );
+
+	/**
+	 * Constructs a triangle counter for the overlaid graph g by building its
+	 * degree-ordered orientation.
+	 * @param g The graph to analyse, which need not outlive this TriangleCounter.
+	 */
+	explicit TriangleCounter( OverlayView const& g );
+
+	/**
+	 * Counts the triangles in the graph.
+	 * @returns The number of distinct triangles (unordered vertex triples
+	 * that are pairwise adjacent).
+	 */
+	uint64_t count() const;
+
+	/**
+	 * Counts, for every vertex, the triangles of which it is a corner.
+	 * @returns A vector whose v'th element is the number of edges between
+	 * neighbours of vertex v.
+	 */
+	std::vector< uint64_t > count_per_vertex() const;
+
+private:
+
+	/**
+	 * Builds the degree-ordered orientation of g.
+	 */
+	template< typename Graph >
+	void orient( Graph const& g );
+
+	uint32_t n_; /**< The number of vertices in the graph. */
+	std::vector< uint32_t > rank_to_vertex_; /**< Vertex ids in ascending degree order. */
+	std::vector< uint64_t > out_offsets_; /**< Start of each rank's out-neighbours. */
+	std::vector< uint32_t > out_neighbours_; /**< Higher-ranked neighbours, as sorted ranks. */
+};
+
+#endif /* TRIANGLE_COUNT_H_ */
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief A set of functions for unit testing the TriangleCounter class.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for rand */
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "triangle_count.test.h"
+#include "triangle_count.h"
+#include "csr_graph.h"
+
+namespace
+{
+	/**
+	 * Builds a CsrGraph from a symmetric adjacency matrix.
+	 */
+	CsrGraph make_graph( std::vector< std::vector< bool > > const& adjacent ) {
+		std::vector< uint64_t > offsets( 1, 0 );
+		std::vector< uint32_t > neighbours;
+		for( uint32_t u = 0; u < adjacent.size(); ++u ) {
+			for( uint32_t v = 0; v < adjacent.size(); ++v ) {
+				if( adjacent[ u ][ v ] ) { neighbours.push_back( v ); }
+			}
+			offsets.push_back( neighbours.size() );
+		}
+		return CsrGraph( std::move( offsets ), std::move( neighbours ) );
+	}
+}
+
+bool test_triangle_count() {
+
+	bool passed = true;
+
+	/**
+	 * @test Diamond graph
+	 * The diamond graph (K4 minus the edge (1,3)) has two triangles,
+	 * {0,1,2} and {0,2,3}; vertices 0 and 2 are corners of both.
+	 */
+	std::vector< std::vector< bool > > diamond( 4, std::vector< bool >( 4, true ) );
+	for( uint32_t v = 0; v < 4; ++v ) { diamond[ v ][ v ] = false; }
+	diamond[ 1 ][ 3 ] = diamond[ 3 ][ 1 ] = false;
+	CsrGraph const diamond_graph = make_graph( diamond );
+	TriangleCounter const diamond_counter( diamond_graph );
+	std::vector< uint64_t > const expected_diamond { 2, 1, 2, 1 };
+	if( diamond_counter.count() != 2 ) { passed = false; }
+	if( diamond_counter.count_per_vertex() != expected_diamond ) { passed = false; }
+
+	/**
+	 * @test Random graphs with hubs
+	 * Random graphs in which a few vertices are adjacent to most others (so
+	 * that neighbourhoods are long enough for the vectorised intersection to
+	 * apply) should match a brute-force count over all vertex triples.
+	 */
+	for( uint32_t const density : { 5u, 50u } ) {
+		const uint32_t n = 120;
+		std::vector< std::vector< bool > > adjacent( n, std::vector< bool >( n, false ) );
+		for( uint32_t u = 0; u < n; ++u ) {
+			for( uint32_t v = u + 1; v < n; ++v ) {
+				const bool hub = u < 4 && rand() % 10 < 9;
+				if( hub || static_cast< uint32_t >( rand() % 100 ) < density ) {
+					adjacent[ u ][ v ] = adjacent[ v ][ u ] = true;
+				}
+			}
+		}
+
+		uint64_t expected = 0;
+		std::vector< uint64_t > expected_per_vertex( n, 0 );
+		for( uint32_t u = 0; u < n; ++u ) {
+			for( uint32_t v = u + 1; v < n; ++v ) {
+				for( uint32_t w = v + 1; w < n; ++w ) {
+					if( adjacent[ u ][ v ] && adjacent[ v ][ w ] && adjacent[ u ][ w ] ) {
+						++expected;
+						++expected_per_vertex[ u ];
+						++expected_per_vertex[ v ];
+						++expected_per_vertex[ w ];
+					}
+				}
+			}
+		}
+
+		CsrGraph const g = make_graph( adjacent );
+		TriangleCounter const counter( g );
+		if( counter.count() != expected ) { passed = false; }
+		if( counter.count_per_vertex() != expected_per_vertex ) { passed = false; }
+	}
+
+	return passed;
+}
@@ -30,12 +30,12 @@
 
 
 #include <cstdint>		/* for uint32_t */
-#include <algorithm>	/* for random_shuffle */
-#include <iostream>		/* for cout, endl */
-#include <cstdlib>		/* for srand, rand */
+#include <algorithm>	/* for std::sort, std::transform */
+#include <ostream>		/* for std::ostream */
+#include <cstdlib>		/* for rand */
 #include <cstring>		/* for ffs and std::string */
 #include <fstream>		/* for ifstream, infile */
-#include <sstream>		/* for istringstream, getline */
+#include <random>		/* for std::mt19937_64 */
 
 /* STL stuff in use. */
 #include <vector>
@@ -43,11 +43,19 @@
 #include <unordered_map>
 #include <queue>
 
-#include <numeric>		/* for std::accumulate() */
 
 #include "omp.h"
 
 #include "unlabelled_graph.h" /* implementing this class. */
+#include "graph_loader.h"
+#include "binary_format.h"
+#include "all_pairs_bfs.h"
+#include "subgraph_centrality.h"
+#include "triangle_count.h"
+#include "graph_analysis.h"
+#include "random_graph.h"
+#include "concurrent_adjacency_builder.h"
+#include "scratch_arena.h"
 
 void UnlabelledGraph::init() {
 	
@@ -55,9 +63,7 @@ void UnlabelledGraph::init() {
 
 	/* Originally, there are no edges yet (every vertex is isolated). */
 	m_ = 0;
-
-	/* initialize random seed for generating random edges later */
-	srand (time(NULL));
+	degree_histogram_.reset( n_ );
 }
 
 UnlabelledGraph::UnlabelledGraph( const uint32_t num_vertices ) :
@@ -70,164 +76,251 @@ UnlabelledGraph::UnlabelledGraph() : n_ ( 0 ),
 UnlabelledGraph::UnlabelledGraph( const std::string filename, graphAnon::FileFormat format )
 	: io_format_( format )
 {
-	std::string line;
-	std::cout << filename << std::endl;
-	std::ifstream infile( filename );
-
-	/* first parse the graph and label alphabet sizes from
-	 * the first line of the file
-	 */
-	std::getline( infile, line );
-	std::istringstream iss( line );
-	iss >> n_;
-
-	/* check whether n_ was at least read correctly -- the only real
-	 * error checking done in this constructor.
-	 */
-	if( n_ <= 0 ) {
-		std::cerr << "Did not parse a positive number of vertices from input file. "
-				<< "Did you format the file correctly and specify the correct path?"
-				<< std::endl;
+	GRAPHANON_PROFILE_PHASE( "load" );
+
+	/* Parse the whole file in bulk. The only real error checking done in
+	 * this constructor is whether a positive number of vertices was read,
+	 * which the caller can check with num_vertices(). */
+	GraphLoader loader( filename );
+	bool loaded;
+	{
+		GRAPHANON_PROFILE_PHASE( "parse" );
+		loaded = loader.load( io_format_ );
+	}
+	if( !loaded ) {
+		n_ = 0;
+		init();
 		return;
 	}
 
 	/* Init like other constructors now that the data structure sizes
-	 * are known.
-	 */
+	 * are known, and then adopt the parsed edges. */
+	n_ = loader.num_vertices();
 	init();
-	
-	if( io_format_ == graphAnon::FileFormat::adjacencyList 
-		|| io_format_ == graphAnon::FileFormat::adjacencyListVertexLabelled )
-	{
-	
-		uint32_t v;
-			
-		/* check if extra meta data for label set size and throw out. */
-		if( io_format_ == graphAnon::FileFormat::adjacencyListVertexLabelled ) {
-			iss >> v;
-		}
-
-		/* Iterate exactly enough times to fill the data structures,
-		 * irrespective of the length of the file. Each iteration handles
-		 * one vertex, and the file is assumed to be sorted by increasing vertex
-		 * id, with all vertex ids represented as integers in a contiguous sequence
-		 * starting from 0.
-		 */
-		for( uint32_t u = 0; u < n_; ++u ) {
-
-			/* grab line related to vertex u. */
-			std::getline( infile, line );
-			std::istringstream iss( line );
-			
-			/* if labelled, throw out label first. */
-			if( io_format_ == graphAnon::FileFormat::adjacencyListVertexLabelled ) {
-				iss >> v;
-			}
-
-			/* all numbers on the adjacency list line
-			 * neighbours of u: add them to u's adjacency list.
-			 * Note: undirected graph, so also reciprocally adds
-			 * (v, u), even if that isn't in the input file
-			 */
-			while( iss >> v ) { add_edge( u, v ); }
-		}
-	}
-	else if( io_format_ == graphAnon::FileFormat::edgeList ) {
-		uint32_t u, v;
-		/* Iterate every edge in the input file. */
-		while( std::getline( infile, line ) ) {
-			std::istringstream iss( line );
-			iss >> u >> v;
-			add_edge( u, v );
-		}
-	}
+	assign_csr( std::move( loader.csr() ) );
 }
 
 UnlabelledGraph::~UnlabelledGraph() {}
 
 uint32_t UnlabelledGraph::num_vertices() const { return n_; }
-uint32_t UnlabelledGraph::num_edges() const { return m_; }
+uint64_t UnlabelledGraph::num_edges() const { return m_; }
 
 bool UnlabelledGraph::add_edge( const uint32_t u, const uint32_t v ) {
 	if( adjacency_list_[ u ].count( v ) > 0 || u == v ) { return false; }
 	if( adjacency_list_[ v ].count( u ) > 0 ) { return false; }
-	adjacency_list_[ u ].insert( v );
-	adjacency_list_[ v ].insert( u );
+	insert_neighbour( u, v );
+	insert_neighbour( v, u );
 	++m_;
+	GRAPHANON_PROFILE_COUNT( edges_added, 1 );
+	csr_.reset();
+	if( degree_histogram_.is_built() ) {
+		degree_histogram_.increment( adjacency_list_[ u ].size() - 1 );
+		degree_histogram_.increment( adjacency_list_[ v ].size() - 1 );
+	}
 	return true;
 }
 
+void UnlabelledGraph::assign_csr( CsrGraph &&g ) {
+	GRAPHANON_PROFILE_PHASE( "adjacency" );
+
+	n_ = g.num_vertices();
+	m_ = g.num_edges();
+	adjacency_list_ = AdjacencyList( n_ );
+#pragma omp parallel for schedule( dynamic, 256 )
+	for( uint32_t u = 0; u < n_; ++u ) {
+		NeighbourRange const neighbours = g.neighbours( u );
+		adjacency_list_[ u ].reserve( neighbours.size() );
+		adjacency_list_[ u ].insert( neighbours.begin(), neighbours.end() );
+	}
+
+	/* The snapshot is already built, so keep it. */
+	csr_ = std::make_shared< const CsrGraph >( std::move( g ) );
+	degree_histogram_.invalidate();
+}
+
+uint64_t UnlabelledGraph::commit_edges( ConcurrentAdjacencyBuilder *builder ) {
+	const uint64_t num_inserted = builder->commit();
+	m_ += num_inserted;
+	csr_.reset();
+	degree_histogram_.invalidate();
+	return num_inserted;
+}
+
 void UnlabelledGraph::add_vertices( const uint32_t num_vertices ) {
 
 	n_ += num_vertices;
 	adjacency_list_.resize( n_ );
+	csr_.reset();
+	if( degree_histogram_.is_built() ) { degree_histogram_.add_vertices( num_vertices ); }
+}
+
+void UnlabelledGraph::reorder( const graphAnon::VertexOrder order ) {
+	if( order == graphAnon::VertexOrder::none ) { return; }
+	GRAPHANON_PROFILE_PHASE( "reorder" );
+
+	std::vector< uint32_t > const new_id = graphAnon::order_vertices( csr(), order );
+	permute_vertex_data( new_id );
+
+	/* Compose with any earlier reordering, so that ids still map to the input. */
+	std::vector< uint32_t > original_ids( n_ );
+	for( uint32_t v = 0; v < n_; ++v ) { original_ids[ new_id[ v ] ] = original_id( v ); }
+	internal_ids_ = graphAnon::invert_permutation( original_ids );
+	original_ids_ = std::move( original_ids );
+
+	assign_csr( graphAnon::permute_vertices( csr(), new_id ) );
+}
+
+void UnlabelledGraph::permute_vertex_data( std::vector< uint32_t > const& ) {}
+
+void UnlabelledGraph::freeze() {
+	GRAPHANON_PROFILE_PHASE( "freeze" );
+
+	/* Prefix-sum the degrees to find where each neighbour list starts. */
+	std::vector< uint64_t > offsets( n_ + 1 );
+	offsets[ 0 ] = 0;
+	for( uint32_t u = 0; u < n_; ++u ) {
+		offsets[ u + 1 ] = offsets[ u ] + adjacency_list_[ u ].size();
+	}
+
+	/* Then copy each neighbour list into its slice and sort it. */
+	std::vector< uint32_t > neighbours( offsets[ n_ ] );
+#pragma omp parallel for schedule( dynamic, 256 )
+	for( uint32_t u = 0; u < n_; ++u ) {
+		auto const first = neighbours.begin() + offsets[ u ];
+		std::copy( adjacency_list_[ u ].cbegin(), adjacency_list_[ u ].cend(), first );
+		std::sort( first, neighbours.begin() + offsets[ u + 1 ] );
+	}
+
+	csr_ = std::make_shared< const CsrGraph >( std::move( offsets ), std::move( neighbours ) );
+}
+
+CsrGraph const& UnlabelledGraph::csr() const {
+	if( !csr_ ) { const_cast< UnlabelledGraph* >( this )->freeze(); }
+	return *csr_;
+}
+
+std::shared_ptr< const CsrGraph > UnlabelledGraph::snapshot() const {
+	csr();
+	return csr_;
+}
+
+void UnlabelledGraph::apply( IdentityPlan const& plan, DegreeSequence const& degrees ) {
+	if( plan.num_new_vertices() == 0 ) { return; }
+	GRAPHANON_PROFILE_PHASE( "insert_edges" );
+	const uint32_t first_new_vertex = n_;
+	add_vertices( plan.num_new_vertices() );
+
+	/* Generating the edges is cheap; inserting them is done in parallel. */
+	ConcurrentAdjacencyBuilder builder( &adjacency_list_ );
+	plan.generate_edges( degrees, first_new_vertex,
+		[ &builder ]( const uint32_t u, const uint32_t v ) { builder.add_edge( u, v ); } );
+	commit_edges( &builder );
 }
 
 void UnlabelledGraph::add_random_edge() {
 
 	/* Error checking -- are there edges to add? */
 	if( is_complete() ) { return; }
+	GRAPHANON_PROFILE_COUNT( random_edge_fallbacks, 1 );
 
-	while( true ) {
+	/* A random pair is usually new, unless the graph is nearly complete. */
+	const uint32_t max_draws = 64;
+	for( uint32_t draw = 0; draw < max_draws; ++draw ) {
 		/* get random edge */
 		const uint32_t u = rand() % n_;
 		const uint32_t v = rand() % n_;
 
 		/* add it if it doesn't yet exist */
 		if ( add_edge( u, v ) ) { return; }
+		GRAPHANON_PROFILE_COUNT( rejection_retries, 1 );
+	}
+
+	/* Otherwise, choose among the missing edges directly in O( n ): u with
+	 * probability proportional to its number of non-neighbours, and then one
+	 * of those uniformly, so that every missing edge remains equally likely. */
+	uint64_t num_missing = 0;
+	for( uint32_t u = 0; u < n_; ++u ) { num_missing += n_ - 1 - adjacency_list_[ u ].size(); }
+	if( num_missing == 0 ) { return; }
+	uint64_t r = ( ( static_cast< uint64_t >( rand() ) << 31 ) ^ rand() ) % num_missing;
+	uint32_t u = 0;
+	while( r >= n_ - 1 - adjacency_list_[ u ].size() ) { r -= n_ - 1 - adjacency_list_[ u++ ].size(); }
+	for( uint32_t v = 0; v < n_; ++v ) {
+		if( v != u && adjacency_list_[ u ].count( v ) == 0 && r-- == 0 ) {
+			add_edge( u, v );
+			return;
+		}
 	}
 }
 
 
-bool UnlabelledGraph::populate_uniformly( const uint32_t num_edges ) {
+bool UnlabelledGraph::populate_uniformly( const uint64_t num_edges, const uint64_t seed ) {
 	/* error checking: can we add this many edges? */
-	if ( num_edges > n_ * ( n_ - 1 ) - m_ ) { return false; }
+	const uint64_t missing_edges = graphAnon::num_vertex_pairs( n_ ) - m_;
+	if ( num_edges > missing_edges ) { return false; }
+	GRAPHANON_PROFILE_PHASE( "generate" );
 
-	/* create a list of all possible edges and randomly shuffle the list */
-	std::vector< std::pair < uint32_t, uint32_t > > possible_edges;
-	for( uint32_t i = 0; i < n_; ++i ) {
-		for( uint32_t j = i + 1; j < n_; ++j ) {
-			possible_edges.push_back( std::pair< uint32_t, uint32_t > ( i, j ) );
+	if( m_ == 0 ) {
+		assign_csr( graphAnon::random_gnm( n_, num_edges, seed ) );
+		return true;
+	}
+
+	std::mt19937_64 rng( seed );
+	if( 2 * num_edges <= missing_edges ) {
+		/* Sparse enough that random pairs are mostly new. */
+		std::uniform_int_distribution< uint32_t > vertex( 0, n_ - 1 );
+		for( uint64_t num_added = 0; num_added < num_edges; ) {
+			const uint32_t u = vertex( rng ), v = vertex( rng );
+			if( add_edge( u, v ) ) { ++num_added; }
+			else { GRAPHANON_PROFILE_COUNT( rejection_retries, 1 ); }
 		}
+		return true;
 	}
-	std::random_shuffle( possible_edges.begin(), possible_edges.end() );
-
-	/* Add the first num_edges randomly shuffled edges that do not already
-	 * exist in the graph.
-	 */
-	uint32_t num_added = 0;
-	for( auto const& e : possible_edges ) {
-		if ( add_edge( e.first, e.second ) ) {
-			if( ++num_added == num_edges ) { return true; } /* Done! */
+
+	/* Otherwise, list the missing edges and add a random num_edges of them. */
+	std::vector< std::pair< uint32_t, uint32_t > > missing;
+	missing.reserve( missing_edges );
+	for( uint32_t u = 0; u < n_; ++u ) {
+		for( uint32_t v = u + 1; v < n_; ++v ) {
+			if( adjacency_list_[ u ].count( v ) == 0 ) { missing.push_back( std::make_pair( u, v ) ); }
 		}
 	}
-	return false; /* should be an unreachable statement! */
+	for( uint64_t i = 0; i < num_edges; ++i ) {
+		std::swap( missing[ i ],
+			missing[ std::uniform_int_distribution< uint64_t >( i, missing.size() - 1 )( rng ) ] );
+		add_edge( missing[ i ].first, missing[ i ].second );
+	}
+	return true;
 }
 
-bool UnlabelledGraph::is_complete() const { return m_ == n_ * ( n_ - 1 ); }
+void UnlabelledGraph::populate_binomially( const double probability, const uint64_t seed ) {
+	GRAPHANON_PROFILE_PHASE( "generate" );
+	CsrGraph random = graphAnon::random_gnp( n_, probability, seed );
+	if( m_ == 0 ) {
+		assign_csr( std::move( random ) );
+		return;
+	}
+	for( uint32_t u = 0; u < n_; ++u ) {
+		for( uint32_t const v : random.neighbours( u ) ) {
+			if( u < v ) { add_edge( u, v ); }
+		}
+	}
+}
+
+bool UnlabelledGraph::is_complete() const { return m_ == graphAnon::num_vertex_pairs( n_ ); }
 
 bool UnlabelledGraph::is_anonymous( const uint32_t k ) const {
 
-	/* First calculate the counts for every degree in the graph. */
-	std::unordered_map< uint32_t, uint32_t > degree_counts;
-	for( auto const& neighbours : adjacency_list_ ) {
-		const uint32_t next_degree = neighbours.size();
-		if( degree_counts.count( next_degree ) == 0 ) {
-			degree_counts[ next_degree ] = 1;
-		}
-		else { ++degree_counts[ next_degree ]; }
-	}
-	
-	/* Then ensure every count is at least k. */
-	for( auto const count : degree_counts ) {
-		if( count.second < k ) { return false; }
+	/* Count the degrees once after a bulk change; edge insertions keep them current. */
+	if( !degree_histogram_.is_built() ) {
+		degree_histogram_.reset( n_ );
+		for( uint32_t u = 0; u < n_; ++u ) { degree_histogram_.move( 0, adjacency_list_[ u ].size() ); }
 	}
-	return true;
+	return degree_histogram_.is_anonymous( k );
 }
 
 float UnlabelledGraph::get_occupancy() const {
-	if( n_ == 0 ) { return 0; }
-	else return m_ / static_cast< float >( ( n_ * ( n_ - 1 ) ) * 2 ); /* x2 because undirected */
+	if( n_ < 2 ) { return 0; }
+	else return static_cast< double >( m_ ) / graphAnon::num_vertex_pairs( n_ ); /* pairs, because undirected */
 }
 
 
@@ -266,8 +359,8 @@ int UnlabelledGraph::calculate_path_length( uint32_t u, uint32_t v ) const {
 		}
 		/* Otherwise, push it onto the queue for revisiting in breadth-first order. */
 		else {
-			q.push( std::make_pair( v, 1 ) );
-			visited.insert( v );
+			q.push( std::make_pair( neighbour, 1 ) );
+			visited.insert( neighbour );
 		}
 	}
 	
@@ -294,32 +387,22 @@ int UnlabelledGraph::calculate_path_length( uint32_t u, uint32_t v ) const {
 }
 
 float UnlabelledGraph::clustering_coefficient() const {
-	
-	uint64_t closed_triangles = 0;
+	return graphAnon::clustering_coefficient( csr() );
+}
 
-	/* First count denominator -- how many open triangles exist. */
-	uint64_t possible_triangles = std::accumulate( 
-		adjacency_list_.cbegin(), adjacency_list_.cend(), 0llu,
-		[]( auto const sum, auto const& neighbour_list )
-		{
-			return sum + neighbour_list.size() * ( neighbour_list.size() - 1 );
-		}
-	);
+std::vector< float > UnlabelledGraph::local_clustering_coefficients() const {
 
-	
-	/* Then count numerator -- how many closed triangles exist. */
-#pragma omp parallel for reduction( +: closed_triangles )
-	for( uint32_t u = 0; u < n_; ++u ) {
-		for( auto v = adjacency_list_[ u ].begin(); v != adjacency_list_[ u ].end(); ++v ) {
-			for( auto w = adjacency_list_[ u ].begin(); w != adjacency_list_[ u ].end(); ++w ) {
-				if( *v == *w ) { continue; }
-				auto closure = std::find( adjacency_list_[ *v ].begin(), adjacency_list_[ *v ].end(), *w );
-				if( closure != adjacency_list_[ *v ].end() ) { ++closed_triangles; } 
-			}
+	CsrGraph const& g = csr();
+	std::vector< uint64_t > const triangles = TriangleCounter( g ).count_per_vertex();
+
+	std::vector< float > coefficients( n_, 0 );
+	for( uint32_t v = 0; v < n_; ++v ) {
+		const uint64_t degree = g.degree( v );
+		if( degree > 1 ) {
+			coefficients[ v ] = 2 * triangles[ v ] / static_cast< float >( degree * ( degree - 1 ) );
 		}
 	}
-	
-	return closed_triangles / static_cast< float >( possible_triangles );
+	return coefficients;
 }
 
 float UnlabelledGraph::clustering_coefficient_brute_force() const {
@@ -349,84 +432,11 @@ float UnlabelledGraph::clustering_coefficient_brute_force() const {
 }
 
 
-HopPlot UnlabelledGraph::hop_plot() const {
-
-	std::unordered_set< uint32_t > visited;
-	std::queue< std::pair< uint32_t, uint32_t > > q; /* (vertex, path length) pairs. */	
-	uint32_t num_threads;
-	
-#pragma omp parallel 
-	{
-		num_threads = omp_get_num_threads();
-	}
-	std::vector< HopPlot > hopplots( num_threads );
-	
-#pragma omp parallel for private( visited, q )
-	for( uint32_t i = 0; i < n_; ++i ) {
-		
-		HopPlot & my_hop_plot = hopplots[ omp_get_thread_num() ];
-
-		/* clear queue and visited set, although set i so we don't loop. */
-		visited.clear();
-		visited.insert( i );
-	
-		/* Init queue to contain all direct neighbours of vertex i. */
-		for( auto const neighbour : adjacency_list_[ i ] ) {
-			q.push( std::make_pair( neighbour, 1 ) );
-			visited.insert( neighbour );
-		}
-		/* Add all neighbours of i to hop plot score = 1. */
-		if( my_hop_plot.count( 1 ) == 1 ) { my_hop_plot.at( 1 ) += adjacency_list_[ i ].size(); }
-		else { ( my_hop_plot)[ 1 ] = adjacency_list_[ i ].size(); }
-	
-		/* Iterate breadth-first through remaining paths. */
-		while( ! q.empty() ) {
-			const uint32_t v = q.front().first;
-			const uint32_t d = q.front().second;
-			q.pop();
-		
-			for( auto const neighbour : adjacency_list_[ v ] ) {
-				if( visited.count( neighbour ) == 0 ) {
-					visited.insert( neighbour );
-					q.push( std::make_pair( neighbour, d + 1 ) );
-
-					if( my_hop_plot.count( d + 1 ) == 0 ) { my_hop_plot[ d + 1 ] = 1; }
-					else { ++my_hop_plot.at( d + 1 ); }
-				}
-			}
-		}
-	}
-		
-	/* Reduce all the hop plots from each thread. */
-	auto & result = hopplots[ 0 ];
-	std::for_each( std::next( hopplots.cbegin(), 1 ), hopplots.cend(),
-		[ &result ]( auto const& hopplot )
-		{
-			for( auto const& hp_entry : hopplot ) {
-				if( result.count( hp_entry.first ) == 0 )
-				{
-					result.insert( std::make_pair( hp_entry.first, hp_entry.second ) );
-				}
-				else
-				{
-					result[ hp_entry.first ] += hp_entry.second;
-				}
-			}
-	} );
-	return result;
-}
+HopPlot UnlabelledGraph::hop_plot() const { return graphAnon::hop_plot( csr() ); }
 
 
 float UnlabelledGraph::harmonic_mean( HopPlot const& hop_plot ) const {
-	
-	float const mean = std::accumulate( hop_plot.cbegin(), hop_plot.cend(), 0.0,
-		[]( float const f, auto const& hp )
-		{
-			return f + hp.second / static_cast< float >( hp.first );
-		}
-	);
-
-	return mean == 0 ? -1.0 : n_ * ( n_ - 1 ) / mean;
+	return graphAnon::harmonic_mean( hop_plot, n_ );
 }
 
 /* Computes sc by repeatedly exponentiating matrix and summing diagonals. */
@@ -436,21 +446,23 @@ double UnlabelledGraph::subgraph_centrality( const uint32_t limit ) const {
 	
 	/* First, create double-buffer adjacency matrix explicitly. 
 	 * Need doubles to avoid overflow in matrix. */
-	double *adjacency_matrix = new double[ n_ * n_ ];
-	double *adjacency_matrix_to_lth = new double[ n_ * n_ ];
-	double *new_values = new double[ n_ * n_ ];
+	const uint64_t cells = static_cast< uint64_t >( n_ ) * n_;
+	double *adjacency_matrix = new double[ cells ];
+	double *adjacency_matrix_to_lth = new double[ cells ];
+	double *new_values = new double[ cells ];
 	
 	/* Populate adjacency matrix. */
+	CsrGraph const& g = csr();
 #pragma omp parallel for
 	for( uint32_t i = 0; i < n_; ++i ) {
-		const uint32_t offset = i * n_;
+		const uint64_t offset = static_cast< uint64_t >( i ) * n_;
 		
 		for( uint32_t j = 0; j < n_; ++j ) {
 			adjacency_matrix[ offset + j ] = 0;
 			adjacency_matrix_to_lth[ offset + j ] = 0;
 		}
 		
-		for( auto const neighbour : adjacency_list_[ i ] ) {
+		for( auto const neighbour : g.neighbours( i ) ) {
 			adjacency_matrix[ offset + neighbour ] = 1;
 			adjacency_matrix_to_lth[ offset + neighbour ] = 1;
 		}
@@ -463,11 +475,11 @@ double UnlabelledGraph::subgraph_centrality( const uint32_t limit ) const {
 		/* Raise adjacency matrix to next power. */
 #pragma omp parallel for reduction ( +: summation )
 		for( uint32_t i = 0; i < n_; ++i ) {
-			const uint32_t row_offset = i * n_;
+			const uint64_t row_offset = static_cast< uint64_t >( i ) * n_;
 			for( uint32_t j = 0; j < n_; ++j ) {
 				double cell_value = 0;
 				for( uint32_t k = 0; k < n_; ++k ) {
-					const uint32_t transpose_offset = k * n_;
+					const uint64_t transpose_offset = static_cast< uint64_t >( k ) * n_;
 					cell_value += adjacency_matrix[ row_offset + k ] 
 											* adjacency_matrix_to_lth[ transpose_offset + j];
 				}
@@ -490,30 +502,91 @@ double UnlabelledGraph::subgraph_centrality( const uint32_t limit ) const {
 	return summation / n_;
 }
 
-std::ostream& operator << ( std::ostream& os, UnlabelledGraph const& g )
-{
-	// Just ignoring the vertex labels	
-	os << g.n_ << std::endl;
-
-	for( uint32_t u = 0; u < g.n_; ++u ) {
-		for( uint32_t const v : g.adjacency_list_[ u ] )
-		{
-			if( u <= v ) // only print undirected
-			{
-				if( g.io_format_ == graphAnon::FileFormat::edgeList )
-				{
-					os << u << " " << v << std::endl;
-				}
-				else
-				{
-					os << v << " ";
-				}
+double UnlabelledGraph::sparse_subgraph_centrality( const double relative_tolerance ) const {
+	return SubgraphCentrality( csr() ).estimate( relative_tolerance );
+}
+
+void UnlabelledGraph::format_header( const graphAnon::FileFormat, std::string *buffer ) const {
+	GraphWriter::append( buffer, n_ );
+	buffer->push_back( '\n' );
+}
+
+void UnlabelledGraph::format_vertex( const uint32_t u, const graphAnon::FileFormat format,
+	std::string *buffer ) const {
+
+	// Just ignoring the vertex labels
+	const uint32_t original_u = original_id( u );
+	ScratchArena::Scope scratch;
+	uint32_t const *const neighbours = sorted_neighbours( u );
+	for( size_t i = 0; i < adjacency_list_[ u ].size(); ++i ) {
+		const uint32_t v = neighbours[ i ];
+		if( original_u <= v ) { // only print undirected
+			if( format == graphAnon::FileFormat::edgeList ) {
+				GraphWriter::append( buffer, original_u );
+				buffer->push_back( ' ' );
+				GraphWriter::append( buffer, v );
+				buffer->push_back( '\n' );
+			}
+			else {
+				GraphWriter::append( buffer, v );
+				buffer->push_back( ' ' );
 			}
 		}
-		if( g.io_format_ != graphAnon::FileFormat::edgeList )
-		{	
-			os << std::endl;
+	}
+	if( format != graphAnon::FileFormat::edgeList ) { buffer->push_back( '\n' ); }
+}
+
+uint32_t* UnlabelledGraph::sorted_neighbours( const uint32_t u ) const {
+	NeighbourList const& list = adjacency_list_[ u ];
+	uint32_t *const neighbours = ScratchArena::local().allocate< uint32_t >( list.size() );
+	std::transform( list.begin(), list.end(), neighbours,
+		[ this ]( const uint32_t v ) { return original_id( v ); } );
+	std::sort( neighbours, neighbours + list.size() );
+	return neighbours;
+}
+
+bool UnlabelledGraph::write_text( GraphWriter *writer, const graphAnon::FileFormat format ) const {
+	std::string header;
+	format_header( format, &header );
+	return writer->write( header, n_, [ this, format ]( const uint32_t i, std::string *buffer ) {
+		format_vertex( internal_id( i ), format, buffer );
+	} );
+}
+
+bool UnlabelledGraph::write( const std::string filename, const graphAnon::FileFormat format,
+	const bool varint, const graphAnon::Compression compression ) const {
+
+	if( format == graphAnon::FileFormat::binary ) {
+		if( compression != graphAnon::Compression::none ) { return false; }
+		if( original_ids_.empty() ) {
+			return write_binary_graph( filename, csr(), output_labels(), output_num_labels(), varint );
 		}
+
+		/* Permute the graph (and any labels) back into the ids of the input. */
+		std::vector< uint32_t > new_id( n_ );
+		for( uint32_t v = 0; v < n_; ++v ) { new_id[ v ] = original_id( v ); }
+		CsrGraph const original = graphAnon::permute_vertices( csr(), new_id );
+		std::vector< uint32_t > const *labels = output_labels();
+		std::vector< uint32_t > original_labels;
+		if( labels != NULL ) {
+			original_labels.resize( n_ );
+			for( uint32_t v = 0; v < n_; ++v ) { original_labels[ new_id[ v ] ] = ( *labels )[ v ]; }
+			labels = &original_labels;
+		}
+		return write_binary_graph( filename, original, labels, output_num_labels(), varint );
 	}
+	GraphWriter writer( filename, compression );
+	const bool written = writer.is_open() && write_text( &writer, format );
+	return writer.close() && written;
+}
+
+std::vector< uint32_t > const* UnlabelledGraph::output_labels() const { return NULL; }
+
+uint32_t UnlabelledGraph::output_num_labels() const { return 0; }
+
+std::ostream& operator << ( std::ostream& os, UnlabelledGraph const& g )
+{
+	GraphWriter writer( &os );
+	g.write_text( &writer, g.io_format_ );
 	return os;
 }
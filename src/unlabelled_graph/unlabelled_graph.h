@@ -34,8 +34,18 @@
 
 /* STL libraries in use */
 #include <vector>
-#include <unordered_set>
 #include <map>
+#include <memory>
+
+#include "csr_graph.h"
+#include "neighbour_list.h"
+#include "vertex_order.h"
+#include "graph_writer.h"
+#include "degree_anonymiser.h" /* for DegreeSequence */
+#include "identity_plan.h"
+#include "graph_analysis.h" /* for HopPlot */
+#include "degree_histogram.h"
+#include "profile.h"
 
 namespace graphAnon
 {
@@ -85,31 +95,20 @@ namespace graphAnon
 		 * 3 1 
 		 * 3 2</pre>
 		 */		
-		edgeList
+		edgeList,
+
+		/**
+		 * The file is a compact, versioned binary image of the graph's CSR arrays
+		 * (optionally delta+varint compressed, and optionally with vertex labels),
+		 * which is memory-mapped rather than parsed when read.
+		 * @see BinaryGraphHeader in binary_format.h for the layout.
+		 */
+		binary
 	};
 }
 
 
-/**
- * A HopPlot is a histogram of path lengths in a graph.
- * It maps from each integer i = 1,... the number of 
- * vertex pairs in the graph that are reachable with a 
- * shortest path of exactly i hops.
- */
-typedef std::map< uint32_t, uint64_t > HopPlot;
-
-/**
- * A DegreeSequence is a list of the degrees for each of the n_ 
- * vertices in a graph, sorted in descending order.
- */
-typedef std::vector< std::pair< uint32_t, uint32_t > > DegreeSequence;
-
-/**
- * A NeighbourList is a set of neighbours for a given vertex. 
- * If vertex i is in the list, then the vertex to whom this 
- * NeighbourList is associated is connected to vertex i.
- */
-typedef std::unordered_set < uint32_t > NeighbourList;
+class ConcurrentAdjacencyBuilder;
 
 /**
  * An AdjacencyList is a format for representing the connectivity of 
@@ -133,6 +132,8 @@ public:
 	 * @warning Does minimal error-checking. If the file format is
 	 * invalid or filename is an incorrect path, then the behaviour
 	 * of this constructor is undefined.
+	 * @note Writes nothing to stdout or stderr: if no vertices could be
+	 * parsed (e.g., filename is an incorrect path), the graph is empty.
 	 * @see <a href="../../workloads/snam_example.adjList">An example file</a>
 	 * consisting of the example UnlabelledGraph from Figure 1 of @cite waldo ,
 	 * represented in the adjacency list format.
@@ -173,36 +174,105 @@ public:
 	/**
 	 * Accessor method to retrieve the number of edges in the graph, |E|.
 	 */
-	uint32_t num_edges() const;
+	uint64_t num_edges() const;
 
 	/**
 	 * Populates the UnlabelledGraph with num_edges undirected edges, 
 	 * randomly chosen with uniform distribution.
 	 * @param num_edges The number of edges to insert into the graph.
+	 * @param seed Seeds the random choice of edges.
 	 * @returns false if num_edges cannot be inserted; true otherwise.
 	 * @post The graph contains num_edges more edges than it had before the
 	 * method was invoked, unless it is impossible to add num_edges more edges
 	 * to the graph (then no edges are added).
 	 *
-	 * This method iterates , picking two vertices u,v uniformly at random.
-	 * If the edge (u,v) does not yet exist, it is added. Once num_edges
-	 * successful edge additions have taken place, the routine terminates. If
-	 * num_edges > n * (n - 1) - the number of edges already in the graph, the
-	 * method returns false (failure).
+	 * If num_edges > n * (n - 1) / 2 - the number of edges already in the
+	 * graph, the method returns false (failure). An edgeless graph becomes a
+	 * G( n, m ) graph from graphAnon::random_gnm() in bulk. Otherwise, two
+	 * vertices u,v are picked uniformly at random and (u,v) is added if it
+	 * does not yet exist, until num_edges have been added (or, if that would
+	 * fill more than half of the graph, num_edges of the missing edges are
+	 * chosen directly).
+	 */
+	bool populate_uniformly( const uint64_t num_edges, const uint64_t seed );
+
+	/**
+	 * Adds each missing undirected edge independently with probability p.
+	 * @param probability The edge probability, p.
+	 * @param seed Seeds the random choice of edges.
+	 * @post An edgeless graph becomes a G( n, p ) graph.
+	 * @see graphAnon::random_gnp()
 	 */
-	bool populate_uniformly( const uint32_t num_edges );
+	void populate_binomially( const double probability, const uint64_t seed );
 
 	/**
 	 * Retrieves the percentage of possible edges tha are present in the graph.
 	 * @return If E is the edge set and V is the vertex set, the return value is
-	 * |E| / |V| / ( |V| - 1 ). Will also return 0 if |V| = 0.
+	 * |E| / ( |V| ( |V| - 1 ) / 2 ). Will also return 0 if |V| < 2.
 	 */
 	float get_occupancy() const;
 	
+	/**
+	 * Freezes the current adjacency list into an immutable CsrGraph snapshot
+	 * over which the analysis routines (clustering_coefficient(), hop_plot(),
+	 * subgraph_centrality(), and is_anonymous()) run.
+	 * @post csr() returns a snapshot consistent with the current edge set.
+	 * @note The snapshot is discarded by any subsequent mutation of the graph
+	 * (e.g., add_edge() or add_vertices()), so this should be invoked once
+	 * loading and anonymisation are done. The analysis routines freeze the
+	 * graph on demand if necessary.
+	 */
+	void freeze();
+
+	/**
+	 * Retrieves the immutable CsrGraph snapshot of this graph, first
+	 * freezing the graph if it has been mutated since the last snapshot.
+	 * @see freeze()
+	 */
+	CsrGraph const& csr() const;
+
+	/**
+	 * Retrieves a shared handle to the snapshot returned by csr(), which stays
+	 * valid (and unchanged) even after the graph is next modified.
+	 */
+	std::shared_ptr< const CsrGraph > snapshot() const;
+
+	/**
+	 * Relabels the vertices, so that the analysis routines and the
+	 * anonymisation algorithms scan neighbourhoods with better locality.
+	 * @param order The relabelling to apply.
+	 * @post Vertex ids (e.g., of csr()) refer to the new labels, but every
+	 * output (operator<<, write(), and LabelledGraph::print()) still uses the
+	 * ids of the input, with any vertices added later numbered after them.
+	 * @see graphAnon::order_vertices()
+	 */
+	void reorder( const graphAnon::VertexOrder order );
+
+	/**
+	 * Retrieves the id with which vertex v is written out, i.e., its id in
+	 * the input if the graph has been reordered since.
+	 */
+	uint32_t original_id( const uint32_t v ) const {
+		return v < original_ids_.size() ? original_ids_[ v ] : v;
+	}
+
 	/**
 	 * Calculates the clustering coefficient of the graph.
+	 * @returns The fraction of ordered pairs of neighbours (v,w) of a common
+	 * vertex u for which v and w are also neighbours (i.e., six times the 
+	 * number of triangles over the number of paths of length two).
+	 * @see TriangleCounter
 	 */
 	float clustering_coefficient() const;
+
+	/**
+	 * Calculates the local clustering coefficient of every vertex.
+	 * @returns A vector whose v'th element is the fraction of pairs of 
+	 * neighbours of v that are themselves neighbours, or 0 if v has 
+	 * fewer than two neighbours.
+	 * @see TriangleCounter
+	 */
+	std::vector< float > local_clustering_coefficients() const;
 	
 	/**
 	 * Calculates the harmonic mean of the graph from a hop plot.
@@ -232,8 +302,22 @@ public:
 	 * @param limit The maximum length walk over which to compute subgraph 
 	 * centrality.
 	 * @returns The subgraph centrality of the graph.
+	 * @note This is the exact, dense reference method: it needs O( n^2 ) memory
+	 * and O( limit * n^3 ) time, so is only practical for small graphs.
+	 * @see sparse_subgraph_centrality()
 	 */
 	double subgraph_centrality( const uint32_t limit ) const;
+
+	/**
+	 * Estimates the subgraph centrality of the graph with sparse Lanczos
+	 * quadrature, i.e., the limit of subgraph_centrality() as the walk length
+	 * limit grows.
+	 * @param relative_tolerance The target relative standard error of the
+	 * estimate. Graphs with at most 1000 vertices are evaluated exactly.
+	 * @returns The (estimated) subgraph centrality of the graph.
+	 * @see SubgraphCentrality
+	 */
+	double sparse_subgraph_centrality( const double relative_tolerance ) const;
 	
 	/**
 	 * Populates the hop plot for this graph.
@@ -245,6 +329,9 @@ public:
 	 */
 	HopPlot hop_plot() const;
 
+	/**
+	 * Determines whether every pair of distinct vertices is adjacent.
+	 */
 	bool is_complete() const;
 	
 	/**
@@ -255,6 +342,8 @@ public:
 	 * order to be k-degree-anonymous.
 	 * @returns True if the UnlabelledGraph is k-degree-anonymous; 
 	 * false if not.
+	 * @note O( 1 ) when asked about the same k as last time, because
+	 * add_edge() and add_vertices() maintain a DegreeHistogram.
 	 */
 	bool is_anonymous( const uint32_t k ) const;
 	
@@ -274,11 +363,111 @@ public:
 	 */
 	template < bool hide_new_vertices >
 	void hide_waldo( const uint32_t k );
+
+	/**
+	 * Populates the degree sequence for this UnlabelledGraph.
+	 * @param degrees A vector to populate with the degree sequence, where each 
+	 * element is a pair of the form (degree, vertex id).
+	 * @post degrees is emptied and then populated with a list of degrees 
+	 * for each vertex, not necessarily unique and in ascending order.
+	 */
+	DegreeSequence retrieve_degree_sequence() const;
+
+	/**
+	 * Applies a planned k-degree anonymisation to this graph, by adding its
+	 * pseudo-vertices and edges.
+	 * @param plan The plan, built from degrees.
+	 * @param degrees The degree sequence of this graph, as returned by
+	 * retrieve_degree_sequence() before any modification.
+	 * @post The graph is modified exactly as by hide_waldo() with the plan's k.
+	 * @see IdentityPlan
+	 */
+	void apply( IdentityPlan const& plan, DegreeSequence const& degrees );
 	
+	/**
+	 * Writes the graph to a file.
+	 * @param filename The path of the file to (over)write.
+	 * @param format The format in which to write the graph. The ascii formats
+	 * are written exactly as by operator<< (except that a LabelledGraph writes
+	 * its labels in the vertex-labelled format); the binary format also stores
+	 * the vertex labels of a LabelledGraph.
+	 * @param varint Whether to delta+varint compress a binary file (ignored
+	 * for the ascii formats).
+	 * @param compression The streaming compression with which to write an
+	 * ascii file (which must be none for the binary format).
+	 * @return False if the file could not be written.
+	 * @see GraphWriter
+	 */
+	bool write( const std::string filename, const graphAnon::FileFormat format,
+		const bool varint = false,
+		const graphAnon::Compression compression = graphAnon::Compression::none ) const;
+
 	friend std::ostream& operator << ( std::ostream& os, UnlabelledGraph const& g );
 
 protected:
 
+	/**
+	 * Writes the graph with writer in one of the ascii formats, formatting
+	 * the vertices in parallel.
+	 * @return False if any write failed.
+	 * @see operator<<
+	 */
+	bool write_text( GraphWriter *writer, const graphAnon::FileFormat format ) const;
+
+	/**
+	 * Formats the first line of an ascii file: the number of vertices.
+	 * @param format The ascii format being written.
+	 * @param buffer The buffer to which to append the line.
+	 */
+	virtual void format_header( const graphAnon::FileFormat format, std::string *buffer ) const;
+
+	/**
+	 * Formats the line(s) of an ascii file that describe vertex u: either
+	 * one "u v" line per neighbour v >= u, or one line listing them, in
+	 * ascending order of v (see sorted_neighbours()).
+	 * @param u The vertex to format.
+	 * @param format The ascii format being written.
+	 * @param buffer The buffer to which to append the line(s).
+	 * @note Called concurrently for different vertices.
+	 */
+	virtual void format_vertex( const uint32_t u, const graphAnon::FileFormat format,
+		std::string *buffer ) const;
+
+	/**
+	 * Copies the neighbours of vertex u into scratch memory as original ids
+	 * in ascending order, so that ascii files list each vertex's neighbours
+	 * in the same order however the NeighbourList was built.
+	 * @pre A ScratchArena::Scope is open on the calling thread's arena.
+	 * @return The first of the degree( u ) sorted ids.
+	 */
+	uint32_t* sorted_neighbours( const uint32_t u ) const;
+
+	/**
+	 * Retrieves the vertex labels to store alongside the graph in binary files.
+	 * @return NULL, because an UnlabelledGraph has no labels.
+	 */
+	virtual std::vector< uint32_t > const* output_labels() const;
+
+	/**
+	 * Retrieves the label alphabet size to store alongside output_labels().
+	 */
+	virtual uint32_t output_num_labels() const;
+
+	/**
+	 * Permutes any per-vertex data of a derived class when the graph is reordered.
+	 * @param new_id A permutation whose v'th element is the new id of vertex v.
+	 * @see reorder()
+	 */
+	virtual void permute_vertex_data( std::vector< uint32_t > const& new_id );
+
+	/**
+	 * Retrieves the vertex with the given id in the output, i.e., the inverse
+	 * of original_id().
+	 */
+	uint32_t internal_id( const uint32_t i ) const {
+		return i < internal_ids_.size() ? internal_ids_[ i ] : i;
+	}
+
 	/**
 	 * Inserts the undirected edge (u,v) into the graph if it does not already exist.
 	 * @param u The source vertex of the edge
@@ -286,9 +475,46 @@ protected:
 	 * @return True if the edge was added, false if it already existed
 	 * @post Edge (u,v) exists in the graph (irrespective of whether it was there
 	 * prior to invoking the method)
+	 * @note Virtual so that derived classes can maintain auxiliary structures
+	 * (e.g., the AlphaProximityTracker of a LabelledGraph) as edges arrive.
 	 */
-	bool add_edge( const uint32_t u, const uint32_t v );
+	virtual bool add_edge( const uint32_t u, const uint32_t v );
+
+	/**
+	 * Inserts v into the neighbour list of u, counting any reallocation of the list.
+	 * @pre v is not already a neighbour of u.
+	 * @note Only modifies u's neighbour list, so may be called concurrently
+	 * for different u.
+	 */
+	void insert_neighbour( const uint32_t u, const uint32_t v ) {
+		NeighbourList &neighbours = adjacency_list_[ u ];
+#ifdef GRAPHANON_NO_INSTRUMENTATION
+		neighbours.insert( v );
+#else
+		const size_t capacity = neighbours.capacity();
+		neighbours.insert( v );
+		if( neighbours.capacity() != capacity ) { GRAPHANON_PROFILE_COUNT( hash_rehashes, 1 ); }
+#endif
+	}
 	
+	/**
+	 * Replaces the vertices and edges of the graph with those of g, in bulk.
+	 * @param g A simple, undirected graph, which becomes the frozen snapshot.
+	 * @post The graph is isomorphic to g, and csr() returns g without
+	 * re-freezing.
+	 */
+	virtual void assign_csr( CsrGraph &&g );
+
+	/**
+	 * Inserts the edges queued in builder with every OpenMP thread.
+	 * @param builder A builder over adjacency_list_.
+	 * @return The number of edges that were inserted.
+	 * @post The graph contains every queued edge.
+	 * @note Virtual so that derived classes can update their auxiliary
+	 * structures in the same parallel pass.
+	 */
+	virtual uint64_t commit_edges( ConcurrentAdjacencyBuilder *builder );
+
 	/**
 	 * Adds a specified number of isolated vertices to the graph.
 	 * @param num_vertices The number of vertices that should be added
@@ -303,17 +529,12 @@ protected:
 	 * a complete graph.
 	 * @post The graph remains unaffected if it is complete. Otherwise,
 	 * one edge that previously was not in the graph now appears.
+	 * @note Rejection samples random pairs for a bounded number of draws and
+	 * then picks among the missing edges in O( n ), so it stays bounded even
+	 * when the graph is nearly complete.
 	 */
 	void add_random_edge();
 	
-	/**
-	 * Populates the degree sequence for this UnlabelledGraph.
-	 * @param degrees A vector to populate with the degree sequence, where each 
-	 * element is a pair of the form (degree, vertex id).
-	 * @post degrees is emptied and then populated with a list of degrees 
-	 * for each vertex, not necessarily unique and in ascending order.
-	 */
-	DegreeSequence retrieve_degree_sequence() const;
 
 	/**
 	 * Returns the path length between vertex u and vertex v.
@@ -329,7 +550,7 @@ protected:
 	/* Member variables */
 	
 	uint32_t n_; /**< The number of vertices in the graph. */
-	uint32_t m_; /**< The number of edges in the graph. */
+	uint64_t m_; /**< The number of edges in the graph. */
 	graphAnon::FileFormat const io_format_; /**< The file format for reading/writing graphs. */
 	
 	/**
@@ -337,6 +558,27 @@ protected:
 	 * of node ids that are neighbours for the node with id i.
 	 */
 	AdjacencyList adjacency_list_;
+
+	/**
+	 * The input id of each vertex that existed when the graph was last
+	 * reordered, or empty if it never has been.
+	 * @see original_id()
+	 */
+	std::vector< uint32_t > original_ids_;
+	std::vector< uint32_t > internal_ids_; /**< The inverse permutation of original_ids_. */
+
+	/**
+	 * The most recent immutable CSR snapshot of adjacency_list_, or null if
+	 * the graph has been mutated since the snapshot was taken.
+	 */
+	mutable std::shared_ptr< const CsrGraph > csr_;
+
+	/**
+	 * How many vertices have each degree, maintained by add_edge() and
+	 * add_vertices() (or built on demand after a bulk change, which should
+	 * invalidate() it).
+	 */
+	mutable DegreeHistogram degree_histogram_;
 	
 private:
 	
@@ -37,8 +37,8 @@
 
 template <bool include_self_paths >
 float UnlabelledGraph::average_path_length_brute_force() const {
-	uint32_t sum_of_path_lengths = 0;
-	uint32_t number_of_connected_paths = 0;
+	uint64_t sum_of_path_lengths = 0;
+	uint64_t number_of_connected_paths = 0;
 	
 	/* Iterate all pairs of distinct vertices. */
 #pragma omp parallel for reduction ( +: sum_of_path_lengths, number_of_connected_paths )
@@ -59,7 +59,7 @@ float UnlabelledGraph::average_path_length_brute_force() const {
 	}
 	
 	if ( number_of_connected_paths > 0  ) {
-		return sum_of_path_lengths / (float) number_of_connected_paths;
+		return sum_of_path_lengths / (double) number_of_connected_paths;
 	}
 	else { return 0; }
 }
@@ -69,19 +69,7 @@ float UnlabelledGraph::average_path_length( HopPlot *hop_plot ) const {
 	
 	//return average_path_length_brute_force< include_self_paths >();
 	
-	/* init with/without the paths (i,i) of length 0 */
-	uint64_t sum = 0;
-	uint64_t count = ( include_self_paths ? n_ : 0 );
-	
-	/* Iterate hop plot to process all length > 0 paths */
-	for( auto it = hop_plot->begin(); it != hop_plot->end(); ++it ) {
-		if( it->second > 0 ) {
-			sum += it->first * it->second;
-			count += it->second;
-		}
-	}
-	
-	return ( count == 0 ? 0 : sum / static_cast< float >( count ) );
+	return graphAnon::average_path_length( *hop_plot, n_, include_self_paths );
 }
 
 /**
@@ -93,79 +81,12 @@ float UnlabelledGraph::average_path_length( HopPlot *hop_plot ) const {
  * @post The degree sequence, degrees, is modified such that every element that appears 
  * in the list appears at least k times.
  * @see Section 3.1 and Table 1 of @cite waldo
+ * @see DegreeSequenceAnonymiser, which should be used directly to reuse its
+ * tables when anonymising many sequences (e.g., for many k).
  */
 uint32_t inline anonymize_degree_sequence( DegreeSequence *degrees, const uint32_t k ) {
-	
-	const uint32_t n = degrees->size();
-	
-	// Check if the graph is large enough to meaningfully anonymise. 
-	// Cannot split fewer than 2k vertices into two groups; so, a graph 
-	// of n < 2k vertices must already be transformed into the complete graph.
-	if( n < 2 * k )
-	{
-		uint32_t deficiency = 0;
-		for( uint32_t i = 1; i < n; ++i )
-		{
-			deficiency += degrees->at( 0 ).first - degrees->at( i ).first;
-		}
-		return deficiency;
-	}
-	
-	/* arrays to store dynamic programming results. */
-	uint32_t costs[ n ];
-	uint32_t starts[ n ];
-	
-	/* trivially populate first 2k - 1 positions, since cannot split. */
-	for( uint32_t i = 0; i < 2 * k - 1; ++i ) {
-		starts[ i ] = 0;
-		costs[ i ] = degrees->at( 0 ).first - degrees->at( i ).first;
-	}
-	
-	/* compute best split for remaining n - (2k - 1) positions. */
-	for( uint32_t i = 2 * k - 1; i < n; ++i ) {
-		const uint32_t range_end = i - k;
-		const uint32_t range_start = ( k - 1 > i - 2 * k + 1 ? k - 1 : i - 2 * k + 1 );
-		
-		uint32_t best_split_pos = range_start + 1;
-		
-		const uint32_t cost_left = costs[ range_start ];
-		const uint32_t cost_right = degrees->at( range_start + 1 ).first - degrees->at( i ).first;
-		uint32_t best_cost = ( cost_left > cost_right ? cost_left : cost_right );
-		uint32_t best_sum = cost_left + cost_right;
-		
-		for( uint32_t j = range_start + 1; j <= range_end; ++j ) {
-			const uint32_t cost_left = costs[ j ];
-			const uint32_t cost_right = degrees->at( j + 1 ).first - degrees->at( i ).first;
-			const uint32_t full_cost = ( cost_left > cost_right ? cost_left : cost_right );
-			const uint32_t sum_cost = cost_left + cost_right;
-			if( full_cost < best_cost || ( full_cost == best_cost && sum_cost < best_sum ) ) {
-				best_split_pos = j + 1;
-				best_cost = full_cost;
-				best_sum = sum_cost;
-			}
-		}
-		starts[ i ] = best_split_pos;
-		costs[ i ] = best_cost;
-	}
-	
-	/* Update degrees to k-anonymize the degree sequence by replaying the
-	 * dynamic programming results backwards. 
-	 * Be aware of crazy loop logic arising from use of unsigned ints: 
-	 * the termination condition is when i == -1, which for unsigned ints 
-	 * means that i == max_int > n.
-	 */
-	for( uint32_t i = n - 1; i < n; i = starts[ i ] - 1 ) {
-		const uint32_t block_start = starts[ i ];
-		assert( block_start <= i );
-		const uint32_t block_degree = degrees->at( block_start ).first;
-		assert( block_degree <= n );
-		for( uint32_t j = block_start + 1; j <= i; ++j ) {
-			degrees->at( j ).first = block_degree;
-		}
-	}
-	
-	/* Return max deficiency. */
-	return costs[ n - 1 ];
+	DegreeSequenceAnonymiser anonymiser;
+	return anonymiser.anonymise( degrees, k );
 }
 
 
@@ -173,49 +94,19 @@ template < bool hide_new_vertices >
 void UnlabelledGraph::hide_waldo( const uint32_t k ) {
 	
 	assert( k <= n_ );
+	GRAPHANON_PROFILE_PHASE( "hide_waldo" );
 	
-	/* Section 3.1: First anonymize degree sequence. */
-	DegreeSequence degrees = retrieve_degree_sequence();
-	DegreeSequence anon_degrees( degrees );
-	uint32_t max_def = anonymize_degree_sequence( &anon_degrees, k );
-	
-	/* Section 3.2: Augment graph with min # vertices. */ 
-	if( max_def > 0 ) {
-		const uint32_t first_new_vertex = n_;
-		if ( hide_new_vertices ) {
-			const uint32_t md_or_k = ( max_def > k ? max_def : k );
-			const uint32_t new_vertices = ( md_or_k % 2 ? md_or_k : md_or_k + 1 );
-			add_vertices( new_vertices );
-		}
-		else { add_vertices( max_def ); }
-	
-		/* Section 3.3: Add new edges cyclically to anonymize original graph. */
-		uint32_t cursor = first_new_vertex;
-		for( uint32_t i = 0; i < first_new_vertex; ++i ) {
-			const uint32_t deficiency = anon_degrees[ i ].first - degrees[ i ].first;
-			for( uint32_t j = 0; j < deficiency; ++j ) {
-				add_edge( degrees[ i ].second, cursor );
-				if( cursor == n_ - 1 ) { cursor = first_new_vertex; }
-				else { ++cursor; }
-			}
-		}
-	
-		/* finally, check whether the new vertices are k-anonymous, or whether the 
-		 * pairing procedure is necessary. */
-		if( hide_new_vertices && cursor != first_new_vertex ) {
-			if( ! is_anonymous( k ) ) {
-				while( cursor < n_ - 1 ) {
-					add_edge( cursor, cursor + 1 );
-					cursor += 2;
-				}
-				if( cursor == n_ - 1 ) {
-					add_edge( n_ - 1, first_new_vertex );
-					for( cursor = first_new_vertex + 1; cursor < n_; cursor += 2 ) {
-						add_edge( cursor, cursor + 1 );
-					}
-				}
-			}
-		}
+	/* Plan the anonymisation from the sorted degree sequence alone. */
+	DegreeSequence degrees;
+	{
+		GRAPHANON_PROFILE_PHASE( "degree_sequence" );
+		degrees = retrieve_degree_sequence();
+	}
+	DegreeSequenceAnonymiser anonymiser;
+	IdentityPlan plan;
+	{
+		GRAPHANON_PROFILE_PHASE( "plan" );
+		plan.build( degrees, k, hide_new_vertices, &anonymiser );
 	}
-	return;
+	apply( plan, degrees );
 }
@@ -0,0 +1,223 @@
+/**
+ * @file
+ * @brief Implementation of the UtilityReport class in utility_report.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t, int64_t */
+#include <cmath>		/* for std::isfinite */
+#include <fstream>		/* for std::ofstream */
+#include <limits>		/* for std::numeric_limits */
+#include <set>
+
+/* STL stuff in use. */
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "utility_report.h" /* implementing this class. */
+#include "all_pairs_bfs.h"
+#include "triangle_count.h"
+#include "subgraph_centrality.h"
+
+namespace
+{
+	/**
+	 * Measures the metrics of g, given its triangle count.
+	 */
+	template< typename Graph >
+	UtilityMetrics measure( Graph const& g, const uint64_t triangles, const double sc_tolerance,
+		HopPlotOptions const& hop_plot_options ) {
+		UtilityMetrics metrics;
+		metrics.num_vertices = g.num_vertices();
+		metrics.num_edges = g.num_edges();
+		metrics.triangles = triangles;
+		metrics.two_paths = 0;
+		for( uint32_t u = 0; u < g.num_vertices(); ++u ) {
+			const uint64_t degree = g.degree( u );
+			metrics.two_paths += degree * ( degree - 1 );
+		}
+		metrics.clustering_coefficient = 6 * triangles / static_cast< float >( metrics.two_paths );
+		metrics.subgraph_centrality = SubgraphCentrality( g ).estimate( sc_tolerance );
+
+		/* One BFS for all three path-length metrics. */
+		metrics.hop_plot = graphAnon::estimate_hop_plot( g, hop_plot_options );
+		metrics.average_path_length
+			= graphAnon::average_path_length( metrics.hop_plot, metrics.num_vertices, true );
+		metrics.harmonic_mean = graphAnon::harmonic_mean( metrics.hop_plot, metrics.num_vertices );
+		return metrics;
+	}
+
+	/** Writes a count, a real number, or null if it is not finite (e.g., 0/0). */
+	void write_number( std::ostream *os, const double x, const char *null ) {
+		if( std::isfinite( x ) ) { *os << x; }
+		else { *os << null; }
+	}
+
+	/**
+	 * The difference between two hop plots, over every length in either.
+	 */
+	std::vector< std::pair< uint32_t, int64_t > > hop_plot_delta( HopPlot const& before,
+		HopPlot const& after ) {
+
+		std::set< uint32_t > lengths;
+		for( auto const& hp : before ) { lengths.insert( hp.first ); }
+		for( auto const& hp : after ) { lengths.insert( hp.first ); }
+		std::vector< std::pair< uint32_t, int64_t > > delta;
+		for( uint32_t const d : lengths ) {
+			auto const b = before.find( d ), a = after.find( d );
+			const int64_t difference = static_cast< int64_t >( a == after.end() ? 0 : a->second )
+				- static_cast< int64_t >( b == before.end() ? 0 : b->second );
+			delta.push_back( std::make_pair( d, difference ) );
+		}
+		return delta;
+	}
+
+	/**
+	 * The metrics of one graph (or their deltas), in report order.
+	 */
+	struct Row {
+		int64_t counts[ 3 ]; /**< |V|, |E|, and the number of triangles. */
+		double reals[ 4 ]; /**< CC, SC, APL, and HM. */
+		std::vector< std::pair< uint32_t, int64_t > > hop_plot;
+	};
+
+	const char *const count_names[] = { "num_vertices", "num_edges", "triangles" };
+	const char *const real_names[] = { "clustering_coefficient", "subgraph_centrality",
+		"average_path_length", "harmonic_mean" };
+
+	Row make_row( UtilityMetrics const& m ) {
+		Row row = { { m.num_vertices, static_cast< int64_t >( m.num_edges ),
+			static_cast< int64_t >( m.triangles ) }, { m.clustering_coefficient,
+			m.subgraph_centrality, m.average_path_length, m.harmonic_mean }, {} };
+		for( auto const& hp : m.hop_plot ) {
+			row.hop_plot.push_back( std::make_pair( hp.first, static_cast< int64_t >( hp.second ) ) );
+		}
+		return row;
+	}
+
+	Row make_delta_row( UtilityMetrics const& before, UtilityMetrics const& after ) {
+		Row const b = make_row( before ), a = make_row( after );
+		Row row;
+		for( uint32_t i = 0; i < 3; ++i ) { row.counts[ i ] = a.counts[ i ] - b.counts[ i ]; }
+		for( uint32_t i = 0; i < 4; ++i ) { row.reals[ i ] = a.reals[ i ] - b.reals[ i ]; }
+		row.hop_plot = hop_plot_delta( before.hop_plot, after.hop_plot );
+		return row;
+	}
+
+	void write_json_row( std::ostream *os, Row const& row ) {
+		*os << "{ ";
+		for( uint32_t i = 0; i < 3; ++i ) {
+			*os << "\"" << count_names[ i ] << "\": " << row.counts[ i ] << ", ";
+		}
+		for( uint32_t i = 0; i < 4; ++i ) {
+			*os << "\"" << real_names[ i ] << "\": ";
+			write_number( os, row.reals[ i ], "null" );
+			*os << ", ";
+		}
+		*os << "\"hop_plot\": {";
+		for( size_t i = 0; i < row.hop_plot.size(); ++i ) {
+			*os << ( i == 0 ? " " : ", " ) << "\"" << row.hop_plot[ i ].first << "\": "
+				<< row.hop_plot[ i ].second;
+		}
+		*os << " } }";
+	}
+
+	void write_csv_row( std::ostream *os, const char *graph, std::string const& parameter,
+		Row const& row ) {
+
+		*os << graph << "," << parameter;
+		for( uint32_t i = 0; i < 3; ++i ) { *os << "," << row.counts[ i ]; }
+		for( uint32_t i = 0; i < 4; ++i ) {
+			*os << ",";
+			write_number( os, row.reals[ i ], "" );
+		}
+		*os << ",";
+		for( size_t i = 0; i < row.hop_plot.size(); ++i ) {
+			*os << ( i == 0 ? "" : " " ) << row.hop_plot[ i ].first << ":" << row.hop_plot[ i ].second;
+		}
+		*os << "\n";
+	}
+}
+
+UtilityReport::UtilityReport( CsrGraph const& input, const double sc_tolerance,
+	HopPlotOptions const& hop_plot_options )
+	: sc_tolerance_( sc_tolerance ), hop_plot_options_( hop_plot_options ),
+	input_( measure( input, TriangleCounter( input ).count(), sc_tolerance, hop_plot_options ) ) {}
+
+UtilityMetrics UtilityReport::measure_output( GraphOverlay const& output ) const {
+	if( output.num_vertices() == input_.num_vertices && output.added_edges().empty() ) {
+		return input_;
+	}
+	OverlayView const g = output.view();
+	const uint64_t triangles = input_.triangles + graphAnon::count_added_triangles( g );
+	return measure( g, triangles, sc_tolerance_, hop_plot_options_ );
+}
+
+UtilityMetrics const& UtilityReport::add_output( const std::string parameter,
+	GraphOverlay const& output ) {
+
+	outputs_.push_back( std::make_pair( parameter, measure_output( output ) ) );
+	return outputs_.back().second;
+}
+
+void UtilityReport::write( std::ostream *os, const graphAnon::ReportFormat format ) const {
+	/* Enough digits to round-trip the (single precision) metrics. */
+	os->precision( std::numeric_limits< float >::max_digits10 );
+
+	if( format == graphAnon::ReportFormat::json ) {
+		*os << "{\n\t\"input\": ";
+		write_json_row( os, make_row( input_ ) );
+		*os << ",\n\t\"outputs\": [";
+		for( size_t i = 0; i < outputs_.size(); ++i ) {
+			*os << ( i == 0 ? "\n" : ",\n" ) << "\t\t{ \"parameter\": \"" << outputs_[ i ].first
+				<< "\",\n\t\t\t\"metrics\": ";
+			write_json_row( os, make_row( outputs_[ i ].second ) );
+			*os << ",\n\t\t\t\"delta\": ";
+			write_json_row( os, make_delta_row( input_, outputs_[ i ].second ) );
+			*os << " }";
+		}
+		*os << ( outputs_.empty() ? "]" : "\n\t]" ) << "\n}\n";
+	}
+	else {
+		*os << "graph,parameter";
+		for( uint32_t i = 0; i < 3; ++i ) { *os << "," << count_names[ i ]; }
+		for( uint32_t i = 0; i < 4; ++i ) { *os << "," << real_names[ i ]; }
+		*os << ",hop_plot\n";
+		write_csv_row( os, "input", "", make_row( input_ ) );
+		for( auto const& output : outputs_ ) {
+			write_csv_row( os, "output", output.first, make_row( output.second ) );
+			write_csv_row( os, "delta", output.first, make_delta_row( input_, output.second ) );
+		}
+	}
+}
+
+bool UtilityReport::write( const std::string filename, const graphAnon::ReportFormat format ) const {
+	std::ofstream file( filename );
+	if( !file.is_open() ) { return false; }
+	write( &file, format );
+	file.close();
+	return !file.fail();
+}
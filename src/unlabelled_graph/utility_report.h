@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Definition of a machine-readable report of the data utility of an
+ * input graph and of its anonymisations.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef UTILITY_REPORT_H_
+#define UTILITY_REPORT_H_
+
+#include <cstdint>	/* For uint32_t, uint64_t */
+#include <string>	/* For std::string */
+#include <ostream>	/* For std::ostream */
+
+/* STL libraries in use */
+#include <vector>
+#include <utility>
+
+#include "csr_graph.h"
+#include "overlay_view.h"
+#include "graph_overlay.h"
+#include "graph_analysis.h" /* for HopPlot */
+#include "hop_plot_estimator.h"
+#include "report_format.h"
+
+/**
+ * @brief The data-utility metrics of one graph: those that -stats echoes,
+ * plus the counts from which they derive.
+ */
+struct UtilityMetrics {
+	uint32_t num_vertices; /**< |V|. */
+	uint64_t num_edges; /**< |E|. */
+	uint64_t triangles; /**< The number of distinct triangles. */
+	uint64_t two_paths; /**< The number of ordered pairs of neighbours of a common vertex. */
+	float clustering_coefficient; /**< 6 * triangles / two_paths. */
+	double subgraph_centrality; /**< The (estimated) subgraph centrality. */
+	HopPlot hop_plot; /**< The histogram of shortest-path lengths. */
+	float average_path_length; /**< As by UnlabelledGraph::average_path_length< true >(). */
+	float harmonic_mean; /**< As by UnlabelledGraph::harmonic_mean(). */
+};
+
+/**
+ * @brief Measures the data utility of an input graph and of any number of
+ * anonymisations of it (as GraphOverlay objects), and writes the metrics and
+ * their deltas as JSON or CSV.
+ *
+ * Each graph is measured in as few traversals as possible: one all-pairs
+ * BFS yields the hop plot, from which the average path length and harmonic
+ * mean both derive, and one degree-ordered triangle count yields the
+ * clustering coefficient. An output reuses the input's triangle count and
+ * only counts the triangles that contain an added edge, and an output that
+ * adds nothing reuses every metric of the input.
+ */
+class UtilityReport {
+public:
+
+	/**
+	 * Measures the input graph.
+	 * @param input The input graph, which need not outlive this UtilityReport.
+	 * @param sc_tolerance The relative standard error of the subgraph
+	 * centrality estimates.
+	 * @param hop_plot_options How to compute the hop plots (and thus the
+	 * average path lengths and harmonic means).
+	 * @see SubgraphCentrality::estimate()
+	 */
+	UtilityReport( CsrGraph const& input, const double sc_tolerance,
+		HopPlotOptions const& hop_plot_options = HopPlotOptions() );
+
+	/**
+	 * Accessor method to retrieve the metrics of the input graph.
+	 */
+	UtilityMetrics const& input() const { return input_; }
+
+	/**
+	 * Measures an anonymisation of the input graph without adding it to the
+	 * report.
+	 * @param output The anonymised graph.
+	 * @pre The base of output is the input graph.
+	 * @return The metrics of output.
+	 */
+	UtilityMetrics measure_output( GraphOverlay const& output ) const;
+
+	/**
+	 * Measures an anonymisation of the input graph and adds it to the report.
+	 * @param parameter A label for the output (e.g., "k=5").
+	 * @param output The anonymised graph.
+	 * @pre The base of output is the input graph.
+	 * @return The metrics of output.
+	 */
+	UtilityMetrics const& add_output( const std::string parameter, GraphOverlay const& output );
+
+	/**
+	 * Writes the report to a stream.
+	 * @param os The stream to write to.
+	 * @param format The format in which to write the report.
+	 */
+	void write( std::ostream *os, const graphAnon::ReportFormat format ) const;
+
+	/**
+	 * Writes the report to a file.
+	 * @param filename The path of the file to (over)write.
+	 * @param format The format in which to write the report.
+	 * @return False if the file could not be written.
+	 */
+	bool write( const std::string filename, const graphAnon::ReportFormat format ) const;
+
+private:
+
+	double sc_tolerance_; /**< The relative standard error of the SC estimates. */
+	HopPlotOptions hop_plot_options_; /**< How to compute the hop plots. */
+	UtilityMetrics input_; /**< The metrics of the input graph. */
+	std::vector< std::pair< std::string, UtilityMetrics > > outputs_; /**< Each output, by label. */
+};
+
+#endif /* UTILITY_REPORT_H_ */
@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Implementation of the vertex reorderings in vertex_order.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>		/* for uint32_t, uint64_t */
+#include <cmath>		/* for std::sqrt */
+#include <algorithm>	/* for std::sort, std::stable_sort, std::reverse, std::max */
+#include <numeric>		/* for std::iota */
+#include <utility>		/* for std::move */
+
+/* STL stuff in use. */
+#include <vector>
+
+#include "omp.h"
+
+#include "vertex_order.h" /* implementing these functions. */
+
+namespace
+{
+	/**
+	 * The number of most recently placed vertices with which Gorder scores
+	 * each candidate (the paper's w).
+	 */
+	const uint32_t gorder_window = 5;
+
+	/**
+	 * A max-priority queue of vertices whose keys only ever change by one,
+	 * kept as a doubly-linked list of the vertices with each key, so that
+	 * every update is O( 1 ) (the paper's unit heap).
+	 */
+	class UnitHeap {
+	public:
+
+		/**
+		 * Constructs a heap of the vertices 0, ..., n - 1, all with key 0.
+		 */
+		explicit UnitHeap( const uint32_t num_vertices ) : key_( num_vertices, 0 ),
+			previous_( num_vertices ), next_( num_vertices ), heads_( 1, none ),
+			top_( 0 ), removed_( num_vertices, 0 ) {
+			/* Linked in reverse, so that ties are first broken by ascending id. */
+			for( uint32_t v = num_vertices; v > 0; --v ) { link( v - 1 ); }
+		}
+
+		/**
+		 * Determines whether v is still in the heap.
+		 */
+		bool contains( const uint32_t v ) const { return removed_[ v ] == 0; }
+
+		/**
+		 * Increases the key of v, which must still be in the heap, by one.
+		 */
+		void increment( const uint32_t v ) {
+			unlink( v );
+			if( ++key_[ v ] == heads_.size() ) { heads_.push_back( none ); }
+			link( v );
+			top_ = std::max( top_, key_[ v ] );
+		}
+
+		/**
+		 * Decreases the positive key of v, which must still be in the heap, by one.
+		 */
+		void decrement( const uint32_t v ) {
+			unlink( v );
+			--key_[ v ];
+			link( v );
+		}
+
+		/**
+		 * Removes a vertex with the largest key from the (non-empty) heap.
+		 */
+		uint32_t pop() {
+			while( heads_[ top_ ] == none ) { --top_; }
+			const uint32_t v = heads_[ top_ ];
+			unlink( v );
+			removed_[ v ] = 1;
+			return v;
+		}
+
+	private:
+
+		/** Marks the end of a list. */
+		static constexpr uint32_t none = ~0u;
+
+		void link( const uint32_t v ) {
+			const uint32_t head = heads_[ key_[ v ] ];
+			previous_[ v ] = none;
+			next_[ v ] = head;
+			if( head != none ) { previous_[ head ] = v; }
+			heads_[ key_[ v ] ] = v;
+		}
+
+		void unlink( const uint32_t v ) {
+			if( previous_[ v ] != none ) { next_[ previous_[ v ] ] = next_[ v ]; }
+			else { heads_[ key_[ v ] ] = next_[ v ]; }
+			if( next_[ v ] != none ) { previous_[ next_[ v ] ] = previous_[ v ]; }
+		}
+
+		std::vector< uint32_t > key_; /**< The key of each vertex. */
+		std::vector< uint32_t > previous_; /**< The previous vertex with the same key. */
+		std::vector< uint32_t > next_; /**< The next vertex with the same key. */
+		std::vector< uint32_t > heads_; /**< The first vertex with each key. */
+		uint32_t top_; /**< No vertex has a larger key than this. */
+		std::vector< uint8_t > removed_; /**< Whether each vertex has been popped. */
+	};
+
+	constexpr uint32_t UnitHeap::none;
+
+	std::vector< uint32_t > degree_order( CsrGraph const& g ) {
+		std::vector< uint32_t > sequence( g.num_vertices() );
+		std::iota( sequence.begin(), sequence.end(), 0 );
+		std::stable_sort( sequence.begin(), sequence.end(),
+			[ &g ]( const uint32_t u, const uint32_t v ) { return g.degree( u ) > g.degree( v ); } );
+		return graphAnon::invert_permutation( sequence ); /* position -> new id */
+	}
+
+	std::vector< uint32_t > rcm_order( CsrGraph const& g ) {
+		const uint32_t n = g.num_vertices();
+		auto const by_degree = [ &g ]( const uint32_t u, const uint32_t v ) {
+			return g.degree( u ) < g.degree( v ) || ( g.degree( u ) == g.degree( v ) && u < v );
+		};
+
+		/* Each component is searched from its first vertex in ascending order of degree. */
+		std::vector< uint32_t > starts( n );
+		std::iota( starts.begin(), starts.end(), 0 );
+		std::sort( starts.begin(), starts.end(), by_degree );
+
+		std::vector< uint32_t > sequence;
+		sequence.reserve( n );
+		std::vector< uint8_t > visited( n, 0 );
+		for( uint32_t const start : starts ) {
+			if( visited[ start ] ) { continue; }
+			visited[ start ] = 1;
+			sequence.push_back( start );
+
+			/* The sequence itself is the BFS queue. */
+			for( size_t head = sequence.size() - 1; head < sequence.size(); ++head ) {
+				const size_t first_child = sequence.size();
+				for( uint32_t const u : g.neighbours( sequence[ head ] ) ) {
+					if( !visited[ u ] ) {
+						visited[ u ] = 1;
+						sequence.push_back( u );
+					}
+				}
+				std::sort( sequence.begin() + first_child, sequence.end(), by_degree );
+			}
+		}
+		std::reverse( sequence.begin(), sequence.end() );
+		return graphAnon::invert_permutation( sequence ); /* position -> new id */
+	}
+
+	std::vector< uint32_t > gorder_order( CsrGraph const& g ) {
+		const uint32_t n = g.num_vertices();
+		if( n == 0 ) { return std::vector< uint32_t >(); }
+		const uint32_t hub_degree = static_cast< uint32_t >( std::sqrt( static_cast< double >( n ) ) );
+
+		/* Adjusts the score of every unplaced vertex that is adjacent to v or
+		 * shares a (non-hub) neighbour with it, as v enters or leaves the window. */
+		UnitHeap heap( n );
+		auto const update = [ &g, &heap, hub_degree ]( const uint32_t v, const bool entering ) {
+			for( uint32_t const u : g.neighbours( v ) ) {
+				if( heap.contains( u ) ) {
+					if( entering ) { heap.increment( u ); }
+					else { heap.decrement( u ); }
+				}
+				if( g.degree( u ) > hub_degree ) { continue; }
+				for( uint32_t const w : g.neighbours( u ) ) {
+					if( w != v && heap.contains( w ) ) {
+						if( entering ) { heap.increment( w ); }
+						else { heap.decrement( w ); }
+					}
+				}
+			}
+		};
+
+		/* Start from a vertex of maximum degree. */
+		uint32_t first = 0;
+		for( uint32_t v = 1; v < n; ++v ) {
+			if( g.degree( v ) > g.degree( first ) ) { first = v; }
+		}
+		heap.increment( first );
+		std::vector< uint32_t > sequence;
+		sequence.reserve( n );
+		sequence.push_back( heap.pop() );
+
+		for( uint32_t i = 1; i < n; ++i ) {
+			update( sequence[ i - 1 ], true );
+			if( i > gorder_window ) { update( sequence[ i - 1 - gorder_window ], false ); }
+			sequence.push_back( heap.pop() );
+		}
+		return graphAnon::invert_permutation( sequence ); /* position -> new id */
+	}
+}
+
+namespace graphAnon
+{
+	std::vector< uint32_t > order_vertices( CsrGraph const& g, const VertexOrder order ) {
+		switch( order ) {
+			case VertexOrder::degree: return degree_order( g );
+			case VertexOrder::rcm: return rcm_order( g );
+			case VertexOrder::gorder: return gorder_order( g );
+			case VertexOrder::none: break;
+		}
+		std::vector< uint32_t > new_id( g.num_vertices() );
+		std::iota( new_id.begin(), new_id.end(), 0 );
+		return new_id;
+	}
+
+	CsrGraph permute_vertices( CsrGraph const& g, std::vector< uint32_t > const& new_id ) {
+		const uint32_t n = g.num_vertices();
+		std::vector< uint64_t > offsets( n + 1, 0 );
+		for( uint32_t v = 0; v < n; ++v ) { offsets[ new_id[ v ] + 1 ] = g.degree( v ); }
+		for( uint32_t v = 0; v < n; ++v ) { offsets[ v + 1 ] += offsets[ v ]; }
+
+		std::vector< uint32_t > neighbours( offsets[ n ] );
+#pragma omp parallel for schedule( dynamic, 256 )
+		for( uint32_t v = 0; v < n; ++v ) {
+			uint32_t *const first = neighbours.data() + offsets[ new_id[ v ] ];
+			uint32_t *last = first;
+			for( uint32_t const u : g.neighbours( v ) ) { *last++ = new_id[ u ]; }
+			std::sort( first, last );
+		}
+		return CsrGraph( std::move( offsets ), std::move( neighbours ) );
+	}
+
+	std::vector< uint32_t > invert_permutation( std::vector< uint32_t > const& new_id ) {
+		std::vector< uint32_t > inverse( new_id.size() );
+		for( uint32_t v = 0; v < new_id.size(); ++v ) { inverse[ new_id[ v ] ] = v; }
+		return inverse;
+	}
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @brief Definition of the vertex reorderings that relabel a graph so that
+ * its neighbourhoods are scanned with better locality.
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VERTEX_ORDER_H_
+#define VERTEX_ORDER_H_
+
+#include <cstdint>	/* For uint32_t */
+
+/* STL libraries in use */
+#include <vector>
+
+#include "csr_graph.h"
+
+namespace graphAnon
+{
+	/** The supported relabellings of the vertices of a graph. */
+	enum class VertexOrder {
+		/** Keeps the vertex ids of the input. */
+		none,
+
+		/**
+		 * Sorts the vertices by descending degree (ties by id), so that the
+		 * hubs, the most frequently visited vertices, share cache lines.
+		 */
+		degree,
+
+		/**
+		 * Reverse Cuthill-McKee: a breadth-first search from a vertex of
+		 * minimum degree in each component, visiting neighbours in ascending
+		 * order of degree, and then reversed. Neighbours receive nearby ids,
+		 * so that the bandwidth of the adjacency matrix is small.
+		 */
+		rcm,
+
+		/**
+		 * Gorder (Wei et al., SIGMOD 2016): greedily appends the vertex that
+		 * shares the most edges and common neighbours with the last window
+		 * (of five) vertices placed, so that vertices accessed together are
+		 * stored together.
+		 */
+		gorder
+	};
+
+	/**
+	 * Computes a relabelling of the vertices of g.
+	 * @param g The graph to relabel.
+	 * @param order The relabelling to compute.
+	 * @return A permutation whose v'th element is the new id of vertex v.
+	 * @note degree and rcm take O( n log n + m ) time. gorder takes time
+	 * proportional to the number of paths of length two through vertices of
+	 * degree at most sqrt( n ) (higher degree vertices are too common a
+	 * neighbour to say anything about locality and are skipped, as in the
+	 * paper's treatment of hubs).
+	 */
+	std::vector< uint32_t > order_vertices( CsrGraph const& g, const VertexOrder order );
+
+	/**
+	 * Relabels the vertices of g.
+	 * @param g The graph to relabel.
+	 * @param new_id A permutation whose v'th element is the new id of vertex v.
+	 * @return The graph in which vertex new_id[ v ] has the neighbours
+	 * { new_id[ u ] : u a neighbour of v }, sorted in ascending order.
+	 */
+	CsrGraph permute_vertices( CsrGraph const& g, std::vector< uint32_t > const& new_id );
+
+	/**
+	 * Inverts a permutation.
+	 * @return The permutation whose new_id[ v ]'th element is v.
+	 */
+	std::vector< uint32_t > invert_permutation( std::vector< uint32_t > const& new_id );
+}
+
+#endif /* VERTEX_ORDER_H_ */
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @brief Implementation of the unit tests in vertex_order.test.h
+ *
+ * @copyright Copyright (c) 2015-2017 Sean Chester
+ * <br />
+ * This file is part of the GraphAnon suite.
+ * GraphAnon, version 2.0, is distributed freely under the *MIT License*:
+ * <br />
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * <br />
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * <br />
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint> /* for uint32_t, uint64_t */
+#include <cstdlib> /* for rand */
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <set>
+#include <string>
+#include <sstream>
+
+#include "vertex_order.test.h"
+#include "vertex_order.h"
+#include "unlabelled_graph.h"
+#include "csr_graph.h"
+#include "random_graph.h"
+
+namespace
+{
+	/**
+	 * Builds a CsrGraph on label.size() vertices from a list of edges, after renaming
+	 * each vertex v to label[ v ].
+	 */
+	CsrGraph make_graph( std::vector< uint32_t > const& label, graphAnon::EdgeList edges ) {
+		for( auto &e : edges ) { e = std::make_pair( label[ e.first ], label[ e.second ] ); }
+		return graphAnon::csr_from_edges( static_cast< uint32_t >( label.size() ), edges );
+	}
+
+	/**
+	 * Generates a random permutation of [ 0, n ).
+	 */
+	std::vector< uint32_t > shuffled( const uint32_t n ) {
+		std::vector< uint32_t > label( n );
+		std::iota( label.begin(), label.end(), 0 );
+		for( uint32_t i = n; i > 1; --i ) { std::swap( label[ i - 1 ], label[ rand() % i ] ); }
+		return label;
+	}
+
+	/**
+	 * Determines whether new_id is a permutation under which permuted is g,
+	 * with sorted neighbour lists.
+	 */
+	bool is_relabelling( CsrGraph const& g, std::vector< uint32_t > const& new_id,
+		CsrGraph const& permuted ) {
+		if( new_id.size() != g.num_vertices() || permuted.num_vertices() != g.num_vertices()
+				|| permuted.num_edges() != g.num_edges() ) {
+			return false;
+		}
+		std::vector< uint8_t > hit( new_id.size(), 0 );
+		for( uint32_t const id : new_id ) {
+			if( id >= new_id.size() || hit[ id ]++ ) { return false; }
+		}
+		for( uint32_t v = 0; v < g.num_vertices(); ++v ) {
+			NeighbourRange const range = permuted.neighbours( new_id[ v ] );
+			if( range.size() != g.degree( v ) || !std::is_sorted( range.begin(), range.end() ) ) {
+				return false;
+			}
+			for( uint32_t const u : g.neighbours( v ) ) {
+				if( !permuted.has_edge( new_id[ v ], new_id[ u ] ) ) { return false; }
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Computes the largest difference in new ids between two adjacent vertices.
+	 */
+	uint32_t bandwidth( CsrGraph const& g, std::vector< uint32_t > const& new_id ) {
+		uint32_t width = 0;
+		for( uint32_t v = 0; v < g.num_vertices(); ++v ) {
+			for( uint32_t const u : g.neighbours( v ) ) {
+				width = std::max( width, new_id[ u ] > new_id[ v ] ? new_id[ u ] - new_id[ v ] : 0 );
+			}
+		}
+		return width;
+	}
+
+	/**
+	 * Parses an adjacency list file into the set of neighbours on each line.
+	 */
+	std::vector< std::set< uint32_t > > parse_lines( std::string const& text ) {
+		std::istringstream lines( text );
+		std::string line;
+		std::getline( lines, line ); /* the number of vertices */
+		std::vector< std::set< uint32_t > > neighbours;
+		while( std::getline( lines, line ) ) {
+			std::istringstream values( line );
+			neighbours.push_back( std::set< uint32_t >() );
+			uint32_t v;
+			while( values >> v ) { neighbours.back().insert( v ); }
+		}
+		return neighbours;
+	}
+}
+
+bool test_vertex_order() {
+
+	bool passed = true;
+	graphAnon::VertexOrder const orders[] = { graphAnon::VertexOrder::none,
+		graphAnon::VertexOrder::degree, graphAnon::VertexOrder::rcm, graphAnon::VertexOrder::gorder };
+
+	/**
+	 * @test Relabelling random graphs
+	 * Every order of a random graph (with some isolated vertices) is a
+	 * permutation, under which permute_vertices() yields the same graph, and
+	 * the degree order sorts the vertices by descending degree (none keeps them).
+	 */
+	const uint32_t n = 400;
+	CsrGraph const g = make_graph( shuffled( n ),
+		graphAnon::edge_list( graphAnon::random_gnm( n - 20, 3 * n, 2017 ) ) );
+	for( auto const order : orders ) {
+		std::vector< uint32_t > const new_id = graphAnon::order_vertices( g, order );
+		if( !is_relabelling( g, new_id, graphAnon::permute_vertices( g, new_id ) ) ) { passed = false; }
+		if( order == graphAnon::VertexOrder::none
+				&& !std::is_sorted( new_id.begin(), new_id.end() ) ) {
+			passed = false;
+		}
+	}
+	CsrGraph const by_degree = graphAnon::permute_vertices( g,
+		graphAnon::order_vertices( g, graphAnon::VertexOrder::degree ) );
+	for( uint32_t v = 1; v < n; ++v ) {
+		if( by_degree.degree( v - 1 ) < by_degree.degree( v ) ) { passed = false; }
+	}
+
+	/**
+	 * @test Reverse Cuthill-McKee of a path
+	 * A path with scrambled ids is searched from one end, so RCM numbers it
+	 * consecutively (bandwidth 1).
+	 */
+	graphAnon::EdgeList path;
+	for( uint32_t v = 1; v < 50; ++v ) { path.push_back( std::make_pair( v - 1, v ) ); }
+	CsrGraph const scrambled_path = make_graph( shuffled( 50 ), path );
+	if( bandwidth( scrambled_path, graphAnon::order_vertices( scrambled_path,
+			graphAnon::VertexOrder::rcm ) ) != 1 ) {
+		passed = false;
+	}
+
+	/**
+	 * @test Disjoint cliques
+	 * Both RCM and Gorder give each of three scrambled 6-cliques a
+	 * contiguous range of ids.
+	 */
+	graphAnon::EdgeList cliques;
+	for( uint32_t c = 0; c < 3; ++c ) {
+		for( uint32_t u = 0; u < 6; ++u ) {
+			for( uint32_t v = u + 1; v < 6; ++v ) { cliques.push_back( std::make_pair( 6 * c + u, 6 * c + v ) ); }
+		}
+	}
+	std::vector< uint32_t > const label = shuffled( 18 );
+	CsrGraph const scrambled_cliques = make_graph( label, cliques );
+	for( auto const order : { graphAnon::VertexOrder::rcm, graphAnon::VertexOrder::gorder } ) {
+		std::vector< uint32_t > const new_id = graphAnon::order_vertices( scrambled_cliques, order );
+		for( uint32_t v = 0; v < 18; ++v ) {
+			if( new_id[ label[ v ] ] / 6 != new_id[ label[ v - v % 6 ] ] / 6 ) { passed = false; }
+		}
+	}
+
+	/**
+	 * @test Output in the input's ids
+	 * A reordered graph, including one reordered twice, is written out
+	 * exactly as the graph was before reordering (up to the order of the
+	 * neighbours on each line).
+	 */
+	for( auto const order : orders ) {
+		UnlabelledGraph graph( 300 );
+		graph.populate_uniformly( 900, 17 );
+		std::ostringstream before, after;
+		before << graph;
+		graph.reorder( order );
+		graph.reorder( graphAnon::VertexOrder::degree );
+		after << graph;
+		if( parse_lines( before.str() ) != parse_lines( after.str() )
+				|| graph.num_edges() != 900 ) {
+			passed = false;
+		}
+	}
+
+	return passed;
+}